@@ -7,6 +7,7 @@
  */
 
 #include "AESWrapper.h"
+#include "Tracer.h"
 #include <modes.h>
 #include <aes.h>
 #include <filters.h>
@@ -106,6 +107,9 @@ std::string AESWrapper::encrypt(const uint8_t* plaintextData, size_t dataLength)
 		throw std::invalid_argument("Plaintext data buffer cannot be null when data length > 0");
 	}
 
+	TraceSpan span("crypto", "aesEncrypt");
+	span.setBytes(dataLength);
+
 	try {
 		// CRITICAL SECURITY WARNING: Fixed IV is used for demonstration only
 		// In production environments, generate a cryptographically secure random IV
@@ -154,6 +158,9 @@ std::string AESWrapper::decrypt(const uint8_t* encryptedData, size_t dataLength)
 		throw std::invalid_argument("Encrypted data buffer cannot be null when data length > 0");
 	}
 
+	TraceSpan span("crypto", "aesDecrypt");
+	span.setBytes(dataLength);
+
 	try {
 		// IV must match the one used during encryption
 		// This should be extracted from the encrypted data or
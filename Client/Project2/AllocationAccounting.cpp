@@ -0,0 +1,103 @@
+/**
+ * @file        AllocationAccounting.cpp
+ * @author      Natanel Maor Fishman
+ * @brief       Implementation of the allocation and copy counters.
+ * @details     Thread-local totals and the counting replacements of the global operator
+ *              new/delete. Compiled to an empty unit unless MESSAGEU_ALLOC_ACCOUNTING is defined.
+ * @date        2025
+ */
+
+#include "AllocationAccounting.h"
+
+#ifdef MESSAGEU_ALLOC_ACCOUNTING
+
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+	/// Trivially destructible, so it stays usable while threads and the process shut down
+	thread_local AllocationSample t_totals;
+
+	void* allocate(const std::size_t size) noexcept
+	{
+		++t_totals.allocations;
+		t_totals.bytes += size;
+		return std::malloc(size == 0 ? 1 : size);
+	}
+}
+
+// ================================
+// Public Interface Methods
+// ================================
+
+AllocationSample AllocationAccounting::current()
+{
+	return t_totals;
+}
+
+void AllocationAccounting::countCopy(const size_t bytes)
+{
+	++t_totals.copies;
+	t_totals.copiedBytes += bytes;
+}
+
+// ================================
+// Global Allocation Functions
+// ================================
+
+void* operator new(const std::size_t size)
+{
+	void* const memory = allocate(size);
+	if (memory == nullptr) {
+		throw std::bad_alloc();
+	}
+	return memory;
+}
+
+void* operator new[](const std::size_t size)
+{
+	return operator new(size);
+}
+
+void* operator new(const std::size_t size, const std::nothrow_t&) noexcept
+{
+	return allocate(size);
+}
+
+void* operator new[](const std::size_t size, const std::nothrow_t&) noexcept
+{
+	return allocate(size);
+}
+
+void operator delete(void* memory) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete[](void* memory, std::size_t) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete(void* memory, const std::nothrow_t&) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete[](void* memory, const std::nothrow_t&) noexcept
+{
+	std::free(memory);
+}
+
+#endif // MESSAGEU_ALLOC_ACCOUNTING
@@ -0,0 +1,87 @@
+/**
+ * @file        AllocationAccounting.h
+ * @author      Natanel Maor Fishman
+ * @brief       Opt-in heap allocation and buffer copy counters
+ * @details     Built with MESSAGEU_ALLOC_ACCOUNTING defined, the client replaces the global
+ *              operator new/delete to count allocations and allocated bytes per thread, and
+ *              explicit payload copies are counted where they happen. LatencyTimer samples
+ *              the counters around each engine operation, so allocation behavior is reported
+ *              next to the latency percentiles. Without the define, nothing is replaced and
+ *              every call below compiles to nothing.
+ * @version     2.0
+ * @date        2025
+ */
+
+#pragma once
+
+// ================================
+// Standard Library Includes
+// ================================
+
+#include <cstddef>
+#include <cstdint>
+
+// ================================
+// Data Structures
+// ================================
+
+/**
+ * @struct      AllocationSample
+ * @brief       Running allocation and copy totals of one thread
+ */
+struct AllocationSample
+{
+	uint64_t allocations = 0;   ///< operator new calls
+	uint64_t bytes = 0;         ///< Bytes requested from operator new
+	uint64_t copies = 0;        ///< Explicit buffer copies
+	uint64_t copiedBytes = 0;   ///< Bytes moved by explicit copies
+};
+
+// ================================
+// Class Definition
+// ================================
+
+/**
+ * @class       AllocationAccounting
+ * @brief       Per-thread allocation and copy counters
+ * @details     Counters are thread-local, so recording needs no synchronization and an
+ *              operation only sees work done on its own thread. Work handed to the task
+ *              pool (e.g. parallel inbox decryption) is not attributed to the operation.
+ *
+ * @note        This class cannot be instantiated - all methods are static. Thread-safe.
+ */
+class AllocationAccounting
+{
+public:
+	// ================================
+	// Copy Control (Deleted)
+	// ================================
+
+	AllocationAccounting() = delete;
+	AllocationAccounting(const AllocationAccounting&) = delete;
+	AllocationAccounting& operator=(const AllocationAccounting&) = delete;
+
+	// ================================
+	// Public Interface Methods
+	// ================================
+
+#ifdef MESSAGEU_ALLOC_ACCOUNTING
+	static constexpr bool ENABLED = true;   ///< Instrumentation build
+
+	/**
+	 * @brief       Gets the running totals of the calling thread
+	 */
+	static AllocationSample current();
+
+	/**
+	 * @brief       Counts an explicit buffer copy on the calling thread
+	 * @param[in]   bytes    Bytes copied
+	 */
+	static void countCopy(size_t bytes);
+#else
+	static constexpr bool ENABLED = false;  ///< Regular build: counters compiled out
+
+	static AllocationSample current() { return AllocationSample(); }
+	static void countCopy(size_t) {}
+#endif
+};
@@ -0,0 +1,268 @@
+/**
+ * @file        BenchmarkBaseline.cpp
+ * @author      Natanel Maor Fishman
+ * @brief       Implementation of benchmark baselines.
+ * @details     Aggregation, JSON baseline files and the regression report.
+ * @date        2025
+ */
+
+#include "BenchmarkBaseline.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <thread>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
+
+namespace
+{
+	constexpr const char* CLIENT_VERSION = "2.0";
+	constexpr double MAD_TO_SIGMA = 1.4826;  ///< MAD of a normal distribution -> standard deviation
+
+	/**
+	 * @brief       Quotes a JSON string (benchmark names are printable ASCII)
+	 */
+	std::string quote(const std::string& value)
+	{
+		std::string quoted = "\"";
+		for (const char c : value)
+		{
+			if (c == '"' || c == '\\') {
+				quoted += '\\';
+			}
+			quoted += (static_cast<unsigned char>(c) < 0x20) ? ' ' : c;
+		}
+		return quoted + '"';
+	}
+
+	std::string key(const std::string& suite, const std::string& name)
+	{
+		return suite + '\n' + name;
+	}
+}
+
+// ================================
+// Public Interface Methods
+// ================================
+
+std::vector<BenchmarkBaseline::Entry> BenchmarkBaseline::aggregate(const std::vector<std::vector<BenchmarkResult>>& runs)
+{
+	std::vector<Entry> entries;
+	std::map<std::string, size_t> index;
+
+	for (const auto& run : runs)
+	{
+		for (const auto& result : run)
+		{
+			const auto inserted = index.insert({ key(result.suite, result.name), entries.size() });
+			if (inserted.second)
+			{
+				entries.emplace_back();
+				entries.back().suite = result.suite;
+				entries.back().name = result.name;
+				entries.back().unit = result.unit;
+			}
+			entries[inserted.first->second].samples.push_back(result.value);
+		}
+	}
+
+	for (Entry& entry : entries)
+	{
+		entry.median = median(entry.samples);
+		std::vector<double> deviations;
+		deviations.reserve(entry.samples.size());
+		for (const double sample : entry.samples) {
+			deviations.push_back(std::fabs(sample - entry.median));
+		}
+		entry.mad = median(deviations);
+	}
+	return entries;
+}
+
+bool BenchmarkBaseline::save(const std::string& path, File baseline)
+{
+	baseline.client = CLIENT_VERSION;
+	baseline.created = boost::posix_time::to_iso_extended_string(boost::posix_time::second_clock::universal_time()) + "Z";
+	baseline.threads = std::thread::hardware_concurrency();
+
+	std::ofstream file(path, std::ios::trunc);
+	if (!file.is_open()) {
+		return false;
+	}
+
+	file << std::setprecision(10)
+		<< "{\n"
+		<< "  \"format\": " << FORMAT << ",\n"
+		<< "  \"client\": " << quote(baseline.client) << ",\n"
+		<< "  \"suite\": " << quote(baseline.suite) << ",\n"
+		<< "  \"repetitions\": " << baseline.repetitions << ",\n"
+		<< "  \"created\": " << quote(baseline.created) << ",\n"
+		<< "  \"threads\": " << baseline.threads << ",\n"
+		<< "  \"results\": [";
+	for (size_t i = 0; i < baseline.entries.size(); ++i)
+	{
+		const Entry& entry = baseline.entries[i];
+		file << (i == 0 ? "\n" : ",\n")
+			<< "    { \"suite\": " << quote(entry.suite) << ", \"name\": " << quote(entry.name)
+			<< ", \"unit\": " << quote(entry.unit) << ", \"median\": " << entry.median
+			<< ", \"mad\": " << entry.mad << ", \"samples\": [";
+		for (size_t s = 0; s < entry.samples.size(); ++s) {
+			file << (s == 0 ? "" : ", ") << entry.samples[s];
+		}
+		file << "] }";
+	}
+	file << "\n  ]\n}\n";
+	return static_cast<bool>(file.flush());
+}
+
+bool BenchmarkBaseline::load(const std::string& path, File& baseline, std::string& error)
+{
+	namespace pt = boost::property_tree;
+
+	pt::ptree root;
+	try
+	{
+		pt::read_json(path, root);
+
+		const int format = root.get<int>("format");
+		if (format != FORMAT)
+		{
+			error = "unsupported baseline format " + std::to_string(format) + " (expected " + std::to_string(FORMAT) + ")";
+			return false;
+		}
+
+		File loaded;
+		loaded.client = root.get<std::string>("client", "");
+		loaded.suite = root.get<std::string>("suite", "");
+		loaded.created = root.get<std::string>("created", "");
+		loaded.repetitions = root.get<size_t>("repetitions", 0);
+		loaded.threads = root.get<size_t>("threads", 0);
+
+		for (const auto& item : root.get_child("results"))
+		{
+			Entry entry;
+			entry.suite = item.second.get<std::string>("suite");
+			entry.name = item.second.get<std::string>("name");
+			entry.unit = item.second.get<std::string>("unit");
+			entry.median = item.second.get<double>("median");
+			entry.mad = item.second.get<double>("mad", 0.0);
+			for (const auto& sample : item.second.get_child("samples", pt::ptree())) {
+				entry.samples.push_back(sample.second.get_value<double>());
+			}
+			loaded.entries.push_back(std::move(entry));
+		}
+		baseline = std::move(loaded);
+	}
+	catch (const pt::ptree_error& e)
+	{
+		error = e.what();
+		return false;
+	}
+	return true;
+}
+
+size_t BenchmarkBaseline::compare(const File& baseline, const std::vector<Entry>& current, const double thresholdPercent, std::ostream& output)
+{
+	std::map<std::string, const Entry*> stored;
+	for (const Entry& entry : baseline.entries) {
+		stored[key(entry.suite, entry.name)] = &entry;
+	}
+
+	if (baseline.threads != 0 && baseline.threads != std::thread::hardware_concurrency())
+	{
+		output << "Warning: baseline was recorded with " << baseline.threads << " hardware threads, this host has "
+			<< std::thread::hardware_concurrency() << std::endl;
+	}
+
+	size_t nameWidth = 20;
+	for (const Entry& entry : current) {
+		nameWidth = std::max(nameWidth, entry.suite.size() + entry.name.size() + 3);
+	}
+
+	output << std::left << std::setw(static_cast<int>(nameWidth)) << "benchmark" << std::right
+		<< std::setw(16) << "baseline" << std::setw(16) << "current" << std::setw(10) << "delta"
+		<< "  status" << std::endl;
+
+	size_t regressions = 0;
+	for (const Entry& entry : current)
+	{
+		const std::string label = entry.suite + " " + entry.name;
+		output << std::left << std::setw(static_cast<int>(nameWidth)) << label << std::right
+			<< std::fixed << std::setprecision(2);
+
+		const auto found = stored.find(key(entry.suite, entry.name));
+		if (found == stored.end())
+		{
+			output << std::setw(16) << "-" << std::setw(16) << entry.median << std::setw(10) << "-" << "  new"
+				<< std::defaultfloat << std::endl;
+			continue;
+		}
+
+		const Entry& base = *found->second;
+		stored.erase(found);
+		const double delta = (base.median != 0) ? 100.0 * (entry.median - base.median) / std::fabs(base.median) : 0.0;
+		const int better = direction(entry.unit);
+
+		// Worse by more than the threshold and outside the combined noise band of both runs
+		const double noise = NOISE_SIGMAS * MAD_TO_SIGMA * (base.mad + entry.mad);
+		const bool worse = better != 0 && delta * better < -thresholdPercent;
+		const bool improved = better != 0 && delta * better > thresholdPercent;
+		const bool significant = std::fabs(entry.median - base.median) > noise;
+
+		const char* status = (better == 0) ? "info"
+			: (worse && significant) ? "REGRESSION"
+			: (worse || improved) && !significant ? "noise"
+			: improved ? "improved" : "ok";
+		if (worse && significant) {
+			++regressions;
+		}
+
+		output << std::setw(16) << base.median << std::setw(16) << entry.median
+			<< std::setw(9) << std::showpos << delta << std::noshowpos << "%  " << status << std::defaultfloat << std::endl;
+	}
+
+	for (const Entry& entry : baseline.entries)
+	{
+		if (stored.count(key(entry.suite, entry.name)) != 0) {
+			output << std::left << std::setw(static_cast<int>(nameWidth)) << (entry.suite + " " + entry.name)
+				<< std::right << "  missing from this run" << std::endl;
+		}
+	}
+
+	output << regressions << " regression(s) past " << thresholdPercent << "% (baseline " << baseline.created
+		<< ", client " << baseline.client << ", " << baseline.repetitions << " repetitions)" << std::endl;
+	return regressions;
+}
+
+int BenchmarkBaseline::direction(const std::string& unit)
+{
+	if (unit == "ops/s" || unit == "MiB/s" || unit == "x") {
+		return 1;
+	}
+	if (unit == "ms" || unit == "MiB" || unit == "calls/KiB" || unit == "copies/B") {
+		return -1;
+	}
+	return 0;
+}
+
+// ================================
+// Private Helper Methods
+// ================================
+
+double BenchmarkBaseline::median(std::vector<double> samples)
+{
+	if (samples.empty()) {
+		return 0;
+	}
+	const size_t middle = samples.size() / 2;
+	std::nth_element(samples.begin(), samples.begin() + middle, samples.end());
+	if (samples.size() % 2 != 0) {
+		return samples[middle];
+	}
+	const double upper = samples[middle];
+	return (upper + *std::max_element(samples.begin(), samples.begin() + middle)) / 2;
+}
@@ -0,0 +1,149 @@
+/**
+ * @file        BenchmarkBaseline.h
+ * @author      Natanel Maor Fishman
+ * @brief       Benchmark baselines and regression comparison
+ * @details     Aggregates repeated benchmark runs into per-benchmark medians, stores them
+ *              as a versioned JSON baseline and compares a later run against it. A change
+ *              counts as a regression only when it is worse than the threshold and larger
+ *              than the run-to-run noise of both runs.
+ * @version     2.0
+ * @date        2025
+ */
+
+#pragma once
+
+// ================================
+// Standard Library Includes
+// ================================
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+// ================================
+// Application Includes
+// ================================
+
+#include "Benchmarks.h"
+
+// ================================
+// Class Definition
+// ================================
+
+/**
+ * @class       BenchmarkBaseline
+ * @brief       Static helpers for baseline files
+ * @details     Baseline file (format 1):
+ *              {
+ *                "format": 1, "client": "2.0", "suite": "all", "repetitions": 5,
+ *                "created": "2025-01-01T12:00:00Z", "threads": 8,
+ *                "results": [
+ *                  { "suite": "registry", "name": "snapshot_lookups", "unit": "ops/s",
+ *                    "median": 1.2e7, "mad": 3.1e5, "samples": [ ... ] }, ...
+ *                ]
+ *              }
+ *              "mad" is the median absolute deviation of the samples. Higher is better for
+ *              throughput units (ops/s, MiB/s, x), lower for costs (ms, MiB, calls/KiB,
+ *              copies/B); other units are informational and never fail a comparison.
+ *
+ * @note        This class cannot be instantiated - all methods are static.
+ */
+class BenchmarkBaseline
+{
+public:
+	// ================================
+	// Data Structures
+	// ================================
+
+	/**
+	 * @struct      Entry
+	 * @brief       One benchmark over all repetitions
+	 */
+	struct Entry
+	{
+		std::string         suite;       ///< Suite name
+		std::string         name;        ///< Metric name within the suite
+		std::string         unit;        ///< Unit of the values
+		std::vector<double> samples;     ///< Value of each repetition
+		double              median = 0;  ///< Median of the samples
+		double              mad = 0;     ///< Median absolute deviation of the samples
+	};
+
+	/**
+	 * @struct      File
+	 * @brief       Contents of a baseline file
+	 */
+	struct File
+	{
+		std::string        suite;            ///< Suite that produced the results
+		std::string        client;           ///< Client version
+		std::string        created;          ///< UTC creation time (ISO 8601)
+		size_t             repetitions = 0;  ///< Runs per benchmark
+		size_t             threads = 0;      ///< Hardware threads of the host
+		std::vector<Entry> entries;          ///< Results, in run order
+	};
+
+	static constexpr int    FORMAT = 1;                 ///< Baseline file format version
+	static constexpr double NOISE_SIGMAS = 3.0;         ///< Noise band in standard deviations
+
+	// ================================
+	// Copy Control (Deleted)
+	// ================================
+
+	BenchmarkBaseline() = delete;
+	BenchmarkBaseline(const BenchmarkBaseline&) = delete;
+	BenchmarkBaseline& operator=(const BenchmarkBaseline&) = delete;
+
+	// ================================
+	// Public Interface Methods
+	// ================================
+
+	/**
+	 * @brief       Merges repeated runs of the same suite into entries
+	 * @param[in]   runs    Results of each repetition
+	 * @return      Entries in the order of the first run, with median and MAD set
+	 */
+	static std::vector<Entry> aggregate(const std::vector<std::vector<BenchmarkResult>>& runs);
+
+	/**
+	 * @brief       Writes a baseline file
+	 * @param[in]   path        Destination
+	 * @param[in]   baseline    Contents (client, created and threads are filled in)
+	 * @return      true if written, false otherwise
+	 */
+	static bool save(const std::string& path, File baseline);
+
+	/**
+	 * @brief       Reads a baseline file
+	 * @param[in]   path        Source
+	 * @param[out]  baseline    Contents
+	 * @param[out]  error       Reason on failure
+	 * @return      true if read, false for a missing, malformed or newer-format file
+	 */
+	static bool load(const std::string& path, File& baseline, std::string& error);
+
+	/**
+	 * @brief       Compares a run against a baseline and prints a delta table
+	 * @param[in]   baseline          Stored results
+	 * @param[in]   current           Results of this run
+	 * @param[in]   thresholdPercent  Largest tolerated slowdown, in percent
+	 * @param[in]   output            Report stream
+	 * @return      Number of regressions
+	 */
+	static size_t compare(const File& baseline, const std::vector<Entry>& current, double thresholdPercent, std::ostream& output);
+
+	/**
+	 * @brief       Direction of a unit: 1 = higher is better, -1 = lower is better, 0 = informational
+	 */
+	static int direction(const std::string& unit);
+
+private:
+	// ================================
+	// Private Helper Methods
+	// ================================
+
+	/**
+	 * @brief       Median of a sample set (0 when empty)
+	 */
+	static double median(std::vector<double> samples);
+};
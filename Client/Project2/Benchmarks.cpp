@@ -0,0 +1,728 @@
+/**
+ * @file        Benchmarks.cpp
+ * @author      Natanel Maor Fishman
+ * @brief       Implementation of the built-in client micro-benchmarks.
+ * @details     Suite dispatch, repetitions and baselines, result printing and the peer
+ *              registry contention benchmark.
+ * @date        2025
+ */
+
+#include "Benchmarks.h"
+#include "BenchmarkBaseline.h"
+#include "MessageEngine.h"
+#include "MockServer.h"
+#include "NetworkConnection.h"
+#include "PeerRegistry.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <boost/asio.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/process.hpp>
+
+namespace
+{
+	constexpr size_t REGISTRY_PEERS = 256;                                    ///< Registry size under test
+	constexpr auto   REGISTRY_DURATION = std::chrono::milliseconds(1000);      ///< Time per variant
+	constexpr auto   REGISTRY_WRITE_INTERVAL = std::chrono::microseconds(500); ///< Writer pacing (read-heavy mix)
+
+	/**
+	 * @brief       Runs reader threads and one paced writer for a fixed time
+	 * @param[out]  reads     Lookups completed by all readers
+	 * @param[out]  writes    Updates completed by the writer
+	 */
+	template <typename Read, typename Write>
+	void runContention(const size_t readers, const std::chrono::milliseconds duration,
+		Read read, Write write, uint64_t& reads, uint64_t& writes)
+	{
+		std::atomic<bool>     running(true);
+		std::atomic<uint64_t> readCount(0);
+		std::vector<std::thread> threads;
+
+		for (size_t r = 0; r < readers; ++r)
+		{
+			threads.emplace_back([&, r]() {
+				uint64_t local = 0;
+				size_t index = r * 7919;
+				while (running.load(std::memory_order_relaxed))
+				{
+					read(index++ % REGISTRY_PEERS);
+					++local;
+				}
+				readCount += local;
+			});
+		}
+
+		uint64_t writeCount = 0;
+		const auto deadline = std::chrono::steady_clock::now() + duration;
+		while (std::chrono::steady_clock::now() < deadline)
+		{
+			write(writeCount++ % REGISTRY_PEERS);
+			std::this_thread::sleep_for(REGISTRY_WRITE_INTERVAL);
+		}
+		running = false;
+
+		for (auto& thread : threads) {
+			thread.join();
+		}
+		reads = readCount.load();
+		writes = writeCount;
+	}
+
+	constexpr uint64_t TRANSPORT_MAX_PAYLOAD = 64ull << 20;                  ///< transport suite: largest payload
+	constexpr uint64_t TRANSPORT_FULL_MAX_PAYLOAD = 1ull << 30;              ///< transport-full suite: largest payload
+	constexpr auto     TRANSPORT_DURATION = std::chrono::milliseconds(200);  ///< Minimum time per configuration
+	constexpr uint64_t TRANSPORT_MAX_OPERATIONS = 100000;                   ///< Operation cap per configuration
+	constexpr size_t   TRANSPORT_CHUNKS[] = { DEFAULT_PACKET_SIZE, 16 * 1024, 256 * 1024 };
+	constexpr size_t   PEER_SCRATCH = 1 << 20;                               ///< Loopback peer I/O buffer
+	constexpr size_t   BASELINE_REPETITIONS = 5;                             ///< Default runs with a baseline
+	constexpr auto     ENGINE_DURATION = std::chrono::milliseconds(500);     ///< Minimum time per engine operation
+	constexpr size_t   ENGINE_MAX_OPERATIONS = 20000;                        ///< Operation cap per engine operation
+	constexpr size_t   ENGINE_DRAIN_EVERY = 256;                             ///< Sends between untimed inbox drains
+	constexpr size_t   ENGINE_INBOX_BATCH = 100;                             ///< Messages per timed inbox retrieval and batch send
+
+	/**
+	 * @enum        PeerMode
+	 * @brief       What the loopback peer does with a request (byte 8 of the request)
+	 */
+	enum PeerMode : uint8_t
+	{
+		PEER_ECHO = 0,    ///< Read the request, send back as many bytes
+		PEER_SINK = 1,    ///< Read the request, send back one packet
+		PEER_SOURCE = 2   ///< Send back the requested number of bytes
+	};
+
+	size_t wireSize(const uint64_t size)
+	{
+		return static_cast<size_t>((size + DEFAULT_PACKET_SIZE - 1) / DEFAULT_PACKET_SIZE * DEFAULT_PACKET_SIZE);
+	}
+
+	/**
+	 * @class       LoopbackPeer
+	 * @brief       In-process TCP peer speaking the packet-padded wire format
+	 * @details     Requests start with the payload length (8 bytes, little-endian) and a
+	 *              PeerMode byte. Each connection is served on its own thread until the
+	 *              client closes it. Response contents are not meaningful.
+	 */
+	class LoopbackPeer
+	{
+	public:
+		LoopbackPeer() : _acceptor(_context), _stopping(false)
+		{
+			const boost::asio::ip::tcp::endpoint endpoint(boost::asio::ip::address_v4::loopback(), 0);
+			_acceptor.open(endpoint.protocol());
+			_acceptor.bind(endpoint);
+			_acceptor.listen();
+			_acceptThread = std::thread([this]() { acceptLoop(); });
+		}
+
+		~LoopbackPeer()
+		{
+			// Wake the blocking accept with a final connection
+			_stopping = true;
+			boost::system::error_code error;
+			boost::asio::ip::tcp::socket wake(_context);
+			wake.connect(_acceptor.local_endpoint(), error);
+			_acceptThread.join();
+			wake.close(error);
+			for (auto& thread : _connections) {
+				thread.join();
+			}
+		}
+
+		LoopbackPeer(const LoopbackPeer&) = delete;
+		LoopbackPeer& operator=(const LoopbackPeer&) = delete;
+
+		std::string port() const { return std::to_string(_acceptor.local_endpoint().port()); }
+
+	private:
+		void acceptLoop()
+		{
+			while (true)
+			{
+				auto socket = std::make_shared<boost::asio::ip::tcp::socket>(_context);
+				boost::system::error_code error;
+				_acceptor.accept(*socket, error);
+				if (_stopping) {
+					return;
+				}
+				if (!error) {
+					_connections.emplace_back([socket]() { serve(*socket); });
+				}
+			}
+		}
+
+		static void serve(boost::asio::ip::tcp::socket& socket)
+		{
+			std::vector<uint8_t> scratch(PEER_SCRATCH);
+			boost::system::error_code error;
+			socket.set_option(boost::asio::ip::tcp::no_delay(true), error);
+
+			const auto transfer = [&](size_t bytes, const bool write) {
+				while (bytes > 0 && !error)
+				{
+					const auto chunk = boost::asio::buffer(scratch.data(), std::min(bytes, scratch.size()));
+					bytes -= write ? boost::asio::write(socket, chunk, error) : boost::asio::read(socket, chunk, error);
+				}
+			};
+
+			while (!error)
+			{
+				transfer(DEFAULT_PACKET_SIZE, false);
+				if (error) {
+					return;  // Client closed the connection
+				}
+				uint64_t size = 0;
+				for (size_t i = 8; i > 0; --i) {
+					size = (size << 8) | scratch[i - 1];
+				}
+				const uint8_t mode = scratch[8];
+
+				if (mode != PEER_SOURCE && wireSize(size) > DEFAULT_PACKET_SIZE) {
+					transfer(wireSize(size) - DEFAULT_PACKET_SIZE, false);
+				}
+				transfer((mode == PEER_SINK) ? DEFAULT_PACKET_SIZE : wireSize(size), true);
+			}
+		}
+
+		boost::asio::io_context        _context;
+		boost::asio::ip::tcp::acceptor _acceptor;
+		std::atomic<bool>              _stopping;
+		std::thread                    _acceptThread;
+		std::vector<std::thread>       _connections;  // Touched by the accept thread only until it is joined
+	};
+
+	/**
+	 * @brief       Writes the loopback peer request header into a payload
+	 */
+	void setPeerRequest(std::vector<uint8_t>& payload, uint64_t size, const PeerMode mode)
+	{
+		for (size_t i = 0; i < 8; ++i, size >>= 8) {
+			payload[i] = static_cast<uint8_t>(size & 0xFF);
+		}
+		payload[8] = mode;
+	}
+
+	std::string formatBytes(const uint64_t bytes)
+	{
+		if (bytes >= (1ull << 30) && bytes % (1ull << 30) == 0) return std::to_string(bytes >> 30) + "G";
+		if (bytes >= (1ull << 20) && bytes % (1ull << 20) == 0) return std::to_string(bytes >> 20) + "M";
+		if (bytes >= (1ull << 10) && bytes % (1ull << 10) == 0) return std::to_string(bytes >> 10) + "K";
+		return std::to_string(bytes) + "B";
+	}
+
+	/**
+	 * @brief       Appends p50, p90 and max of a sample set
+	 */
+	void addDistribution(std::vector<BenchmarkResult>& results, const std::string& suite, const std::string& name,
+		std::vector<double> samples, const std::string& unit)
+	{
+		if (samples.empty()) {
+			return;
+		}
+		std::sort(samples.begin(), samples.end());
+		const auto at = [&samples](const double quantile) {
+			return samples[static_cast<size_t>(quantile * static_cast<double>(samples.size() - 1) + 0.5)];
+		};
+		results.push_back({ suite, name + " p50", at(0.50), unit });
+		results.push_back({ suite, name + " p90", at(0.90), unit });
+		results.push_back({ suite, name + " max", samples.back(), unit });
+	}
+
+	std::vector<PeerInfo> makePeers()
+	{
+		std::vector<PeerInfo> peers(REGISTRY_PEERS);
+		for (size_t i = 0; i < peers.size(); ++i)
+		{
+			peers[i].id.uuid[0] = static_cast<uint8_t>(i);
+			peers[i].id.uuid[1] = static_cast<uint8_t>(i >> 8);
+			peers[i].username = "peer" + std::to_string(i);
+		}
+		return peers;
+	}
+}
+
+// ================================
+// Entry Points
+// ================================
+
+int Benchmarks::run(const ClientOptions& options, const std::string& executable)
+{
+	const bool useBaseline = !options.baselineSavePath.empty() || !options.baselineComparePath.empty();
+	const size_t repetitions = (options.benchmarkRepetitions > 0) ? options.benchmarkRepetitions
+		: useBaseline ? BASELINE_REPETITIONS : 1;
+
+	// A bad baseline fails before the suites spend their time
+	BenchmarkBaseline::File stored;
+	std::string error;
+	if (!options.baselineComparePath.empty() && !BenchmarkBaseline::load(options.baselineComparePath, stored, error))
+	{
+		std::cerr << "Cannot read baseline " << options.baselineComparePath << ": " << error << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	std::vector<std::vector<BenchmarkResult>> runs;
+	for (size_t repetition = 1; repetition <= repetitions; ++repetition)
+	{
+		if (repetitions > 1) {
+			std::cerr << "benchmark: run " << repetition << "/" << repetitions << std::endl;
+		}
+		runs.emplace_back();
+		if (!runSuite(options, executable, runs.back())) {
+			return EXIT_FAILURE;
+		}
+	}
+
+	if (repetitions == 1 && !useBaseline)
+	{
+		print(runs.front());
+		return EXIT_SUCCESS;
+	}
+
+	// Medians of the repetitions
+	const auto entries = BenchmarkBaseline::aggregate(runs);
+	std::vector<BenchmarkResult> medians;
+	for (const auto& entry : entries) {
+		medians.push_back({ entry.suite, entry.name, entry.median, entry.unit });
+	}
+	print(medians);
+
+	if (!options.baselineSavePath.empty())
+	{
+		BenchmarkBaseline::File baseline;
+		baseline.suite = options.benchmarkSuite;
+		baseline.repetitions = repetitions;
+		baseline.entries = entries;
+		if (!BenchmarkBaseline::save(options.baselineSavePath, baseline))
+		{
+			std::cerr << "Cannot write baseline " << options.baselineSavePath << std::endl;
+			return EXIT_FAILURE;
+		}
+		std::cout << std::endl << "Baseline written to " << options.baselineSavePath << std::endl;
+	}
+
+	if (!options.baselineComparePath.empty())
+	{
+		std::cout << std::endl;
+		if (BenchmarkBaseline::compare(stored, entries, static_cast<double>(options.regressionThreshold), std::cout) > 0) {
+			return EXIT_FAILURE;
+		}
+	}
+	return EXIT_SUCCESS;
+}
+
+/**
+ * @brief       Same workload against the snapshot registry and a mutex-guarded vector
+ * @details     Readers look peers up by username; the writer sets a symmetric key on one
+ *              peer per iteration.
+ */
+std::vector<BenchmarkResult> Benchmarks::runRegistryContention(const size_t readers, const std::chrono::milliseconds duration)
+{
+	const std::vector<PeerInfo> peers = makePeers();
+	std::vector<std::string> names;
+	for (const auto& peer : peers) {
+		names.push_back(peer.username);
+	}
+
+	// Snapshot registry
+	PeerRegistry registry;
+	registry.mergeList(peers);
+	uint64_t snapshotReads = 0;
+	uint64_t snapshotWrites = 0;
+	runContention(readers, duration,
+		[&](const size_t i) {
+			PeerInfo peer;
+			(void)registry.findByName(names[i], peer);
+		},
+		[&](const size_t i) {
+			registry.update([&](std::vector<PeerInfo>& current) {
+				current[i].symmetricKeySet = true;
+				return true;
+			});
+		},
+		snapshotReads, snapshotWrites);
+
+	// Baseline: linear search under a mutex
+	std::vector<PeerInfo> locked = peers;
+	std::mutex lockedMutex;
+	uint64_t lockedReads = 0;
+	uint64_t lockedWrites = 0;
+	runContention(readers, duration,
+		[&](const size_t i) {
+			PeerInfo peer;
+			std::lock_guard<std::mutex> lock(lockedMutex);
+			for (const auto& entry : locked)
+			{
+				if (entry.username == names[i])
+				{
+					peer = entry;
+					break;
+				}
+			}
+		},
+		[&](const size_t i) {
+			std::lock_guard<std::mutex> lock(lockedMutex);
+			locked[i].symmetricKeySet = true;
+		},
+		lockedReads, lockedWrites);
+
+	const double seconds = std::chrono::duration<double>(duration).count();
+	const double snapshotRate = snapshotReads / seconds;
+	const double lockedRate = lockedReads / seconds;
+
+	std::vector<BenchmarkResult> results;
+	results.push_back({ "registry", "readers", static_cast<double>(readers), "threads" });
+	results.push_back({ "registry", "snapshot_lookups", snapshotRate, "ops/s" });
+	results.push_back({ "registry", "snapshot_updates", snapshotWrites / seconds, "ops/s" });
+	results.push_back({ "registry", "mutex_lookups", lockedRate, "ops/s" });
+	results.push_back({ "registry", "mutex_updates", lockedWrites / seconds, "ops/s" });
+	results.push_back({ "registry", "lookup_speedup", (lockedRate > 0) ? snapshotRate / lockedRate : 0, "x" });
+	results.push_back({ "registry", "retired_pending", static_cast<double>(registry.retiredCount()), "snapshots" });
+	return results;
+}
+
+/**
+ * @brief       Sweeps payload size, chunk size and connection reuse over loopback TCP
+ * @details     Throughput counts payload bytes in the measured direction(s). Socket calls
+ *              and copies come from NetworkConnection's transfer counters and include the
+ *              peer protocol's small control and acknowledgement packets.
+ */
+std::vector<BenchmarkResult> Benchmarks::runTransport(const uint64_t maxPayload, const std::chrono::milliseconds minDuration)
+{
+	struct Operation
+	{
+		const char* name;
+		PeerMode    mode;
+		bool        reuse;
+		unsigned    directions;  // Payload copies moved per operation
+	};
+	const Operation operations[] = {
+		{ "send",          PEER_SINK,   true,  1 },
+		{ "receive",       PEER_SOURCE, true,  1 },
+		{ "exchange",      PEER_ECHO,   true,  2 },
+		{ "exchange/new",  PEER_ECHO,   false, 2 }
+	};
+
+	std::vector<uint64_t> sizes;
+	for (uint64_t size = 16; size <= maxPayload; size *= 16) {
+		sizes.push_back(size);
+	}
+	if (sizes.back() != maxPayload) {
+		sizes.push_back(maxPayload);
+	}
+
+	LoopbackPeer peer;
+	std::vector<uint8_t> payload(static_cast<size_t>(maxPayload), 0x5A);
+	std::vector<uint8_t> response(std::max<size_t>(static_cast<size_t>(maxPayload), DEFAULT_PACKET_SIZE));
+	std::vector<uint8_t> control(DEFAULT_PACKET_SIZE);
+	std::vector<BenchmarkResult> results;
+
+	for (const Operation& operation : operations)
+	{
+		for (const uint64_t size : sizes)
+		{
+			for (const size_t chunk : TRANSPORT_CHUNKS)
+			{
+				NetworkConnection connection;
+				connection.configureEndpoint("127.0.0.1", peer.port());
+				connection.setPersistent(operation.reuse);
+				connection.setTransferChunkSize(chunk);
+				if (operation.reuse && !connection.acquireConnection())
+				{
+					std::cerr << "transport: cannot connect to the loopback peer" << std::endl;
+					return results;
+				}
+
+				const size_t length = static_cast<size_t>(size);
+				setPeerRequest(payload, size, operation.mode);
+				setPeerRequest(control, size, operation.mode);
+				const auto runOnce = [&]() {
+					switch (operation.mode)
+					{
+					case PEER_SINK:
+						return connection.sendData(payload.data(), length) && connection.receiveData(response.data(), 1);
+					case PEER_SOURCE:
+						return connection.sendData(control.data(), 16) && connection.receiveData(response.data(), length);
+					default:
+						return connection.exchangeData(payload.data(), length, response.data(), length);
+					}
+				};
+
+				uint64_t count = 0;
+				const auto start = std::chrono::steady_clock::now();
+				std::chrono::duration<double> elapsed(0);
+				do
+				{
+					if (!runOnce())
+					{
+						std::cerr << "transport: " << operation.name << " of " << formatBytes(size) << " failed" << std::endl;
+						return results;
+					}
+					++count;
+					elapsed = std::chrono::steady_clock::now() - start;
+				} while (elapsed < minDuration && count < TRANSPORT_MAX_OPERATIONS);
+				connection.disconnectSocket();
+
+				const NetworkConnection::TransferStats stats = connection.getTransferStats();
+				const double bytes = static_cast<double>(size) * count * operation.directions;
+				const std::string name = std::string(operation.name) + " " + formatBytes(size) + " chunk=" + formatBytes(chunk);
+				results.push_back({ "transport", name, bytes / (1 << 20) / elapsed.count(), "MiB/s" });
+				results.push_back({ "transport", name + " calls", (stats.readCalls + stats.writeCalls) / (bytes / 1024), "calls/KiB" });
+				results.push_back({ "transport", name + " copies", stats.bytesCopied / bytes, "copies/B" });
+			}
+		}
+	}
+	return results;
+}
+
+/**
+ * @brief       Launches the client as a headless run that only starts up
+ * @details     The child gets "--startup-profile --exec #": a comment line is a valid
+ *              headless script that does nothing, so the process exits right after its
+ *              startup report. Wall time spans process creation to exit.
+ */
+bool Benchmarks::runColdStart(const std::string& executable, const size_t launches, std::vector<BenchmarkResult>& results)
+{
+	namespace bp = boost::process;
+
+	std::vector<double> wallTimes;
+	std::vector<std::string> phaseNames;                 // In report order
+	std::map<std::string, std::vector<double>> phases;  // Phase -> ms (peak_rss: MiB)
+
+	for (size_t launch = 0; launch < launches; ++launch)
+	{
+		bp::ipstream report;
+		std::vector<std::string> lines;
+		int status = -1;
+		const auto start = std::chrono::steady_clock::now();
+		try
+		{
+			bp::child child(executable, "--startup-profile", "--exec", "#",
+				bp::std_in < bp::null, bp::std_out > bp::null, bp::std_err > report);
+			for (std::string line; std::getline(report, line);) {
+				lines.push_back(line);
+			}
+			child.wait();
+			status = child.exit_code();
+		}
+		catch (const std::exception& e)
+		{
+			std::cerr << "cold-start: cannot launch " << executable << ": " << e.what() << std::endl;
+			return false;
+		}
+		wallTimes.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+
+		if (status != 0)
+		{
+			std::cerr << "cold-start: client exited with status " << status
+				<< " (server.info and my.info in the working directory are needed)" << std::endl;
+			for (const auto& line : lines) {
+				std::cerr << "  " << line << std::endl;
+			}
+			return false;
+		}
+
+		for (const auto& line : lines)
+		{
+			std::istringstream fields(line);
+			std::string name;
+			double value = 0;
+			if (!(fields >> name >> value) || name.compare(0, 8, "startup.") != 0) {
+				continue;
+			}
+			name = name.substr(8);
+			if (phases.find(name) == phases.end()) {
+				phaseNames.push_back(name);
+			}
+			phases[name].push_back(value);
+		}
+	}
+
+	addDistribution(results, "cold-start", "wall", wallTimes, "ms");
+	for (const auto& name : phaseNames) {
+		addDistribution(results, "cold-start", name, phases[name], (name == "peak_rss") ? "MiB" : "ms");
+	}
+	return true;
+}
+
+/**
+ * @brief       Times engine operations against a MockServer
+ * @details     Only the timed calls count towards throughput and latency; the untimed
+ *              inbox drains keep the mock server's store small between sends.
+ */
+std::vector<BenchmarkResult> Benchmarks::runEngine(const std::chrono::milliseconds minDuration)
+{
+	std::vector<BenchmarkResult> results;
+	MockServer server;
+	if (!server.start())
+	{
+		std::cerr << "engine: cannot start the mock server" << std::endl;
+		return results;
+	}
+
+	boost::system::error_code error;
+	const boost::filesystem::path directory = boost::filesystem::temp_directory_path(error)
+		/ boost::filesystem::unique_path("messageu-bench-%%%%%%%%");
+	boost::filesystem::create_directories(directory, error);
+	if (error)
+	{
+		std::cerr << "engine: cannot create " << directory.string() << ": " << error.message() << std::endl;
+		return results;
+	}
+
+	{
+		MessageEngine sender;
+		MessageEngine receiver;
+		const std::string port = std::to_string(server.getPort());
+		const auto fail = [&sender, &receiver, &results](const std::string& step) {
+			std::cerr << "engine: " << step << " failed: " << (sender.getErrorMessage().empty() ? receiver : sender).getErrorMessage() << std::endl;
+			results.clear();
+			return false;
+		};
+
+		bool ready = true;
+		for (MessageEngine* const engine : { &sender, &receiver })
+		{
+			const std::string name = (engine == &sender) ? "benchsender" : "benchreceiver";
+			engine->setPersistentConnection(true);
+			engine->setCredentialsFile((directory / (name + ".info")).string());
+			ready = ready && ((engine->setServerEndpoint("127.0.0.1", port) && engine->registerClient(name)) || fail("register " + name));
+		}
+
+		const auto drain = [&receiver]() {
+			return receiver.retrievePendingMessages([](const MessageEngine::MessageData&) {});
+		};
+		ready = ready && ((receiver.requestClientsList() && sender.prepareSecureChannel("benchreceiver") && drain())
+			|| fail("key exchange"));
+
+		// Times the operation until minDuration of timed work or the operation cap; the
+		// optional prepare step runs untimed before each call
+		const auto measure = [&](const std::string& name, const std::function<bool()>& operation,
+			const std::function<bool(size_t)>& prepare, const size_t itemsPerOperation) {
+			std::vector<double> latencies;
+			std::chrono::duration<double> timed(0);
+			while (timed < minDuration && latencies.size() < ENGINE_MAX_OPERATIONS)
+			{
+				if (prepare && !prepare(latencies.size())) {
+					return fail(name + " setup");
+				}
+				const auto start = std::chrono::steady_clock::now();
+				if (!operation()) {
+					return fail(name);
+				}
+				const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+				timed += elapsed;
+				latencies.push_back(elapsed.count() * 1000);
+			}
+			results.push_back({ "engine", name, static_cast<double>(latencies.size() * itemsPerOperation) / timed.count(), "ops/s" });
+			addDistribution(results, "engine", name + " latency", latencies, "ms");
+			return true;
+		};
+
+		const std::string smallText(64, 'x');
+		const std::string largeText(64 * 1024, 'x');
+		const auto drainEvery = [&drain](const size_t done) {
+			return done % ENGINE_DRAIN_EVERY != 0 || drain();
+		};
+		const auto fillInbox = [&sender](size_t) {
+			for (size_t i = 0; i < ENGINE_INBOX_BATCH; ++i)
+			{
+				if (!sender.sendMessage("benchreceiver", MSG_TEXT, "inbox message")) {
+					return false;
+				}
+			}
+			return true;
+		};
+		const std::vector<MessageEngine::BatchEntry> smallBatch(ENGINE_INBOX_BATCH, { "benchreceiver", MSG_TEXT, smallText });
+		std::vector<messageID_t> batchIds;
+
+		ready = ready
+			&& measure("clients_list", [&]() { return sender.requestClientsList(); }, nullptr, 1)
+			&& measure("public_key", [&]() { return sender.requestClientPublicKey("benchreceiver"); }, nullptr, 1)
+			&& measure("send_text 64B", [&]() { return sender.sendMessage("benchreceiver", MSG_TEXT, smallText); }, drainEvery, 1)
+			&& measure("send_text 64K", [&]() { return sender.sendMessage("benchreceiver", MSG_TEXT, largeText); }, drainEvery, 1)
+			&& measure("send_batch 64B x" + std::to_string(ENGINE_INBOX_BATCH), [&]() { return sender.sendMessages(smallBatch, batchIds); },
+				[&drain](size_t) { return drain(); }, ENGINE_INBOX_BATCH)
+			&& (drain() || fail("inbox drain"))
+			&& measure("inbox empty", drain, nullptr, 1)
+			&& measure("inbox_probe", [&]() { MessageEngine::InboxStatus status; return receiver.probeInbox(status); }, nullptr, 1)
+			&& measure("inbox x" + std::to_string(ENGINE_INBOX_BATCH), drain, fillInbox, ENGINE_INBOX_BATCH);
+		if (ready) {
+			results.push_back({ "engine", "server_requests", static_cast<double>(server.getRequestCount()), "requests" });
+		}
+	}
+
+	server.stop();
+	boost::filesystem::remove_all(directory, error);
+	return results;
+}
+
+// ================================
+// Private Helper Methods
+// ================================
+
+bool Benchmarks::runSuite(const ClientOptions& options, const std::string& executable, std::vector<BenchmarkResult>& results)
+{
+	const std::string& suite = options.benchmarkSuite;
+
+	if (suite == "cold-start" && !runColdStart(executable, options.coldStarts, results)) {
+		return false;
+	}
+
+	if (suite == "registry" || suite == "all")
+	{
+		const size_t readers = std::max<size_t>(2, std::thread::hardware_concurrency());
+		const auto registry = runRegistryContention(readers, REGISTRY_DURATION);
+		results.insert(results.end(), registry.begin(), registry.end());
+	}
+
+	if (suite == "transport" || suite == "transport-full" || suite == "all")
+	{
+		const auto transport = runTransport((suite == "transport-full") ? TRANSPORT_FULL_MAX_PAYLOAD : TRANSPORT_MAX_PAYLOAD,
+			TRANSPORT_DURATION);
+		results.insert(results.end(), transport.begin(), transport.end());
+	}
+
+	if (suite == "engine" || suite == "all")
+	{
+		const auto engine = runEngine(ENGINE_DURATION);
+		if (engine.empty()) {
+			return false;
+		}
+		results.insert(results.end(), engine.begin(), engine.end());
+	}
+
+	if (results.empty())
+	{
+		std::cerr << "Unknown benchmark suite '" << suite << "' (available: registry, transport, transport-full, engine, cold-start, all)" << std::endl;
+		return false;
+	}
+	return true;
+}
+
+void Benchmarks::print(const std::vector<BenchmarkResult>& results)
+{
+	size_t suiteWidth = 10;
+	size_t nameWidth = 20;
+	for (const auto& result : results)
+	{
+		suiteWidth = std::max(suiteWidth, result.suite.size() + 2);
+		nameWidth = std::max(nameWidth, result.name.size() + 2);
+	}
+
+	for (const auto& result : results)
+	{
+		std::cout << std::left << std::setw(static_cast<int>(suiteWidth)) << result.suite
+			<< std::setw(static_cast<int>(nameWidth)) << result.name
+			<< std::right << std::setw(16) << std::fixed << std::setprecision(2) << result.value
+			<< " " << result.unit << std::endl;
+	}
+}
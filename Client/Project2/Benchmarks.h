@@ -0,0 +1,151 @@
+/**
+ * @file        Benchmarks.h
+ * @author      Natanel Maor Fishman
+ * @brief       Built-in client micro-benchmarks
+ * @details     Self-contained benchmark suites that exercise client components without a
+ *              running server, run from the command line with --benchmark [suite].
+ * @version     2.0
+ * @date        2025
+ */
+
+#pragma once
+
+// ================================
+// Standard Library Includes
+// ================================
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// ================================
+// Application Includes
+// ================================
+
+#include "CommandLine.h"
+
+// ================================
+// Data Structures
+// ================================
+
+/**
+ * @struct      BenchmarkResult
+ * @brief       One measured value of a benchmark suite
+ */
+struct BenchmarkResult
+{
+	std::string suite;      ///< Suite name (e.g. "registry")
+	std::string name;       ///< Metric name within the suite
+	double      value = 0;  ///< Measured value
+	std::string unit;       ///< Unit of the value
+};
+
+// ================================
+// Class Definition
+// ================================
+
+/**
+ * @class       Benchmarks
+ * @brief       Static entry points of the benchmark suites
+ * @details     Suites:
+ *              - registry: read-heavy contention on the peer registry. Reader threads look up
+ *                peers while one writer publishes key updates; the snapshot registry is
+ *                compared against a mutex-guarded vector (the previous design).
+ *              - transport: NetworkConnection against an in-process loopback peer. Sweeps
+ *                payload size (16 B to 64 MiB), transfer chunk size (one packet, as used
+ *                by the client, vs. larger) and connection reuse, reporting throughput,
+ *                socket calls per KiB and copies per byte. transport-full extends the
+ *                payload sweep to 1 GiB (needs about 2 GiB of memory).
+ *              - engine: two MessageEngine clients against an in-process MockServer. Reports
+ *                throughput and latency of the clients list, public key, text send (64 B and
+ *                64 KiB, and batches of 64 B texts), inbox probe and inbox retrieval, i.e. the
+ *                client cost of each request without the Python server or a real network
+ *                in the way.
+ *              - cold-start: launches the client repeatedly as a headless run with no
+ *                commands and reports the distribution of wall time, each startup phase
+ *                and peak RSS. Uses server.info and my.info of the working directory, so
+ *                it is not part of "all".
+ *
+ * @note        This class cannot be instantiated - all methods are static.
+ */
+class Benchmarks
+{
+public:
+	// ================================
+	// Copy Control (Deleted)
+	// ================================
+
+	Benchmarks() = delete;
+	Benchmarks(const Benchmarks&) = delete;
+	Benchmarks& operator=(const Benchmarks&) = delete;
+
+	// ================================
+	// Entry Points
+	// ================================
+
+	/**
+	 * @brief       Runs one suite (or "all") and prints the results
+	 * @param[in]   options       Parsed options (suite name, cold-start launches, repetitions,
+	 *                            baseline files and regression threshold)
+	 * @param[in]   executable    Path of this client (argv[0]), launched by cold-start
+	 * @return      EXIT_SUCCESS, or EXIT_FAILURE for an unknown or failed suite, an unreadable
+	 *              baseline or a regression against the compared baseline
+	 * @details     With several repetitions or a baseline file the suite runs repeatedly and
+	 *              the medians are printed (see BenchmarkBaseline).
+	 */
+	static int run(const ClientOptions& options, const std::string& executable);
+
+	/**
+	 * @brief       Peer registry read-heavy contention benchmark
+	 * @param[in]   readers     Number of concurrent reader threads
+	 * @param[in]   duration    Measurement time per variant
+	 * @return      Lookup and update throughput of both variants
+	 */
+	static std::vector<BenchmarkResult> runRegistryContention(size_t readers, std::chrono::milliseconds duration);
+
+	/**
+	 * @brief       Loopback transport benchmark
+	 * @param[in]   maxPayload     Largest payload of the size sweep
+	 * @param[in]   minDuration    Minimum measuring time per configuration
+	 * @return      Throughput, socket calls and copies per sweep configuration
+	 * @details     Operations: send (sendData, peer acknowledges), receive (receiveData of a
+	 *              peer-generated response) and exchange (exchangeData against an echo,
+	 *              with and without connection reuse).
+	 */
+	static std::vector<BenchmarkResult> runTransport(uint64_t maxPayload, std::chrono::milliseconds minDuration);
+
+	/**
+	 * @brief       Cold-start benchmark
+	 * @param[in]   executable    Client to launch
+	 * @param[in]   launches      Number of launches
+	 * @param[out]  results       p50, p90 and max of wall time, each startup phase and peak RSS
+	 * @return      true if every launch completed startup, false otherwise (error on stderr)
+	 */
+	static bool runColdStart(const std::string& executable, size_t launches, std::vector<BenchmarkResult>& results);
+
+	/**
+	 * @brief       Engine benchmark against an in-process MockServer
+	 * @param[in]   minDuration    Minimum timed work per operation
+	 * @return      Throughput and latency distribution per operation, or empty on failure
+	 *              (error on stderr)
+	 * @details     Credentials are kept in a temporary directory removed afterwards.
+	 */
+	static std::vector<BenchmarkResult> runEngine(std::chrono::milliseconds minDuration);
+
+private:
+	// ================================
+	// Private Helper Methods
+	// ================================
+
+	/**
+	 * @brief       Runs the selected suite once, appending its results
+	 * @return      true on success, false for an unknown or failed suite (error on stderr)
+	 */
+	static bool runSuite(const ClientOptions& options, const std::string& executable, std::vector<BenchmarkResult>& results);
+
+	/**
+	 * @brief       Prints results as an aligned table
+	 */
+	static void print(const std::vector<BenchmarkResult>& results);
+};
@@ -0,0 +1,390 @@
+/**
+ * @file        CommandLine.cpp
+ * @author      Natanel Maor Fishman
+ * @brief       Implementation of command-line option parsing.
+ * @details     argv parsing, rate limit specifications, usage text and engine configuration.
+ * @date        2025
+ */
+
+#include "CommandLine.h"
+#include "EmulatedConnection.h"
+#include "LoadGenerator.h"
+#include "MessageEngine.h"
+#include "PollScheduler.h"
+#include "SharedDirectory.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+namespace
+{
+	/**
+	 * @brief       Checks if the argument after index i exists and is not an option
+	 */
+	bool hasValue(const int i, const int argumentCount, char* argumentVector[])
+	{
+		return (i + 1 < argumentCount) && (strncmp(argumentVector[i + 1], "--", 2) != 0);
+	}
+}
+
+// ================================
+// Parsing Methods
+// ================================
+
+bool CommandLine::parse(const int argumentCount, char* argumentVector[], ClientOptions& options, std::string& error)
+{
+	for (int i = 1; i < argumentCount; ++i)
+	{
+		const std::string argument = argumentVector[i];
+
+		if (argument == "--help" || argument == "-h")
+		{
+			options.showHelp = true;
+		}
+		else if (argument == "--shared-directory")
+		{
+			options.sharedDirectory = true;
+			options.sharedDirectoryName = hasValue(i, argumentCount, argumentVector) ? argumentVector[++i] : SHARED_DIRECTORY_NAME;
+		}
+		else if (argument == "--rate-limit")
+		{
+			code_t code = 0;
+			RateLimiter::Limit limit;
+			if (!hasValue(i, argumentCount, argumentVector) || !parseRateLimit(argumentVector[++i], code, limit))
+			{
+				error = "Invalid --rate-limit specification (expected code:rps[:bps])";
+				return false;
+			}
+			options.rateLimits.emplace_back(code, limit);
+		}
+		else if (argument == "--benchmark")
+		{
+			options.benchmark = true;
+			options.benchmarkSuite = hasValue(i, argumentCount, argumentVector) ? argumentVector[++i] : "all";
+		}
+		else if (argument == "--exec" || argument == "-e")
+		{
+			if (i + 1 >= argumentCount)
+			{
+				error = "Missing command after " + argument;
+				return false;
+			}
+			options.commands.push_back(argumentVector[++i]);
+		}
+		else if (argument == "--script")
+		{
+			if (i + 1 >= argumentCount)
+			{
+				error = "Missing file name after --script";
+				return false;
+			}
+			options.scriptFiles.push_back(argumentVector[++i]);
+		}
+		else if (argument == "--keep-going")
+		{
+			options.keepGoing = true;
+		}
+		else if (argument == "--json")
+		{
+			options.jsonOutput = true;
+		}
+		else if (argument == "--keep-alive")
+		{
+			options.persistentConnection = true;
+		}
+		else if (argument == "--stream")
+		{
+			if (!hasValue(i, argumentCount, argumentVector))
+			{
+				error = "Missing recipient after --stream";
+				return false;
+			}
+			options.streamRecipient = argumentVector[++i];
+		}
+		else if (argument == "--trace")
+		{
+			if (!hasValue(i, argumentCount, argumentVector))
+			{
+				error = "Missing file name after --trace";
+				return false;
+			}
+			options.tracePath = argumentVector[++i];
+		}
+		else if (argument == "--capture" || argument == "--replay" || argument == "--metrics-file"
+			|| argument == "--baseline-save" || argument == "--baseline-compare" || argument == "--log-file")
+		{
+			if (!hasValue(i, argumentCount, argumentVector))
+			{
+				error = "Missing file name after " + argument;
+				return false;
+			}
+			std::string& target = (argument == "--capture") ? options.capturePath
+				: (argument == "--replay") ? options.replayPath
+				: (argument == "--metrics-file") ? options.metricsPath
+				: (argument == "--baseline-save") ? options.baselineSavePath
+				: (argument == "--baseline-compare") ? options.baselineComparePath : options.logPath;
+			target = argumentVector[++i];
+		}
+		else if (argument == "--replay-serve")
+		{
+			size_t port = 0;
+			if (!hasValue(i, argumentCount, argumentVector) || !parseCount(argumentVector[++i], port) || port > UINT16_MAX)
+			{
+				error = "Invalid port for --replay-serve";
+				return false;
+			}
+			options.replayServePort = static_cast<uint16_t>(port);
+		}
+		else if (argument == "--mock-server")
+		{
+			size_t port = 0;
+			if (!hasValue(i, argumentCount, argumentVector) || !parseCount(argumentVector[++i], port) || port > UINT16_MAX)
+			{
+				error = "Invalid port for --mock-server";
+				return false;
+			}
+			options.mockServer = true;
+			options.mockServerPort = static_cast<uint16_t>(port);
+		}
+		else if (argument == "--replay-paced")
+		{
+			options.replayPaced = true;
+		}
+		else if (argument == "--load-test")
+		{
+			options.loadTest = true;
+		}
+		else if (argument == "--load-mix")
+		{
+			LoadGenerator::Mix mix;
+			if (!hasValue(i, argumentCount, argumentVector) || !LoadGenerator::parseMix(argumentVector[++i], mix))
+			{
+				error = "Invalid --load-mix specification (expected e.g. text=60,file=5,list=10,inbox=25)";
+				return false;
+			}
+			options.loadMix = argumentVector[i];
+		}
+		else if (argument == "--net-emulation")
+		{
+			EmulatedConnection::Profile profile;
+			if (!hasValue(i, argumentCount, argumentVector) || !EmulatedConnection::parseProfile(argumentVector[++i], profile))
+			{
+				error = "Invalid --net-emulation profile (expected e.g. rtt=80,jitter=10,bw=1048576,reset=0.01,partial=0.005,seed=7)";
+				return false;
+			}
+			options.networkEmulation = argumentVector[i];
+		}
+		else if (argument == "--log-level")
+		{
+			if (!hasValue(i, argumentCount, argumentVector) || !EventLog::parseLevel(argumentVector[++i], options.logLevel))
+			{
+				error = "Invalid --log-level (expected debug, info, warning or failure)";
+				return false;
+			}
+		}
+		else if (argument == "--tui")
+		{
+			options.terminalUI = true;
+		}
+		else if (argument == "--startup-profile")
+		{
+			options.startupProfile = true;
+		}
+		else if (argument == "--wire-stats")
+		{
+			options.wireStats = true;
+		}
+		else if (argument == "--batch-bytes" || argument == "--batch-ms" || argument == "--poll-ms" || argument == "--poll-max-ms"
+			|| argument == "--load-clients" || argument == "--load-seconds" || argument == "--cold-starts"
+			|| argument == "--metrics-ms" || argument == "--repetitions" || argument == "--regression-threshold"
+			|| argument == "--log-max-bytes" || argument == "--log-files"
+			|| argument == "--stripes" || argument == "--stripe-min-bytes")
+		{
+			size_t& target = (argument == "--batch-bytes") ? options.batchBytes
+				: (argument == "--batch-ms") ? options.batchWindowMs
+				: (argument == "--poll-ms") ? options.pollIntervalMs
+				: (argument == "--poll-max-ms") ? options.pollMaxIntervalMs
+				: (argument == "--load-clients") ? options.loadClients
+				: (argument == "--load-seconds") ? options.loadSeconds
+				: (argument == "--cold-starts") ? options.coldStarts
+				: (argument == "--metrics-ms") ? options.metricsIntervalMs
+				: (argument == "--repetitions") ? options.benchmarkRepetitions
+				: (argument == "--regression-threshold") ? options.regressionThreshold
+				: (argument == "--log-max-bytes") ? options.logMaxBytes
+				: (argument == "--stripes") ? options.maxStripes
+				: (argument == "--stripe-min-bytes") ? options.stripeMinimumBytes : options.logFiles;
+			if (!hasValue(i, argumentCount, argumentVector) || !parseCount(argumentVector[++i], target))
+			{
+				error = "Invalid value for " + argument + " (expected a positive integer)";
+				return false;
+			}
+		}
+		else
+		{
+			error = "Unknown option '" + argument + "'";
+			return false;
+		}
+	}
+	return true;
+}
+
+bool CommandLine::parseRateLimit(const std::string& specification, code_t& code, RateLimiter::Limit& limit)
+{
+	unsigned long parsedCode = 0;
+
+	try
+	{
+		const size_t first = specification.find(':');
+		if (first == std::string::npos) {
+			return false;
+		}
+		const size_t second = specification.find(':', first + 1);
+
+		parsedCode = std::stoul(specification.substr(0, first));
+		limit.requestsPerSecond = std::stod(specification.substr(first + 1, second - first - 1));
+		if (second != std::string::npos) {
+			limit.bytesPerSecond = std::stod(specification.substr(second + 1));
+		}
+	}
+	catch (...)
+	{
+		return false;
+	}
+
+	if (parsedCode > UINT16_MAX || limit.requestsPerSecond < 0 || limit.bytesPerSecond < 0) {
+		return false;
+	}
+
+	code = static_cast<code_t>(parsedCode);
+	limit.burstRequests = std::max(1.0, limit.requestsPerSecond / 10);
+	return true;
+}
+
+bool CommandLine::parseCount(const std::string& text, size_t& value)
+{
+	if (text.empty() || !std::all_of(text.begin(), text.end(), [](const char c) { return c >= '0' && c <= '9'; })) {
+		return false;
+	}
+	try
+	{
+		value = static_cast<size_t>(std::stoull(text));
+	}
+	catch (...)
+	{
+		return false;
+	}
+	return value > 0;
+}
+
+void CommandLine::printUsage(std::ostream& output)
+{
+	output
+		<< "Usage: MessageU [options]" << std::endl
+		<< std::endl
+		<< "Options:" << std::endl
+		<< "  --shared-directory [name]     Share the peer directory with co-located clients" << std::endl
+		<< "  --rate-limit code:rps[:bps]   Pace outbound requests of one request code (repeatable)" << std::endl
+		<< "  --benchmark [suite]           Run an offline micro-benchmark and exit" << std::endl
+		<< "  --cold-starts n               Benchmark cold-start: client launches to measure (20)" << std::endl
+		<< "  --repetitions n               Benchmark: run the suite n times and print medians" << std::endl
+		<< "  --baseline-save file          Benchmark: write the medians as a JSON baseline (5 runs by default)" << std::endl
+		<< "  --baseline-compare file       Benchmark: compare against a baseline, exit 1 on a regression" << std::endl
+		<< "  --regression-threshold pct    Benchmark: slowdown tolerated by --baseline-compare (10)" << std::endl
+		<< "  --startup-profile             Print startup phase times and peak RSS to stderr" << std::endl
+		<< "  --exec, -e \"command\"          Run a headless command (repeatable, in order)" << std::endl
+		<< "  --script file                 Run headless commands from a file, one per line (- = stdin)" << std::endl
+		<< "  --keep-going                  Continue a headless run after a failed command" << std::endl
+		<< "  --json                        Print the headless inbox as JSON Lines" << std::endl
+		<< "  --keep-alive                  Reuse one server connection for all requests" << std::endl
+		<< "  --stripes n                   Send large files over up to n parallel connections (1 = off)" << std::endl
+		<< "  --stripe-min-bytes n          Striping: smallest encrypted file that is striped (8388608)" << std::endl
+		<< "  --stream username             Send stdin lines to a user in batched text messages" << std::endl
+		<< "  --batch-bytes n               Streaming: send a batch once it reaches n bytes (65536)" << std::endl
+		<< "  --batch-ms n                  Streaming: send a partial batch after n ms (200)" << std::endl
+		<< "  --tui                         Full-screen interface with live message updates" << std::endl
+		<< "  --poll-ms n                   TUI: check for new messages every n ms while chatting (1000)" << std::endl
+		<< "  --poll-max-ms n               TUI: back off to at most n ms between checks when idle (30000)" << std::endl
+		<< "  --load-test                   Drive synthetic clients against the server and report" << std::endl
+		<< "  --load-clients n              Load test: concurrent clients (8)" << std::endl
+		<< "  --load-seconds n              Load test: load phase length (30)" << std::endl
+		<< "  --load-mix spec               Load test: operation weights (text=60,file=5,list=10,inbox=25)" << std::endl
+		<< "  --capture file                Record all request and response frames to file" << std::endl
+		<< "  --replay file                 Replay a capture against the server and report latencies" << std::endl
+		<< "  --replay-serve port           With --replay: serve the capture to clients on 127.0.0.1:port" << std::endl
+		<< "  --replay-paced                With --replay: keep the recorded request timing" << std::endl
+		<< "  --mock-server port            Serve the protocol from memory on 127.0.0.1:port (no Python server)" << std::endl
+		<< "  --trace file                  Write trace spans to file (Chrome/Perfetto JSON)" << std::endl
+		<< "  --metrics-file file           Write engine metrics to file in the Prometheus text format" << std::endl
+		<< "  --metrics-ms n                Metrics file: write every n ms (15000)" << std::endl
+		<< "  --wire-stats                  On exit, print header, padding and payload bytes per request code" << std::endl
+		<< "  --log-file file               Append an operational event log to file (JSON Lines)" << std::endl
+		<< "  --log-level level             Event log: lowest level kept (debug, info, warning, failure; info)" << std::endl
+		<< "  --log-max-bytes n             Event log: rotate the file at n bytes (10485760)" << std::endl
+		<< "  --log-files n                 Event log: rotated files kept (5)" << std::endl
+		<< "  --net-emulation profile       Emulate a WAN link (rtt=ms,jitter=ms,bw=B/s,reset=p,partial=p,seed=n)" << std::endl
+		<< "  --help, -h                    Show this help" << std::endl
+		<< std::endl
+		<< "Headless commands:" << std::endl
+		<< "  register <username>           Register and write my.info" << std::endl
+		<< "  list                          Print registered usernames" << std::endl
+		<< "  pubkey <username>             Fetch a client's public key" << std::endl
+		<< "  inbox                         Print and clear waiting messages" << std::endl
+		<< "  probe                         Print the number and size of waiting messages" << std::endl
+		<< "  send <username> <text>        Send a text message (rest of the line)" << std::endl
+		<< "  file <username> <path>        Send a file" << std::endl
+		<< "  send-batch <path>             Send one text per '<username> <text>' line in one request" << std::endl
+		<< "  request-key <username>        Ask a client for a symmetric key" << std::endl
+		<< "  send-key <username>           Send a symmetric key to a client" << std::endl
+		<< "  latency                       Print latency percentiles of this run" << std::endl
+		<< "  latency-dump <path>           Write latency percentiles of this run as CSV" << std::endl
+		<< "  Names containing spaces may be quoted. Lines starting with # are ignored." << std::endl
+		<< std::endl
+		<< "Exit status: 0 success, 1 operation failed, 2 usage error," << std::endl
+		<< "             3 configuration error, 4 not registered" << std::endl;
+}
+
+// ================================
+// Engine Configuration
+// ================================
+
+void CommandLine::applyEngineOptions(const ClientOptions& options, MessageEngine& engine)
+{
+	if (options.sharedDirectory && !engine.attachSharedDirectory(options.sharedDirectoryName))
+	{
+		std::cerr << "Warning: " << engine.getErrorMessage() << std::endl;
+	}
+
+	for (const auto& rateLimit : options.rateLimits)
+	{
+		engine.getRateLimiter()->setLimit(rateLimit.first, rateLimit.second);
+	}
+
+	if (options.persistentConnection) {
+		engine.setPersistentConnection(true);
+	}
+
+	if (options.maxStripes > 1) {
+		engine.setStriping(options.maxStripes, options.stripeMinimumBytes);
+	}
+
+	if (options.wireStats) {
+		engine.setWireReport(&std::cerr);
+	}
+
+	PollScheduler::Settings polling = engine.getPollScheduler()->getSettings();
+	polling.minimumInterval = std::chrono::milliseconds(options.pollIntervalMs);
+	polling.maximumInterval = std::chrono::milliseconds(options.pollMaxIntervalMs);
+	engine.getPollScheduler()->configure(polling);
+
+	EmulatedConnection::Profile profile;
+	if (!options.networkEmulation.empty() && EmulatedConnection::parseProfile(options.networkEmulation, profile)) {
+		engine.replaceConnection(new EmulatedConnection(profile));
+	}
+
+	if (!options.metricsPath.empty()
+		&& !engine.startMetricsExport(options.metricsPath, std::chrono::milliseconds(options.metricsIntervalMs)))
+	{
+		std::cerr << "Warning: " << engine.getErrorMessage() << std::endl;
+	}
+}
@@ -0,0 +1,184 @@
+/**
+ * @file        CommandLine.h
+ * @author      Natanel Maor Fishman
+ * @brief       Command-line option parsing for the MessageU client
+ * @details     Parses argv into ClientOptions, which selects the run mode (interactive menu,
+ *              headless script, benchmark) and configures the messaging engine.
+ * @version     2.0
+ * @date        2025
+ */
+
+#pragma once
+
+// ================================
+// Standard Library Includes
+// ================================
+
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+// ================================
+// Application Includes
+// ================================
+
+#include "EventLog.h"
+#include "RateLimiter.h"
+#include "protocol.h"
+
+// ================================
+// Forward Declarations
+// ================================
+
+class MessageEngine;
+
+// ================================
+// Enumerations
+// ================================
+
+/**
+ * @enum        ExitCode
+ * @brief       Process exit status of non-interactive runs
+ */
+enum class ExitCode : int
+{
+	SUCCESS = 0,                ///< Every operation succeeded
+	OPERATION_FAILED = 1,       ///< An operation was rejected or failed (server, network, crypto)
+	USAGE_ERROR = 2,            ///< Invalid command line or script syntax
+	CONFIGURATION_ERROR = 3,    ///< server.info missing or invalid
+	NOT_REGISTERED = 4          ///< Operation requires registration (my.info missing)
+};
+
+// ================================
+// Data Structures
+// ================================
+
+/**
+ * @struct      ClientOptions
+ * @brief       Parsed command-line options
+ */
+struct ClientOptions
+{
+	using RateLimitEntry = std::pair<code_t, RateLimiter::Limit>;
+
+	bool                        showHelp = false;         ///< --help
+	bool                        sharedDirectory = false;  ///< --shared-directory given
+	std::string                 sharedDirectoryName;      ///< Shared-memory segment name
+	std::vector<RateLimitEntry> rateLimits;               ///< --rate-limit entries
+	bool                        benchmark = false;        ///< --benchmark given
+	std::string                 benchmarkSuite;           ///< Suite to run
+	std::vector<std::string>    commands;                 ///< --exec commands, in order
+	std::vector<std::string>    scriptFiles;              ///< --script files ("-" = stdin)
+	bool                        keepGoing = false;        ///< --keep-going
+	bool                        persistentConnection = false; ///< --keep-alive
+	size_t                      maxStripes = 1;           ///< --stripes: connections per large file (1 = off)
+	size_t                      stripeMinimumBytes = 8 << 20; ///< --stripe-min-bytes: smallest striped file
+	std::string                 streamRecipient;          ///< --stream target (empty = no streaming)
+	size_t                      batchBytes = 64 * 1024;   ///< --batch-bytes
+	size_t                      batchWindowMs = 200;      ///< --batch-ms
+	bool                        jsonOutput = false;       ///< --json: inbox as JSON Lines
+	bool                        terminalUI = false;       ///< --tui: full-screen interface
+	size_t                      pollIntervalMs = 1000;    ///< --poll-ms: shortest inbox poll interval
+	size_t                      pollMaxIntervalMs = 30000; ///< --poll-max-ms: longest inbox poll interval
+	std::string                 tracePath;                ///< --trace: trace-event file (empty = tracing off)
+	std::string                 capturePath;              ///< --capture: wire capture file (empty = off)
+	std::string                 replayPath;               ///< --replay: capture to replay (empty = no replay)
+	uint16_t                    replayServePort = 0;      ///< --replay-serve: fake server port (0 = replay to server)
+	bool                        replayPaced = false;      ///< --replay-paced: keep recorded request times
+	bool                        mockServer = false;       ///< --mock-server given
+	uint16_t                    mockServerPort = 0;       ///< --mock-server: listening port
+	bool                        loadTest = false;         ///< --load-test given
+	size_t                      loadClients = 8;          ///< --load-clients
+	size_t                      loadSeconds = 30;         ///< --load-seconds
+	std::string                 loadMix;                  ///< --load-mix (empty = default mix)
+	bool                        startupProfile = false;   ///< --startup-profile: print startup phases
+	std::string                 networkEmulation;         ///< --net-emulation profile (empty = real network)
+	size_t                      coldStarts = 20;          ///< --cold-starts: launches of the cold-start benchmark
+	std::string                 metricsPath;              ///< --metrics-file: Prometheus text file (empty = off)
+	size_t                      metricsIntervalMs = 15000; ///< --metrics-ms: metrics file write period
+	bool                        wireStats = false;        ///< --wire-stats: print wire composition on exit
+	std::string                 baselineSavePath;         ///< --baseline-save: benchmark baseline to write
+	std::string                 baselineComparePath;      ///< --baseline-compare: benchmark baseline to check against
+	size_t                      benchmarkRepetitions = 0; ///< --repetitions (0 = 1, or 5 with a baseline)
+	size_t                      regressionThreshold = 10; ///< --regression-threshold: tolerated slowdown in percent
+	std::string                 logPath;                  ///< --log-file: event log (empty = off)
+	EventLog::Level             logLevel = EventLog::Level::INFO; ///< --log-level
+	size_t                      logMaxBytes = 10 << 20;   ///< --log-max-bytes: rotation size
+	size_t                      logFiles = 5;             ///< --log-files: rotated files kept
+
+	/**
+	 * @brief       Checks if the client runs without the interactive menu
+	 */
+	bool isHeadless() const { return !commands.empty() || !scriptFiles.empty() || !streamRecipient.empty(); }
+};
+
+// ================================
+// Class Definition
+// ================================
+
+/**
+ * @class       CommandLine
+ * @brief       Static command-line parser and engine option applier
+ * @note        This class cannot be instantiated - all methods are static.
+ */
+class CommandLine
+{
+public:
+	// ================================
+	// Copy Control (Deleted)
+	// ================================
+
+	CommandLine() = delete;
+	CommandLine(const CommandLine&) = delete;
+	CommandLine& operator=(const CommandLine&) = delete;
+
+	// ================================
+	// Parsing Methods
+	// ================================
+
+	/**
+	 * @brief       Parses the process arguments
+	 * @param[in]   argumentCount     Number of arguments (argc)
+	 * @param[in]   argumentVector    Arguments (argv)
+	 * @param[out]  options           Parsed options
+	 * @param[out]  error             Description of the first invalid argument
+	 * @return      true if all arguments are valid, false otherwise
+	 */
+	static bool parse(int argumentCount, char* argumentVector[], ClientOptions& options, std::string& error);
+
+	/**
+	 * @brief       Parses a rate limit specification
+	 * @param[in]   specification    "code:requestsPerSecond[:bytesPerSecond]"
+	 * @param[out]  code             Paced request code
+	 * @param[out]  limit            Pacing configuration (burst = 1/10 s of requests)
+	 * @return      true if the specification is valid, false otherwise
+	 */
+	static bool parseRateLimit(const std::string& specification, code_t& code, RateLimiter::Limit& limit);
+
+	/**
+	 * @brief       Parses a positive integer option value
+	 * @param[in]   text     Option value
+	 * @param[out]  value    Parsed value
+	 * @return      true if text is a positive decimal integer, false otherwise
+	 */
+	static bool parseCount(const std::string& text, size_t& value);
+
+	/**
+	 * @brief       Prints option and headless command help
+	 * @param[in,out] output    Stream to print to
+	 */
+	static void printUsage(std::ostream& output);
+
+	// ================================
+	// Engine Configuration
+	// ================================
+
+	/**
+	 * @brief       Applies engine-level options (shared directory, rate limits, keep-alive, network emulation)
+	 * @param[in]     options    Parsed options
+	 * @param[in,out] engine     Engine to configure
+	 * @details     Failures are reported as warnings on stderr; these options are optimizations only.
+	 */
+	static void applyEngineOptions(const ClientOptions& options, MessageEngine& engine);
+};
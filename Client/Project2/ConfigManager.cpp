@@ -8,6 +8,7 @@
  */
 
 #include "ConfigManager.h"
+#include "Tracer.h"
 
 #include <algorithm>
 #include <fstream>
@@ -246,6 +247,8 @@ size_t ConfigManager::getFileSize() const
  */
 bool ConfigManager::readFileComplete(const std::string& filePath, uint8_t*& fileData, size_t& fileSize)
 {
+	TraceSpan span("config", "readFileComplete");
+
 	// Open the file for reading
 	if (!openFile(filePath)) {
 		return false;
@@ -262,6 +265,7 @@ bool ConfigManager::readFileComplete(const std::string& filePath, uint8_t*& file
 		// Allocate memory for file data
 		fileData = new uint8_t[fileSize];
 		const bool readSuccess = readBytes(fileData, fileSize);
+		span.setBytes(fileSize);
 
 		// Clean up allocated memory if read failed
 		if (!readSuccess) {
@@ -287,6 +291,9 @@ bool ConfigManager::readFileComplete(const std::string& filePath, uint8_t*& file
  */
 bool ConfigManager::writeFileComplete(const std::string& filePath, const std::string& fileContent)
 {
+	TraceSpan span("config", "writeFileComplete");
+	span.setBytes(fileContent.size());
+
 	// Validate input and open file for writing
 	if (fileContent.empty() || !openFile(filePath, true)) {
 		return false;
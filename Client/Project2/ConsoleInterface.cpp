@@ -8,6 +8,7 @@
  */
 
 #include "ConsoleInterface.h"
+#include "LatencyMetrics.h"
 #include <iostream>
 #include <algorithm>
 #include <boost/algorithm/string/trim.hpp>
@@ -38,6 +39,16 @@ void ConsoleInterface::prepare()
     authenticated = engineInstance.loadUserCredentials();
 }
 
+/**
+ * @brief       Applies command-line engine options
+ * @param[in]   options    Parsed options (shared directory, rate limits)
+ * @details     Failures are not fatal - these options are optimizations only
+ */
+void ConsoleInterface::configure(const ClientOptions& options)
+{
+    CommandLine::applyEngineOptions(options, engineInstance);
+}
+
 /**
  * @brief       Displays the main application menu with user context
  * @details     Renders personalized greeting and available commands based on
@@ -173,6 +184,7 @@ bool ConsoleInterface::executeSelectedCommand(const MenuCommands& command)
     {
     case MenuCommands::CommandsEnum::QUIT:
         std::cout << "Shutting down MessageU client. Goodbye!" << std::endl;
+        engineInstance.reportWireUsage();
         waitForInput();
         exit(EXIT_SUCCESS);
         break;
@@ -246,6 +258,22 @@ bool ConsoleInterface::executeSelectedCommand(const MenuCommands& command)
         operationSuccess = engineInstance.sendMessage(recipient, MSG_FILE, filePath);
     }
     break;
+
+    case MenuCommands::CommandsEnum::SHOW_LATENCY:
+        engineInstance.getLatencyMetrics()->print(std::cout);
+        operationSuccess = true;
+        break;
+
+    case MenuCommands::CommandsEnum::SAVE_LATENCY:
+    {
+        const std::string filePath = captureInput("Enter output file path (CSV):");
+        operationSuccess = engineInstance.getLatencyMetrics()->dump(filePath);
+        if (!operationSuccess)
+        {
+            std::cout << "Cannot write " << filePath << std::endl;
+        }
+    }
+    break;
     }
 
     return operationSuccess;
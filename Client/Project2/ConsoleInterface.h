@@ -20,6 +20,7 @@
 #include <cstdint>
 
 // Application includes
+#include "CommandLine.h"
 #include "MessageEngine.h"
 
 /**
@@ -63,6 +64,14 @@ public:
 	 */
 	void prepare();
 
+	/**
+	 * @brief       Applies command-line engine options
+	 * @param[in]   options    Parsed options (shared directory, rate limits)
+	 * @details     Optional features; on failure a warning is shown and the client
+	 *              keeps working without them.
+	 */
+	void configure(const ClientOptions& options);
+
 	/**
 	 * @brief       Displays the main application menu with user context
 	 * @details     Renders personalized greeting and available commands based on
@@ -134,6 +143,10 @@ private:
 			SHARE_ENCRYPTION_KEY = 152,     ///< Share symmetric key with user
 			UPLOAD_FILE = 153,              ///< Send encrypted file
 			
+			// Diagnostics commands (no auth required)
+			SHOW_LATENCY = 160,             ///< Print latency percentiles
+			SAVE_LATENCY = 161,             ///< Write latency percentiles to a CSV file
+			
 			// System commands (no auth required)
 			QUIT = 0                        ///< Exit application
 		};
@@ -227,6 +240,8 @@ private:
 		{ MenuCommands::CommandsEnum::REQUEST_ENCRYPTION_KEY,   true,  "Send a request for symmetric key", "Symmetric key request sent successfully."},
 		{ MenuCommands::CommandsEnum::SHARE_ENCRYPTION_KEY,		true,  "Send your symmetric key", "Symmetric key shared successfully."},
 		{ MenuCommands::CommandsEnum::UPLOAD_FILE,				true,  "Send a file", "File transferred successfully."},
+		{ MenuCommands::CommandsEnum::SHOW_LATENCY,				false, "Show latency statistics", ""},
+		{ MenuCommands::CommandsEnum::SAVE_LATENCY,				false, "Save latency statistics to file", "Latency statistics saved."},
 		{ MenuCommands::CommandsEnum::QUIT,						false, "Exit client", ""}
 	};
 
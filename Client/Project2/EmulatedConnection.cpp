@@ -0,0 +1,164 @@
+/**
+ * @file        EmulatedConnection.cpp
+ * @author      Natanel Maor Fishman
+ * @brief       Implementation of the WAN-emulating connection.
+ * @details     Delay, bandwidth and fault injection around the NetworkConnection transfers,
+ *              and profile parsing.
+ * @date        2025
+ */
+
+#include "EmulatedConnection.h"
+
+#include <sstream>
+#include <thread>
+
+// ================================
+// Constructor
+// ================================
+
+EmulatedConnection::EmulatedConnection(const Profile& profile)
+	: m_profile(profile), m_random(profile.seed), m_awaitingResponse(false)
+{
+}
+
+// ================================
+// NetworkConnection Overrides
+// ================================
+
+bool EmulatedConnection::establishConnection()
+{
+	waitRoundTrip();  // TCP handshake
+	if (fault(m_profile.resetRate)) {
+		return false;
+	}
+	m_awaitingResponse = false;
+	return NetworkConnection::establishConnection();
+}
+
+bool EmulatedConnection::receiveData(uint8_t* const buffer, const size_t size) const
+{
+	if (m_awaitingResponse)
+	{
+		waitRoundTrip();
+		m_awaitingResponse = false;
+	}
+	waitTransmission(size);
+
+	if (fault(m_profile.resetRate)) {
+		return false;
+	}
+	if (fault(m_profile.partialRate))
+	{
+		// First half of the packets arrive, then the connection breaks
+		const size_t packets = (size + DEFAULT_PACKET_SIZE - 1) / DEFAULT_PACKET_SIZE;
+		if (packets > 1) {
+			(void)NetworkConnection::receiveData(buffer, packets / 2 * DEFAULT_PACKET_SIZE);
+		}
+		return false;
+	}
+	return NetworkConnection::receiveData(buffer, size);
+}
+
+bool EmulatedConnection::sendData(const uint8_t* const buffer, const size_t size) const
+{
+	waitTransmission(size);
+	if (fault(m_profile.resetRate)) {
+		return false;
+	}
+	m_awaitingResponse = true;
+	return NetworkConnection::sendData(buffer, size);
+}
+
+NetworkConnection* EmulatedConnection::createConnection() const
+{
+	Profile profile = m_profile;
+	profile.seed = m_random();  // Same conditions, independent draws
+	EmulatedConnection* const connection = new EmulatedConnection(profile);
+	copySettingsTo(*connection);
+	return connection;
+}
+
+// ================================
+// Public Interface Methods
+// ================================
+
+bool EmulatedConnection::parseProfile(const std::string& specification, Profile& profile)
+{
+	Profile parsed;
+	std::istringstream entries(specification);
+	std::string entry;
+
+	while (std::getline(entries, entry, ','))
+	{
+		const size_t separator = entry.find('=');
+		if (separator == std::string::npos || separator + 1 >= entry.size()) {
+			return false;
+		}
+		const std::string name = entry.substr(0, separator);
+
+		double value = 0;
+		std::istringstream text(entry.substr(separator + 1));
+		if (!(text >> value) || !text.eof() || value < 0) {
+			return false;
+		}
+
+		if (name == "rtt") {
+			parsed.roundTrip = std::chrono::milliseconds(static_cast<int64_t>(value));
+		}
+		else if (name == "jitter") {
+			parsed.jitter = std::chrono::milliseconds(static_cast<int64_t>(value));
+		}
+		else if (name == "bw") {
+			parsed.bytesPerSecond = value;
+		}
+		else if ((name == "reset" || name == "partial") && value <= 1) {
+			((name == "reset") ? parsed.resetRate : parsed.partialRate) = value;
+		}
+		else if (name == "seed" && value <= UINT32_MAX) {
+			parsed.seed = static_cast<uint32_t>(value);
+		}
+		else {
+			return false;
+		}
+	}
+
+	if (parsed.jitter > parsed.roundTrip) {
+		return false;  // A round trip cannot be shorter than zero
+	}
+	profile = parsed;
+	return true;
+}
+
+// ================================
+// Private Helper Methods
+// ================================
+
+void EmulatedConnection::waitRoundTrip() const
+{
+	auto delay = m_profile.roundTrip;
+	if (m_profile.jitter.count() > 0)
+	{
+		std::uniform_int_distribution<int64_t> jitter(-m_profile.jitter.count(), m_profile.jitter.count());
+		delay += std::chrono::milliseconds(jitter(m_random));
+	}
+	if (delay.count() > 0) {
+		std::this_thread::sleep_for(delay);
+	}
+}
+
+void EmulatedConnection::waitTransmission(const size_t size) const
+{
+	if (m_profile.bytesPerSecond <= 0) {
+		return;
+	}
+	const size_t wireBytes = (size + DEFAULT_PACKET_SIZE - 1) / DEFAULT_PACKET_SIZE * DEFAULT_PACKET_SIZE;
+	std::this_thread::sleep_for(std::chrono::duration<double>(static_cast<double>(wireBytes) / m_profile.bytesPerSecond));
+}
+
+bool EmulatedConnection::fault(const double probability) const
+{
+	if (probability <= 0) {
+		return false;
+	}
+	return std::uniform_real_distribution<double>(0.0, 1.0)(m_random) < probability;
+}
@@ -0,0 +1,154 @@
+/**
+ * @file        EmulatedConnection.h
+ * @author      Natanel Maor Fishman
+ * @brief       Network connection with emulated WAN conditions
+ * @details     Decorates NetworkConnection with round-trip latency, jitter, a bandwidth
+ *              cap and injected faults (connection resets, responses cut short), so
+ *              latency-hiding features and error handling can be evaluated against a
+ *              local server. Faults and jitter come from a seeded generator: the same
+ *              profile and request sequence reproduce the same run.
+ * @version     2.0
+ * @date        2025
+ */
+
+#pragma once
+
+// ================================
+// Standard Library Includes
+// ================================
+
+#include <chrono>
+#include <cstdint>
+#include <random>
+#include <string>
+
+// ================================
+// Application Includes
+// ================================
+
+#include "NetworkConnection.h"
+
+// ================================
+// Class Definition
+// ================================
+
+/**
+ * @class       EmulatedConnection
+ * @brief       NetworkConnection that delays and fails transfers like a WAN link
+ * @details     Emulation model:
+ *              - connect waits one round trip before connecting
+ *              - every transfer waits for its wire bytes at the bandwidth cap
+ *              - the first receive after a send waits one round trip
+ *              - each round trip adds uniform jitter in [-jitter, +jitter]
+ *              - a reset fails a connect or transfer before any byte moves
+ *              - a partial read delivers the first half of a response and then fails
+ *              A failed transfer leaves recovery to the caller, which drops the
+ *              connection exactly as after a real reset.
+ *
+ * @note        This class is non-copyable. Not thread-safe (like NetworkConnection).
+ */
+class EmulatedConnection : public NetworkConnection
+{
+public:
+	// ================================
+	// Data Structures
+	// ================================
+
+	/**
+	 * @struct      Profile
+	 * @brief       Emulated link conditions
+	 */
+	struct Profile
+	{
+		std::chrono::milliseconds roundTrip{ 0 };   ///< Round-trip time
+		std::chrono::milliseconds jitter{ 0 };      ///< Maximum deviation per round trip
+		double                    bytesPerSecond = 0;  ///< Bandwidth cap per direction (0 = unlimited)
+		double                    resetRate = 0;       ///< Probability that a connect or transfer fails
+		double                    partialRate = 0;     ///< Probability that a receive is cut short
+		uint32_t                  seed = 1;            ///< Jitter and fault generator seed
+	};
+
+	// ================================
+	// Constructor and Destructor
+	// ================================
+
+	/**
+	 * @brief       Creates an unconnected emulated connection
+	 * @param[in]   profile    Link conditions
+	 */
+	explicit EmulatedConnection(const Profile& profile);
+
+	/**
+	 * @brief       Default destructor
+	 */
+	virtual ~EmulatedConnection() = default;
+
+	// ================================
+	// Copy Control (Deleted)
+	// ================================
+
+	EmulatedConnection(const EmulatedConnection&) = delete;
+	EmulatedConnection& operator=(const EmulatedConnection&) = delete;
+
+	// ================================
+	// NetworkConnection Overrides
+	// ================================
+
+	bool establishConnection() override;
+	bool receiveData(uint8_t* const buffer, const size_t size) const override;
+	bool sendData(const uint8_t* const buffer, const size_t size) const override;
+
+	/**
+	 * @brief       Creates another connection over an emulated link with the same profile
+	 * @details     Each link has its own bandwidth cap and draws its own jitter and faults.
+	 */
+	NetworkConnection* createConnection() const override;
+
+	// ================================
+	// Public Interface Methods
+	// ================================
+
+	/**
+	 * @brief       Gets the emulated link conditions
+	 */
+	const Profile& getProfile() const { return m_profile; }
+
+	/**
+	 * @brief       Parses a profile specification
+	 * @param[in]   specification    e.g. "rtt=80,jitter=10,bw=1048576,reset=0.01,partial=0.005,seed=7"
+	 *                               (milliseconds, bytes per second, probabilities 0..1);
+	 *                               omitted settings keep their defaults
+	 * @param[out]  profile          Parsed profile
+	 * @return      true if the specification is valid, false otherwise
+	 */
+	static bool parseProfile(const std::string& specification, Profile& profile);
+
+private:
+	// ================================
+	// Member Variables
+	// ================================
+
+	const Profile        m_profile;            ///< Link conditions
+	mutable std::mt19937 m_random;             ///< Jitter and fault generator
+	mutable bool         m_awaitingResponse;   ///< A send is waiting for its first receive
+
+	// ================================
+	// Private Helper Methods
+	// ================================
+
+	/**
+	 * @brief       Sleeps one round trip plus jitter
+	 */
+	void waitRoundTrip() const;
+
+	/**
+	 * @brief       Sleeps for the transmission time of a transfer at the bandwidth cap
+	 * @param[in]   size    Logical transfer size (padded to whole packets on the wire)
+	 */
+	void waitTransmission(size_t size) const;
+
+	/**
+	 * @brief       Draws a fault with the given probability
+	 */
+	bool fault(double probability) const;
+};
@@ -0,0 +1,158 @@
+/**
+ * @file        EngineCounters.cpp
+ * @author      Natanel Maor Fishman
+ * @brief       Implementation of the engine health counters.
+ * @details     Request code slots, wire composition table and label names.
+ * @date        2025
+ */
+
+#include "EngineCounters.h"
+
+#include <iomanip>
+
+// ================================
+// Constructor
+// ================================
+
+EngineCounters::EngineCounters()
+	: _bytesSent(0), _bytesReceived(0), _decrypted(0), _decryptionFailures(0), _cryptoMicros(0)
+{
+	for (auto& slot : _requests)
+	{
+		for (auto& counter : slot) {
+			counter.store(0, std::memory_order_relaxed);
+		}
+	}
+	for (auto& slot : _wire)
+	{
+		for (auto& counter : slot) {
+			counter.store(0, std::memory_order_relaxed);
+		}
+	}
+	for (auto& counter : _wireTotal) {
+		counter.store(0, std::memory_order_relaxed);
+	}
+}
+
+// ================================
+// Recording Methods
+// ================================
+
+void EngineCounters::recordRequest(const code_t code, const Outcome outcome)
+{
+	if (outcome >= Outcome::COUNT) {
+		return;
+	}
+	_requests[slotOf(code)][static_cast<size_t>(outcome)].fetch_add(1, std::memory_order_relaxed);
+}
+
+void EngineCounters::recordWire(const code_t code, const Wire kind, const uint64_t bytes)
+{
+	if (kind >= Wire::PACKET_PADDING || bytes == 0) {
+		return;
+	}
+	_wire[slotOf(code)][static_cast<size_t>(kind)].fetch_add(bytes, std::memory_order_relaxed);
+}
+
+// ================================
+// Accessor Methods
+// ================================
+
+uint64_t EngineCounters::getWire(const size_t slot, const Wire kind) const
+{
+	if (kind < Wire::PACKET_PADDING) {
+		return _wire[slot][static_cast<size_t>(kind)].load(std::memory_order_relaxed);
+	}
+
+	// Socket bytes not covered by a classified frame
+	uint64_t classified = 0;
+	for (const auto& counter : _wire[slot]) {
+		classified += counter.load(std::memory_order_relaxed);
+	}
+	const uint64_t total = getWireTotal(slot);
+	return (total > classified) ? total - classified : 0;
+}
+
+void EngineCounters::printWire(std::ostream& output) const
+{
+	constexpr size_t KINDS = static_cast<size_t>(Wire::COUNT);
+	std::array<uint64_t, KINDS> sums = {};
+	uint64_t sumTotal = 0;
+
+	const auto row = [&output](const char* name, const uint64_t total, const std::array<uint64_t, KINDS>& kinds) {
+		output << std::left << std::setw(14) << name << std::right << std::setw(12) << total;
+		for (const uint64_t bytes : kinds) {
+			output << std::setw(16) << bytes;
+		}
+		const double useful = (total > 0)
+			? 100.0 * static_cast<double>(kinds[static_cast<size_t>(Wire::PAYLOAD)]) / static_cast<double>(total) : 0.0;
+		output << std::setw(9) << std::fixed << std::setprecision(1) << useful << '%' << std::defaultfloat << std::endl;
+	};
+
+	output << std::left << std::setw(14) << "wire bytes" << std::right << std::setw(12) << "total";
+	for (size_t kind = 0; kind < KINDS; ++kind) {
+		output << std::setw(16) << wireName(static_cast<Wire>(kind));
+	}
+	output << std::setw(10) << "useful" << std::endl;
+
+	for (size_t slot = 0; slot < CODE_SLOTS; ++slot)
+	{
+		const uint64_t total = getWireTotal(slot);
+		if (total == 0) {
+			continue;
+		}
+		std::array<uint64_t, KINDS> kinds = {};
+		for (size_t kind = 0; kind < KINDS; ++kind)
+		{
+			kinds[kind] = getWire(slot, static_cast<Wire>(kind));
+			sums[kind] += kinds[kind];
+		}
+		sumTotal += total;
+		row(slotName(slot), total, kinds);
+	}
+	row("all", sumTotal, sums);
+}
+
+// ================================
+// Names
+// ================================
+
+const char* EngineCounters::slotName(const size_t slot)
+{
+	static const char* const NAMES[CODE_SLOTS] = { "600", "601", "602", "603", "604", "605", "606", "607", "608", "other" };
+	return (slot < CODE_SLOTS) ? NAMES[slot] : "other";
+}
+
+const char* EngineCounters::wireName(const Wire kind)
+{
+	switch (kind)
+	{
+	case Wire::HEADER:         return "header";
+	case Wire::FIELD_PADDING:  return "field_padding";
+	case Wire::EXPANSION:      return "expansion";
+	case Wire::PAYLOAD:        return "payload";
+	case Wire::PACKET_PADDING: return "packet_padding";
+	default:                   return "unknown";
+	}
+}
+
+const char* EngineCounters::outcomeName(const Outcome outcome)
+{
+	switch (outcome)
+	{
+	case Outcome::SUCCESS:  return "success";
+	case Outcome::REJECTED: return "rejected";
+	case Outcome::FAILED:   return "failed";
+	default:                return "unknown";
+	}
+}
+
+// ================================
+// Private Helper Methods
+// ================================
+
+size_t EngineCounters::slotOf(const code_t code)
+{
+	const size_t offset = static_cast<size_t>(code) - FIRST_CODE;
+	return (code >= FIRST_CODE && offset < CODE_SLOTS - 1) ? offset : CODE_SLOTS - 1;
+}
@@ -0,0 +1,233 @@
+/**
+ * @file        EngineCounters.h
+ * @author      Natanel Maor Fishman
+ * @brief       Health counters of the messaging engine
+ * @details     Monotonic counters of server requests by code and outcome, wire bytes and
+ *              their composition, message decryption results and time spent in cryptography.
+ *              Together with the latency histograms and a few gauges they are exported by
+ *              MetricsExporter.
+ * @version     2.0
+ * @date        2025
+ */
+
+#pragma once
+
+// ================================
+// Standard Library Includes
+// ================================
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+
+// ================================
+// Application Includes
+// ================================
+
+#include "protocol.h"
+
+// ================================
+// Class Definitions
+// ================================
+
+/**
+ * @class       EngineCounters
+ * @brief       Lock-free monotonic engine counters
+ * @note        Thread-safe. Recording costs one relaxed atomic increment.
+ */
+class EngineCounters
+{
+public:
+	// ================================
+	// Enumerations
+	// ================================
+
+	/**
+	 * @enum        Outcome
+	 * @brief       Result of one server request
+	 */
+	enum class Outcome : size_t
+	{
+		SUCCESS,    ///< Response received and accepted
+		REJECTED,   ///< Server error response or unexpected response header
+		FAILED,     ///< Connection or transfer failure
+		COUNT
+	};
+
+	/**
+	 * @enum        Wire
+	 * @brief       Composition of the bytes a request code puts on the wire (both directions)
+	 * @details     The engine classifies the frames of completed exchanges. Packet padding is
+	 *              not recorded: it is the rest of the socket bytes, so it also holds the bytes
+	 *              of failed transfers.
+	 */
+	enum class Wire : size_t
+	{
+		HEADER,          ///< Request, response and per-message headers
+		FIELD_PADDING,   ///< Unused part of fixed-size fields (e.g. 255-byte names)
+		EXPANSION,       ///< Ciphertext beyond the plaintext (CBC padding, RSA-wrapped keys)
+		PAYLOAD,         ///< Useful content: ids, keys, names, plaintext
+		PACKET_PADDING,  ///< Zero fill up to whole 1024-byte packets
+		COUNT
+	};
+
+	static constexpr code_t FIRST_CODE = REQUEST_REGISTRATION;  ///< Code of slot 0
+	static constexpr size_t CODE_SLOTS = 10;                    ///< Codes 600..608 plus "other"
+
+	// ================================
+	// Constructor and Destructor
+	// ================================
+
+	/**
+	 * @brief       Creates zeroed counters
+	 */
+	EngineCounters();
+
+	/**
+	 * @brief       Default destructor
+	 */
+	virtual ~EngineCounters() = default;
+
+	// ================================
+	// Copy Control (Deleted)
+	// ================================
+
+	EngineCounters(const EngineCounters&) = delete;
+	EngineCounters& operator=(const EngineCounters&) = delete;
+
+	// ================================
+	// Recording Methods
+	// ================================
+
+	/**
+	 * @brief       Counts a finished server request
+	 * @param[in]   code    Request code (unknown codes share one "other" slot)
+	 */
+	void recordRequest(code_t code, Outcome outcome);
+
+	/**
+	 * @brief       Adds bytes written to the server (padded wire bytes)
+	 */
+	void addBytesSent(uint64_t bytes) { _bytesSent.fetch_add(bytes, std::memory_order_relaxed); }
+
+	/**
+	 * @brief       Adds bytes read from the server (padded wire bytes)
+	 */
+	void addBytesReceived(uint64_t bytes) { _bytesReceived.fetch_add(bytes, std::memory_order_relaxed); }
+
+	/**
+	 * @brief       Adds socket bytes of a request code, in either direction
+	 */
+	void addWireBytes(code_t code, uint64_t bytes) { _wireTotal[slotOf(code)].fetch_add(bytes, std::memory_order_relaxed); }
+
+	/**
+	 * @brief       Classifies frame bytes of a request code (PACKET_PADDING is derived, not recorded)
+	 */
+	void recordWire(code_t code, Wire kind, uint64_t bytes);
+
+	/**
+	 * @brief       Counts one message content or key decryption
+	 */
+	void recordDecryption(bool success)
+	{
+		(success ? _decrypted : _decryptionFailures).fetch_add(1, std::memory_order_relaxed);
+	}
+
+	/**
+	 * @brief       Adds time spent in encryption, decryption and key handling
+	 */
+	void addCryptoTime(std::chrono::microseconds duration)
+	{
+		_cryptoMicros.fetch_add(static_cast<uint64_t>(duration.count()), std::memory_order_relaxed);
+	}
+
+	// ================================
+	// Accessor Methods
+	// ================================
+
+	uint64_t getRequests(size_t slot, Outcome outcome) const
+	{
+		return _requests[slot][static_cast<size_t>(outcome)].load(std::memory_order_relaxed);
+	}
+	uint64_t getBytesSent() const { return _bytesSent.load(std::memory_order_relaxed); }
+	uint64_t getBytesReceived() const { return _bytesReceived.load(std::memory_order_relaxed); }
+	uint64_t getDecrypted() const { return _decrypted.load(std::memory_order_relaxed); }
+	uint64_t getDecryptionFailures() const { return _decryptionFailures.load(std::memory_order_relaxed); }
+	uint64_t getCryptoMicros() const { return _cryptoMicros.load(std::memory_order_relaxed); }
+	uint64_t getWireTotal(size_t slot) const { return _wireTotal[slot].load(std::memory_order_relaxed); }
+
+	/**
+	 * @brief       Gets the bytes of one kind sent and received under a request code slot
+	 */
+	uint64_t getWire(size_t slot, Wire kind) const;
+
+	/**
+	 * @brief       Prints the wire composition per request code as a table
+	 */
+	void printWire(std::ostream& output) const;
+
+	/**
+	 * @brief       Gets the request code label of a slot ("600".."608" or "other")
+	 */
+	static const char* slotName(size_t slot);
+
+	/**
+	 * @brief       Gets the label of an outcome (e.g. "rejected")
+	 */
+	static const char* outcomeName(Outcome outcome);
+
+	/**
+	 * @brief       Gets the label of a wire kind (e.g. "field_padding")
+	 */
+	static const char* wireName(Wire kind);
+
+private:
+	// ================================
+	// Member Variables
+	// ================================
+
+	using OutcomeCounters = std::array<std::atomic<uint64_t>, static_cast<size_t>(Outcome::COUNT)>;
+	using WireCounters = std::array<std::atomic<uint64_t>, static_cast<size_t>(Wire::PACKET_PADDING)>;
+
+	std::array<OutcomeCounters, CODE_SLOTS> _requests;           ///< Per code and outcome
+	std::array<WireCounters, CODE_SLOTS>    _wire;               ///< Classified bytes per code
+	std::array<std::atomic<uint64_t>, CODE_SLOTS> _wireTotal;    ///< Socket bytes per code
+	std::atomic<uint64_t>                   _bytesSent;          ///< Wire bytes written
+	std::atomic<uint64_t>                   _bytesReceived;      ///< Wire bytes read
+	std::atomic<uint64_t>                   _decrypted;          ///< Successful decryptions
+	std::atomic<uint64_t>                   _decryptionFailures; ///< Failed decryptions
+	std::atomic<uint64_t>                   _cryptoMicros;       ///< Time in cryptography
+
+	/**
+	 * @brief       Maps a request code to its slot
+	 */
+	static size_t slotOf(code_t code);
+};
+
+/**
+ * @class       CryptoTimer
+ * @brief       Scoped timer adding its lifetime to the crypto time counter
+ * @details     A null counters pointer disables recording.
+ */
+class CryptoTimer
+{
+public:
+	explicit CryptoTimer(EngineCounters* counters) : _counters(counters), _start(std::chrono::steady_clock::now()) {}
+
+	~CryptoTimer()
+	{
+		if (_counters != nullptr) {
+			_counters->addCryptoTime(std::chrono::duration_cast<std::chrono::microseconds>(
+				std::chrono::steady_clock::now() - _start));
+		}
+	}
+
+	CryptoTimer(const CryptoTimer&) = delete;
+	CryptoTimer& operator=(const CryptoTimer&) = delete;
+
+private:
+	EngineCounters* const                       _counters;  ///< Destination (may be null)
+	const std::chrono::steady_clock::time_point _start;     ///< Start time
+};
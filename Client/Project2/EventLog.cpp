@@ -0,0 +1,372 @@
+/**
+ * @file        EventLog.cpp
+ * @author      Natanel Maor Fishman
+ * @brief       Implementation of the asynchronous structured log.
+ * @details     Per-thread single-producer rings, the writer thread, JSON Lines
+ *              formatting and file rotation.
+ * @date        2025
+ */
+
+#include "EventLog.h"
+#include "JsonLinesWriter.h"
+
+#include <algorithm>
+#include <array>
+#include <condition_variable>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <boost/filesystem.hpp>
+
+namespace
+{
+	constexpr auto FLUSH_INTERVAL = std::chrono::milliseconds(100);  ///< Writer drain period
+
+	/**
+	 * @struct      LogRecord
+	 * @brief       One event as stored by the producing thread (no allocation)
+	 */
+	struct LogRecord
+	{
+		int64_t         timeMicros;    // System clock, since the epoch
+		const char*     event;
+		uint64_t        bytes;
+		uint64_t        micros;
+		uint32_t        thread;
+		code_t          code;
+		EventLog::Level level;
+		uint8_t         detailLength;
+		char            detail[EventLog::DETAIL_LENGTH];
+	};
+
+	/**
+	 * @struct      Ring
+	 * @brief       Single-producer, single-consumer record ring of one thread
+	 * @details     The owning thread fills records[head] and publishes it by advancing
+	 *              head; the writer copies records[tail..head) and releases them by
+	 *              advancing tail. Both counters only grow.
+	 */
+	struct Ring
+	{
+		std::array<LogRecord, EventLog::RING_RECORDS> records;
+		std::atomic<uint64_t> head{ 0 };
+		char                  separation[64];  // Keeps head and tail on different cache lines
+		std::atomic<uint64_t> tail{ 0 };
+		uint32_t              thread = 0;
+	};
+
+	/**
+	 * @struct      LogState
+	 * @brief       Writer state shared by all threads
+	 */
+	struct LogState
+	{
+		std::mutex                         mutex;       // Guards everything below but the counters
+		std::condition_variable            wakeup;
+		std::vector<std::shared_ptr<Ring>> rings;       // Kept until drained after their threads exit
+		std::atomic<uint64_t>              generation{ 0 };  // Invalidates thread-local rings
+		uint32_t                           nextThread = 0;
+		EventLog::Settings                 settings;
+		std::ofstream                      file;
+		uint64_t                           fileBytes = 0;
+		bool                               failed = false;  // A write or rotation failed
+		bool                               stopping = false;
+		std::thread                        writer;
+		std::atomic<uint64_t>              dropped{ 0 };
+		uint64_t                           reportedDropped = 0;
+	};
+
+	LogState& state()
+	{
+		static LogState instance;
+		return instance;
+	}
+
+	/**
+	 * @brief       Gets the calling thread's ring for the current log
+	 */
+	Ring& threadRing()
+	{
+		thread_local std::shared_ptr<Ring> ring;
+		thread_local uint64_t ringGeneration = 0;
+
+		LogState& log = state();
+		if (!ring || ringGeneration != log.generation.load(std::memory_order_acquire))
+		{
+			std::lock_guard<std::mutex> lock(log.mutex);  // Once per thread and log
+			ring = std::make_shared<Ring>();
+			ring->thread = ++log.nextThread;
+			ringGeneration = log.generation.load(std::memory_order_relaxed);
+			log.rings.push_back(ring);
+		}
+		return *ring;
+	}
+
+	int64_t nowMicros()
+	{
+		return std::chrono::duration_cast<std::chrono::microseconds>(
+			std::chrono::system_clock::now().time_since_epoch()).count();
+	}
+
+	/**
+	 * @brief       Appends one record as a JSON line
+	 */
+	void format(std::string& output, const LogRecord& record)
+	{
+		static const boost::posix_time::ptime epoch(boost::gregorian::date(1970, 1, 1));
+		const boost::posix_time::ptime time = epoch + boost::posix_time::microseconds(record.timeMicros);
+
+		output += "{\"time\":\"";
+		output += boost::posix_time::to_iso_extended_string(time);
+		output += "Z\",\"level\":\"";
+		output += EventLog::levelName(record.level);
+		output += "\",\"thread\":" + std::to_string(record.thread);
+		output += ",\"event\":";
+		JsonLinesWriter::appendString(output, record.event);
+		output += ",\"code\":" + std::to_string(record.code);
+		output += ",\"bytes\":" + std::to_string(record.bytes);
+		output += ",\"micros\":" + std::to_string(record.micros);
+		if (record.detailLength > 0)
+		{
+			output += ",\"detail\":";
+			JsonLinesWriter::appendString(output, std::string(record.detail, record.detailLength));
+		}
+		output += "}\n";
+	}
+
+	/**
+	 * @brief       Writes formatted lines to the current file
+	 */
+	void append(LogState& log, const char* data, const size_t size)
+	{
+		if (size == 0 || !log.file.is_open()) {
+			return;
+		}
+		log.file.write(data, static_cast<std::streamsize>(size));
+		log.file.flush();
+		log.fileBytes += size;
+		if (!log.file) {
+			log.failed = true;
+		}
+	}
+
+	/**
+	 * @brief       Shifts path -> path.1 -> ... -> path.maxFiles and reopens path
+	 */
+	void rotate(LogState& log)
+	{
+		namespace fs = boost::filesystem;
+		const std::string& path = log.settings.path;
+		boost::system::error_code error;
+
+		log.file.close();
+		fs::remove(path + "." + std::to_string(log.settings.maxFiles), error);
+		for (size_t i = log.settings.maxFiles; i > 1; --i) {
+			fs::rename(path + "." + std::to_string(i - 1), path + "." + std::to_string(i), error);
+		}
+		if (log.settings.maxFiles > 0) {
+			fs::rename(path, path + ".1", error);
+		}
+
+		log.file.open(path, std::ios::binary | std::ios::trunc);
+		log.fileBytes = 0;
+		if (!log.file.is_open()) {
+			log.failed = true;
+		}
+	}
+
+	/**
+	 * @brief       Moves all published records to the file (called with the mutex held)
+	 */
+	void drain(LogState& log)
+	{
+		std::vector<LogRecord> batch;
+		for (auto ring = log.rings.begin(); ring != log.rings.end();)
+		{
+			Ring& source = **ring;
+			const uint64_t tail = source.tail.load(std::memory_order_relaxed);
+			const uint64_t head = source.head.load(std::memory_order_acquire);
+			for (uint64_t i = tail; i < head; ++i) {
+				batch.push_back(source.records[i % EventLog::RING_RECORDS]);
+			}
+			source.tail.store(head, std::memory_order_release);
+
+			// Only this list still refers to the ring of an exited thread
+			if (ring->use_count() == 1 && head == tail) {
+				ring = log.rings.erase(ring);
+			}
+			else {
+				++ring;
+			}
+		}
+
+		const uint64_t dropped = log.dropped.load(std::memory_order_relaxed);
+		if (dropped != log.reportedDropped)
+		{
+			LogRecord record = {};
+			record.timeMicros = nowMicros();
+			record.event = "records_dropped";
+			const std::string detail = std::to_string(dropped - log.reportedDropped) + " records lost to full rings";
+			record.detailLength = static_cast<uint8_t>((detail.size() < EventLog::DETAIL_LENGTH) ? detail.size() : EventLog::DETAIL_LENGTH);
+			memcpy(record.detail, detail.data(), record.detailLength);
+			record.level = EventLog::Level::WARNING;
+			batch.push_back(record);
+			log.reportedDropped = dropped;
+		}
+		if (batch.empty()) {
+			return;
+		}
+
+		std::stable_sort(batch.begin(), batch.end(), [](const LogRecord& left, const LogRecord& right) {
+			return left.timeMicros < right.timeMicros;
+		});
+
+		std::string output;
+		for (const LogRecord& record : batch)
+		{
+			const size_t before = output.size();
+			format(output, record);
+			if (log.fileBytes + output.size() > log.settings.maxFileBytes && log.fileBytes + before > 0)
+			{
+				// The current file ends with the lines before this one
+				append(log, output.data(), before);
+				rotate(log);
+				output.erase(0, before);
+			}
+		}
+		append(log, output.data(), output.size());
+	}
+
+	void run(LogState& log)
+	{
+		std::unique_lock<std::mutex> lock(log.mutex);
+		while (!log.wakeup.wait_for(lock, FLUSH_INTERVAL, [&log]() { return log.stopping; })) {
+			drain(log);
+		}
+		drain(log);
+	}
+}
+
+std::atomic<uint8_t> EventLog::s_minimumLevel(static_cast<uint8_t>(EventLog::Level::COUNT));
+
+// ================================
+// Public Interface Methods
+// ================================
+
+bool EventLog::start(const Settings& settings)
+{
+	LogState& log = state();
+	{
+		std::lock_guard<std::mutex> lock(log.mutex);
+		if (log.writer.joinable()) {
+			return false;
+		}
+
+		log.file.open(settings.path, std::ios::binary | std::ios::app);
+		if (!log.file.is_open()) {
+			return false;
+		}
+		boost::system::error_code error;
+		const auto size = boost::filesystem::file_size(settings.path, error);
+		log.fileBytes = error ? 0 : static_cast<uint64_t>(size);
+
+		log.settings = settings;
+		log.rings.clear();
+		log.nextThread = 0;
+		log.failed = false;
+		log.stopping = false;
+		log.dropped = 0;
+		log.reportedDropped = 0;
+		log.generation.fetch_add(1, std::memory_order_release);
+		log.writer = std::thread([&log]() { run(log); });
+	}
+
+	s_minimumLevel.store(static_cast<uint8_t>(settings.minimumLevel));
+	write(Level::INFO, "log_started", 0, 0, 0);
+	return true;
+}
+
+bool EventLog::stop()
+{
+	LogState& log = state();
+	{
+		std::lock_guard<std::mutex> lock(log.mutex);
+		if (!log.writer.joinable()) {
+			return true;
+		}
+		s_minimumLevel.store(static_cast<uint8_t>(Level::COUNT));
+		log.stopping = true;
+	}
+	log.wakeup.notify_all();
+	log.writer.join();
+
+	std::lock_guard<std::mutex> lock(log.mutex);
+	log.file.close();
+	log.rings.clear();
+	log.generation.fetch_add(1, std::memory_order_release);
+	return !log.failed;
+}
+
+void EventLog::write(const Level level, const char* event, const code_t code, const uint64_t bytes, const uint64_t micros,
+	const char* detail, const size_t detailLength)
+{
+	if (!isEnabled(level)) {
+		return;
+	}
+
+	Ring& ring = threadRing();
+	const uint64_t head = ring.head.load(std::memory_order_relaxed);
+	if (head - ring.tail.load(std::memory_order_acquire) >= RING_RECORDS)
+	{
+		state().dropped.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+
+	LogRecord& record = ring.records[head % RING_RECORDS];
+	record.timeMicros = nowMicros();
+	record.event = event;
+	record.bytes = bytes;
+	record.micros = micros;
+	record.thread = ring.thread;
+	record.code = code;
+	record.level = level;
+	record.detailLength = static_cast<uint8_t>((detailLength < DETAIL_LENGTH) ? detailLength : DETAIL_LENGTH);
+	if (record.detailLength > 0) {
+		memcpy(record.detail, detail, record.detailLength);
+	}
+	ring.head.store(head + 1, std::memory_order_release);
+}
+
+uint64_t EventLog::getDropped()
+{
+	return state().dropped.load(std::memory_order_relaxed);
+}
+
+bool EventLog::parseLevel(const std::string& name, Level& level)
+{
+	for (uint8_t i = 0; i < static_cast<uint8_t>(Level::COUNT); ++i)
+	{
+		if (name == levelName(static_cast<Level>(i)))
+		{
+			level = static_cast<Level>(i);
+			return true;
+		}
+	}
+	return false;
+}
+
+const char* EventLog::levelName(const Level level)
+{
+	switch (level)
+	{
+	case Level::DEBUG:   return "debug";
+	case Level::INFO:    return "info";
+	case Level::WARNING: return "warning";
+	case Level::FAILURE: return "failure";
+	default:             return "unknown";
+	}
+}
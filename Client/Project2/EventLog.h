@@ -0,0 +1,156 @@
+/**
+ * @file        EventLog.h
+ * @author      Natanel Maor Fishman
+ * @brief       Asynchronous structured operational log
+ * @details     Hot-path calls copy a fixed-size binary record into a lock-free ring owned
+ *              by the calling thread. A background thread drains the rings, formats the
+ *              records as JSON Lines and appends them to a size-rotated file, so logging
+ *              never waits for formatting or disk I/O. While the log is off, a call costs
+ *              one relaxed atomic load.
+ * @version     2.0
+ * @date        2025
+ */
+
+#pragma once
+
+// ================================
+// Standard Library Includes
+// ================================
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+// ================================
+// Application Includes
+// ================================
+
+#include "protocol.h"
+
+// ================================
+// Class Definition
+// ================================
+
+/**
+ * @class       EventLog
+ * @brief       Process-wide structured log
+ * @details     Each line is one record:
+ *              {"time":"2025-01-01T12:00:00.123456Z","level":"info","thread":2,
+ *               "event":"request","code":603,"bytes":1047,"micros":412,"detail":"..."}
+ *              "code", "bytes" and "micros" are 0 when not applicable; "detail" is present
+ *              only when set and is cut to DETAIL_LENGTH bytes. Records are ordered by time
+ *              within each drain. A thread whose ring is full drops the record rather than
+ *              wait; the writer reports drops as a "records_dropped" warning.
+ *              Once the file reaches the size limit it becomes path.1 (path.1 becomes
+ *              path.2, and so on); the oldest rotated file beyond the limit is removed.
+ *
+ * @note        This class cannot be instantiated - all methods are static. Thread-safe.
+ */
+class EventLog
+{
+public:
+	// ================================
+	// Data Structures
+	// ================================
+
+	/**
+	 * @enum        Level
+	 * @brief       Record severity, in increasing order
+	 */
+	enum class Level : uint8_t
+	{
+		DEBUG,    ///< Connection lifecycle
+		INFO,     ///< Completed requests
+		WARNING,  ///< Rejected requests, failed connects, dropped records
+		FAILURE,  ///< Failed requests and engine errors
+		COUNT     ///< Number of levels (also: log off)
+	};
+
+	/**
+	 * @struct      Settings
+	 * @brief       Log destination, threshold and rotation
+	 */
+	struct Settings
+	{
+		std::string path;                           ///< Log file
+		Level       minimumLevel = Level::INFO;     ///< Records below are skipped
+		uint64_t    maxFileBytes = 10ull << 20;     ///< Rotate once the file reaches this size
+		size_t      maxFiles = 5;                   ///< Rotated files kept besides the current one
+	};
+
+	static constexpr size_t RING_RECORDS = 1024;  ///< Records per thread ring
+	static constexpr size_t DETAIL_LENGTH = 86;   ///< Detail bytes kept per record
+
+	// ================================
+	// Copy Control (Deleted)
+	// ================================
+
+	EventLog() = delete;
+	EventLog(const EventLog&) = delete;
+	EventLog& operator=(const EventLog&) = delete;
+
+	// ================================
+	// Public Interface Methods
+	// ================================
+
+	/**
+	 * @brief       Opens the log file (appending) and starts the writer thread
+	 * @param[in]   settings    Destination, threshold and rotation
+	 * @return      true if started, false if already running or the file cannot be opened
+	 */
+	static bool start(const Settings& settings);
+
+	/**
+	 * @brief       Stops logging, writes out the remaining records and closes the file
+	 * @return      true if every record reached the file (or the log was off), false otherwise
+	 */
+	static bool stop();
+
+	/**
+	 * @brief       Checks if records of a level are kept
+	 */
+	static bool isEnabled(const Level level)
+	{
+		return static_cast<uint8_t>(level) >= s_minimumLevel.load(std::memory_order_relaxed);
+	}
+
+	/**
+	 * @brief       Records an event (never blocks)
+	 * @param[in]   level           Severity
+	 * @param[in]   event           Event name (static string, stored by pointer)
+	 * @param[in]   code            Request code, or 0
+	 * @param[in]   bytes           Bytes involved, or 0
+	 * @param[in]   micros          Duration in microseconds, or 0
+	 * @param[in]   detail          Optional text (copied, cut to DETAIL_LENGTH bytes)
+	 * @param[in]   detailLength    Length of detail
+	 */
+	static void write(Level level, const char* event, code_t code, uint64_t bytes, uint64_t micros,
+		const char* detail = nullptr, size_t detailLength = 0);
+
+	/**
+	 * @brief       Records an event with a text detail
+	 */
+	static void write(const Level level, const char* event, const code_t code, const std::string& detail)
+	{
+		write(level, event, code, 0, 0, detail.data(), detail.size());
+	}
+
+	/**
+	 * @brief       Gets the number of records dropped because a ring was full
+	 */
+	static uint64_t getDropped();
+
+	/**
+	 * @brief       Parses a level name ("debug", "info", "warning", "failure")
+	 * @return      true if recognized, false otherwise
+	 */
+	static bool parseLevel(const std::string& name, Level& level);
+
+	/**
+	 * @brief       Gets the name of a level
+	 */
+	static const char* levelName(Level level);
+
+private:
+	static std::atomic<uint8_t> s_minimumLevel;  ///< Lowest kept level (COUNT = log off)
+};
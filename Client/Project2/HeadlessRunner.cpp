@@ -0,0 +1,412 @@
+/**
+ * @file        HeadlessRunner.cpp
+ * @author      Natanel Maor Fishman
+ * @brief       Implementation of the non-interactive client mode.
+ * @details     Command parsing, dispatch to the messaging engine and exit code mapping.
+ * @date        2025
+ */
+
+#include "HeadlessRunner.h"
+#include "JsonLinesWriter.h"
+#include "LatencyMetrics.h"
+#include "StartupProfile.h"
+#include "StreamSender.h"
+
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <boost/algorithm/string/trim.hpp>
+
+namespace
+{
+	/// Headless commands and their argument counts
+	const std::map<std::string, size_t> COMMAND_ARITY = {
+		{ "register",     1 },
+		{ "list",         0 },
+		{ "pubkey",       1 },
+		{ "inbox",        0 },
+		{ "probe",        0 },
+		{ "send",         2 },
+		{ "file",         2 },
+		{ "send-batch",   1 },
+		{ "request-key",  1 },
+		{ "send-key",     1 },
+		{ "latency",      0 },
+		{ "latency-dump", 1 }
+	};
+}
+
+// ================================
+// Constructor
+// ================================
+
+HeadlessRunner::HeadlessRunner(const ClientOptions& options)
+	: _options(options), _registered(false), _peersFetched(false), _status(ExitCode::SUCCESS)
+{
+}
+
+// ================================
+// Public Interface Methods
+// ================================
+
+int HeadlessRunner::run()
+{
+	if (!_engine.loadServerConfiguration())
+	{
+		std::cerr << "Error: " << _engine.getErrorMessage() << std::endl;
+		return static_cast<int>(ExitCode::CONFIGURATION_ERROR);
+	}
+	_registered = _engine.loadUserCredentials();
+	CommandLine::applyEngineOptions(_options, _engine);
+	StartupProfile::ready();
+
+	for (size_t i = 0; i < _options.commands.size(); ++i)
+	{
+		if (!runLine(_options.commands[i], "--exec #" + std::to_string(i + 1))) {
+			return static_cast<int>(_status);
+		}
+	}
+
+	for (const auto& scriptFile : _options.scriptFiles)
+	{
+		if (scriptFile == "-")
+		{
+			if (!runStream(std::cin, "stdin")) {
+				return static_cast<int>(_status);
+			}
+			continue;
+		}
+
+		std::ifstream script(scriptFile);
+		if (!script.is_open())
+		{
+			std::cerr << "Error: cannot open script '" << scriptFile << "'" << std::endl;
+			return static_cast<int>(ExitCode::USAGE_ERROR);
+		}
+		if (!runStream(script, scriptFile)) {
+			return static_cast<int>(_status);
+		}
+	}
+
+	if (!_options.streamRecipient.empty()) {
+		(void)runStreaming();
+	}
+
+	return static_cast<int>(_status);
+}
+
+// ================================
+// Private Helper Methods
+// ================================
+
+bool HeadlessRunner::runStream(std::istream& input, const std::string& source)
+{
+	std::string line;
+	size_t lineNumber = 0;
+	while (std::getline(input, line))
+	{
+		++lineNumber;
+		if (!runLine(line, source + ":" + std::to_string(lineNumber))) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool HeadlessRunner::runLine(const std::string& line, const std::string& location)
+{
+	const std::string trimmed = boost::algorithm::trim_copy(line);
+	if (trimmed.empty() || trimmed[0] == '#') {
+		return true;
+	}
+
+	std::vector<std::string> words;
+	std::vector<std::string> arguments;
+	std::string error;
+	ExitCode result = ExitCode::USAGE_ERROR;
+
+	const auto arity = tokenize(trimmed, 2, words) ? COMMAND_ARITY.find(words[0]) : COMMAND_ARITY.end();
+
+	if (arity == COMMAND_ARITY.end())
+	{
+		error = words.empty() ? "Unterminated quote" : "Unknown command '" + words[0] + "'";
+	}
+	else if ((arity->second > 0 && (words.size() < 2 || !tokenize(words[1], arity->second, arguments)))
+		|| arguments.size() != arity->second || (arity->second == 0 && words.size() > 1))
+	{
+		error = "'" + words[0] + "' expects " + std::to_string(arity->second) + " argument(s)";
+	}
+	else
+	{
+		result = execute(words[0], arguments, error);
+	}
+
+	if (result == ExitCode::SUCCESS) {
+		return true;
+	}
+
+	std::cerr << location << ": " << error << std::endl;
+	if (_status == ExitCode::SUCCESS) {
+		_status = result;
+	}
+	return _options.keepGoing && result != ExitCode::USAGE_ERROR;
+}
+
+bool HeadlessRunner::runStreaming()
+{
+	ExitCode result = ExitCode::NOT_REGISTERED;
+	if (!_registered) {
+		std::cerr << "--stream: Not registered (run 'register <username>' first)" << std::endl;
+	}
+	else
+	{
+		StreamSender::Settings settings;
+		settings.recipient = _options.streamRecipient;
+		settings.batchBytes = _options.batchBytes;
+		settings.batchWindow = std::chrono::milliseconds(_options.batchWindowMs);
+		settings.queueBytes = std::max(settings.queueBytes, 4 * settings.batchBytes);
+		settings.stopOnFailure = !_options.keepGoing;
+
+		StreamSender sender(_engine, settings);
+		result = sender.run(std::cin, std::cerr);
+	}
+
+	if (result != ExitCode::SUCCESS && _status == ExitCode::SUCCESS) {
+		_status = result;
+	}
+	return result == ExitCode::SUCCESS;
+}
+
+ExitCode HeadlessRunner::execute(const std::string& command, const std::vector<std::string>& arguments, std::string& error)
+{
+	bool success = false;
+
+	// Diagnostics: no registration or server needed
+	if (command == "latency")
+	{
+		_engine.getLatencyMetrics()->print(std::cout);
+		return ExitCode::SUCCESS;
+	}
+	if (command == "latency-dump")
+	{
+		if (!_engine.getLatencyMetrics()->dump(arguments[0]))
+		{
+			error = "Cannot write " + arguments[0];
+			return ExitCode::OPERATION_FAILED;
+		}
+		return ExitCode::SUCCESS;
+	}
+
+	if (command == "register")
+	{
+		if (_registered)
+		{
+			error = "Already registered as " + _engine.getSelfUsername();
+			return ExitCode::OPERATION_FAILED;
+		}
+		success = _engine.registerClient(arguments[0]);
+		_registered = success;
+	}
+	else if (!_registered)
+	{
+		error = "Not registered (run 'register <username>' first)";
+		return ExitCode::NOT_REGISTERED;
+	}
+	else if (command == "list")
+	{
+		success = _engine.requestClientsList();
+		if (success)
+		{
+			_peersFetched = true;
+			for (const auto& username : _engine.getUsernames()) {
+				std::cout << username << std::endl;
+			}
+		}
+	}
+	else if (command == "inbox")
+	{
+		if (_options.jsonOutput)
+		{
+			// Streamed through the writer's buffer as each message is decrypted
+			JsonLinesWriter writer(std::cout);
+			success = _engine.retrievePendingMessages([&writer](MessageEngine::MessageData&& message) {
+				writer.write(message);
+			});
+		}
+		else
+		{
+			std::vector<MessageEngine::MessageData> messages;
+			success = _engine.retrievePendingMessages(messages);
+			for (const auto& message : messages)
+			{
+				std::cout << "From: " << message.username << std::endl
+					<< message.content << std::endl
+					<< "-----------------" << std::endl;
+			}
+		}
+
+		if (success)
+		{
+			const std::string warnings = _engine.getErrorMessage();
+			if (!warnings.empty()) {
+				std::cerr << warnings;
+			}
+		}
+	}
+	else if (command == "probe")
+	{
+		MessageEngine::InboxStatus status;
+		success = _engine.probeInbox(status);
+		if (success)
+		{
+			std::cout << status.messages << " messages, " << status.bytes << " bytes waiting";
+			if (status.pollHint.count() > 0) {
+				std::cout << " (server asks for polls at least " << status.pollHint.count() << " ms apart)";
+			}
+			std::cout << std::endl;
+		}
+	}
+	else if (command == "send-batch")
+	{
+		std::ifstream input(arguments[0]);
+		if (!input.is_open())
+		{
+			error = "Cannot read " + arguments[0];
+			return ExitCode::OPERATION_FAILED;
+		}
+
+		// One "<username> <text>" per line, with the quoting rules of commands
+		std::vector<MessageEngine::BatchEntry> batch;
+		std::string line;
+		size_t lineNumber = 0;
+		while (std::getline(input, line))
+		{
+			++lineNumber;
+			const std::string trimmed = boost::algorithm::trim_copy(line);
+			std::vector<std::string> fields;
+			if (trimmed.empty() || trimmed[0] == '#') {
+				continue;
+			}
+			if (!tokenize(trimmed, 2, fields) || fields.size() != 2)
+			{
+				error = arguments[0] + ":" + std::to_string(lineNumber) + ": expected '<username> <text>'";
+				return ExitCode::USAGE_ERROR;
+			}
+			resolvePeer(fields[0]);
+			batch.push_back({ fields[0], MSG_TEXT, fields[1] });
+		}
+
+		// Nothing to send is not a failure; no empty request goes out
+		if (batch.empty()) {
+			std::cout << "0 messages sent (" << arguments[0] << " has no messages)" << std::endl;
+		}
+
+		// One all-or-nothing request per BATCH_MAX_ENTRIES messages; a failure names what was not sent
+		for (size_t first = 0; first < batch.size(); )
+		{
+			const size_t last = std::min(batch.size(), first + BATCH_MAX_ENTRIES);
+			const std::vector<MessageEngine::BatchEntry> part(batch.begin() + first, batch.begin() + last);
+			std::vector<messageID_t> messageIds;
+			if (!_engine.sendMessages(part, messageIds))
+			{
+				error = _engine.getErrorMessage();
+				if (first > 0) {
+					error = "Messages " + std::to_string(first + 1) + "-" + std::to_string(batch.size()) + " not sent; in that batch: " + error;
+				}
+				return ExitCode::OPERATION_FAILED;
+			}
+			std::cout << "Messages " << (first + 1) << "-" << last << " sent (IDs " << messageIds.front() << "-" << messageIds.back() << ")" << std::endl;
+			first = last;
+		}
+		success = true;
+	}
+	else
+	{
+		resolvePeer(arguments[0]);
+
+		if (command == "pubkey") {
+			success = _engine.requestClientPublicKey(arguments[0]);
+		}
+		else if (command == "send") {
+			success = _engine.sendMessage(arguments[0], MSG_TEXT, arguments[1]);
+		}
+		else if (command == "file") {
+			success = _engine.sendMessage(arguments[0], MSG_FILE, arguments[1]);
+		}
+		else if (command == "request-key") {
+			success = _engine.sendMessage(arguments[0], MSG_SYMMETRIC_KEY_REQUEST);
+		}
+		else if (command == "send-key") {
+			success = _engine.sendMessage(arguments[0], MSG_SYMMETRIC_KEY_SEND);
+		}
+	}
+
+	if (!success)
+	{
+		error = _engine.getErrorMessage();
+		return ExitCode::OPERATION_FAILED;
+	}
+	return ExitCode::SUCCESS;
+}
+
+void HeadlessRunner::resolvePeer(const std::string& username)
+{
+	if (_peersFetched) {
+		return;
+	}
+
+	const auto usernames = _engine.getUsernames();
+	if (std::find(usernames.begin(), usernames.end(), username) == usernames.end())
+	{
+		// A failed fetch surfaces as "user not found" from the command itself
+		_peersFetched = _engine.requestClientsList();
+	}
+}
+
+bool HeadlessRunner::tokenize(const std::string& text, const size_t maxTokens, std::vector<std::string>& tokens)
+{
+	tokens.clear();
+	size_t position = 0;
+
+	while (tokens.size() < maxTokens)
+	{
+		while (position < text.size() && std::isspace(static_cast<unsigned char>(text[position]))) {
+			++position;
+		}
+		if (position >= text.size()) {
+			break;
+		}
+
+		// Last token: rest of the text, unquoted if it is one quoted string
+		if (tokens.size() + 1 == maxTokens)
+		{
+			std::string rest = boost::algorithm::trim_copy(text.substr(position));
+			if (rest.size() >= 2 && rest.front() == '"' && rest.back() == '"') {
+				rest = rest.substr(1, rest.size() - 2);
+			}
+			tokens.push_back(rest);
+			break;
+		}
+
+		if (text[position] == '"')
+		{
+			const size_t closing = text.find('"', position + 1);
+			if (closing == std::string::npos) {
+				return false;
+			}
+			tokens.push_back(text.substr(position + 1, closing - position - 1));
+			position = closing + 1;
+		}
+		else
+		{
+			const size_t start = position;
+			while (position < text.size() && !std::isspace(static_cast<unsigned char>(text[position]))) {
+				++position;
+			}
+			tokens.push_back(text.substr(start, position - start));
+		}
+	}
+	return true;
+}
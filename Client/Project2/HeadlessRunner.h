@@ -0,0 +1,141 @@
+/**
+ * @file        HeadlessRunner.h
+ * @author      Natanel Maor Fishman
+ * @brief       Non-interactive, scriptable client mode
+ * @details     Executes commands given with --exec or read from --script files against
+ *              the messaging engine, without the menu, screen clearing or pause prompts,
+ *              and reports the outcome through the process exit code. --stream runs last
+ *              and forwards stdin lines to a peer.
+ * @version     2.0
+ * @date        2025
+ */
+
+#pragma once
+
+// ================================
+// Standard Library Includes
+// ================================
+
+#include <istream>
+#include <string>
+#include <vector>
+
+// ================================
+// Application Includes
+// ================================
+
+#include "CommandLine.h"
+#include "MessageEngine.h"
+
+// ================================
+// Class Definition
+// ================================
+
+/**
+ * @class       HeadlessRunner
+ * @brief       Runs headless commands and maps results to exit codes
+ * @details     Command output goes to stdout (one username or message per block), errors to
+ *              stderr prefixed with the command's source location. The first failure stops the
+ *              run unless --keep-going is set; the exit code is that of the first failure.
+ *
+ *              Peers named by send/pubkey/key commands are looked up in the client list,
+ *              which is fetched automatically the first time an unknown name is used.
+ *
+ * @note        This class is non-copyable because it owns the messaging engine.
+ */
+class HeadlessRunner
+{
+public:
+	// ================================
+	// Constructor and Destructor
+	// ================================
+
+	/**
+	 * @brief       Creates a runner for the given options
+	 * @param[in]   options    Parsed command-line options (commands and scripts)
+	 */
+	explicit HeadlessRunner(const ClientOptions& options);
+
+	/**
+	 * @brief       Default destructor
+	 */
+	virtual ~HeadlessRunner() = default;
+
+	// ================================
+	// Copy Control (Deleted)
+	// ================================
+
+	HeadlessRunner(const HeadlessRunner&) = delete;
+	HeadlessRunner& operator=(const HeadlessRunner&) = delete;
+
+	// ================================
+	// Public Interface Methods
+	// ================================
+
+	/**
+	 * @brief       Loads configuration and runs all commands
+	 * @return      Process exit code (see ExitCode)
+	 */
+	int run();
+
+private:
+	// ================================
+	// Member Variables
+	// ================================
+
+	const ClientOptions& _options;       ///< Commands, scripts and engine options
+	MessageEngine        _engine;        ///< Messaging engine
+	bool                 _registered;    ///< my.info loaded or register succeeded
+	bool                 _peersFetched;  ///< Client list fetched during this run
+	ExitCode             _status;        ///< First failure (SUCCESS if none)
+
+	// ================================
+	// Private Helper Methods
+	// ================================
+
+	/**
+	 * @brief       Runs every non-empty, non-comment line of a stream
+	 * @param[in]   input     Command source
+	 * @param[in]   source    Source name for error messages
+	 * @return      false if the run must stop
+	 */
+	bool runStream(std::istream& input, const std::string& source);
+
+	/**
+	 * @brief       Runs one command line and records its outcome
+	 * @param[in]   line        Command line
+	 * @param[in]   location    Source location for error messages
+	 * @return      false if the run must stop
+	 */
+	bool runLine(const std::string& line, const std::string& location);
+
+	/**
+	 * @brief       Streams stdin to the --stream recipient
+	 * @return      false if the run must stop
+	 */
+	bool runStreaming();
+
+	/**
+	 * @brief       Executes one parsed command
+	 * @param[in]   command      Command word
+	 * @param[in]   arguments    Arguments (count already validated)
+	 * @param[out]  error        Failure description
+	 * @return      Outcome of the command
+	 */
+	ExitCode execute(const std::string& command, const std::vector<std::string>& arguments, std::string& error);
+
+	/**
+	 * @brief       Makes sure a peer is in the client list, fetching the list once if needed
+	 * @param[in]   username    Peer name
+	 */
+	void resolvePeer(const std::string& username);
+
+	/**
+	 * @brief       Splits text into at most maxTokens whitespace-separated tokens
+	 * @param[in]   text         Text to split
+	 * @param[in]   maxTokens    The last token takes the rest of the text
+	 * @param[out]  tokens       Tokens (surrounding double quotes removed)
+	 * @return      false on an unterminated quote
+	 */
+	static bool tokenize(const std::string& text, size_t maxTokens, std::vector<std::string>& tokens);
+};
@@ -0,0 +1,194 @@
+/**
+ * @file        JsonLinesWriter.cpp
+ * @author      Natanel Maor Fishman
+ * @brief       Implementation of the JSON Lines inbox writer.
+ * @details     Message serialization, string escaping and block-buffered output.
+ * @date        2025
+ */
+
+#include "JsonLinesWriter.h"
+#include "StringUtility.h"
+
+namespace
+{
+	constexpr char HEX_DIGITS[] = "0123456789abcdef";
+
+	/**
+	 * @brief       Length of the valid UTF-8 sequence starting at value[i], or 0 if invalid
+	 */
+	size_t utf8SequenceLength(const std::string& value, const size_t i)
+	{
+		const auto lead = static_cast<unsigned char>(value[i]);
+		size_t length = 0;
+		unsigned char minSecond = 0x80;
+		unsigned char maxSecond = 0xBF;
+
+		if (lead >= 0xC2 && lead <= 0xDF) {
+			length = 2;
+		}
+		else if (lead >= 0xE0 && lead <= 0xEF)
+		{
+			length = 3;
+			minSecond = (lead == 0xE0) ? 0xA0 : 0x80;  // Overlong forms
+			maxSecond = (lead == 0xED) ? 0x9F : 0xBF;  // Surrogates
+		}
+		else if (lead >= 0xF0 && lead <= 0xF4)
+		{
+			length = 4;
+			minSecond = (lead == 0xF0) ? 0x90 : 0x80;
+			maxSecond = (lead == 0xF4) ? 0x8F : 0xBF;
+		}
+		else {
+			return 0;
+		}
+
+		if (i + length > value.size()) {
+			return 0;
+		}
+		for (size_t k = 1; k < length; ++k)
+		{
+			const auto next = static_cast<unsigned char>(value[i + k]);
+			const unsigned char low = (k == 1) ? minSecond : 0x80;
+			const unsigned char high = (k == 1) ? maxSecond : 0xBF;
+			if (next < low || next > high) {
+				return 0;
+			}
+		}
+		return length;
+	}
+}
+
+// ================================
+// Constructor and Destructor
+// ================================
+
+JsonLinesWriter::JsonLinesWriter(std::ostream& output, const size_t bufferBytes)
+	: _output(output), _bufferBytes(bufferBytes), _count(0)
+{
+	_buffer.reserve(bufferBytes + 1024);
+}
+
+JsonLinesWriter::~JsonLinesWriter()
+{
+	flush();
+}
+
+// ================================
+// Public Interface Methods
+// ================================
+
+void JsonLinesWriter::write(const MessageEngine::MessageData& message)
+{
+	_buffer.append("{\"senderId\":\"");
+	_buffer.append(StringUtility::hex(message.senderId.uuid, sizeof(message.senderId.uuid)));
+	_buffer.append("\",\"sender\":");
+	appendString(_buffer, message.username);
+	_buffer.append(",\"messageId\":");
+	_buffer.append(std::to_string(message.messageId));
+	_buffer.append(",\"type\":\"");
+	_buffer.append(typeName(message.type));
+	_buffer.append("\",\"size\":");
+	_buffer.append(std::to_string(message.size));
+
+	if (!message.decrypted) {
+		_buffer.append(",\"error\":");
+	}
+	else if (message.type == MSG_FILE) {
+		_buffer.append(",\"path\":");
+	}
+	else {
+		_buffer.append(",\"content\":");
+	}
+	appendString(_buffer, message.content);
+	_buffer.append("}\n");
+
+	++_count;
+	if (_buffer.size() >= _bufferBytes) {
+		drain();
+	}
+}
+
+void JsonLinesWriter::flush()
+{
+	drain();
+	_output.flush();
+}
+
+const char* JsonLinesWriter::typeName(const messageType_t type)
+{
+	switch (type)
+	{
+	case MSG_SYMMETRIC_KEY_REQUEST: return "key_request";
+	case MSG_SYMMETRIC_KEY_SEND:    return "key";
+	case MSG_TEXT:                  return "text";
+	case MSG_FILE:                  return "file";
+	default:                        return "unknown";
+	}
+}
+
+void JsonLinesWriter::appendString(std::string& target, const std::string& value)
+{
+	target.push_back('"');
+
+	size_t i = 0;
+	while (i < value.size())
+	{
+		// Copy runs of plain characters in one append
+		size_t run = i;
+		while (run < value.size())
+		{
+			const auto c = static_cast<unsigned char>(value[run]);
+			if (c < 0x20 || c == '"' || c == '\\' || c >= 0x80) {
+				break;
+			}
+			++run;
+		}
+		target.append(value, i, run - i);
+		i = run;
+		if (i >= value.size()) {
+			break;
+		}
+
+		const auto c = static_cast<unsigned char>(value[i]);
+		if (c >= 0x80)
+		{
+			const size_t length = utf8SequenceLength(value, i);
+			if (length > 0)
+			{
+				target.append(value, i, length);
+				i += length;
+				continue;
+			}
+		}
+
+		switch (c)
+		{
+		case '"':  target.append("\\\""); break;
+		case '\\': target.append("\\\\"); break;
+		case '\n': target.append("\\n"); break;
+		case '\r': target.append("\\r"); break;
+		case '\t': target.append("\\t"); break;
+		default:
+			target.append("\\u00");
+			target.push_back(HEX_DIGITS[c >> 4]);
+			target.push_back(HEX_DIGITS[c & 0x0F]);
+			break;
+		}
+		++i;
+	}
+
+	target.push_back('"');
+}
+
+// ================================
+// Private Helper Methods
+// ================================
+
+void JsonLinesWriter::drain()
+{
+	if (!_buffer.empty())
+	{
+		_output.write(_buffer.data(), static_cast<std::streamsize>(_buffer.size()));
+		_buffer.clear();
+	}
+}
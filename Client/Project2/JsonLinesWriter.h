@@ -0,0 +1,122 @@
+/**
+ * @file        JsonLinesWriter.h
+ * @author      Natanel Maor Fishman
+ * @brief       Machine-readable inbox output in JSON Lines format
+ * @details     Serializes received messages as one JSON object per line into a
+ *              large private buffer that is written out in blocks, so streaming very
+ *              large inboxes to a pipe does not pay a flush or a write per message.
+ * @version     2.0
+ * @date        2025
+ */
+
+#pragma once
+
+// ================================
+// Standard Library Includes
+// ================================
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+// ================================
+// Application Includes
+// ================================
+
+#include "MessageEngine.h"
+
+// ================================
+// Class Definition
+// ================================
+
+/**
+ * @class       JsonLinesWriter
+ * @brief       Buffered writer of one JSON object per received message
+ * @details     Each message becomes a line such as
+ *              {"senderId":"..","sender":"bob","messageId":7,"type":"text","size":48,"content":".."}
+ *              Files carry "path" instead of "content"; messages that could not be
+ *              decrypted carry "error". Strings are escaped per RFC 8259; bytes that are
+ *              not valid UTF-8 are emitted as \\u00XX (Latin-1) so every line stays valid JSON.
+ *
+ *              Output is only written when the buffer fills, on flush() and on destruction.
+ *
+ * @note        This class is non-copyable and not thread-safe.
+ */
+class JsonLinesWriter
+{
+public:
+	// ================================
+	// Constructor and Destructor
+	// ================================
+
+	/**
+	 * @brief       Creates a writer
+	 * @param[in]   output        Destination stream (usually stdout)
+	 * @param[in]   bufferBytes   Buffer size; output is written in blocks of about this size
+	 */
+	explicit JsonLinesWriter(std::ostream& output, size_t bufferBytes = DEFAULT_BUFFER_BYTES);
+
+	/**
+	 * @brief       Destructor - writes out any buffered lines
+	 */
+	virtual ~JsonLinesWriter();
+
+	// ================================
+	// Copy Control (Deleted)
+	// ================================
+
+	JsonLinesWriter(const JsonLinesWriter&) = delete;
+	JsonLinesWriter& operator=(const JsonLinesWriter&) = delete;
+
+	// ================================
+	// Public Interface Methods
+	// ================================
+
+	/**
+	 * @brief       Appends one message as a JSON line
+	 */
+	void write(const MessageEngine::MessageData& message);
+
+	/**
+	 * @brief       Writes buffered lines to the stream and flushes it
+	 */
+	void flush();
+
+	/**
+	 * @brief       Number of messages written so far
+	 */
+	uint64_t getCount() const { return _count; }
+
+	/**
+	 * @brief       Gets the JSON name of a message type ("text", "file", "key_request", "key")
+	 */
+	static const char* typeName(messageType_t type);
+
+	/**
+	 * @brief       Appends a quoted, escaped JSON string
+	 * @param[out]  target    String to append to
+	 * @param[in]   value     Raw bytes (UTF-8 expected)
+	 */
+	static void appendString(std::string& target, const std::string& value);
+
+	static constexpr size_t DEFAULT_BUFFER_BYTES = 256 * 1024;  ///< Default buffer size
+
+private:
+	// ================================
+	// Member Variables
+	// ================================
+
+	std::ostream& _output;       ///< Destination stream
+	std::string   _buffer;       ///< Pending output
+	const size_t  _bufferBytes;  ///< Drain threshold
+	uint64_t      _count;        ///< Messages written
+
+	// ================================
+	// Private Helper Methods
+	// ================================
+
+	/**
+	 * @brief       Writes the buffer to the stream without flushing it
+	 */
+	void drain();
+};
@@ -0,0 +1,353 @@
+/**
+ * @file        LatencyMetrics.cpp
+ * @author      Natanel Maor Fishman
+ * @brief       Implementation of the latency histograms.
+ * @details     Log-linear bucketing, percentile extraction and table/CSV reporting.
+ * @date        2025
+ */
+
+#include "LatencyMetrics.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+
+namespace
+{
+	/**
+	 * @brief       Index of the highest set bit (value > 0)
+	 */
+	unsigned highestBit(uint64_t value)
+	{
+		unsigned bit = 0;
+		if (value >> 32) { value >>= 32; bit += 32; }
+		if (value >> 16) { value >>= 16; bit += 16; }
+		if (value >> 8)  { value >>= 8;  bit += 8; }
+		if (value >> 4)  { value >>= 4;  bit += 4; }
+		if (value >> 2)  { value >>= 2;  bit += 2; }
+		if (value >> 1)  { bit += 1; }
+		return bit;
+	}
+
+	constexpr double MICROS_PER_MILLI = 1000.0;
+}
+
+// ================================
+// LatencyHistogram
+// ================================
+
+LatencyHistogram::LatencyHistogram() : _buckets(BUCKET_COUNT), _count(0), _sum(0), _max(0)
+{
+	reset();
+}
+
+void LatencyHistogram::record(const std::chrono::microseconds duration)
+{
+	const uint64_t maxValue = (uint64_t(1) << MAX_VALUE_BITS) - 1;
+	const uint64_t value = std::min<uint64_t>(static_cast<uint64_t>(std::max<int64_t>(0, duration.count())), maxValue);
+
+	_buckets[bucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+	_count.fetch_add(1, std::memory_order_relaxed);
+	_sum.fetch_add(value, std::memory_order_relaxed);
+
+	uint64_t currentMax = _max.load(std::memory_order_relaxed);
+	while (value > currentMax && !_max.compare_exchange_weak(currentMax, value, std::memory_order_relaxed)) {
+	}
+}
+
+LatencyHistogram::Summary LatencyHistogram::summarize() const
+{
+	std::vector<uint64_t> buckets(BUCKET_COUNT);
+	uint64_t count = 0;
+	for (size_t i = 0; i < BUCKET_COUNT; ++i)
+	{
+		buckets[i] = _buckets[i].load(std::memory_order_relaxed);
+		count += buckets[i];
+	}
+
+	Summary summary;
+	summary.count = count;
+	summary.max = _max.load(std::memory_order_relaxed);
+	if (count == 0) {
+		return summary;
+	}
+	summary.mean = static_cast<double>(_sum.load(std::memory_order_relaxed)) / static_cast<double>(count);
+	summary.p50 = valueAt(buckets, count, summary.max, 0.50);
+	summary.p90 = valueAt(buckets, count, summary.max, 0.90);
+	summary.p99 = valueAt(buckets, count, summary.max, 0.99);
+	summary.p999 = valueAt(buckets, count, summary.max, 0.999);
+	return summary;
+}
+
+uint64_t LatencyHistogram::valueAt(const double quantile) const
+{
+	std::vector<uint64_t> buckets(BUCKET_COUNT);
+	uint64_t count = 0;
+	for (size_t i = 0; i < BUCKET_COUNT; ++i)
+	{
+		buckets[i] = _buckets[i].load(std::memory_order_relaxed);
+		count += buckets[i];
+	}
+	return valueAt(buckets, count, _max.load(std::memory_order_relaxed), quantile);
+}
+
+void LatencyHistogram::reset()
+{
+	for (auto& bucket : _buckets) {
+		bucket.store(0, std::memory_order_relaxed);
+	}
+	_count.store(0, std::memory_order_relaxed);
+	_sum.store(0, std::memory_order_relaxed);
+	_max.store(0, std::memory_order_relaxed);
+}
+
+size_t LatencyHistogram::bucketIndex(const uint64_t value)
+{
+	if (value < SUB_BUCKET_COUNT) {
+		return static_cast<size_t>(value);
+	}
+	// Shift the value into [SUB_BUCKET_HALF, SUB_BUCKET_COUNT); each shift level adds half a range
+	const unsigned shift = highestBit(value) - (SUB_BUCKET_BITS - 1);
+	return SUB_BUCKET_COUNT + (shift - 1) * SUB_BUCKET_HALF + static_cast<size_t>((value >> shift) - SUB_BUCKET_HALF);
+}
+
+uint64_t LatencyHistogram::bucketUpperBound(const size_t index)
+{
+	if (index < SUB_BUCKET_COUNT) {
+		return index;
+	}
+	const size_t shift = (index - SUB_BUCKET_COUNT) / SUB_BUCKET_HALF + 1;
+	const uint64_t subBucket = (index - SUB_BUCKET_COUNT) % SUB_BUCKET_HALF + SUB_BUCKET_HALF;
+	return ((subBucket + 1) << shift) - 1;
+}
+
+uint64_t LatencyHistogram::valueAt(const std::vector<uint64_t>& buckets, const uint64_t count, const uint64_t max, const double quantile)
+{
+	if (count == 0) {
+		return 0;
+	}
+	const double clamped = std::min(1.0, std::max(0.0, quantile));
+	const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(clamped * static_cast<double>(count))));
+
+	uint64_t seen = 0;
+	for (size_t i = 0; i < buckets.size(); ++i)
+	{
+		seen += buckets[i];
+		if (seen >= rank) {
+			return std::min(bucketUpperBound(i), max);
+		}
+	}
+	return max;
+}
+
+// ================================
+// LatencyMetrics - Recording
+// ================================
+
+void LatencyMetrics::recordOperation(const Operation operation, const std::chrono::microseconds duration)
+{
+	if (operation < Operation::COUNT) {
+		_operations[static_cast<size_t>(operation)].record(duration);
+	}
+}
+
+void LatencyMetrics::recordPhase(const code_t code, const Phase phase, const std::chrono::microseconds duration)
+{
+	if (phase < Phase::COUNT) {
+		_phases[codeSlot(code)][static_cast<size_t>(phase)].record(duration);
+	}
+}
+
+void LatencyMetrics::recordAllocations(const Operation operation, const AllocationSample& delta)
+{
+	if (operation >= Operation::COUNT) {
+		return;
+	}
+	AllocationTotals& totals = _allocations[static_cast<size_t>(operation)];
+	totals.operations.fetch_add(1, std::memory_order_relaxed);
+	totals.allocations.fetch_add(delta.allocations, std::memory_order_relaxed);
+	totals.bytes.fetch_add(delta.bytes, std::memory_order_relaxed);
+	totals.copies.fetch_add(delta.copies, std::memory_order_relaxed);
+	totals.copiedBytes.fetch_add(delta.copiedBytes, std::memory_order_relaxed);
+}
+
+LatencyMetrics::Operation LatencyMetrics::sendOperation(const MessageTypeEnum type)
+{
+	switch (type)
+	{
+	case MSG_SYMMETRIC_KEY_REQUEST: return Operation::SEND_KEY_REQUEST;
+	case MSG_SYMMETRIC_KEY_SEND:    return Operation::SEND_SYMMETRIC_KEY;
+	case MSG_FILE:                  return Operation::SEND_FILE;
+	case MSG_TEXT:
+	default:                        return Operation::SEND_TEXT;
+	}
+}
+
+// ================================
+// LatencyMetrics - Reporting
+// ================================
+
+void LatencyMetrics::print(std::ostream& output) const
+{
+	const std::vector<Row> rows = collect();
+	if (rows.empty())
+	{
+		output << "No latency data recorded yet." << std::endl;
+		return;
+	}
+
+	const auto millis = [](const double micros) { return micros / MICROS_PER_MILLI; };
+
+	output << std::left << std::setw(26) << "metric (ms)" << std::right
+		<< std::setw(8) << "count" << std::setw(10) << "mean" << std::setw(10) << "p50"
+		<< std::setw(10) << "p90" << std::setw(10) << "p99" << std::setw(10) << "p99.9"
+		<< std::setw(10) << "max" << std::endl;
+
+	output << std::fixed << std::setprecision(2);
+	for (const Row& row : rows)
+	{
+		const LatencyHistogram::Summary& s = row.summary;
+		output << std::left << std::setw(26) << row.name << std::right
+			<< std::setw(8) << s.count << std::setw(10) << millis(s.mean)
+			<< std::setw(10) << millis(static_cast<double>(s.p50)) << std::setw(10) << millis(static_cast<double>(s.p90))
+			<< std::setw(10) << millis(static_cast<double>(s.p99)) << std::setw(10) << millis(static_cast<double>(s.p999))
+			<< std::setw(10) << millis(static_cast<double>(s.max)) << std::endl;
+	}
+	output << std::defaultfloat;
+
+	if (AllocationAccounting::ENABLED) {
+		printAllocations(output);
+	}
+}
+
+bool LatencyMetrics::dump(const std::string& path) const
+{
+	std::ofstream file(path, std::ios::trunc);
+	if (!file.is_open()) {
+		return false;
+	}
+
+	file << "metric,count,mean_us,p50_us,p90_us,p99_us,p999_us,max_us\n";
+	for (const Row& row : collect())
+	{
+		const LatencyHistogram::Summary& s = row.summary;
+		file << row.name << ',' << s.count << ',' << static_cast<uint64_t>(s.mean) << ',' << s.p50 << ','
+			<< s.p90 << ',' << s.p99 << ',' << s.p999 << ',' << s.max << '\n';
+	}
+	return static_cast<bool>(file.flush());
+}
+
+void LatencyMetrics::reset()
+{
+	for (auto& histogram : _operations) {
+		histogram.reset();
+	}
+	for (auto& slot : _phases)
+	{
+		for (auto& histogram : slot) {
+			histogram.reset();
+		}
+	}
+	for (auto& totals : _allocations)
+	{
+		totals.operations.store(0, std::memory_order_relaxed);
+		totals.allocations.store(0, std::memory_order_relaxed);
+		totals.bytes.store(0, std::memory_order_relaxed);
+		totals.copies.store(0, std::memory_order_relaxed);
+		totals.copiedBytes.store(0, std::memory_order_relaxed);
+	}
+}
+
+// ================================
+// LatencyMetrics - Names
+// ================================
+
+const char* LatencyMetrics::operationName(const Operation operation)
+{
+	switch (operation)
+	{
+	case Operation::REGISTER:           return "register";
+	case Operation::CLIENTS_LIST:       return "clients_list";
+	case Operation::PUBLIC_KEY:         return "public_key";
+	case Operation::SEND_KEY_REQUEST:   return "send_key_request";
+	case Operation::SEND_SYMMETRIC_KEY: return "send_symmetric_key";
+	case Operation::SEND_TEXT:          return "send_text";
+	case Operation::SEND_FILE:          return "send_file";
+	case Operation::PENDING_MESSAGES:   return "pending_messages";
+	case Operation::INBOX_PROBE:        return "inbox_probe";
+	case Operation::SEND_BATCH:         return "send_batch";
+	default:                            return "unknown";
+	}
+}
+
+const char* LatencyMetrics::phaseName(const Phase phase)
+{
+	switch (phase)
+	{
+	case Phase::CONNECT:    return "connect";
+	case Phase::SEND:       return "send";
+	case Phase::FIRST_BYTE: return "first_byte";
+	case Phase::RECEIVE:    return "receive";
+	default:                return "unknown";
+	}
+}
+
+// ================================
+// Private Helper Methods
+// ================================
+
+size_t LatencyMetrics::codeSlot(const code_t code)
+{
+	const size_t slot = static_cast<size_t>(code) - FIRST_CODE;
+	return (code >= FIRST_CODE && slot < CODE_SLOTS - 1) ? slot : CODE_SLOTS - 1;
+}
+
+std::vector<LatencyMetrics::Row> LatencyMetrics::collect() const
+{
+	std::vector<Row> rows;
+
+	for (size_t i = 0; i < _operations.size(); ++i)
+	{
+		if (_operations[i].getCount() > 0) {
+			rows.push_back({ std::string("op.") + operationName(static_cast<Operation>(i)), _operations[i].summarize() });
+		}
+	}
+
+	for (size_t slot = 0; slot < CODE_SLOTS; ++slot)
+	{
+		const std::string code = (slot == CODE_SLOTS - 1) ? std::string("other") : std::to_string(FIRST_CODE + slot);
+		for (size_t phase = 0; phase < _phases[slot].size(); ++phase)
+		{
+			if (_phases[slot][phase].getCount() > 0) {
+				rows.push_back({ code + "." + phaseName(static_cast<Phase>(phase)), _phases[slot][phase].summarize() });
+			}
+		}
+	}
+	return rows;
+}
+
+void LatencyMetrics::printAllocations(std::ostream& output) const
+{
+	output << std::endl << std::left << std::setw(26) << "allocations (per op)" << std::right
+		<< std::setw(8) << "count" << std::setw(10) << "allocs" << std::setw(12) << "bytes"
+		<< std::setw(10) << "copies" << std::setw(12) << "copied" << std::endl;
+
+	output << std::fixed << std::setprecision(1);
+	for (size_t i = 0; i < _allocations.size(); ++i)
+	{
+		const AllocationTotals& totals = _allocations[i];
+		const uint64_t count = totals.operations.load(std::memory_order_relaxed);
+		if (count == 0) {
+			continue;
+		}
+		const auto average = [count](const std::atomic<uint64_t>& total) {
+			return static_cast<double>(total.load(std::memory_order_relaxed)) / static_cast<double>(count);
+		};
+		output << std::left << std::setw(26) << (std::string("op.") + operationName(static_cast<Operation>(i))) << std::right
+			<< std::setw(8) << count << std::setw(10) << average(totals.allocations)
+			<< std::setw(12) << average(totals.bytes) << std::setw(10) << average(totals.copies)
+			<< std::setw(12) << average(totals.copiedBytes) << std::endl;
+	}
+	output << std::defaultfloat;
+}
@@ -0,0 +1,407 @@
+/**
+ * @file        LatencyMetrics.h
+ * @author      Natanel Maor Fishman
+ * @brief       Client-side latency histograms
+ * @details     HDR-style log-linear histograms with lock-free recording, collected per
+ *              engine operation and per network phase of each request code, so latency
+ *              percentiles (p50/p99/p99.9) can be inspected in production. Instrumentation
+ *              builds (MESSAGEU_ALLOC_ACCOUNTING) also collect allocations and copies per operation.
+ * @version     2.0
+ * @date        2025
+ */
+
+#pragma once
+
+// ================================
+// Standard Library Includes
+// ================================
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// ================================
+// Application Includes
+// ================================
+
+#include "AllocationAccounting.h"
+#include "protocol.h"
+
+// ================================
+// Class Definitions
+// ================================
+
+/**
+ * @class       LatencyHistogram
+ * @brief       Lock-free log-linear histogram of microsecond durations
+ * @details     Values below 128 us have exact buckets; above that each power of two is
+ *              split into 64 linear sub-buckets, bounding the relative error of any
+ *              reported percentile to about 1.6% (HDR histogram with 2 significant digits).
+ *              Values up to 2^40 us (~12.7 days) are tracked; larger ones are clamped.
+ *
+ *              record() costs a handful of relaxed atomic operations and never locks,
+ *              so it can be called from any thread on hot paths.
+ *
+ * @note        Thread-safe. Snapshots taken during recording may be slightly inconsistent.
+ */
+class LatencyHistogram
+{
+public:
+	// ================================
+	// Data Structures
+	// ================================
+
+	/**
+	 * @struct      Summary
+	 * @brief       Percentile summary of a histogram snapshot (microseconds)
+	 */
+	struct Summary
+	{
+		uint64_t count = 0;  ///< Recorded values
+		double   mean = 0;   ///< Arithmetic mean
+		uint64_t p50 = 0;    ///< Median
+		uint64_t p90 = 0;    ///< 90th percentile
+		uint64_t p99 = 0;    ///< 99th percentile
+		uint64_t p999 = 0;   ///< 99.9th percentile
+		uint64_t max = 0;    ///< Largest value
+	};
+
+	// ================================
+	// Constructor and Destructor
+	// ================================
+
+	/**
+	 * @brief       Creates an empty histogram
+	 */
+	LatencyHistogram();
+
+	/**
+	 * @brief       Default destructor
+	 */
+	virtual ~LatencyHistogram() = default;
+
+	// ================================
+	// Copy Control (Deleted)
+	// ================================
+
+	LatencyHistogram(const LatencyHistogram&) = delete;
+	LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+	// ================================
+	// Public Interface Methods
+	// ================================
+
+	/**
+	 * @brief       Records one duration
+	 */
+	void record(std::chrono::microseconds duration);
+
+	/**
+	 * @brief       Computes count, mean, percentiles and maximum
+	 */
+	Summary summarize() const;
+
+	/**
+	 * @brief       Gets the value at a quantile
+	 * @param[in]   quantile    0..1 (e.g. 0.999)
+	 * @return      Highest value equivalent to the quantile's bucket, in microseconds
+	 */
+	uint64_t valueAt(double quantile) const;
+
+	/**
+	 * @brief       Gets the number of recorded values
+	 */
+	uint64_t getCount() const { return _count.load(std::memory_order_relaxed); }
+
+	/**
+	 * @brief       Clears all recorded values
+	 */
+	void reset();
+
+	static constexpr unsigned MAX_VALUE_BITS = 40;                    ///< Values are clamped below 2^40 us
+	static constexpr unsigned SUB_BUCKET_BITS = 7;                    ///< log2 of the linear range
+	static constexpr size_t   SUB_BUCKET_COUNT = size_t(1) << SUB_BUCKET_BITS;
+	static constexpr size_t   SUB_BUCKET_HALF = SUB_BUCKET_COUNT / 2;
+	static constexpr size_t   BUCKET_COUNT = SUB_BUCKET_COUNT + (MAX_VALUE_BITS - SUB_BUCKET_BITS) * SUB_BUCKET_HALF;
+
+	/**
+	 * @brief       Maps a value to its bucket
+	 */
+	static size_t bucketIndex(uint64_t value);
+
+	/**
+	 * @brief       Gets the largest value that maps to a bucket
+	 */
+	static uint64_t bucketUpperBound(size_t index);
+
+private:
+	// ================================
+	// Member Variables
+	// ================================
+
+	std::vector<std::atomic<uint64_t>> _buckets;  ///< Per-bucket counts
+	std::atomic<uint64_t>              _count;    ///< Total values
+	std::atomic<uint64_t>              _sum;      ///< Sum of values (for the mean)
+	std::atomic<uint64_t>              _max;      ///< Largest value
+
+	// ================================
+	// Private Helper Methods
+	// ================================
+
+	/**
+	 * @brief       Finds the value at a quantile in a bucket snapshot
+	 */
+	static uint64_t valueAt(const std::vector<uint64_t>& buckets, uint64_t count, uint64_t max, double quantile);
+};
+
+/**
+ * @class       LatencyMetrics
+ * @brief       Latency histograms of the messaging engine and its connection
+ * @details     Operations measure a whole MessageEngine call (including file access and
+ *              encryption; failed attempts included). Phases measure one request on the
+ *              wire, per request code:
+ *              - connect      TCP connection setup (not recorded when a connection is reused)
+ *              - send         writing the complete request
+ *              - first_byte   end of send until the first response packet arrives
+ *              - receive      end of send until the complete response has been read
+ *
+ * @note        Thread-safe.
+ */
+class LatencyMetrics
+{
+public:
+	// ================================
+	// Enumerations
+	// ================================
+
+	/**
+	 * @enum        Operation
+	 * @brief       Measured MessageEngine operations
+	 */
+	enum class Operation : size_t
+	{
+		REGISTER,
+		CLIENTS_LIST,
+		PUBLIC_KEY,
+		SEND_KEY_REQUEST,
+		SEND_SYMMETRIC_KEY,
+		SEND_TEXT,
+		SEND_FILE,
+		PENDING_MESSAGES,
+		INBOX_PROBE,
+		SEND_BATCH,
+		COUNT
+	};
+
+	/**
+	 * @enum        Phase
+	 * @brief       Measured phases of a request on the connection
+	 */
+	enum class Phase : size_t
+	{
+		CONNECT,
+		SEND,
+		FIRST_BYTE,
+		RECEIVE,
+		COUNT
+	};
+
+	// ================================
+	// Constructor and Destructor
+	// ================================
+
+	/**
+	 * @brief       Creates empty histograms
+	 */
+	LatencyMetrics() = default;
+
+	/**
+	 * @brief       Default destructor
+	 */
+	virtual ~LatencyMetrics() = default;
+
+	// ================================
+	// Copy Control (Deleted)
+	// ================================
+
+	LatencyMetrics(const LatencyMetrics&) = delete;
+	LatencyMetrics& operator=(const LatencyMetrics&) = delete;
+
+	// ================================
+	// Recording Methods
+	// ================================
+
+	/**
+	 * @brief       Records the duration of an engine operation
+	 */
+	void recordOperation(Operation operation, std::chrono::microseconds duration);
+
+	/**
+	 * @brief       Records the duration of a request phase
+	 * @param[in]   code    Request code (unknown codes share one "other" slot)
+	 */
+	void recordPhase(code_t code, Phase phase, std::chrono::microseconds duration);
+
+	/**
+	 * @brief       Adds the allocations and copies of one engine operation
+	 * @param[in]   delta    Counter difference across the operation
+	 */
+	void recordAllocations(Operation operation, const AllocationSample& delta);
+
+	/**
+	 * @brief       Maps a message type to its send operation
+	 */
+	static Operation sendOperation(MessageTypeEnum type);
+
+	// ================================
+	// Reporting Methods
+	// ================================
+
+	/**
+	 * @brief       Prints an aligned table (milliseconds) of every non-empty histogram
+	 * @details     Instrumentation builds append per-operation allocation and copy averages.
+	 */
+	void print(std::ostream& output) const;
+
+	/**
+	 * @brief       Writes every non-empty histogram as CSV (microseconds)
+	 * @param[in]   path    Output file (overwritten)
+	 * @return      true if the file was written, false otherwise
+	 */
+	bool dump(const std::string& path) const;
+
+	/**
+	 * @brief       Clears all histograms
+	 */
+	void reset();
+
+	// ================================
+	// Accessor Methods
+	// ================================
+
+	/**
+	 * @brief       Gets the histogram of an operation
+	 */
+	const LatencyHistogram& getOperation(Operation operation) const { return _operations[static_cast<size_t>(operation)]; }
+
+	/**
+	 * @brief       Gets the histogram of a request phase
+	 */
+	const LatencyHistogram& getPhase(code_t code, Phase phase) const { return _phases[codeSlot(code)][static_cast<size_t>(phase)]; }
+
+	/**
+	 * @brief       Gets the display name of an operation (e.g. "send_text")
+	 */
+	static const char* operationName(Operation operation);
+
+	/**
+	 * @brief       Gets the display name of a phase (e.g. "first_byte")
+	 */
+	static const char* phaseName(Phase phase);
+
+private:
+	// ================================
+	// Internal Types
+	// ================================
+
+	static constexpr code_t FIRST_CODE = REQUEST_REGISTRATION;  ///< Code of slot 0
+	static constexpr size_t CODE_SLOTS = 10;                    ///< Codes 600..608 plus "other"
+
+	using PhaseHistograms = std::array<LatencyHistogram, static_cast<size_t>(Phase::COUNT)>;
+
+	/**
+	 * @struct      AllocationTotals
+	 * @brief       Summed allocation counters of one operation
+	 */
+	struct AllocationTotals
+	{
+		std::atomic<uint64_t> operations{ 0 };   ///< Recorded operations
+		std::atomic<uint64_t> allocations{ 0 };  ///< operator new calls
+		std::atomic<uint64_t> bytes{ 0 };        ///< Allocated bytes
+		std::atomic<uint64_t> copies{ 0 };       ///< Explicit buffer copies
+		std::atomic<uint64_t> copiedBytes{ 0 };  ///< Copied bytes
+	};
+
+	/**
+	 * @struct      Row
+	 * @brief       One reported histogram
+	 */
+	struct Row
+	{
+		std::string               name;     ///< e.g. "op.send_text" or "601.receive"
+		LatencyHistogram::Summary summary;  ///< Percentiles
+	};
+
+	// ================================
+	// Member Variables
+	// ================================
+
+	std::array<LatencyHistogram, static_cast<size_t>(Operation::COUNT)> _operations;  ///< Per operation
+	std::array<PhaseHistograms, CODE_SLOTS>                              _phases;      ///< Per code and phase
+	std::array<AllocationTotals, static_cast<size_t>(Operation::COUNT)> _allocations; ///< Per operation (instrumentation builds)
+
+	// ================================
+	// Private Helper Methods
+	// ================================
+
+	/**
+	 * @brief       Maps a request code to its phase slot
+	 */
+	static size_t codeSlot(code_t code);
+
+	/**
+	 * @brief       Collects summaries of all non-empty histograms
+	 */
+	std::vector<Row> collect() const;
+
+	/**
+	 * @brief       Prints per-operation allocation and copy averages
+	 */
+	void printAllocations(std::ostream& output) const;
+};
+
+/**
+ * @class       LatencyTimer
+ * @brief       Scoped timer recording an engine operation on destruction
+ * @details     A null metrics pointer disables recording. Instrumentation builds also
+ *              record the allocations and copies made on this thread during the scope.
+ */
+class LatencyTimer
+{
+public:
+	LatencyTimer(LatencyMetrics* metrics, const LatencyMetrics::Operation operation)
+		: _metrics(metrics), _operation(operation), _start(std::chrono::steady_clock::now()),
+		_allocations(AllocationAccounting::current()) {}
+
+	~LatencyTimer()
+	{
+		if (_metrics == nullptr) {
+			return;
+		}
+		_metrics->recordOperation(_operation, std::chrono::duration_cast<std::chrono::microseconds>(
+			std::chrono::steady_clock::now() - _start));
+
+		if (AllocationAccounting::ENABLED)
+		{
+			AllocationSample delta = AllocationAccounting::current();
+			delta.allocations -= _allocations.allocations;
+			delta.bytes -= _allocations.bytes;
+			delta.copies -= _allocations.copies;
+			delta.copiedBytes -= _allocations.copiedBytes;
+			_metrics->recordAllocations(_operation, delta);
+		}
+	}
+
+	LatencyTimer(const LatencyTimer&) = delete;
+	LatencyTimer& operator=(const LatencyTimer&) = delete;
+
+private:
+	LatencyMetrics* const                       _metrics;    ///< Destination (may be null)
+	const LatencyMetrics::Operation             _operation;  ///< Measured operation
+	const std::chrono::steady_clock::time_point _start;      ///< Start time
+	const AllocationSample                      _allocations; ///< Thread counters at start
+};
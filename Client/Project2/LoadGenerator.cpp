@@ -0,0 +1,384 @@
+/**
+ * @file        LoadGenerator.cpp
+ * @author      Natanel Maor Fishman
+ * @brief       Implementation of the multi-client load generator.
+ * @details     Identity setup, key exchange, per-client load threads and the result report.
+ * @date        2025
+ */
+
+#include "LoadGenerator.h"
+#include "MessageEngine.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <random>
+#include <sstream>
+#include <thread>
+#include <boost/filesystem.hpp>
+
+namespace
+{
+	constexpr double MICROS_PER_MILLI = 1000.0;
+}
+
+/**
+ * @struct      LoadGenerator::Client
+ * @brief       One synthetic client and its load state
+ */
+struct LoadGenerator::Client
+{
+	explicit Client(ThreadPool* pool) : engine(pool) {}
+
+	MessageEngine            engine;    ///< Full client stack
+	size_t                   index = 0; ///< Position in _clients
+	std::string              username;  ///< Registered name
+	std::vector<std::string> partners;  ///< Key exchange partners (send targets)
+	std::string              text;      ///< Text message payload
+	std::mt19937             random;    ///< Operation and target choice
+};
+
+// ================================
+// Constructor and Destructor
+// ================================
+
+LoadGenerator::LoadGenerator(const Settings& settings) : _settings(settings), _taskPool(new ThreadPool())
+{
+}
+
+LoadGenerator::~LoadGenerator() = default;
+
+// ================================
+// Public Interface Methods
+// ================================
+
+ExitCode LoadGenerator::run(std::ostream& report)
+{
+	const bool sends = _settings.mix[static_cast<size_t>(Operation::TEXT)] > 0 || _settings.mix[static_cast<size_t>(Operation::FILE)] > 0;
+	if (sends && (_settings.clients < 2 || _settings.peers == 0))
+	{
+		report << "Error: sending needs at least 2 clients and 1 peer" << std::endl;
+		return ExitCode::USAGE_ERROR;
+	}
+
+	const ExitCode setupResult = setup(report);
+	if (setupResult != ExitCode::SUCCESS) {
+		return setupResult;
+	}
+	if (!exchangeKeys(report)) {
+		return ExitCode::OPERATION_FAILED;
+	}
+
+	report << "Running load for " << _settings.duration.count() << " s..." << std::endl;
+	const Clock::time_point start = Clock::now();
+	const Clock::time_point deadline = start + _settings.duration;
+	(void)forEachClient([this, deadline](Client& client) {
+		drive(client, deadline);
+		return true;
+	});
+	printReport(report, Clock::now() - start);
+
+	for (const OperationStats& stats : _stats)
+	{
+		if (stats.failures.load() > 0) {
+			return ExitCode::OPERATION_FAILED;
+		}
+	}
+	return ExitCode::SUCCESS;
+}
+
+bool LoadGenerator::parseMix(const std::string& specification, Mix& mix)
+{
+	Mix parsed{};
+	std::istringstream entries(specification);
+	std::string entry;
+
+	while (std::getline(entries, entry, ','))
+	{
+		const size_t separator = entry.find('=');
+		if (separator == std::string::npos || separator + 1 >= entry.size()) {
+			return false;
+		}
+
+		const std::string name = entry.substr(0, separator);
+		const std::string weight = entry.substr(separator + 1);
+		if (weight.find_first_not_of("0123456789") != std::string::npos || weight.size() > 6) {
+			return false;
+		}
+
+		size_t operation = 0;
+		while (operation < parsed.size() && name != operationName(static_cast<Operation>(operation))) {
+			++operation;
+		}
+		if (operation == parsed.size()) {
+			return false;
+		}
+		parsed[operation] = static_cast<unsigned>(std::stoul(weight));
+	}
+
+	for (const unsigned weight : parsed)
+	{
+		if (weight > 0)
+		{
+			mix = parsed;
+			return true;
+		}
+	}
+	return false;
+}
+
+const char* LoadGenerator::operationName(const Operation operation)
+{
+	switch (operation)
+	{
+	case Operation::TEXT:  return "text";
+	case Operation::FILE:  return "file";
+	case Operation::LIST:  return "list";
+	case Operation::INBOX: return "inbox";
+	default:               return "unknown";
+	}
+}
+
+// ================================
+// Private Helper Methods
+// ================================
+
+ExitCode LoadGenerator::setup(std::ostream& report)
+{
+	boost::system::error_code error;
+	boost::filesystem::create_directories(_settings.credentialsDirectory, error);
+	if (error)
+	{
+		report << "Error: cannot create " << _settings.credentialsDirectory << ": " << error.message() << std::endl;
+		return ExitCode::OPERATION_FAILED;
+	}
+
+	// File payload, written once and sent by every client
+	_filePath = (boost::filesystem::path(_settings.credentialsDirectory) / "payload.bin").string();
+	{
+		std::ofstream payload(_filePath, std::ios::binary | std::ios::trunc);
+		for (size_t i = 0; i < _settings.fileBytes; ++i) {
+			payload.put(static_cast<char>('a' + i % 26));
+		}
+		if (!payload)
+		{
+			report << "Error: cannot write " << _filePath << std::endl;
+			return ExitCode::OPERATION_FAILED;
+		}
+	}
+
+	// Fresh identities get a per-run tag, so their names cannot collide with earlier runs
+	std::random_device entropy;
+	std::ostringstream tag;
+	tag << std::hex << entropy();
+
+	for (size_t i = 0; i < _settings.clients; ++i)
+	{
+		std::unique_ptr<Client> client(new Client(_taskPool.get()));
+		client->index = i;
+		client->random.seed(entropy());
+		client->text.assign(_settings.textBytes, static_cast<char>('A' + i % 26));
+		if (!client->engine.loadServerConfiguration())
+		{
+			report << "Error: " << client->engine.getErrorMessage() << std::endl;
+			return ExitCode::CONFIGURATION_ERROR;
+		}
+		client->engine.setPersistentConnection(_settings.persistentConnection);
+		if (_settings.emulateNetwork)
+		{
+			EmulatedConnection::Profile profile = _settings.emulation;
+			profile.seed += static_cast<uint32_t>(i);
+			client->engine.replaceConnection(new EmulatedConnection(profile));
+		}
+		client->engine.setCredentialsFile((boost::filesystem::path(_settings.credentialsDirectory)
+			/ ("client" + std::to_string(i) + ".info")).string());
+		_clients.push_back(std::move(client));
+	}
+
+	report << "Setting up " << _clients.size() << " clients..." << std::endl;
+	std::atomic<size_t> registered(0);
+	const bool ready = forEachClient([this, &report, &registered, &tag](Client& client) {
+		if (client.engine.loadUserCredentials())
+		{
+			client.username = client.engine.getSelfUsername();
+			return true;
+		}
+
+		const std::string username = _settings.namePrefix + tag.str() + "n" + std::to_string(client.index);
+		if (!client.engine.registerClient(username))
+		{
+			std::lock_guard<std::mutex> lock(_errorMutex);
+			report << "Error: register " << username << ": " << client.engine.getErrorMessage() << std::endl;
+			return false;
+		}
+		client.username = username;
+		++registered;
+		return true;
+	});
+	if (!ready) {
+		return ExitCode::OPERATION_FAILED;
+	}
+	report << "  " << registered.load() << " registered, " << (_clients.size() - registered.load()) << " reused" << std::endl;
+
+	// Partners: up to `peers` neighbours on each side by index
+	for (const auto& client : _clients)
+	{
+		const size_t first = (client->index > _settings.peers) ? client->index - _settings.peers : 0;
+		const size_t last = std::min(_clients.size() - 1, client->index + _settings.peers);
+		for (size_t j = first; j <= last; ++j)
+		{
+			if (j != client->index) {
+				client->partners.push_back(_clients[j]->username);
+			}
+		}
+	}
+	return ExitCode::SUCCESS;
+}
+
+bool LoadGenerator::exchangeKeys(std::ostream& report)
+{
+	report << "Exchanging keys..." << std::endl;
+
+	const auto fail = [this, &report](const Client& client, const std::string& step) {
+		std::lock_guard<std::mutex> lock(_errorMutex);
+		report << "Error: " << client.username << ": " << step << ": " << client.engine.getErrorMessage() << std::endl;
+		return false;
+	};
+
+	// Every client must know every partner before keys arrive
+	if (!forEachClient([&fail](Client& client) {
+		return client.engine.requestClientsList() || fail(client, "client list");
+	})) {
+		return false;
+	}
+
+	// Keys flow from the lower to the higher index only, so each pair shares one key
+	if (!forEachClient([this, &fail](Client& client) {
+		for (size_t j = client.index + 1; j < _clients.size() && j <= client.index + _settings.peers; ++j)
+		{
+			if (!client.engine.prepareSecureChannel(_clients[j]->username)) {
+				return fail(client, "key exchange with " + _clients[j]->username);
+			}
+		}
+		return true;
+	})) {
+		return false;
+	}
+
+	return forEachClient([&fail](Client& client) {
+		std::vector<MessageEngine::MessageData> messages;
+		return client.engine.retrievePendingMessages(messages) || fail(client, "key delivery");
+	});
+}
+
+void LoadGenerator::drive(Client& client, const Clock::time_point deadline)
+{
+	std::discrete_distribution<size_t> pick(_settings.mix.begin(), _settings.mix.end());
+
+	while (Clock::now() < deadline)
+	{
+		const Operation operation = static_cast<Operation>(pick(client.random));
+		const Clock::time_point start = Clock::now();
+		if (execute(client, operation)) {
+			_stats[static_cast<size_t>(operation)].latency.record(
+				std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start));
+		}
+		else {
+			recordFailure(operation, client.engine.getErrorMessage());
+		}
+	}
+}
+
+bool LoadGenerator::execute(Client& client, const Operation operation)
+{
+	if (operation == Operation::LIST) {
+		return client.engine.requestClientsList();
+	}
+	if (operation == Operation::INBOX)
+	{
+		std::vector<MessageEngine::MessageData> messages;
+		return client.engine.retrievePendingMessages(messages);
+	}
+
+	std::uniform_int_distribution<size_t> target(0, client.partners.size() - 1);
+	const std::string& recipient = client.partners[target(client.random)];
+	return (operation == Operation::TEXT)
+		? client.engine.sendMessage(recipient, MSG_TEXT, client.text)
+		: client.engine.sendMessage(recipient, MSG_FILE, _filePath);
+}
+
+bool LoadGenerator::forEachClient(const std::function<bool(Client&)>& task)
+{
+	std::atomic<bool> success(true);
+	std::vector<std::thread> threads;
+	threads.reserve(_clients.size());
+
+	for (const auto& client : _clients)
+	{
+		Client* const target = client.get();
+		threads.emplace_back([&task, &success, target]() {
+			if (!task(*target)) {
+				success = false;
+			}
+		});
+	}
+	for (auto& thread : threads) {
+		thread.join();
+	}
+	return success.load();
+}
+
+void LoadGenerator::recordFailure(const Operation operation, const std::string& error)
+{
+	OperationStats& stats = _stats[static_cast<size_t>(operation)];
+	if (stats.failures.fetch_add(1) == 0)
+	{
+		std::lock_guard<std::mutex> lock(_errorMutex);
+		stats.firstError = error;
+	}
+}
+
+void LoadGenerator::printReport(std::ostream& report, const std::chrono::duration<double> elapsed) const
+{
+	const auto millis = [](const double micros) { return micros / MICROS_PER_MILLI; };
+	const double seconds = elapsed.count();
+
+	report << std::endl << "Load test: " << _clients.size() << " clients, " << std::fixed << std::setprecision(1)
+		<< seconds << " s" << std::endl;
+	report << std::left << std::setw(10) << "operation" << std::right
+		<< std::setw(9) << "ok" << std::setw(8) << "failed" << std::setw(10) << "ops/s"
+		<< std::setw(10) << "mean ms" << std::setw(10) << "p50" << std::setw(10) << "p90"
+		<< std::setw(10) << "p99" << std::setw(10) << "p99.9" << std::setw(10) << "max" << std::endl;
+
+	uint64_t totalOk = 0;
+	uint64_t totalFailed = 0;
+	report << std::setprecision(2);
+	for (size_t i = 0; i < _stats.size(); ++i)
+	{
+		if (_settings.mix[i] == 0) {
+			continue;
+		}
+		const LatencyHistogram::Summary s = _stats[i].latency.summarize();
+		const uint64_t failed = _stats[i].failures.load();
+		totalOk += s.count;
+		totalFailed += failed;
+
+		report << std::left << std::setw(10) << operationName(static_cast<Operation>(i)) << std::right
+			<< std::setw(9) << s.count << std::setw(8) << failed << std::setw(10) << s.count / seconds
+			<< std::setw(10) << millis(s.mean)
+			<< std::setw(10) << millis(static_cast<double>(s.p50)) << std::setw(10) << millis(static_cast<double>(s.p90))
+			<< std::setw(10) << millis(static_cast<double>(s.p99)) << std::setw(10) << millis(static_cast<double>(s.p999))
+			<< std::setw(10) << millis(static_cast<double>(s.max)) << std::endl;
+	}
+	report << std::left << std::setw(10) << "total" << std::right
+		<< std::setw(9) << totalOk << std::setw(8) << totalFailed << std::setw(10) << totalOk / seconds << std::endl;
+	report << std::defaultfloat;
+
+	for (size_t i = 0; i < _stats.size(); ++i)
+	{
+		if (_stats[i].failures.load() > 0) {
+			report << "First " << operationName(static_cast<Operation>(i)) << " failure: " << _stats[i].firstError << std::endl;
+		}
+	}
+}
@@ -0,0 +1,227 @@
+/**
+ * @file        LoadGenerator.h
+ * @author      Natanel Maor Fishman
+ * @brief       Multi-client load generator
+ * @details     Drives many synthetic clients, each a full MessageEngine, against a server
+ *              and reports throughput and latency percentiles per operation. Used to size
+ *              server capacity and to catch client performance regressions.
+ * @version     2.0
+ * @date        2025
+ */
+
+#pragma once
+
+// ================================
+// Standard Library Includes
+// ================================
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// ================================
+// Application Includes
+// ================================
+
+#include "CommandLine.h"
+#include "EmulatedConnection.h"
+#include "LatencyMetrics.h"
+
+// ================================
+// Forward Declarations
+// ================================
+
+class ThreadPool;
+
+// ================================
+// Class Definition
+// ================================
+
+/**
+ * @class       LoadGenerator
+ * @brief       Closed-loop load test with N concurrent synthetic clients
+ * @details     A run has three phases:
+ *              1. Setup: every client loads its credentials file from the credentials
+ *                 directory, or registers a new identity and writes one. Identities are
+ *                 therefore reused across runs instead of filling the server database.
+ *              2. Key exchange: each client sends a symmetric key to the next `peers`
+ *                 clients by index, then every client drains its inbox to receive the keys.
+ *                 Keys travel in one direction per pair, so both sides agree on one key.
+ *              3. Load: one thread per client picks operations by weight (text send, file
+ *                 send, client list refresh, inbox poll) back to back for the configured
+ *                 duration. Sends go to a random key-exchange partner.
+ *
+ *              Latency is recorded per operation in lock-free histograms shared by all
+ *              threads; failed operations are counted separately and not timed. All
+ *              clients share one task pool, so background workers do not grow with the
+ *              client count.
+ *
+ * @note        This class is non-copyable. run() may be called once.
+ */
+class LoadGenerator
+{
+public:
+	// ================================
+	// Data Structures
+	// ================================
+
+	/**
+	 * @enum        Operation
+	 * @brief       Operations of the load mix
+	 */
+	enum class Operation : size_t
+	{
+		TEXT,       ///< Send a text message
+		FILE,       ///< Send a file
+		LIST,       ///< Refresh the client list
+		INBOX,      ///< Poll and decrypt pending messages
+		COUNT
+	};
+
+	/// Relative weight of each operation (0 disables it)
+	using Mix = std::array<unsigned, static_cast<size_t>(Operation::COUNT)>;
+
+	/**
+	 * @struct      Settings
+	 * @brief       Load test configuration
+	 */
+	struct Settings
+	{
+		size_t                clients = 8;                        ///< Concurrent synthetic clients
+		size_t                peers = 4;                          ///< Key exchange partners per client (each side)
+		std::chrono::seconds  duration{ 30 };                     ///< Load phase length
+		Mix                   mix{ { 60, 5, 10, 25 } };           ///< text, file, list, inbox weights
+		size_t                textBytes = 256;                    ///< Text message size
+		size_t                fileBytes = 64 * 1024;              ///< File message size
+		std::string           credentialsDirectory = "loadgen";   ///< Per-client credentials files
+		std::string           namePrefix = "loadgen";             ///< Prefix of registered usernames
+		bool                  persistentConnection = false;       ///< Reuse one connection per client
+		bool                  emulateNetwork = false;             ///< Route clients through emulated links
+		EmulatedConnection::Profile emulation;                    ///< Link profile (client i uses seed + i)
+	};
+
+	// ================================
+	// Constructor and Destructor
+	// ================================
+
+	/**
+	 * @brief       Creates a load generator
+	 * @param[in]   settings    Load test configuration
+	 */
+	explicit LoadGenerator(const Settings& settings);
+
+	/**
+	 * @brief       Releases the synthetic clients
+	 */
+	virtual ~LoadGenerator();
+
+	// ================================
+	// Copy Control (Deleted)
+	// ================================
+
+	LoadGenerator(const LoadGenerator&) = delete;
+	LoadGenerator& operator=(const LoadGenerator&) = delete;
+
+	// ================================
+	// Public Interface Methods
+	// ================================
+
+	/**
+	 * @brief       Runs setup, key exchange and the load phase, then prints the report
+	 * @param[in,out] report    Progress and result output
+	 * @return      SUCCESS if no operation failed, CONFIGURATION_ERROR if server.info is
+	 *              invalid, OPERATION_FAILED otherwise
+	 */
+	ExitCode run(std::ostream& report);
+
+	/**
+	 * @brief       Parses a mix specification
+	 * @param[in]   specification    e.g. "text=60,file=5,list=10,inbox=25"; omitted operations get 0
+	 * @param[out]  mix              Parsed weights
+	 * @return      true if the specification is valid and some weight is positive, false otherwise
+	 */
+	static bool parseMix(const std::string& specification, Mix& mix);
+
+	/**
+	 * @brief       Gets the display name of an operation
+	 */
+	static const char* operationName(Operation operation);
+
+private:
+	// ================================
+	// Internal Types
+	// ================================
+
+	using Clock = std::chrono::steady_clock;
+
+	struct Client;
+
+	/**
+	 * @struct      OperationStats
+	 * @brief       Results of one operation across all clients
+	 */
+	struct OperationStats
+	{
+		LatencyHistogram      latency;        ///< Successful operation latencies
+		std::atomic<uint64_t> failures{ 0 };  ///< Failed operations
+		std::string           firstError;     ///< First failure message (guarded by _errorMutex)
+	};
+
+	// ================================
+	// Member Variables
+	// ================================
+
+	const Settings                       _settings;   ///< Load test configuration
+	std::unique_ptr<ThreadPool>          _taskPool;   ///< Task pool of every client (outlives them)
+	std::vector<std::unique_ptr<Client>> _clients;    ///< Synthetic clients
+	std::array<OperationStats, static_cast<size_t>(Operation::COUNT)> _stats;  ///< Per-operation results
+	std::mutex                           _errorMutex; ///< Guards firstError
+	std::string                          _filePath;   ///< Payload file of file sends
+
+	// ================================
+	// Private Helper Methods
+	// ================================
+
+	/**
+	 * @brief       Creates the clients and loads or registers their identities
+	 */
+	ExitCode setup(std::ostream& report);
+
+	/**
+	 * @brief       Establishes symmetric keys between key exchange partners
+	 */
+	bool exchangeKeys(std::ostream& report);
+
+	/**
+	 * @brief       Load phase loop of one client
+	 */
+	void drive(Client& client, Clock::time_point deadline);
+
+	/**
+	 * @brief       Runs one operation of a client
+	 * @return      true if it succeeded
+	 */
+	bool execute(Client& client, Operation operation);
+
+	/**
+	 * @brief       Runs a task per client on its own thread and waits for all of them
+	 * @return      true if the task succeeded for every client
+	 */
+	bool forEachClient(const std::function<bool(Client&)>& task);
+
+	/**
+	 * @brief       Records a failure message (the first one per operation is kept)
+	 */
+	void recordFailure(Operation operation, const std::string& error);
+
+	/**
+	 * @brief       Prints throughput and latency per operation
+	 */
+	void printReport(std::ostream& report, std::chrono::duration<double> elapsed) const;
+};
@@ -7,11 +7,28 @@
  */
 #include "RSAWrapper.h"
 #include "AESWrapper.h"
+#include "AllocationAccounting.h"
 #include "MessageEngine.h"
 #include "StringUtility.h"
 #include "ConfigManager.h"
+#include "EngineCounters.h"
+#include "EventLog.h"
+#include "LatencyMetrics.h"
+#include "MetricsExporter.h"
 #include "NetworkConnection.h"
+#include "PollScheduler.h"
+#include "RateLimiter.h"
+#include "SharedDirectory.h"
+#include "StartupProfile.h"
+#include "ThreadPool.h"
+#include "Tracer.h"
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <future>
 #include <limits>
+#include <memory>
+#include <random>
 
 
  //Stream operator for MessageType enumeration
@@ -22,13 +39,180 @@ std::ostream& operator<<(std::ostream& os, const MessageTypeEnum& type)
 	return os;
 }
 
+namespace
+{
+	using Wire = EngineCounters::Wire;
+
+	constexpr size_t STRIPE_MIN_BYTES = 1 << 20;           // Smallest stripe worth its own connection
+	constexpr double STRIPE_MIN_SECONDS = 0.25;            // Shortest stripe transfer that repays connection setup
+	constexpr size_t STRIPE_CHUNK_BYTES = 64 * 1024;       // Socket write size of stripe connections
+	constexpr size_t THROUGHPUT_SAMPLE_BYTES = 64 * 1024;  // Smaller sends are latency-bound
+	constexpr double THROUGHPUT_WEIGHT = 0.3;              // Weight of the newest throughput sample
+
+	/**
+	 * Bytes moved by copying a message into the result list (allocation accounting).
+	 */
+	size_t messageBytes(const MessageEngine::MessageData& message)
+	{
+		return sizeof(message) + message.username.size() + message.content.size();
+	}
+
+	/**
+	 * Runs a cryptographic operation and adds its duration to the crypto time counter.
+	 */
+	template <typename Function>
+	auto timeCrypto(EngineCounters* counters, Function function) -> decltype(function())
+	{
+		CryptoTimer timer(counters);
+		return function();
+	}
+
+	/**
+	 * Tracks one request/response exchange with the server.
+	 * Paces the request on construction and reports the outcome on destruction.
+	 * Network phases of the exchange are timed under the request code, and the
+	 * whole exchange is a trace span and an event log record.
+	 */
+	class ExchangeScope
+	{
+	public:
+		ExchangeScope(RateLimiter& limiter, EngineCounters& counters, NetworkConnection& network, const uint8_t* const request, const size_t reqSize)
+			: _limiter(limiter), _counters(counters), _code(reinterpret_cast<const RequestHeaderStruct*>(request)->code),
+			_bytes(reqSize), _failed(false), _rejected(false), _span("engine", "exchange")
+		{
+			_span.setBytes(reqSize);
+			_limiter.acquire(_code, reqSize);
+			network.beginRequest(_code);
+			_start = std::chrono::steady_clock::now();
+		}
+
+		~ExchangeScope()
+		{
+			const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - _start);
+			_limiter.reportOutcome(_code, !_failed, elapsed);
+			_counters.recordRequest(_code, _failed ? EngineCounters::Outcome::FAILED
+				: _rejected ? EngineCounters::Outcome::REJECTED : EngineCounters::Outcome::SUCCESS);
+			EventLog::write(_failed ? EventLog::Level::FAILURE : _rejected ? EventLog::Level::WARNING : EventLog::Level::INFO,
+				_failed ? "request_failed" : _rejected ? "request_rejected" : "request", _code, _bytes,
+				static_cast<uint64_t>(elapsed.count()));
+		}
+
+		// Mark a connection or transfer failure (server-side rejections are not failures)
+		void fail() { _failed = true; }
+
+		// Mark a server error response or an unexpected response header
+		void reject() { _rejected = true; }
+
+	private:
+		RateLimiter& _limiter;
+		EngineCounters& _counters;
+		const code_t _code;
+		const size_t _bytes;
+		bool _failed;
+		bool _rejected;
+		std::chrono::steady_clock::time_point _start;
+		TraceSpan _span;
+	};
+
+	/**
+	 * Logs the error message left by a public operation.
+	 * Errors are reported by clearing and refilling the error buffer, so a new error
+	 * generation at scope exit means this call, or one it made, reported a problem.
+	 * Nested scopes log each error once.
+	 */
+	class ErrorLogScope
+	{
+	public:
+		ErrorLogScope(const char* operation, const std::stringstream& errors, const uint64_t& generation, uint64_t& logged)
+			: _operation(operation), _errors(errors), _generation(generation), _logged(logged), _start(generation) {}
+
+		~ErrorLogScope()
+		{
+			if (_generation == _start || _generation == _logged || !EventLog::isEnabled(EventLog::Level::FAILURE)) {
+				return;
+			}
+			_logged = _generation;
+			const std::string message = _errors.str();
+			if (!message.empty()) {
+				EventLog::write(EventLog::Level::FAILURE, _operation, 0, message);
+			}
+		}
+
+		ErrorLogScope(const ErrorLogScope&) = delete;
+		ErrorLogScope& operator=(const ErrorLogScope&) = delete;
+
+	private:
+		const char* const        _operation;
+		const std::stringstream& _errors;
+		const uint64_t&          _generation;
+		uint64_t&                _logged;
+		const uint64_t           _start;
+	};
+
+	/**
+	 * Outcome of one stripe exchange, handed back from a pool thread.
+	 */
+	struct StripeResult
+	{
+		bool                                  sent = false;
+		size_t                                bytes = 0;
+		ResponseStripeReceivedStruct          response;
+		std::chrono::steady_clock::duration   elapsed{};
+		std::string                           error;
+	};
+
+	/**
+	 * Sends one stripe of content on a connection of its own.
+	 * Runs on pool threads: the limiter locks, the counters and metrics are atomic.
+	 */
+	StripeResult exchangeStripe(RateLimiter& limiter, EngineCounters& counters, NetworkConnection& connection,
+		RequestSendStripeStruct request, const std::string& content)
+	{
+		StripeResult result;
+		std::vector<uint8_t> packet(sizeof(request) + request.payloadHeader.stripeSize);
+		memcpy(packet.data(), &request, sizeof(request));
+		memcpy(packet.data() + sizeof(request), content.data() + request.payloadHeader.offset, request.payloadHeader.stripeSize);
+		AllocationAccounting::countCopy(packet.size());
+		result.bytes = packet.size();
+
+		ExchangeScope exchange(limiter, counters, connection, packet.data(), packet.size());
+		const auto start = std::chrono::steady_clock::now();
+		if (!connection.exchangeData(packet.data(), packet.size(), reinterpret_cast<uint8_t*>(&result.response), sizeof(result.response)))
+		{
+			exchange.fail();
+			std::ostringstream error;
+			error << "Stripe transfer failed: " << connection;
+			result.error = error.str();
+			return result;
+		}
+		result.elapsed = std::chrono::steady_clock::now() - start;
+		result.sent = true;
+		counters.recordWire(REQUEST_SEND_STRIPE, Wire::HEADER, sizeof(RequestHeaderStruct) + sizeof(ResponseHeaderStruct));
+		if (result.response.header.code != RESPONSE_STRIPE_RECEIVED) {
+			exchange.reject();
+		}
+		return result;
+	}
+}
+
 //Constructs a new MessageEngine with initialized subsystems
-MessageEngine::MessageEngine() : _configManager(nullptr), _networkManager(nullptr), _cryptoEngine(nullptr)
+MessageEngine::MessageEngine(ThreadPool* sharedPool) : _configManager(nullptr), _networkManager(nullptr), _cryptoEngine(nullptr), _sharedDirectory(nullptr), _rateLimiter(nullptr), _pollScheduler(nullptr), _taskPool(sharedPool), _ownsTaskPool(sharedPool == nullptr), _latencyMetrics(nullptr), _counters(nullptr), _metricsExporter(nullptr), _wireReport(nullptr), _credentialsFile(CLIENT_INFO), m_errorGeneration(0), m_loggedErrorGeneration(0),
+	m_maxStripes(1), m_stripeMinimumBytes(8 << 20), m_connectionThroughput(0), m_serverFeatures(0), m_serverFeaturesKnown(false)
 {
+	StartupTimer timer("engine_init");
 	try {
 		// Initialize subsystem components
 		_configManager = new ConfigManager();
 		_networkManager = new NetworkConnection();
+		_rateLimiter = new RateLimiter();
+		_pollScheduler = new PollScheduler();
+		if (_ownsTaskPool) {
+			_taskPool = new ThreadPool();
+		}
+		_latencyMetrics = new LatencyMetrics();
+		_counters = new EngineCounters();
+		_networkManager->setLatencyMetrics(_latencyMetrics);
+		_networkManager->setEngineCounters(_counters);
 	}
 	catch (const std::bad_alloc& e) {
 		// Handle resource allocation failures
@@ -48,7 +232,21 @@ MessageEngine::~MessageEngine() {
 }
 
 void MessageEngine::cleanup() {
-	// Release resources in optimal order
+	// Release resources in optimal order (exporter first: its final write reads the
+	// other subsystems; then the pool: queued tasks may still run)
+	if (_metricsExporter) {
+		delete _metricsExporter;
+		_metricsExporter = nullptr;
+	}
+	reportWireUsage();
+
+	if (_taskPool) {
+		if (_ownsTaskPool) {
+			delete _taskPool;
+		}
+		_taskPool = nullptr;
+	}
+
 	if (_cryptoEngine) {
 		delete _cryptoEngine;
 		_cryptoEngine = nullptr;
@@ -63,11 +261,129 @@ void MessageEngine::cleanup() {
 		delete _configManager;
 		_configManager = nullptr;
 	}
+
+	if (_sharedDirectory) {
+		delete _sharedDirectory;
+		_sharedDirectory = nullptr;
+	}
+
+	if (_rateLimiter) {
+		delete _rateLimiter;
+		_rateLimiter = nullptr;
+	}
+
+	if (_pollScheduler) {
+		delete _pollScheduler;
+		_pollScheduler = nullptr;
+	}
+
+	if (_latencyMetrics) {
+		delete _latencyMetrics;
+		_latencyMetrics = nullptr;
+	}
+
+	if (_counters) {
+		delete _counters;
+		_counters = nullptr;
+	}
+}
+
+// Maps the host-wide peer directory shared by co-located client processes
+bool MessageEngine::attachSharedDirectory(const std::string& segmentName)
+{
+	if (_sharedDirectory == nullptr) {
+		_sharedDirectory = new SharedPeerDirectory();
+	}
+
+	if (!_sharedDirectory->attach(segmentName))
+	{
+		delete _sharedDirectory;
+		_sharedDirectory = nullptr;
+		clearLastError();
+		m_errorBuffer << "Failed to attach shared peer directory: " << segmentName;
+		return false;
+	}
+	return true;
+}
+
+// Reuses (or stops reusing) one server connection across requests
+void MessageEngine::setPersistentConnection(const bool persistent)
+{
+	_networkManager->setPersistent(persistent);
+}
+
+bool MessageEngine::isPersistentConnection() const
+{
+	return _networkManager->isPersistent();
+}
+
+bool MessageEngine::failedBeforeSending() const
+{
+	return _networkManager->connectFailed();
+}
+
+void MessageEngine::setStriping(const size_t maxStripes, const size_t minimumBytes)
+{
+	m_maxStripes = std::max<size_t>(maxStripes, 1);
+	m_stripeMinimumBytes = minimumBytes;
+}
+
+void MessageEngine::replaceConnection(NetworkConnection* connection)
+{
+	if (connection == nullptr || connection == _networkManager) {
+		return;
+	}
+	if (!_networkManager->getAddress().empty()) {
+		connection->configureEndpoint(_networkManager->getAddress(), _networkManager->getPort());
+	}
+	connection->setPersistent(_networkManager->isPersistent());
+	connection->setLatencyMetrics(_latencyMetrics);
+	connection->setEngineCounters(_counters);
+	delete _networkManager;
+	_networkManager = connection;
+}
+
+size_t MessageEngine::getPeerCount() const
+{
+	const PeerRegistry::ReadGuard snapshot(m_peerRegistry);
+	return snapshot->peers.size();
+}
+
+bool MessageEngine::startMetricsExport(const std::string& path, const std::chrono::milliseconds interval)
+{
+	delete _metricsExporter;
+	_metricsExporter = new MetricsExporter(*this, path, interval);
+	if (!_metricsExporter->isWriting())
+	{
+		delete _metricsExporter;
+		_metricsExporter = nullptr;
+		clearLastError();
+		m_errorBuffer << "Cannot write metrics file: " << path;
+		return false;
+	}
+	return true;
+}
+
+void MessageEngine::reportWireUsage()
+{
+	if (_wireReport != nullptr && _counters != nullptr)
+	{
+		*_wireReport << std::endl;
+		_counters->printWire(*_wireReport);
+		_wireReport = nullptr;
+	}
+}
+
+void MessageEngine::setCredentialsFile(const std::string& path)
+{
+	_credentialsFile = path;
 }
 
 // Parses server connection information from configuration file
 bool MessageEngine::loadServerConfiguration()
 {
+	StartupTimer timer("server_config");
+	ErrorLogScope errors("server_config", m_errorBuffer, m_errorGeneration, m_loggedErrorGeneration);
 	if (!_configManager->openFile(SERVER_INFO))
 	{
 		clearLastError();
@@ -105,14 +421,32 @@ bool MessageEngine::loadServerConfiguration()
 	return true;
 }
 
+void MessageEngine::getServerEndpoint(std::string& address, std::string& port) const
+{
+	address = _networkManager->getAddress();
+	port = _networkManager->getPort();
+}
+
+bool MessageEngine::setServerEndpoint(const std::string& address, const std::string& port)
+{
+	if (!_networkManager->configureEndpoint(address, port))
+	{
+		clearLastError();
+		m_errorBuffer << "Invalid server address or port: " << address << ":" << port;
+		return false;
+	}
+	return true;
+}
+
 
 bool MessageEngine::loadUserCredentials()
 {
+	StartupTimer readTimer("credentials_read");
 	std::string data;
-	if (!_configManager->openFile(CLIENT_INFO))
+	if (!_configManager->openFile(_credentialsFile))
 	{
 		clearLastError();
-		m_errorBuffer << "Failed to open client configuration: " << CLIENT_INFO;
+		m_errorBuffer << "Failed to open client configuration: " << _credentialsFile;
 		return false;
 	}
 
@@ -120,7 +454,7 @@ bool MessageEngine::loadUserCredentials()
 	if (!_configManager->readTextLine(data))
 	{
 		clearLastError();
-		m_errorBuffer << "Failed to read username from " << CLIENT_INFO;
+		m_errorBuffer << "Failed to read username from " << _credentialsFile;
 		return false;
 	}
 
@@ -137,7 +471,7 @@ bool MessageEngine::loadUserCredentials()
 	if (!_configManager->readTextLine(data))
 	{
 		clearLastError();
-		m_errorBuffer << "Failed to read client UUID from " << CLIENT_INFO;
+		m_errorBuffer << "Failed to read client UUID from " << _credentialsFile;
 		return false;
 	}
 
@@ -147,7 +481,7 @@ bool MessageEngine::loadUserCredentials()
 	{
 		memset(m_localUser.id.uuid, 0, sizeof(m_localUser.id.uuid));
 		clearLastError();
-		m_errorBuffer << "Invalid UUID format in " << CLIENT_INFO;
+		m_errorBuffer << "Invalid UUID format in " << _credentialsFile;
 		return false;
 	}
 	memcpy(m_localUser.id.uuid, decodedUuid, sizeof(m_localUser.id.uuid));
@@ -162,18 +496,22 @@ bool MessageEngine::loadUserCredentials()
 	if (privateKey.empty())
 	{
 		clearLastError();
-		m_errorBuffer << "No private key found in " << CLIENT_INFO;
+		m_errorBuffer << "No private key found in " << _credentialsFile;
 		return false;
 	}
+	readTimer.stop();
+
+	StartupTimer keyTimer("credentials_key");
 	try
 	{
 		delete _cryptoEngine;
+		CryptoTimer crypto(_counters);
 		_cryptoEngine = new RSAPrivateWrapper(privateKey);
 	}
 	catch (...)
 	{
 		clearLastError();
-		m_errorBuffer << "Failed to parse private key from " << CLIENT_INFO;
+		m_errorBuffer << "Failed to parse private key from " << _credentialsFile;
 		return false;
 	}
 
@@ -188,8 +526,9 @@ bool MessageEngine::loadUserCredentials()
  */
 std::vector<std::string> MessageEngine::getUsernames() const
 {
-	std::vector<std::string> usernames(m_peerRegistry.size());
-	std::transform(m_peerRegistry.begin(), m_peerRegistry.end(), usernames.begin(),
+	const PeerRegistry::ReadGuard snapshot(m_peerRegistry);
+	std::vector<std::string> usernames(snapshot->peers.size());
+	std::transform(snapshot->peers.begin(), snapshot->peers.end(), usernames.begin(),
 		[](const ClientInfo& client) { return client.username; });
 	std::sort(usernames.begin(), usernames.end());
 	return usernames;
@@ -200,6 +539,7 @@ std::vector<std::string> MessageEngine::getUsernames() const
  */
 void MessageEngine::clearLastError()
 {
+	++m_errorGeneration;
 	const std::stringstream clean;
 	m_errorBuffer.str("");
 	m_errorBuffer.clear();
@@ -207,14 +547,14 @@ void MessageEngine::clearLastError()
 }
 
 /**
- * Store client info to CLIENT_INFO file.
+ * Store client info to the credentials file (CLIENT_INFO unless overridden).
  */
 bool MessageEngine::storeClientInfo()
 {
-	if (!_configManager->openFile(CLIENT_INFO, true))
+	if (!_configManager->openFile(_credentialsFile, true))
 	{
 		clearLastError();
-		m_errorBuffer << "Failed to open " << CLIENT_INFO << " for writing";
+		m_errorBuffer << "Failed to open " << _credentialsFile << " for writing";
 		return false;
 	}
 
@@ -222,7 +562,7 @@ bool MessageEngine::storeClientInfo()
 	if (!_configManager->writeTextLine(m_localUser.username))
 	{
 		clearLastError();
-		m_errorBuffer << "Failed to write username to " << CLIENT_INFO;
+		m_errorBuffer << "Failed to write username to " << _credentialsFile;
 		return false;
 	}
 
@@ -231,7 +571,7 @@ bool MessageEngine::storeClientInfo()
 	if (!_configManager->writeTextLine(hexUUID))
 	{
 		clearLastError();
-		m_errorBuffer << "Failed to write UUID to " << CLIENT_INFO;
+		m_errorBuffer << "Failed to write UUID to " << _credentialsFile;
 		return false;
 	}
 
@@ -240,7 +580,7 @@ bool MessageEngine::storeClientInfo()
 	if (!_configManager->writeBytes(reinterpret_cast<const uint8_t*>(encodedKey.c_str()), encodedKey.size()))
 	{
 		clearLastError();
-		m_errorBuffer << "Failed to write private key to " << CLIENT_INFO;
+		m_errorBuffer << "Failed to write private key to " << _credentialsFile;
 		return false;
 	}
 
@@ -248,6 +588,75 @@ bool MessageEngine::storeClientInfo()
 	return true;
 }
 
+/**
+ * Merge the shared directory's peer list into m_peerRegistry, if it is fresh.
+ */
+bool MessageEngine::loadSharedDirectory()
+{
+	std::vector<SharedPeerDirectory::PeerRecord> peers;
+	int64_t refreshedAt = 0;
+
+	if (_sharedDirectory == nullptr || !_sharedDirectory->isFresh() || !_sharedDirectory->readPeers(peers, refreshedAt))
+		return false;
+
+	std::vector<ClientInfo> registry;
+	registry.reserve(peers.size());
+	for (const auto& peer : peers)
+	{
+		if (peer.id == m_localUser.id)
+			continue;
+
+		ClientInfo client;
+		client.id = peer.id;
+		client.username = peer.username;
+		client.publicKey = peer.publicKey;
+		client.publicKeySet = peer.publicKeySet;
+		registry.push_back(client);
+	}
+
+	if (registry.empty())
+		return false;
+
+	m_peerRegistry.mergeList(std::move(registry));
+	return true;
+}
+
+/**
+ * Publish m_peerRegistry (plus the local user) to the shared directory.
+ */
+void MessageEngine::publishSharedDirectory() const
+{
+	if (_sharedDirectory == nullptr)
+		return;
+
+	const PeerRegistry::ReadGuard snapshot(m_peerRegistry);
+	std::vector<SharedPeerDirectory::PeerRecord> peers;
+	peers.reserve(snapshot->peers.size() + 1);
+	for (const ClientInfo& client : snapshot->peers)
+	{
+		SharedPeerDirectory::PeerRecord peer;
+		peer.id = client.id;
+		peer.username = client.username;
+		peer.publicKey = client.publicKey;
+		peer.publicKeySet = client.publicKeySet;
+		peers.push_back(peer);
+	}
+
+	if (_cryptoEngine != nullptr)
+	{
+		const auto selfKey = _cryptoEngine->getPublicKey();
+		SharedPeerDirectory::PeerRecord self;
+		self.id = m_localUser.id;
+		self.username = m_localUser.username;
+		self.publicKeySet = (selfKey.size() == PUBLIC_KEY_LENGTH);
+		if (self.publicKeySet)
+			memcpy(self.publicKey.publicKey, selfKey.c_str(), PUBLIC_KEY_LENGTH);
+		peers.push_back(self);
+	}
+
+	(void)_sharedDirectory->publishPeers(peers);  // Another process may be refreshing
+}
+
 /**
  * Validate ResponseHeaderStruct upon an expected ResponseCodeEnum.
  */
@@ -285,6 +694,31 @@ bool MessageEngine::validateHeader(const ResponseHeaderStruct& header, const Res
 		expectedSize = sizeof(ResponseMessageSentStruct) - sizeof(ResponseHeaderStruct);
 		break;
 	}
+	case RESPONSE_STRIPE_RECEIVED:
+	{
+		expectedSize = sizeof(ResponseStripeReceivedStruct) - sizeof(ResponseHeaderStruct);
+		break;
+	}
+	case RESPONSE_INBOX_STATUS:
+	{
+		expectedSize = sizeof(ResponseInboxStatusStruct) - sizeof(ResponseHeaderStruct);
+		break;
+	}
+	case RESPONSE_SERVER_INFO:
+	{
+		expectedSize = sizeof(ResponseServerInfoStruct) - sizeof(ResponseHeaderStruct);
+		break;
+	}
+	case RESPONSE_BATCH_SENT:
+	{
+		if (header.payloadSize < sizeof(ResponseBatchSentStruct) - sizeof(ResponseHeaderStruct))
+		{
+			clearLastError();
+			m_errorBuffer << "Invalid payload size: " << header.payloadSize;
+			return false;
+		}
+		return true;  // Entries are checked by sendMessages
+	}
 	default:
 	{
 		return true;
@@ -301,6 +735,29 @@ bool MessageEngine::validateHeader(const ResponseHeaderStruct& header, const Res
 	return true;
 }
 
+/**
+ * Exchange a fixed-size request/response with the server, paced by the rate limiter.
+ */
+bool MessageEngine::exchangeRequest(const uint8_t* const request, const size_t reqSize, uint8_t* const response, const size_t resSize)
+{
+	ExchangeScope exchange(*_rateLimiter, *_counters, *_networkManager, request, reqSize);
+	if (!_networkManager->exchangeData(request, reqSize, response, resSize))
+	{
+		exchange.fail();
+		return false;
+	}
+	_counters->recordWire(reinterpret_cast<const RequestHeaderStruct*>(request)->code, Wire::HEADER,
+		sizeof(RequestHeaderStruct) + sizeof(ResponseHeaderStruct));
+
+	// The server closes the connection after a rejected request
+	if (resSize >= sizeof(ResponseHeaderStruct) &&
+		reinterpret_cast<const ResponseHeaderStruct*>(response)->code == RESPONSE_ERROR) {
+		exchange.reject();
+		_networkManager->releaseConnection(false);
+	}
+	return true;
+}
+
 /**
  * Receive unknown payload. Payload size is parsed from header.
  * Caller responsible for deleting payload upon success.
@@ -312,82 +769,135 @@ bool MessageEngine::receiveUnknownPayload(
 	uint8_t*& payload,
 	size_t& size
 ) {
-	ResponseHeaderStruct response;
-	uint8_t buffer[DEFAULT_PACKET_SIZE];
 	payload = nullptr;
 	size = 0;
 
+	return receivePayload(request, reqSize, expectedCode, [&payload, &size](const size_t payloadSize, const PayloadReader& read) {
+		if (payloadSize == 0) {
+			return true;  // No payload, but successful response
+		}
+
+		// Allocate memory for complete payload
+		std::unique_ptr<uint8_t[]> buffer(new uint8_t[payloadSize]);
+		if (!read(buffer.get(), payloadSize)) {
+			return false;
+		}
+		payload = buffer.release();
+		size = payloadSize;
+		return true;
+	});
+}
+
+/**
+ * Send a request and pass the response payload to a consumer as it arrives.
+ * The server sends whole packets; a read takes whole packets straight into the
+ * destination and serves the rest from one packet buffer.
+ */
+bool MessageEngine::receivePayload(
+	const uint8_t* const request,
+	const size_t reqSize,
+	const ResponseCodeEnum expectedCode,
+	const PayloadConsumer& consume
+) {
+	ResponseHeaderStruct response;
+	uint8_t buffer[DEFAULT_PACKET_SIZE];
+
 	if (request == nullptr || reqSize == 0) {
 		clearLastError();
 		m_errorBuffer << "Invalid request parameters";
 		return false;
 	}
 
-	if (!_networkManager->establishConnection()) {
+	ExchangeScope exchange(*_rateLimiter, *_counters, *_networkManager, request, reqSize);
+	if (!_networkManager->acquireConnection()) {
+		exchange.fail();
 		clearLastError();
 		m_errorBuffer << "Connection failed: " << _networkManager;
 		return false;
 	}
 
 	if (!_networkManager->sendData(request, reqSize)) {
-		_networkManager->disconnectSocket();
+		exchange.fail();
+		_networkManager->releaseConnection(false);
 		clearLastError();
 		m_errorBuffer << "Failed to send request: " << _networkManager;
 		return false;
 	}
 
 	if (!_networkManager->receiveData(buffer, sizeof(buffer))) {
+		exchange.fail();
+		_networkManager->releaseConnection(false);
 		clearLastError();
 		m_errorBuffer << "Failed to receive response header: " << _networkManager;
 		return false;
 	}
 
 	memcpy(&response, buffer, sizeof(ResponseHeaderStruct));
+	_counters->recordWire(reinterpret_cast<const RequestHeaderStruct*>(request)->code, Wire::HEADER,
+		sizeof(RequestHeaderStruct) + sizeof(ResponseHeaderStruct));
 	if (!validateHeader(response, expectedCode)) {
+		exchange.reject();
+		_networkManager->releaseConnection(false);
 		clearLastError();
 		m_errorBuffer << "Invalid response from server: " << _networkManager;
 		return false;
 	}
 
-	if (response.payloadSize == 0) {
-		return true;  // No payload, but successful response
-	}
-
-	// Allocate memory for complete payload
-	size = response.payloadSize;
-	payload = new uint8_t[size];
-
-	// Copy initial payload chunk from buffer
-	uint8_t* ptr = static_cast<uint8_t*>(buffer) + sizeof(ResponseHeaderStruct);
-	size_t receivedSize = sizeof(buffer) - sizeof(ResponseHeaderStruct);
-	if (receivedSize > size) {
-		receivedSize = size;
-	}
-	memcpy(payload, ptr, receivedSize);
+	// The first payload bytes follow the header in the first packet
+	size_t remaining = response.payloadSize;  // Not yet passed to the consumer
+	size_t offset = sizeof(ResponseHeaderStruct);
+	size_t buffered = std::min(sizeof(buffer) - offset, remaining);
+	bool received = true;
 
-	// Receive remaining payload if needed
-	ptr = payload + receivedSize;
-	while (receivedSize < size) {
-		size_t bytesToRead = (size - receivedSize);
-		if (bytesToRead > DEFAULT_PACKET_SIZE) {
-			bytesToRead = DEFAULT_PACKET_SIZE;
+	const PayloadReader read = [&](uint8_t* destination, size_t count) {
+		if (count > remaining) {
+			return false;  // Past the end of the payload
 		}
+		while (count > 0)
+		{
+			if (buffered == 0)
+			{
+				const size_t packets = count / DEFAULT_PACKET_SIZE * DEFAULT_PACKET_SIZE;
+				const size_t readSize = (packets > 0) ? packets : std::min(sizeof(buffer), remaining);
+				if (!_networkManager->receiveData((packets > 0) ? destination : buffer, readSize)) {
+					received = false;
+					return false;
+				}
+				if (packets > 0)
+				{
+					destination += packets;
+					count -= packets;
+					remaining -= packets;
+					continue;
+				}
+				offset = 0;
+				buffered = readSize;
+			}
 
-		if (!_networkManager->receiveData(buffer, bytesToRead)) {
-			clearLastError();
-			m_errorBuffer << "Failed to receive payload data: " << _networkManager;
-			delete[] payload;
-			payload = nullptr;
-			size = 0;
-			return false;
+			const size_t copySize = std::min(count, buffered);
+			memcpy(destination, buffer + offset, copySize);
+			AllocationAccounting::countCopy(copySize);
+			destination += copySize;
+			count -= copySize;
+			offset += copySize;
+			buffered -= copySize;
+			remaining -= copySize;
 		}
+		return true;
+	};
 
-		memcpy(ptr, buffer, bytesToRead);
-		receivedSize += bytesToRead;
-		ptr += bytesToRead;
+	const bool consumed = consume(response.payloadSize, read);
+	if (!received) {
+		exchange.fail();
+		_networkManager->releaseConnection(false);
+		clearLastError();
+		m_errorBuffer << "Failed to receive payload data: " << _networkManager;
+		return false;
 	}
 
-	return true;
+	// A consumer that stops early leaves the rest of the payload on the connection
+	_networkManager->releaseConnection(consumed && remaining == 0);
+	return consumed;
 }
 
 /**
@@ -395,16 +905,18 @@ bool MessageEngine::receiveUnknownPayload(
  */
 bool MessageEngine::setClientPublicKey(const ClientIdStruct& clientID, const PublicKeyStruct& publicKey)
 {
-	for (ClientInfo& client : m_peerRegistry)
-	{
-		if (client.id == clientID)
+	return m_peerRegistry.update([&](std::vector<ClientInfo>& peers) {
+		for (ClientInfo& client : peers)
 		{
-			client.publicKey = publicKey;
-			client.publicKeySet = true;
-			return true;
+			if (client.id == clientID)
+			{
+				client.publicKey = publicKey;
+				client.publicKeySet = true;
+				return true;
+			}
 		}
-	}
-	return false;
+		return false;
+	});
 }
 
 /**
@@ -412,16 +924,18 @@ bool MessageEngine::setClientPublicKey(const ClientIdStruct& clientID, const Pub
  */
 bool MessageEngine::setClientSymmetricKey(const ClientIdStruct& clientID, const SymmetricKeyStruct& symmetricKey)
 {
-	for (ClientInfo& client : m_peerRegistry)
-	{
-		if (client.id == clientID)
+	return m_peerRegistry.update([&](std::vector<ClientInfo>& peers) {
+		for (ClientInfo& client : peers)
 		{
-			client.symmetricKey = symmetricKey;
-			client.symmetricKeySet = true;
-			return true;
+			if (client.id == clientID)
+			{
+				client.symmetricKey = symmetricKey;
+				client.symmetricKeySet = true;
+				return true;
+			}
 		}
-	}
-	return false;
+		return false;
+	});
 }
 
 
@@ -431,15 +945,11 @@ bool MessageEngine::setClientSymmetricKey(const ClientIdStruct& clientID, const
  */
 bool MessageEngine::findClientById(const ClientIdStruct& clientID, ClientInfo& client) const
 {
-	for (const ClientInfo& entry : m_peerRegistry)
-	{
-		if (entry.id == clientID)
-		{
-			client = entry;
-			return true;
-		}
+	const bool found = m_peerRegistry.findById(clientID, client);
+	if (found) {
+		AllocationAccounting::countCopy(sizeof(client) + client.username.size());
 	}
-	return false;
+	return found;
 }
 
 /**
@@ -448,15 +958,11 @@ bool MessageEngine::findClientById(const ClientIdStruct& clientID, ClientInfo& c
  */
 bool MessageEngine::findClientByUsername(const std::string& username, ClientInfo& client) const
 {
-	for (const ClientInfo& entry : m_peerRegistry)
-	{
-		if (username == entry.username)
-		{
-			client = entry;
-			return true;
-		}
+	const bool found = m_peerRegistry.findByName(username, client);
+	if (found) {
+		AllocationAccounting::countCopy(sizeof(client) + client.username.size());
 	}
-	return false; // client invalid.
+	return found;
 }
 
 /**
@@ -464,6 +970,9 @@ bool MessageEngine::findClientByUsername(const std::string& username, ClientInfo
  */
 bool MessageEngine::registerClient(const std::string& username)
 {
+	LatencyTimer timer(_latencyMetrics, LatencyMetrics::Operation::REGISTER);
+	TraceSpan span("engine", "register");
+	ErrorLogScope errors("register", m_errorBuffer, m_errorGeneration, m_loggedErrorGeneration);
 	RequestRegistrationStruct  request;
 	ResponseRegistrationStruct response;
 
@@ -486,7 +995,7 @@ bool MessageEngine::registerClient(const std::string& username)
 
 	// Generate new RSA key pair
 	delete _cryptoEngine;
-	_cryptoEngine = new RSAPrivateWrapper();
+	_cryptoEngine = timeCrypto(_counters, []() { return new RSAPrivateWrapper(); });
 	const auto publicKey = _cryptoEngine->getPublicKey();
 
 	if (publicKey.size() != PUBLIC_KEY_LENGTH)
@@ -502,17 +1011,20 @@ bool MessageEngine::registerClient(const std::string& username)
 	memcpy(request.payload.clientPublicKey.publicKey, publicKey.c_str(), sizeof(request.payload.clientPublicKey.publicKey));
 
 	// Send request and receive response
-	if (!_networkManager->exchangeData(reinterpret_cast<const uint8_t* const>(&request), sizeof(request),
+	if (!exchangeRequest(reinterpret_cast<const uint8_t* const>(&request), sizeof(request),
 		reinterpret_cast<uint8_t* const>(&response), sizeof(response)))
 	{
 		clearLastError();
 		m_errorBuffer << "Communication with server failed: " << _networkManager;
 		return false;
 	}
+	_counters->recordWire(REQUEST_REGISTRATION, Wire::PAYLOAD, username.size() + sizeof(request.payload.clientPublicKey));
+	_counters->recordWire(REQUEST_REGISTRATION, Wire::FIELD_PADDING, sizeof(request.payload.clientName) - username.size());
 
 	// Validate response
 	if (!validateHeader(response.header, RESPONSE_REGISTRATION))
 		return false;	  // Error message set by validateHeader
+	_counters->recordWire(REQUEST_REGISTRATION, Wire::PAYLOAD, sizeof(response.payload));
 
 	// Store client info
 	m_localUser.id = response.payload;
@@ -534,6 +1046,9 @@ bool MessageEngine::registerClient(const std::string& username)
  */
 bool MessageEngine::requestClientsList()
 {
+	LatencyTimer timer(_latencyMetrics, LatencyMetrics::Operation::CLIENTS_LIST);
+	TraceSpan span("engine", "clients_list");
+	ErrorLogScope errors("clients_list", m_errorBuffer, m_errorGeneration, m_loggedErrorGeneration);
 	RequestClientsListStruct request(m_localUser.id);
 	uint8_t* payload = nullptr;
 	uint8_t* ptr = nullptr;
@@ -546,6 +1061,10 @@ bool MessageEngine::requestClientsList()
 		ClientNameStruct clientName;
 	}clientEntry;
 
+	// Served from the host-wide directory while another process keeps it fresh
+	if (loadSharedDirectory())
+		return true;
+
 	if (!receiveUnknownPayload(reinterpret_cast<uint8_t*>(&request), sizeof(request), RESPONSE_USERS, payload, payloadSize))
 		return false;  // Error message set by receiveUnknownPayload
 
@@ -566,20 +1085,33 @@ bool MessageEngine::requestClientsList()
 	}
 
 	ptr = payload;
-	m_peerRegistry.clear();
+	std::vector<ClientInfo> registry;
+	registry.reserve(payloadSize / sizeof(clientEntry));
 
 	while (parsedBytes < payloadSize)
 	{
 		memcpy(&clientEntry, ptr, sizeof(clientEntry));
+		AllocationAccounting::countCopy(sizeof(clientEntry));
 		ptr += sizeof(clientEntry);
 		parsedBytes += sizeof(clientEntry);
 
 		// Ensure null termination of client name
 		clientEntry.clientName.name[sizeof(clientEntry.clientName.name) - 1] = '\0';
+		const size_t nameLength = strlen(reinterpret_cast<const char*>(clientEntry.clientName.name));
+		_counters->recordWire(REQUEST_CLIENTS_LIST, Wire::PAYLOAD, sizeof(clientEntry.clientId) + nameLength);
+		_counters->recordWire(REQUEST_CLIENTS_LIST, Wire::FIELD_PADDING, sizeof(clientEntry.clientName) - nameLength);
 
-		m_peerRegistry.push_back({ clientEntry.clientId, reinterpret_cast<char*>(clientEntry.clientName.name) });
+		ClientInfo client;
+		client.id = clientEntry.clientId;
+		client.username = reinterpret_cast<char*>(clientEntry.clientName.name);
+		registry.push_back(client);
 	}
 	delete[] payload;
+
+	// Keys already exchanged with peers that are still registered survive the refresh
+	m_peerRegistry.mergeList(std::move(registry));
+
+	publishSharedDirectory();
 	return true;
 }
 
@@ -589,6 +1121,9 @@ bool MessageEngine::requestClientsList()
  */
 bool MessageEngine::requestClientPublicKey(const std::string& username)
 {
+	LatencyTimer timer(_latencyMetrics, LatencyMetrics::Operation::PUBLIC_KEY);
+	TraceSpan span("engine", "public_key");
+	ErrorLogScope errors("public_key", m_errorBuffer, m_errorGeneration, m_loggedErrorGeneration);
 	RequestPublicKeyStruct  request(m_localUser.id);
 	ResponsePublicKeyStruct response;
 	ClientInfo            client;
@@ -610,18 +1145,28 @@ bool MessageEngine::requestClientPublicKey(const std::string& username)
 
 	request.payload = client.id;
 
+	// Use a key already published by a co-located client
+	PublicKeyStruct sharedKey;
+	if (_sharedDirectory != nullptr && _sharedDirectory->findPublicKey(client.id, sharedKey)
+		&& setClientPublicKey(client.id, sharedKey))
+	{
+		return true;
+	}
+
 	// Request public key from server
-	if (!_networkManager->exchangeData(reinterpret_cast<const uint8_t* const>(&request), sizeof(request),
+	if (!exchangeRequest(reinterpret_cast<const uint8_t* const>(&request), sizeof(request),
 		reinterpret_cast<uint8_t* const>(&response), sizeof(response)))
 	{
 		clearLastError();
 		m_errorBuffer << "Communication with server failed: " << _networkManager;
 		return false;
 	}
+	_counters->recordWire(REQUEST_PUBLIC_KEY, Wire::PAYLOAD, sizeof(request.payload));
 
 	// Validate response
 	if (!validateHeader(response.header, RESPONSE_PUBLIC_KEY))
 		return false;  // error message set by validateHeader.
+	_counters->recordWire(REQUEST_PUBLIC_KEY, Wire::PAYLOAD, sizeof(response.payload));
 
 	if (request.payload != response.payload.clientId)
 	{
@@ -637,6 +1182,9 @@ bool MessageEngine::requestClientPublicKey(const std::string& username)
 		m_errorBuffer << "Failed to store public key for " << username << ". Please refresh user list.";
 		return false;
 	}
+
+	if (_sharedDirectory != nullptr)
+		(void)_sharedDirectory->publishPublicKey(response.payload.clientId, response.payload.clientPublicKey);
 	return true;
 }
 
@@ -646,185 +1194,316 @@ bool MessageEngine::requestClientPublicKey(const std::string& username)
  */
 bool MessageEngine::retrievePendingMessages(std::vector<MessageData>& messages)
 {
-	RequestMessagesStruct  request(m_localUser.id);
-	uint8_t* payload = nullptr;
-	uint8_t* ptr = nullptr;
-	size_t   payloadSize = 0;
-	size_t   parsedBytes = 0;
-
 	messages.clear();
+	return retrievePendingMessages([&messages](MessageData&& message) {
+		messages.push_back(std::move(message));
+	});
+}
 
-	if (!receiveUnknownPayload(reinterpret_cast<uint8_t*>(&request), sizeof(request), RESPONSE_PENDING_MSG, payload, payloadSize))
-		return false; // Error message set by receiveUnknownPayload
 
-	if (payloadSize == 0)
-	{
-		delete[] payload;
-		clearLastError();
-		m_errorBuffer << "No pending messages";
-		return false;
-	}
-	if (payload == nullptr || payloadSize < sizeof(PendingMessageStruct))
-	{
-		delete[] payload;
-		clearLastError();
-		m_errorBuffer << "Invalid response payload";
-		return false;
-	}
+/**
+ * Invoke logic: request pending messages from server and hand them over one by one.
+ */
+bool MessageEngine::retrievePendingMessages(const MessageHandler& handler)
+{
+	LatencyTimer timer(_latencyMetrics, LatencyMetrics::Operation::PENDING_MESSAGES);
+	TraceSpan span("engine", "pending_messages");
+	ErrorLogScope errors("pending_messages", m_errorBuffer, m_errorGeneration, m_loggedErrorGeneration);
+	RequestMessagesStruct request(m_localUser.id);
+
+	// Message content splits into plaintext and cipher expansion once decrypted
+	const auto recordContent = [this](const size_t cipherSize, const size_t plainSize) {
+		const size_t payloadSize = std::min(cipherSize, plainSize);
+		_counters->recordWire(REQUEST_PENDING_MSG, Wire::PAYLOAD, payloadSize);
+		_counters->recordWire(REQUEST_PENDING_MSG, Wire::EXPANSION, cipherSize - payloadSize);
+	};
 
-	clearLastError();
-	ptr = payload;
-	while (parsedBytes < payloadSize)
+	// Messages read but not yet handed over, in inbox order. Text and file messages
+	// are decrypted on the task pool meanwhile, with the sender's key as it was when
+	// the message was read, so a key delivered earlier in the same inbox is honored.
+	using DecryptResult = std::pair<bool, std::string>;
+	struct PendingMessage
 	{
-		ClientInfo      client;
-		MessageData     message;
-		const size_t msgHeaderSize = sizeof(PendingMessageStruct);
-		const auto   header = reinterpret_cast<PendingMessageStruct*>(ptr);
-		const size_t remainingBytes = payloadSize - parsedBytes;
+		MessageData                message;
+		size_t                     cipherSize = 0;
+		std::future<DecryptResult> decrypted;  // Not valid when there is nothing to decrypt
+	};
+	std::deque<PendingMessage> inFlight;
+	const size_t window = _taskPool->getWorkerCount() + 1;  // Most messages held back at once
+
+	const auto isReady = [](const PendingMessage& pending) {
+		return !pending.decrypted.valid() || pending.decrypted.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+	};
+
+	// Hands the oldest message over, waiting for its decryption; files that cannot be saved are dropped
+	const auto deliver = [&]() {
+		PendingMessage pending = std::move(inFlight.front());
+		inFlight.pop_front();
+		MessageData& message = pending.message;
 
-		// Validate message structure
-		if ((msgHeaderSize > remainingBytes) || (msgHeaderSize + header->messageSize) > remainingBytes)
+		if (pending.decrypted.valid())
 		{
-			delete[] payload;
-			clearLastError();
-			m_errorBuffer << "Corrupted message data detected";
-			return false;
-		}
+			DecryptResult result = pending.decrypted.get();
+			_counters->recordDecryption(result.first);
+			recordContent(pending.cipherSize, result.first ? result.second.size() : pending.cipherSize);
 
-		//Resolve username
-		if (findClientById(header->clientId, client))
-		{
-			message.username = client.username;
-		}
-		else
-		{
-			// Handle unknown client ID
-			message.username = "Unknown client: ";
-			message.username.append(StringUtility::hex(header->clientId.uuid, sizeof(header->clientId.uuid)));
+			if (!result.first)
+			{
+				m_errorBuffer << "\tMessage #" << message.messageId << ": Failed to decrypt content" << std::endl;
+			}
+			else if (message.type == MSG_FILE)
+			{
+				// Set filename with timestamp.
+				std::stringstream filepath;
+				filepath << _configManager->getTemporaryDirectory() << "\\MessageU\\" << message.username << "_" << StringUtility::getTimestamp();
+
+				if (!_configManager->writeFileComplete(filepath.str(), result.second))
+				{
+					m_errorBuffer << "\tMessage #" << message.messageId << ": Failed to save file" << std::endl;
+					return;
+				}
+				message.content = filepath.str();
+				message.decrypted = true;
+			}
+			else  // Message text
+			{
+				message.content = std::move(result.second);
+				message.decrypted = true;
+			}
 		}
 
-		ptr += msgHeaderSize;
-		parsedBytes += msgHeaderSize;
+		handler(std::move(message));
+	};
 
-		// Process message based on type
-		switch (header->messageType)
+	bool empty = false;
+	EngineCounters* const counters = _counters;
+	const bool success = receivePayload(reinterpret_cast<uint8_t*>(&request), sizeof(request), RESPONSE_PENDING_MSG,
+		[&](const size_t payloadSize, const PayloadReader& read) -> bool {
+		clearLastError();
+		if (payloadSize == 0)
 		{
-		case MSG_SYMMETRIC_KEY_REQUEST:
+			empty = true;  // An empty inbox is a successful (empty) retrieval
+			return true;
+		}
+		if (payloadSize < sizeof(PendingMessageStruct))
 		{
-			message.content = "Request for symmetric key";
-			messages.push_back(message);
-			break;
+			m_errorBuffer << "Invalid response payload";
+			return false;
 		}
 
-		case MSG_SYMMETRIC_KEY_SEND:
+		size_t parsedBytes = 0;
+		while (parsedBytes < payloadSize)
 		{
-			if (header->messageSize == 0)
+			ClientInfo           client;
+			MessageData          message;
+			PendingMessageStruct header;
+			const size_t msgHeaderSize = sizeof(PendingMessageStruct);
+
+			// Validate message structure
+			if (msgHeaderSize > payloadSize - parsedBytes)
 			{
-				m_errorBuffer << "\tMessage #" << header->messageId << ": Invalid symmetric key (empty content)" << std::endl;
-				parsedBytes += header->messageSize;
-				ptr += header->messageSize;
-				continue;
+				clearLastError();
+				m_errorBuffer << "Corrupted message data detected";
+				return false;
+			}
+			if (!read(reinterpret_cast<uint8_t*>(&header), msgHeaderSize))
+				return false;  // Error message set by receivePayload
+			parsedBytes += msgHeaderSize;
+			if (header.messageSize > payloadSize - parsedBytes)
+			{
+				clearLastError();
+				m_errorBuffer << "Corrupted message data detected";
+				return false;
 			}
 
-			std::string key;
-			try
+			std::unique_ptr<uint8_t[]> content(new uint8_t[header.messageSize]);
+			if (header.messageSize > 0 && !read(content.get(), header.messageSize))
+				return false;  // Error message set by receivePayload
+			parsedBytes += header.messageSize;
+
+			message.senderId = header.clientId;
+			message.messageId = header.messageId;
+			message.type = header.messageType;
+			message.size = header.messageSize;
+			_counters->recordWire(REQUEST_PENDING_MSG, Wire::HEADER, msgHeaderSize);
+
+			//Resolve username
+			if (findClientById(header.clientId, client))
 			{
-				key = _cryptoEngine->decrypt(ptr, header->messageSize);
+				message.username = client.username;
 			}
-			catch (...)
+			else
 			{
-
-				m_errorBuffer << "\tMessage #" << header->messageId << ": Failed to decrypt symmetric key" << std::endl;
-				parsedBytes += header->messageSize;
-				ptr += header->messageSize;
-				continue;
+				// Handle unknown client ID
+				message.username = "Unknown client: ";
+				message.username.append(StringUtility::hex(header.clientId.uuid, sizeof(header.clientId.uuid)));
 			}
 
-			const size_t keySize = key.size();
-			if (keySize != SYMMETRIC_KEY_LENGTH)  // invalid symmetric key
+			PendingMessage pending;
+
+			// Process message based on type
+			switch (header.messageType)
+			{
+			case MSG_SYMMETRIC_KEY_REQUEST:
 			{
-				m_errorBuffer << "\tMessage #" << header->messageId << ": Invalid symmetric key length (" << key.size() << ")" << std::endl;
+				message.content = "Request for symmetric key";
+				break;
 			}
-			else
+
+			case MSG_SYMMETRIC_KEY_SEND:
 			{
-				memcpy(client.symmetricKey.symmetricKey, key.c_str(), keySize);
-				if (setClientSymmetricKey(header->clientId, client.symmetricKey))
+				if (header.messageSize == 0)
 				{
-					message.content = "Symmetric key received";
-					messages.push_back(message);
+					m_errorBuffer << "\tMessage #" << header.messageId << ": Invalid symmetric key (empty content)" << std::endl;
+					continue;
 				}
-				else
+
+				std::string key;
+				try
 				{
-					m_errorBuffer << "\tMessage #" << header->messageId << ": Failed to store symmetric key for " << message.username << std::endl;
+					CryptoTimer crypto(_counters);
+					key = _cryptoEngine->decrypt(content.get(), header.messageSize);
+				}
+				catch (...)
+				{
+					_counters->recordDecryption(false);
+					recordContent(header.messageSize, header.messageSize);
+					m_errorBuffer << "\tMessage #" << header.messageId << ": Failed to decrypt symmetric key" << std::endl;
+					continue;
 				}
-			}
-			parsedBytes += header->messageSize;
-			ptr += header->messageSize;
-			break;
-		}
 
-		case MSG_TEXT:
-		case MSG_FILE:
-		{
-			if (header->messageSize == 0)
-			{
-				m_errorBuffer << "\tMessage #" << header->messageId << ": Empty message content" << std::endl;
-				parsedBytes += header->messageSize;
-				ptr += header->messageSize;
-				continue;
+				const size_t keySize = key.size();
+				_counters->recordDecryption(keySize == SYMMETRIC_KEY_LENGTH);
+				recordContent(header.messageSize, keySize);
+				if (keySize != SYMMETRIC_KEY_LENGTH)  // invalid symmetric key
+				{
+					m_errorBuffer << "\tMessage #" << header.messageId << ": Invalid symmetric key length (" << key.size() << ")" << std::endl;
+					continue;
+				}
+				memcpy(client.symmetricKey.symmetricKey, key.c_str(), keySize);
+				if (!setClientSymmetricKey(header.clientId, client.symmetricKey))
+				{
+					m_errorBuffer << "\tMessage #" << header.messageId << ": Failed to store symmetric key for " << message.username << std::endl;
+					continue;
+				}
+				message.content = "Symmetric key received";
+				break;
 			}
 
-			message.content = "Cannot decrypt message"; // Default error message
-			bool addToQueue = true;
-
-			if (client.symmetricKeySet)
+			case MSG_TEXT:
+			case MSG_FILE:
 			{
-				AESWrapper aes(client.symmetricKey);
-				std::string decryptedData;
-
-				try
+				if (header.messageSize == 0)
 				{
-					decryptedData = aes.decrypt(ptr, header->messageSize);
+					m_errorBuffer << "\tMessage #" << header.messageId << ": Empty message content" << std::endl;
+					continue;
 				}
-				catch (...) {} // Keep default error message
 
-				if (header->messageType == MSG_FILE)
+				message.content = "Cannot decrypt message"; // Default error message
+				message.decrypted = false;
+
+				if (!client.symmetricKeySet)
 				{
-					// Set filename with timestamp.
-					std::stringstream filepath;
-					filepath << _configManager->getTemporaryDirectory() << "\\MessageU\\" << message.username << "_" << StringUtility::getTimestamp();
-					message.content = filepath.str();
+					_counters->recordDecryption(false);  // No symmetric key for this sender
+					recordContent(header.messageSize, header.messageSize);
+					break;
+				}
 
-					if (!_configManager->writeFileComplete(message.content, decryptedData))
+				auto decrypt = [content = std::move(content), size = header.messageSize, key = client.symmetricKey, counters]() -> DecryptResult {
+					try
+					{
+						CryptoTimer crypto(counters);
+						AESWrapper aes(key);
+						return DecryptResult(true, aes.decrypt(content.get(), size));
+					}
+					catch (...)
 					{
-						m_errorBuffer << "\tMessage #" << header->messageId << ": Failed to save file" << std::endl;
-						addToQueue = false;
+						return DecryptResult(false, std::string());
 					}
+				};
+
+				pending.cipherSize = header.messageSize;
+				if (parsedBytes < payloadSize)
+				{
+					pending.decrypted = _taskPool->submit(std::move(decrypt), TaskPriority::HIGH);
 				}
-				else  // Message text
+				else
 				{
-					message.content = decryptedData;
+					// The last message is decrypted here: nothing is left to read meanwhile
+					std::promise<DecryptResult> inlineResult;
+					inlineResult.set_value(decrypt());
+					pending.decrypted = inlineResult.get_future();
 				}
+				break;
+			}
+			default:
+			{
+				continue;  // Corrupted message. Don't store.
 			}
-
-			if (addToQueue) {
-				messages.push_back(message);
 			}
 
-			parsedBytes += header->messageSize;
-			ptr += header->messageSize;
-			break;
-		}
-		default:
-		{
-			message.content = ""; // Corrupted message. Don't store.
-			break;
-		}
+			AllocationAccounting::countCopy(messageBytes(message));
+			pending.message = std::move(message);
+			inFlight.push_back(std::move(pending));
+
+			// Hand over everything ready in order; wait only when too much is held back
+			while (!inFlight.empty() && (inFlight.size() > window || isReady(inFlight.front()))) {
+				deliver();
+			}
 		}
+		return true;
+	});
 
+	// Messages read before a failure are still handed over
+	while (!inFlight.empty()) {
+		deliver();
 	}
 
-	delete[] payload;
+	if (!success)
+		return false;  // Error message set by receivePayload or the parser
+
+	if (empty) {
+		_pollScheduler->recordEmptyPoll();
+	}
+	else {
+		_pollScheduler->recordActivity();
+	}
+	return true;
+}
+
+/**
+ * Ask the server for the pending messages count and size, leaving the inbox untouched.
+ */
+bool MessageEngine::probeInbox(InboxStatus& status)
+{
+	LatencyTimer timer(_latencyMetrics, LatencyMetrics::Operation::INBOX_PROBE);
+	TraceSpan span("engine", "inbox_probe");
+	ErrorLogScope errors("inbox_probe", m_errorBuffer, m_errorGeneration, m_loggedErrorGeneration);
+	RequestInboxProbeStruct   request(m_localUser.id);
+	ResponseInboxStatusStruct response;
+	status = InboxStatus();
+
+	if (!exchangeRequest(reinterpret_cast<const uint8_t* const>(&request), sizeof(request),
+		reinterpret_cast<uint8_t* const>(&response), sizeof(response)))
+	{
+		clearLastError();
+		m_errorBuffer << "Communication with server failed: " << _networkManager;
+		return false;
+	}
+
+	status.supported = (response.header.code != RESPONSE_ERROR);
+	if (!validateHeader(response.header, RESPONSE_INBOX_STATUS))
+		return false;  // Error message set by validateHeader
+	_counters->recordWire(REQUEST_INBOX_PROBE, Wire::PAYLOAD, sizeof(response.payload));
+
+	status.messages = response.payload.messageCount;
+	status.bytes = response.payload.totalBytes;
+	status.pollHint = std::chrono::milliseconds(response.payload.pollHintMs);
+
+	_pollScheduler->setServerHint(status.pollHint);
+	if (status.messages == 0) {
+		_pollScheduler->recordEmptyPoll();
+	}
 	return true;
 }
 
@@ -832,10 +1511,15 @@ bool MessageEngine::retrievePendingMessages(std::vector<MessageData>& messages)
 // Send a message to another client via the server.
 bool MessageEngine::sendMessage(const std::string& username, const MessageTypeEnum type, const std::string& data)
 {
+	LatencyTimer timer(_latencyMetrics, LatencyMetrics::sendOperation(type));
+	TraceSpan span("engine", LatencyMetrics::operationName(LatencyMetrics::sendOperation(type)));
+	ErrorLogScope errors(LatencyMetrics::operationName(LatencyMetrics::sendOperation(type)), m_errorBuffer,
+		m_errorGeneration, m_loggedErrorGeneration);
 	ClientInfo              client; // client to send to
 	RequestSendMessageStruct  request(m_localUser.id, (type));
 	ResponseMessageSentStruct response;
 	uint8_t* content = nullptr;
+	size_t plainSize = 0;  // Content size before encryption
 
 	std::map<const MessageTypeEnum, const std::string> messageTypeNames = {
 		{MSG_SYMMETRIC_KEY_REQUEST, "symmetric key request"},
@@ -883,7 +1567,9 @@ bool MessageEngine::sendMessage(const std::string& username, const MessageTypeEn
 
 		// Encrypt symmetric key with recipient's public key
 		RSAPublicWrapper rsa(client.publicKey);
-		const std::string encryptedKey = rsa.encrypt(symKey.symmetricKey, sizeof(symKey.symmetricKey));
+		const std::string encryptedKey = timeCrypto(_counters, [&]() {
+			return rsa.encrypt(symKey.symmetricKey, sizeof(symKey.symmetricKey));
+		});
 
 
 		// Validate size for transmission
@@ -896,6 +1582,8 @@ bool MessageEngine::sendMessage(const std::string& username, const MessageTypeEn
 		request.payloadHeader.contentSize = static_cast<csize_t>(encryptedKey.size());
 		content = new uint8_t[request.payloadHeader.contentSize];
 		memcpy(content, encryptedKey.c_str(), request.payloadHeader.contentSize);
+		plainSize = sizeof(symKey.symmetricKey);
+		AllocationAccounting::countCopy(request.payloadHeader.contentSize);
 	}
 	else if (type == MSG_TEXT || type == MSG_FILE)
 	{
@@ -926,12 +1614,13 @@ bool MessageEngine::sendMessage(const std::string& username, const MessageTypeEn
 
 		// Encrypt content
 		AESWrapper aes(client.symmetricKey);
-		const std::string encrypted = (type == MSG_TEXT)
-			? aes.encrypt(data)
-			: aes.encrypt(fileData, fileSize);
+		const std::string encrypted = timeCrypto(_counters, [&]() {
+			return (type == MSG_TEXT) ? aes.encrypt(data) : aes.encrypt(fileData, fileSize);
+		});
 
 		// Clean up file data if needed
 		delete[] fileData;
+		plainSize = (type == MSG_TEXT) ? data.size() : fileSize;
 
 
 		// Validate size for transmission
@@ -941,9 +1630,17 @@ bool MessageEngine::sendMessage(const std::string& username, const MessageTypeEn
 			return false;
 		}
 
+		// Large files may go out over several connections at once
+		const size_t stripes = (type == MSG_FILE && m_maxStripes > 1 && encrypted.size() >= m_stripeMinimumBytes)
+			? chooseStripeCount(encrypted.size()) : 1;
+		if (stripes > 1) {
+			return sendStriped(client.id, type, encrypted, plainSize, stripes);
+		}
+
 		request.payloadHeader.contentSize = static_cast<csize_t>(encrypted.size());
 		content = new uint8_t[request.payloadHeader.contentSize];
 		memcpy(content, encrypted.c_str(), request.payloadHeader.contentSize);
+		AllocationAccounting::countCopy(request.payloadHeader.contentSize);
 	}
 
 	// prepare message to send
@@ -961,11 +1658,14 @@ bool MessageEngine::sendMessage(const std::string& username, const MessageTypeEn
 		msgPacket = new uint8_t[sizeof(request) + request.payloadHeader.contentSize];
 		memcpy(msgPacket, &request, sizeof(request));
 		memcpy(msgPacket + sizeof(request), content, request.payloadHeader.contentSize);
+		AllocationAccounting::countCopy(sizeof(request) + request.payloadHeader.contentSize);
 		msgSize = sizeof(request) + request.payloadHeader.contentSize;
 	}
 
 	// Send message and receive confirmation
-	bool success = _networkManager->exchangeData(msgPacket, msgSize, reinterpret_cast<uint8_t* const>(&response), sizeof(response));
+	const auto sendStart = std::chrono::steady_clock::now();
+	bool success = exchangeRequest(msgPacket, msgSize, reinterpret_cast<uint8_t* const>(&response), sizeof(response));
+	const auto sendTime = std::chrono::steady_clock::now() - sendStart;
 
 	// Clean up resources
 	delete[] content;
@@ -976,10 +1676,14 @@ bool MessageEngine::sendMessage(const std::string& username, const MessageTypeEn
 		m_errorBuffer << "Communication with server failed: " << _networkManager;
 		return false;
 	}
+	_counters->recordWire(REQUEST_SEND_MSG, Wire::HEADER, sizeof(request.payloadHeader));
+	_counters->recordWire(REQUEST_SEND_MSG, Wire::PAYLOAD, plainSize);
+	_counters->recordWire(REQUEST_SEND_MSG, Wire::EXPANSION, request.payloadHeader.contentSize - plainSize);
 
 	// Validate response
 	if (!validateHeader(response.header, RESPONSE_MSG_SENT))
 		return false;  // Error message set by validateHeade
+	_counters->recordWire(REQUEST_SEND_MSG, Wire::PAYLOAD, sizeof(response.payload));
 
 	if (request.payloadHeader.clientId != response.payload.clientId)
 	{
@@ -987,6 +1691,412 @@ bool MessageEngine::sendMessage(const std::string& username, const MessageTypeEn
 		m_errorBuffer << "Unexpected clientID was received.";
 		return false;
 	}
+	recordThroughput(msgSize, sendTime);
+	_pollScheduler->recordActivity();  // A reply is likely soon
+	return true;
+}
+
+/**
+ * Send many messages in as few requests as possible: recipients are resolved
+ * and files read first, then every content is encrypted on the task pool.
+ */
+bool MessageEngine::sendMessages(const std::vector<BatchEntry>& batch, std::vector<messageID_t>& messageIds)
+{
+	LatencyTimer timer(_latencyMetrics, LatencyMetrics::Operation::SEND_BATCH);
+	TraceSpan span("engine", "send_batch");
+	ErrorLogScope errors("send_batch", m_errorBuffer, m_errorGeneration, m_loggedErrorGeneration);
+	using SentEntry = ResponseMessageSentStruct::PayloadStruct;
+	constexpr size_t MAX_PAYLOAD = std::numeric_limits<csize_t>::max();
+	messageIds.clear();
+
+	if (batch.empty())
+	{
+		clearLastError();
+		m_errorBuffer << "No messages to send";
+		return false;
+	}
+	if (batch.size() > BATCH_MAX_ENTRIES)
+	{
+		clearLastError();
+		m_errorBuffer << "Too many messages in one batch (" << batch.size() << ", at most " << BATCH_MAX_ENTRIES << ")";
+		return false;
+	}
+
+	// Everything that can fail locally is checked before the first request
+	std::vector<ClientInfo> recipients(batch.size());
+	std::vector<std::unique_ptr<uint8_t[]>> files(batch.size());
+	std::vector<size_t> plainSizes(batch.size());
+	for (size_t i = 0; i < batch.size(); ++i)
+	{
+		const BatchEntry& entry = batch[i];
+		ClientInfo& client = recipients[i];
+
+		if (entry.type != MSG_TEXT && entry.type != MSG_FILE)
+		{
+			clearLastError();
+			m_errorBuffer << "Message " << (i + 1) << ": only text messages and files can be batched";
+			return false;
+		}
+		if (entry.data.empty())
+		{
+			clearLastError();
+			m_errorBuffer << "Message " << (i + 1) << ": no content provided";
+			return false;
+		}
+		if (entry.username == m_localUser.username)
+		{
+			clearLastError();
+			m_errorBuffer << "Message " << (i + 1) << ": cannot send to yourself";
+			return false;
+		}
+		if (!findClientByUsername(entry.username, client))
+		{
+			clearLastError();
+			m_errorBuffer << "Message " << (i + 1) << ": user '" << entry.username << "' not found. Please refresh the user list.";
+			return false;
+		}
+		if (!client.symmetricKeySet)
+		{
+			clearLastError();
+			m_errorBuffer << "Message " << (i + 1) << ": symmetric key for " << client.username << " not available";
+			return false;
+		}
+
+		plainSizes[i] = entry.data.size();
+		if (entry.type == MSG_FILE)
+		{
+			uint8_t* fileData = nullptr;
+			if (!_configManager->readFileComplete(entry.data, fileData, plainSizes[i]))
+			{
+				clearLastError();
+				m_errorBuffer << "Message " << (i + 1) << ": file not found: " << entry.data;
+				return false;
+			}
+			files[i].reset(fileData);
+		}
+	}
+
+	// Encrypt in parallel; a single entry runs inline to avoid the hand-off
+	using EncryptResult = std::pair<bool, std::string>;
+	std::vector<std::future<EncryptResult>> encrypting;
+	encrypting.reserve(batch.size());
+	EngineCounters* const counters = _counters;
+	for (size_t i = 0; i < batch.size(); ++i)
+	{
+		const SymmetricKeyStruct key = recipients[i].symmetricKey;
+		const uint8_t* const plain = files[i] ? files[i].get() : reinterpret_cast<const uint8_t*>(batch[i].data.data());
+		const size_t plainSize = plainSizes[i];
+		auto encrypt = [key, plain, plainSize, counters]() -> EncryptResult {
+			try
+			{
+				CryptoTimer crypto(counters);
+				AESWrapper aes(key);
+				return EncryptResult(true, aes.encrypt(plain, plainSize));
+			}
+			catch (...)
+			{
+				return EncryptResult(false, std::string());
+			}
+		};
+
+		if (batch.size() > 1)
+		{
+			encrypting.push_back(_taskPool->submit(encrypt, TaskPriority::HIGH));
+		}
+		else
+		{
+			std::promise<EncryptResult> inlineResult;
+			inlineResult.set_value(encrypt());
+			encrypting.push_back(inlineResult.get_future());
+		}
+	}
+
+	// Every task must finish before the plaintext it reads is released
+	std::vector<std::string> contents(batch.size());
+	size_t failed = 0;
+	for (size_t i = 0; i < batch.size(); ++i)
+	{
+		EncryptResult result = encrypting[i].get();
+		if (!result.first || result.second.size() > MAX_PAYLOAD - sizeof(RequestSendBatchStruct::PayloadHeaderStruct) - sizeof(BatchEntryStruct))
+		{
+			failed = (failed == 0) ? i + 1 : failed;
+			continue;
+		}
+		contents[i] = std::move(result.second);
+	}
+	files.clear();
+	if (failed != 0)
+	{
+		clearLastError();
+		m_errorBuffer << "Message " << failed << ": encryption failed or content exceeds maximum transmission size";
+		return false;
+	}
+
+	// One request, so the server stores the whole batch or none of it
+	uint64_t payloadSize = sizeof(RequestSendBatchStruct::PayloadHeaderStruct);
+	for (const std::string& content : contents) {
+		payloadSize += sizeof(BatchEntryStruct) + content.size();
+	}
+	if (payloadSize > MAX_PAYLOAD)
+	{
+		clearLastError();
+		m_errorBuffer << "Batch exceeds maximum transmission size; send it in smaller batches";
+		return false;
+	}
+
+	RequestSendBatchStruct header(m_localUser.id);
+	header.header.payloadSize = static_cast<csize_t>(payloadSize);
+	header.payloadHeader.entryCount = static_cast<uint32_t>(batch.size());
+
+	std::vector<uint8_t> request(sizeof(RequestHeaderStruct) + payloadSize);
+	uint8_t* ptr = request.data();
+	memcpy(ptr, &header, sizeof(header));
+	ptr += sizeof(header);
+	size_t plainBytes = 0;
+	size_t cipherBytes = 0;
+	for (size_t i = 0; i < batch.size(); ++i)
+	{
+		BatchEntryStruct entry;
+		entry.clientId = recipients[i].id;
+		entry.messageType = batch[i].type;
+		entry.contentSize = static_cast<csize_t>(contents[i].size());
+		memcpy(ptr, &entry, sizeof(entry));
+		memcpy(ptr + sizeof(entry), contents[i].data(), contents[i].size());
+		ptr += sizeof(entry) + contents[i].size();
+		plainBytes += plainSizes[i];
+		cipherBytes += contents[i].size();
+		std::string().swap(contents[i]);  // Copied into the request
+	}
+	AllocationAccounting::countCopy(request.size());
+
+	uint8_t* payload = nullptr;
+	size_t responseSize = 0;
+	const auto sendStart = std::chrono::steady_clock::now();
+	if (!receiveUnknownPayload(request.data(), request.size(), RESPONSE_BATCH_SENT, payload, responseSize))
+		return false;  // Error message set by receiveUnknownPayload
+	const auto sendTime = std::chrono::steady_clock::now() - sendStart;
+
+	_counters->recordWire(REQUEST_SEND_BATCH, Wire::HEADER, sizeof(RequestSendBatchStruct::PayloadHeaderStruct) + batch.size() * sizeof(BatchEntryStruct));
+	_counters->recordWire(REQUEST_SEND_BATCH, Wire::PAYLOAD, plainBytes + responseSize);
+	_counters->recordWire(REQUEST_SEND_BATCH, Wire::EXPANSION, cipherBytes - plainBytes);
+
+	const auto sent = reinterpret_cast<const ResponseBatchSentStruct::PayloadHeaderStruct*>(payload);
+	if (payload == nullptr || responseSize != sizeof(*sent) + batch.size() * sizeof(SentEntry) || sent->entryCount != batch.size())
+	{
+		delete[] payload;
+		clearLastError();
+		m_errorBuffer << "Invalid response payload";
+		return false;
+	}
+
+	const auto entries = reinterpret_cast<const SentEntry*>(payload + sizeof(*sent));
+	for (size_t i = 0; i < batch.size(); ++i)
+	{
+		if (entries[i].clientId != recipients[i].id)
+		{
+			delete[] payload;
+			clearLastError();
+			m_errorBuffer << "Unexpected clientID was received.";
+			return false;
+		}
+	}
+	messageIds.reserve(batch.size());
+	for (size_t i = 0; i < batch.size(); ++i) {
+		messageIds.push_back(entries[i].messageId);
+	}
+	delete[] payload;
+
+	recordThroughput(request.size(), sendTime);
+	_pollScheduler->recordActivity();  // Replies are likely soon
+	return true;
+}
+
+/**
+ * Pick a stripe count: at least STRIPE_MIN_BYTES and, once the connection
+ * throughput is known, at least STRIPE_MIN_SECONDS of transfer per stripe.
+ * A server that reads one request at a time would only serialize the stripes.
+ */
+size_t MessageEngine::chooseStripeCount(const size_t size)
+{
+	size_t stripes = size / STRIPE_MIN_BYTES;
+	if (m_connectionThroughput > 0) {
+		stripes = std::min(stripes, static_cast<size_t>(size / (m_connectionThroughput * STRIPE_MIN_SECONDS)));
+	}
+	stripes = std::min({ stripes, m_maxStripes, _taskPool->getWorkerCount() + 1 });  // The caller sends one
+	if (stripes > 1 && (getServerFeatures() & FEATURE_CONCURRENT_STRIPES) == 0) {
+		return 1;
+	}
+	return std::max<size_t>(stripes, 1);
+}
+
+/**
+ * Ask the server for its optional features, once per engine. A server that
+ * rejects the request predates it and has none; a failed exchange is retried.
+ */
+uint32_t MessageEngine::getServerFeatures()
+{
+	if (m_serverFeaturesKnown) {
+		return m_serverFeatures;
+	}
+
+	RequestServerInfoStruct  request(m_localUser.id);
+	ResponseServerInfoStruct response;
+	if (!exchangeRequest(reinterpret_cast<const uint8_t* const>(&request), sizeof(request),
+		reinterpret_cast<uint8_t* const>(&response), sizeof(response))) {
+		return 0;
+	}
+
+	m_serverFeaturesKnown = true;
+	if (response.header.code == RESPONSE_SERVER_INFO && response.header.payloadSize == sizeof(response.payload))
+	{
+		_counters->recordWire(REQUEST_SERVER_INFO, Wire::PAYLOAD, sizeof(response.payload));
+		m_serverFeatures = response.payload.features;
+	}
+	return m_serverFeatures;
+}
+
+/**
+ * Send the stripes of one message in parallel, each on its own connection.
+ * The server stores the message when the last missing stripe arrives.
+ */
+bool MessageEngine::sendStriped(const ClientIdStruct& recipient, const MessageTypeEnum type, const std::string& content,
+	const size_t plainSize, const size_t stripes)
+{
+	TraceSpan span("engine", "striped_send");
+	span.setBytes(content.size());
+
+	uint32_t transferId = 0;
+	std::random_device random;
+	while (transferId == 0) {
+		transferId = random();
+	}
+
+	// Requests are built where they are sent; everything they refer to outlives the tasks below
+	const size_t stripeSize = (content.size() + stripes - 1) / stripes;
+	std::vector<std::unique_ptr<NetworkConnection>> connections;
+	std::vector<std::future<StripeResult>> pending;
+	std::packaged_task<StripeResult()> local;
+	for (size_t offset = 0; offset < content.size(); offset += stripeSize)
+	{
+		RequestSendStripeStruct request(m_localUser.id, type);
+		request.payloadHeader.clientId = recipient;
+		request.payloadHeader.transferId = transferId;
+		request.payloadHeader.totalSize = static_cast<csize_t>(content.size());
+		request.payloadHeader.offset = static_cast<csize_t>(offset);
+		request.payloadHeader.stripeSize = static_cast<csize_t>(std::min(stripeSize, content.size() - offset));
+		request.header.payloadSize = sizeof(request.payloadHeader) + request.payloadHeader.stripeSize;
+
+		// Same transport as the engine's connection, so --net-emulation applies to stripes too
+		connections.emplace_back(_networkManager->createConnection());
+		NetworkConnection* const connection = connections.back().get();
+		connection->setPersistent(false);
+		connection->setTransferChunkSize(STRIPE_CHUNK_BYTES);
+
+		auto send = [this, request, connection, &content]() {
+			return exchangeStripe(*_rateLimiter, *_counters, *connection, request, content);
+		};
+		if (offset == 0)
+		{
+			// The first stripe goes last, on this thread, once the others are queued
+			std::packaged_task<StripeResult()> task(send);
+			pending.push_back(task.get_future());
+			local = std::move(task);
+		}
+		else {
+			pending.push_back(_taskPool->submit(send, TaskPriority::HIGH));
+		}
+	}
+	local();
+
+	// Collect every stripe before returning, reporting the first problem
+	bool success = true;
+	bool complete = false;
+	for (auto& stripe : pending)
+	{
+		const StripeResult result = stripe.get();
+		if (!success) {
+			continue;
+		}
+		if (!result.sent)
+		{
+			clearLastError();
+			m_errorBuffer << result.error;
+			success = false;
+		}
+		else if (!validateHeader(result.response.header, RESPONSE_STRIPE_RECEIVED)) {
+			success = false;  // Error message set by validateHeader
+		}
+		else if (result.response.payload.clientId != recipient || result.response.payload.transferId != transferId)
+		{
+			clearLastError();
+			m_errorBuffer << "Unexpected stripe response was received.";
+			success = false;
+		}
+		else
+		{
+			recordThroughput(result.bytes, result.elapsed);
+			complete = complete || (result.response.payload.receivedSize == content.size());
+		}
+	}
+	if (!success) {
+		return false;
+	}
+	if (!complete)
+	{
+		clearLastError();
+		m_errorBuffer << "Server did not complete the striped transfer";
+		return false;
+	}
+
+	_counters->recordWire(REQUEST_SEND_STRIPE, Wire::HEADER, pending.size() * sizeof(RequestSendStripeStruct::PayloadHeaderStruct));
+	_counters->recordWire(REQUEST_SEND_STRIPE, Wire::PAYLOAD, plainSize + pending.size() * sizeof(ResponseStripeReceivedStruct::PayloadStruct));
+	_counters->recordWire(REQUEST_SEND_STRIPE, Wire::EXPANSION, content.size() - plainSize);
+	_pollScheduler->recordActivity();
 	return true;
 }
 
+/**
+ * Exponentially weighted average of per-connection send rates.
+ */
+void MessageEngine::recordThroughput(const size_t bytes, const std::chrono::steady_clock::duration elapsed)
+{
+	const double seconds = std::chrono::duration<double>(elapsed).count();
+	if (bytes < THROUGHPUT_SAMPLE_BYTES || seconds <= 0) {
+		return;
+	}
+	const double sample = bytes / seconds;
+	m_connectionThroughput = (m_connectionThroughput > 0)
+		? m_connectionThroughput + THROUGHPUT_WEIGHT * (sample - m_connectionThroughput)
+		: sample;
+}
+
+
+/**
+ * Establish a symmetric key with a user: client list, public key and key
+ * delivery are requested only when missing.
+ */
+bool MessageEngine::prepareSecureChannel(const std::string& username)
+{
+	ErrorLogScope errors("secure_channel", m_errorBuffer, m_errorGeneration, m_loggedErrorGeneration);
+	ClientInfo client;
+	if (!findClientByUsername(username, client))
+	{
+		if (!requestClientsList())
+			return false;  // Error message set by requestClientsList
+		if (!findClientByUsername(username, client))
+		{
+			clearLastError();
+			m_errorBuffer << "User '" << username << "' not found.";
+			return false;
+		}
+	}
+
+	if (client.symmetricKeySet)
+		return true;
+
+	if (!client.publicKeySet && !requestClientPublicKey(username))
+		return false;  // Error message set by requestClientPublicKey
+
+	return sendMessage(username, MSG_SYMMETRIC_KEY_SEND);
+}
+
@@ -12,11 +12,14 @@
 #pragma once
 
 // Standard library includes
+#include <chrono>
+#include <functional>
 #include <sstream>
 #include <string>
 #include <vector>
 
 // Application includes
+#include "PeerRegistry.h"
 #include "protocol.h"
 
 // ================================
@@ -32,8 +35,15 @@ constexpr auto SERVER_INFO = "server.info";
 // ================================
 
 class ConfigManager;
+class EngineCounters;
+class LatencyMetrics;
+class MetricsExporter;
 class NetworkConnection;
+class PollScheduler;
 class RSAPrivateWrapper;
+class RateLimiter;
+class SharedPeerDirectory;
+class ThreadPool;
 
 /**
  * @class       MessageEngine
@@ -50,21 +60,8 @@ public:
 	// Data Structures
 	// ================================
 
-	/**
-	 * @struct      ClientInfo
-	 * @brief       Complete client information structure
-	 * @details     Contains all necessary information about a client including
-	 *              identification, authentication, and encryption keys.
-	 */
-	struct ClientInfo
-	{
-		ClientIdStruct         id;				///< Unique client identifier
-		std::string            username;		///< Client's display name
-		PublicKeyStruct        publicKey;		///< RSA public key for asymmetric encryption
-		SymmetricKeyStruct     symmetricKey;	///< Session encryption key for symmetric encryption
-		bool publicKeySet =	   false;			///< Flag indicating if public key is available
-		bool symmetricKeySet = false;			///< Flag indicating if symmetric key is available
-	};
+	/// Complete client information (see PeerInfo)
+	using ClientInfo = PeerInfo;
 
 	/**
 	 * @struct      MessageData
@@ -73,10 +70,41 @@ public:
 	 */
 	struct MessageData
 	{
-		std::string username;   ///< Source username
-		std::string content;    ///< Message content
+		std::string    username;          ///< Source username
+		std::string    content;           ///< Message content (saved file path for files)
+		ClientIdStruct senderId;          ///< Source client ID
+		messageID_t    messageId = 0;     ///< Server-assigned message ID
+		messageType_t  type = 0;          ///< Message type (MessageTypeEnum)
+		csize_t        size = 0;          ///< Encrypted content size on the wire
+		bool           decrypted = true;  ///< false if the content could not be decrypted
 	};
 
+	/**
+	 * @struct      InboxStatus
+	 * @brief       Pending messages summary returned by probeInbox()
+	 */
+	struct InboxStatus
+	{
+		size_t                    messages = 0;      ///< Messages waiting on the server
+		uint64_t                  bytes = 0;         ///< Their total encrypted content size
+		std::chrono::milliseconds pollHint{ 0 };     ///< Shortest poll interval the server asks for (0 = none)
+		bool                      supported = true;  ///< false if the server rejected the probe (no request 606)
+	};
+
+	/**
+	 * @struct      BatchEntry
+	 * @brief       One message of a batch send (see sendMessages())
+	 */
+	struct BatchEntry
+	{
+		std::string     username;         ///< Target username
+		MessageTypeEnum type = MSG_TEXT;  ///< MSG_TEXT or MSG_FILE
+		std::string     data;             ///< Message text, or path of the file to send
+	};
+
+	/// Receives each pending message as soon as it is ready, in inbox order
+	using MessageHandler = std::function<void(MessageData&&)>;
+
 public:
 	// ================================
 	// Constructor and Destructor
@@ -86,8 +114,11 @@ public:
 	 * @brief       Default constructor - initializes messaging engine
 	 * @details     Creates new messaging engine with uninitialized state.
 	 *              Component interfaces are created and initialized.
+	 * @param[in]   sharedPool    Task pool to use instead of creating one (not owned;
+	 *                            must outlive the engine). Lets many engines in one
+	 *                            process share one set of workers.
 	 */
-	MessageEngine();
+	explicit MessageEngine(ThreadPool* sharedPool = nullptr);
 
 	/**
 	 * @brief       Virtual destructor with automatic cleanup
@@ -118,6 +149,21 @@ public:
 	 */
 	bool loadServerConfiguration();
 
+	/**
+	 * @brief       Gets the server endpoint read by loadServerConfiguration()
+	 * @param[out]  address    Server address
+	 * @param[out]  port       Server port
+	 */
+	void getServerEndpoint(std::string& address, std::string& port) const;
+
+	/**
+	 * @brief       Sets the server endpoint directly, instead of reading server.info
+	 * @param[in]   address    Server IPv4 address
+	 * @param[in]   port       Server port
+	 * @return      true if the endpoint is valid, false otherwise
+	 */
+	bool setServerEndpoint(const std::string& address, const std::string& port);
+
 	/**
 	 * @brief       Loads user credentials from file
 	 * @return      true if credentials loaded successfully, false otherwise
@@ -125,6 +171,69 @@ public:
 	 */
 	bool loadUserCredentials();
 
+	/**
+	 * @brief       Attaches the shared-memory peer directory
+	 * @param[in]   segmentName    Name of the segment shared by co-located clients
+	 * @return      true if the directory is attached, false otherwise
+	 * @details     Once attached, client list and public key requests are served from
+	 *              the shared directory while it is fresh, and results fetched from the
+	 *              server are published for the other processes on this host.
+	 */
+	bool attachSharedDirectory(const std::string& segmentName);
+
+	/**
+	 * @brief       Enables or disables reuse of one server connection across requests
+	 * @param[in]   persistent    true to keep the connection open between requests
+	 * @details     Saves a TCP handshake per request for high-rate senders.
+	 */
+	void setPersistentConnection(bool persistent);
+
+	/**
+	 * @brief       Checks if one server connection is reused across requests
+	 */
+	bool isPersistentConnection() const;
+
+	/**
+	 * @brief       Checks whether the last server request failed before it was sent
+	 * @return      true if no connection could be made, so the server never saw the
+	 *              request and repeating it cannot act twice
+	 */
+	bool failedBeforeSending() const;
+
+	/**
+	 * @brief       Enables striped upload of large files over parallel connections
+	 * @param[in]   maxStripes      Most connections one file is spread over (1 = off)
+	 * @param[in]   minimumBytes    Smallest encrypted file that is striped
+	 * @details     The stripe count is chosen per file from its size and the measured
+	 *              per-connection throughput, so that every stripe runs long enough to
+	 *              repay its connection setup. Stripes are sent on engine pool threads,
+	 *              at most one per worker. Files are striped only if the server reports
+	 *              FEATURE_CONCURRENT_STRIPES; it is asked once, before the first file
+	 *              large enough to stripe.
+	 */
+	void setStriping(size_t maxStripes, size_t minimumBytes);
+
+	/**
+	 * @brief       Gets the measured send throughput of one server connection
+	 * @return      Bytes per second of recent large sends (0 = not measured yet)
+	 */
+	double getConnectionThroughput() const { return m_connectionThroughput; }
+
+	/**
+	 * @brief       Replaces the server connection (e.g. with an EmulatedConnection)
+	 * @param[in]   connection    New unconnected connection; the engine takes ownership
+	 * @details     The endpoint, reuse mode and latency metrics of the current connection
+	 *              carry over. Call after loadServerConfiguration(), between requests.
+	 */
+	void replaceConnection(NetworkConnection* connection);
+
+	/**
+	 * @brief       Sets the file user credentials are loaded from and registered to
+	 * @param[in]   path    Credentials file (default CLIENT_INFO)
+	 * @details     Lets several identities share one working directory (load generation).
+	 */
+	void setCredentialsFile(const std::string& path);
+
 	// Client Management
 	/**
 	 * @brief       Registers a new client with the server
@@ -168,6 +277,20 @@ public:
 	bool sendMessage(const std::string& username, MessageTypeEnum type,
 		const std::string& data = "");
 
+	/**
+	 * @brief       Sends text and file messages to several users, each with its own content
+	 * @param[in]   batch         Messages in send order
+	 * @param[out]  messageIds    Server message IDs in batch order (empty on failure)
+	 * @return      true if every message was stored, false otherwise
+	 * @details     Every recipient needs a symmetric key. All entries are checked and
+	 *              encrypted, in parallel on the task pool, before anything is sent. The
+	 *              batch goes out in one request, which the server stores completely or not
+	 *              at all, so it may hold at most BATCH_MAX_ENTRIES entries and must fit the
+	 *              maximum payload size. Larger batches are rejected; the caller splits them.
+	 *              If the connection fails after the request was sent, the outcome is unknown.
+	 */
+	bool sendMessages(const std::vector<BatchEntry>& batch, std::vector<messageID_t>& messageIds);
+
 	/**
 	 * @brief       Retrieves pending messages from server
 	 * @param[out]  messages    Vector to store retrieved messages
@@ -176,6 +299,42 @@ public:
 	 */
 	bool retrievePendingMessages(std::vector<MessageData>& messages);
 
+	/**
+	 * @brief       Retrieves pending messages from server, streaming them to a handler
+	 * @param[in]   handler    Called once per message, in inbox order
+	 * @return      true if retrieval successful, false otherwise
+	 * @details     Messages are parsed off the connection as they arrive and decrypted on
+	 *              the task pool while later ones are received. Each is handed over once it
+	 *              and all earlier ones are decrypted (or saved), and is not retained
+	 *              afterwards; at most one message per pool worker, plus one, is held back.
+	 *              The handler runs while the response is still being received, so it must
+	 *              not call back into the engine. Messages read before a receive failure
+	 *              are still handed over. Per-message problems are reported through
+	 *              getErrorMessage().
+	 */
+	bool retrievePendingMessages(const MessageHandler& handler);
+
+	/**
+	 * @brief       Asks the server how many messages are waiting, without fetching them
+	 * @param[out]  status    Pending messages count and total size
+	 * @return      true if the server answered, false otherwise
+	 * @details     One small fixed-size exchange with nothing to decrypt, cheap enough to
+	 *              call every second. Pollers fetch with retrievePendingMessages() only
+	 *              when status.messages is non-zero. The result and the server's poll
+	 *              hint are fed to the poll scheduler. On failure, status.supported tells
+	 *              a server that rejected the request apart from a failed exchange.
+	 */
+	bool probeInbox(InboxStatus& status);
+
+	/**
+	 * @brief       Makes sure text and files can be sent encrypted to a user
+	 * @param[in]   username    Target username
+	 * @return      true if a symmetric key is established, false otherwise
+	 * @details     Fetches the client list and the user's public key as needed, then
+	 *              generates and sends a symmetric key if none is known yet.
+	 */
+	bool prepareSecureChannel(const std::string& username);
+
 	// ================================
 	// Accessor Methods
 	// ================================
@@ -201,7 +360,76 @@ public:
 	 */
 	ClientIdStruct getSelfClientID() const { return m_localUser.id; }
 
+	/**
+	 * @brief       Gets the outbound request pacer
+	 * @return      Rate limiter applied to every server exchange
+	 * @details     No request code is paced until a limit is configured.
+	 */
+	RateLimiter* getRateLimiter() const { return _rateLimiter; }
+
+	/**
+	 * @brief       Gets the inbox poll scheduler
+	 * @return      Interval controller for background pollers
+	 * @details     Sent and received messages, empty inbox checks and server hints are
+	 *              recorded by the engine; pollers wait nextDelay() between checks.
+	 */
+	PollScheduler* getPollScheduler() const { return _pollScheduler; }
+
+	/**
+	 * @brief       Gets the engine-level task pool
+	 * @return      Shared work-stealing pool for crypto and I/O tasks
+	 * @details     Subsystems submit background work here instead of spawning threads.
+	 */
+	ThreadPool* getTaskPool() const { return _taskPool; }
+
+	/**
+	 * @brief       Gets the latency histograms
+	 * @return      Per-operation and per-request-phase latency histograms
+	 * @details     Recording is always on; its cost is a few relaxed atomic increments.
+	 */
+	LatencyMetrics* getLatencyMetrics() const { return _latencyMetrics; }
+
+	/**
+	 * @brief       Gets the request, traffic, decryption and crypto time counters
+	 */
+	EngineCounters* getEngineCounters() const { return _counters; }
+
+	/**
+	 * @brief       Gets the number of known peers
+	 */
+	size_t getPeerCount() const;
+
+	/**
+	 * @brief       Writes the engine metrics to a Prometheus text file periodically
+	 * @param[in]   path        Metrics file (replaced atomically on every write)
+	 * @param[in]   interval    Time between writes; a final write happens on shutdown
+	 * @return      true if the first write succeeded, false otherwise
+	 */
+	bool startMetricsExport(const std::string& path, std::chrono::milliseconds interval);
+
+	/**
+	 * @brief       Sets where the wire composition table is printed on shutdown
+	 * @param[in]   output    Report stream (nullptr = no report)
+	 */
+	void setWireReport(std::ostream* output) { _wireReport = output; }
+
+	/**
+	 * @brief       Prints the wire composition table to the report stream, once
+	 * @details     Called on destruction; paths that leave through exit() call it first.
+	 */
+	void reportWireUsage();
+
 private:
+	// ================================
+	// Internal Types
+	// ================================
+
+	/// Reads the next bytes of a response payload; false on a receive failure or past its end
+	using PayloadReader = std::function<bool(uint8_t* destination, size_t count)>;
+
+	/// Consumes a response payload of the given size through a reader
+	using PayloadConsumer = std::function<bool(size_t payloadSize, const PayloadReader& read)>;
+
 	// ================================
 	// Member Variables
 	// ================================
@@ -210,11 +438,28 @@ private:
 	NetworkConnection* _networkManager; ///< Network communication manager
 	ConfigManager* _configManager;		///< Configuration storage manager
 	RSAPrivateWrapper* _cryptoEngine;   ///< Encryption/decryption engine
+	SharedPeerDirectory* _sharedDirectory; ///< Optional host-wide peer directory
+	RateLimiter* _rateLimiter;          ///< Outbound request pacing
+	PollScheduler* _pollScheduler;      ///< Adaptive inbox poll interval
+	ThreadPool* _taskPool;              ///< Shared background executor
+	bool _ownsTaskPool;                 ///< _taskPool was created by this engine
+	LatencyMetrics* _latencyMetrics;    ///< Operation and network phase latencies
+	EngineCounters* _counters;          ///< Request, traffic and crypto counters
+	MetricsExporter* _metricsExporter;  ///< Optional Prometheus textfile writer
+	std::ostream* _wireReport;          ///< Shutdown wire composition report (optional)
+	std::string _credentialsFile;       ///< User credentials file (my.info)
 
 	// Data storage
 	ClientInfo				m_localUser;     ///< Current user's information
-	std::vector<ClientInfo> m_peerRegistry;  ///< Known clients registry
+	PeerRegistry			m_peerRegistry;  ///< Known clients registry (snapshot-published)
 	std::stringstream		m_errorBuffer;	 ///< Error message buffer
+	uint64_t				m_errorGeneration;        ///< Errors reported so far (see clearLastError)
+	uint64_t				m_loggedErrorGeneration;  ///< Last error written to the event log
+	size_t					m_maxStripes;             ///< Most connections per striped file (1 = off)
+	size_t					m_stripeMinimumBytes;     ///< Smallest encrypted file that is striped
+	double					m_connectionThroughput;   ///< Per-connection send rate in bytes/s (0 = unknown)
+	uint32_t				m_serverFeatures;         ///< FEATURE_* flags of the server
+	bool					m_serverFeaturesKnown;    ///< m_serverFeatures has been received
 
 	// ================================
 	// Private Helper Methods
@@ -246,6 +491,20 @@ private:
 	 */
 	bool storeClientInfo();
 
+	/**
+	 * @brief       Loads the peer registry from the shared directory
+	 * @return      true if a fresh, non-empty peer list was loaded, false otherwise
+	 * @details     The local user is excluded, matching the server's client list.
+	 */
+	bool loadSharedDirectory();
+
+	/**
+	 * @brief       Publishes the peer registry to the shared directory
+	 * @details     The local user is published as well, since other processes' lists
+	 *              must contain it. Failure to publish is not an error.
+	 */
+	void publishSharedDirectory() const;
+
 	// Key Management
 	/**
 	 * @brief       Sets client's public key
@@ -265,6 +524,54 @@ private:
 	 */
 	bool setClientSymmetricKey(const ClientIdStruct& clientID, const SymmetricKeyStruct& symmetricKey);
 
+	// Request Handling
+	/**
+	 * @brief       Performs a paced request/response exchange with the server
+	 * @param[in]   request     Request buffer (starts with RequestHeaderStruct)
+	 * @param[in]   reqSize     Request size
+	 * @param[out]  response    Response buffer
+	 * @param[in]   resSize     Expected response size
+	 * @return      true if the exchange completed, false on transport failure
+	 * @details     Waits for the rate limiter and reports the outcome back to it.
+	 */
+	bool exchangeRequest(const uint8_t* const request, const size_t reqSize,
+		uint8_t* const response, const size_t resSize);
+
+	// Striped Upload
+	/**
+	 * @brief       Chooses how many connections a file is sent over
+	 * @param[in]   size    Encrypted content size
+	 * @return      Stripe count (1 = send in one request, always if the server does not
+	 *              receive stripes concurrently)
+	 */
+	size_t chooseStripeCount(size_t size);
+
+	/**
+	 * @brief       Gets the server's optional features, asking it on first use
+	 * @return      FEATURE_* flags (0 if the server does not know the request, or could
+	 *              not be reached; the latter is asked again next time)
+	 */
+	uint32_t getServerFeatures();
+
+	/**
+	 * @brief       Sends encrypted content as stripes over parallel connections
+	 * @param[in]   recipient   Destination client ID
+	 * @param[in]   type        Message type
+	 * @param[in]   content     Encrypted content
+	 * @param[in]   plainSize   Content size before encryption (wire accounting)
+	 * @param[in]   stripes     Number of stripes (from chooseStripeCount)
+	 * @return      true if the server stored the complete message, false otherwise
+	 */
+	bool sendStriped(const ClientIdStruct& recipient, MessageTypeEnum type, const std::string& content,
+		size_t plainSize, size_t stripes);
+
+	/**
+	 * @brief       Adds a large send to the per-connection throughput estimate
+	 * @param[in]   bytes      Request size
+	 * @param[in]   elapsed    Exchange duration, connection setup included
+	 */
+	void recordThroughput(size_t bytes, std::chrono::steady_clock::duration elapsed);
+
 	// Response Handling
 	/**
 	 * @brief       Validates response header from server
@@ -288,6 +595,20 @@ private:
 	bool receiveUnknownPayload(const uint8_t* const request, const size_t reqSize,
 		const ResponseCodeEnum expectedCode, uint8_t*& payload, size_t& size);
 
+	/**
+	 * @brief       Sends a request and streams the response payload to a consumer
+	 * @param[in]   request       Original request data
+	 * @param[in]   reqSize       Request size
+	 * @param[in]   expectedCode  Expected response code
+	 * @param[in]   consume       Called once with the payload size and a reader; must read
+	 *                            the whole payload or return false
+	 * @return      true if the consumer succeeded, false otherwise
+	 * @details     The consumer runs while the response is still arriving, so it can act on
+	 *              the start of a large payload before the rest is received.
+	 */
+	bool receivePayload(const uint8_t* const request, const size_t reqSize,
+		const ResponseCodeEnum expectedCode, const PayloadConsumer& consume);
+
 	// Resource Management
 	/**
 	 * @brief       Releases allocated resources
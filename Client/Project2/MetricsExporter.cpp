@@ -0,0 +1,198 @@
+/**
+ * @file        MetricsExporter.cpp
+ * @author      Natanel Maor Fishman
+ * @brief       Implementation of the Prometheus textfile exporter.
+ * @details     Writer thread, atomic file replacement and exposition formatting.
+ * @date        2025
+ */
+
+#include "MetricsExporter.h"
+#include "EngineCounters.h"
+#include "LatencyMetrics.h"
+#include "MessageEngine.h"
+#include "ThreadPool.h"
+
+#include <fstream>
+#include <iomanip>
+#include <boost/filesystem.hpp>
+
+namespace
+{
+	constexpr double MICROS_PER_SECOND = 1e6;
+
+	/**
+	 * @brief       Writes the HELP and TYPE lines of a metric family
+	 */
+	void family(std::ostream& output, const char* name, const char* type, const char* help)
+	{
+		output << "# HELP messageu_" << name << ' ' << help << '\n'
+			<< "# TYPE messageu_" << name << ' ' << type << '\n';
+	}
+
+	/**
+	 * @brief       Writes the quantile, sum and count samples of a latency histogram
+	 * @param[in]   labels    Label pairs without braces (e.g. operation="send_text")
+	 */
+	void summary(std::ostream& output, const char* name, const std::string& labels, const LatencyHistogram& histogram)
+	{
+		const LatencyHistogram::Summary s = histogram.summarize();
+		const std::pair<const char*, uint64_t> quantiles[] = {
+			{ "0.5", s.p50 }, { "0.9", s.p90 }, { "0.99", s.p99 }, { "0.999", s.p999 }
+		};
+		for (const auto& quantile : quantiles)
+		{
+			output << "messageu_" << name << '{' << labels << ",quantile=\"" << quantile.first << "\"} "
+				<< static_cast<double>(quantile.second) / MICROS_PER_SECOND << '\n';
+		}
+		output << "messageu_" << name << "_sum{" << labels << "} " << s.mean * static_cast<double>(s.count) / MICROS_PER_SECOND << '\n'
+			<< "messageu_" << name << "_count{" << labels << "} " << s.count << '\n';
+	}
+}
+
+// ================================
+// Constructor and Destructor
+// ================================
+
+MetricsExporter::MetricsExporter(const MessageEngine& engine, const std::string& path, const std::chrono::milliseconds interval)
+	: _engine(engine), _path(path), _interval(interval), _stopping(false), _lastWriteSucceeded(false)
+{
+	write();
+	_thread = std::thread([this]() { run(); });
+}
+
+MetricsExporter::~MetricsExporter()
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_stopping = true;
+	}
+	_wakeup.notify_all();
+	_thread.join();
+	write();
+}
+
+// ================================
+// Public Interface Methods
+// ================================
+
+bool MetricsExporter::write()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return writeLocked();
+}
+
+void MetricsExporter::format(const MessageEngine& engine, std::ostream& output)
+{
+	const EngineCounters& counters = *engine.getEngineCounters();
+	const LatencyMetrics& latency = *engine.getLatencyMetrics();
+	const ThreadPool::Stats pool = engine.getTaskPool()->getStats();
+
+	output << std::setprecision(9);
+
+	family(output, "requests_total", "counter", "Server requests by request code and outcome.");
+	for (size_t slot = 0; slot < EngineCounters::CODE_SLOTS; ++slot)
+	{
+		for (size_t outcome = 0; outcome < static_cast<size_t>(EngineCounters::Outcome::COUNT); ++outcome)
+		{
+			const auto value = counters.getRequests(slot, static_cast<EngineCounters::Outcome>(outcome));
+			if (value > 0) {
+				output << "messageu_requests_total{code=\"" << EngineCounters::slotName(slot) << "\",outcome=\""
+					<< EngineCounters::outcomeName(static_cast<EngineCounters::Outcome>(outcome)) << "\"} " << value << '\n';
+			}
+		}
+	}
+
+	family(output, "bytes_sent_total", "counter", "Bytes written to the server, including packet padding.");
+	output << "messageu_bytes_sent_total " << counters.getBytesSent() << '\n';
+	family(output, "bytes_received_total", "counter", "Bytes read from the server, including packet padding.");
+	output << "messageu_bytes_received_total " << counters.getBytesReceived() << '\n';
+	family(output, "decryptions_total", "counter", "Messages and symmetric keys decrypted.");
+	output << "messageu_decryptions_total " << counters.getDecrypted() << '\n';
+	family(output, "decryption_failures_total", "counter", "Messages and symmetric keys that failed to decrypt.");
+	output << "messageu_decryption_failures_total " << counters.getDecryptionFailures() << '\n';
+	family(output, "crypto_seconds_total", "counter", "Time spent in encryption, decryption and key handling.");
+	output << "messageu_crypto_seconds_total " << static_cast<double>(counters.getCryptoMicros()) / MICROS_PER_SECOND << '\n';
+
+	family(output, "wire_bytes_total", "counter", "Wire bytes by request code and kind (header, padding, expansion, payload).");
+	for (size_t slot = 0; slot < EngineCounters::CODE_SLOTS; ++slot)
+	{
+		if (counters.getWireTotal(slot) == 0) {
+			continue;
+		}
+		for (size_t kind = 0; kind < static_cast<size_t>(EngineCounters::Wire::COUNT); ++kind)
+		{
+			output << "messageu_wire_bytes_total{code=\"" << EngineCounters::slotName(slot) << "\",kind=\""
+				<< EngineCounters::wireName(static_cast<EngineCounters::Wire>(kind)) << "\"} "
+				<< counters.getWire(slot, static_cast<EngineCounters::Wire>(kind)) << '\n';
+		}
+	}
+
+	family(output, "peers", "gauge", "Clients in the local peer registry.");
+	output << "messageu_peers " << engine.getPeerCount() << '\n';
+	family(output, "task_pool_pending", "gauge", "Task pool tasks queued or running.");
+	output << "messageu_task_pool_pending " << (pool.tasksSubmitted - pool.tasksExecuted) << '\n';
+	family(output, "task_pool_workers", "gauge", "Task pool worker threads.");
+	output << "messageu_task_pool_workers " << pool.workers << '\n';
+	family(output, "task_pool_utilization", "gauge", "Task pool busy time over uptime and workers (0..1).");
+	output << "messageu_task_pool_utilization " << pool.utilization << '\n';
+
+	family(output, "operation_latency_seconds", "summary", "Engine operation latency.");
+	for (size_t i = 0; i < static_cast<size_t>(LatencyMetrics::Operation::COUNT); ++i)
+	{
+		const auto operation = static_cast<LatencyMetrics::Operation>(i);
+		const LatencyHistogram& histogram = latency.getOperation(operation);
+		if (histogram.getCount() > 0) {
+			summary(output, "operation_latency_seconds",
+				std::string("operation=\"") + LatencyMetrics::operationName(operation) + "\"", histogram);
+		}
+	}
+
+	family(output, "request_phase_seconds", "summary", "Request phase latency by request code.");
+	for (size_t slot = 0; slot + 1 < EngineCounters::CODE_SLOTS; ++slot)
+	{
+		const code_t code = static_cast<code_t>(EngineCounters::FIRST_CODE + slot);
+		for (size_t i = 0; i < static_cast<size_t>(LatencyMetrics::Phase::COUNT); ++i)
+		{
+			const auto phase = static_cast<LatencyMetrics::Phase>(i);
+			const LatencyHistogram& histogram = latency.getPhase(code, phase);
+			if (histogram.getCount() > 0) {
+				summary(output, "request_phase_seconds", std::string("code=\"") + EngineCounters::slotName(slot)
+					+ "\",phase=\"" + LatencyMetrics::phaseName(phase) + "\"", histogram);
+			}
+		}
+	}
+}
+
+// ================================
+// Private Helper Methods
+// ================================
+
+void MetricsExporter::run()
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	while (!_wakeup.wait_for(lock, _interval, [this]() { return _stopping; })) {
+		writeLocked();
+	}
+}
+
+bool MetricsExporter::writeLocked()
+{
+	const std::string temporary = _path + ".tmp";
+	bool written = false;
+	{
+		std::ofstream file(temporary, std::ios::trunc);
+		if (file.is_open())
+		{
+			format(_engine, file);
+			written = static_cast<bool>(file.flush());
+		}
+	}
+
+	boost::system::error_code error;
+	if (written) {
+		boost::filesystem::rename(temporary, _path, error);
+	}
+	written = written && !error;
+	_lastWriteSucceeded.store(written, std::memory_order_relaxed);
+	return written;
+}
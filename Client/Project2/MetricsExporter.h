@@ -0,0 +1,128 @@
+/**
+ * @file        MetricsExporter.h
+ * @author      Natanel Maor Fishman
+ * @brief       Prometheus text-format metrics file writer
+ * @details     Periodically writes the engine's counters, gauges and latency summaries to
+ *              a file in the Prometheus exposition format, for the node-exporter textfile
+ *              collector. The file is replaced atomically, so a scrape never sees a partial
+ *              write, and the client opens no network listener.
+ * @version     2.0
+ * @date        2025
+ */
+
+#pragma once
+
+// ================================
+// Standard Library Includes
+// ================================
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+
+// ================================
+// Forward Declarations
+// ================================
+
+class MessageEngine;
+
+// ================================
+// Class Definition
+// ================================
+
+/**
+ * @class       MetricsExporter
+ * @brief       Background writer of an engine's metrics file
+ * @details     Exported families (all prefixed "messageu_"):
+ *              - requests_total{code,outcome}            counter
+ *              - bytes_sent_total, bytes_received_total   counters (padded wire bytes)
+ *              - wire_bytes_total{code,kind}              counter
+ *              - decryptions_total, decryption_failures_total  counters
+ *              - crypto_seconds_total                     counter
+ *              - peers, task_pool_pending, task_pool_workers, task_pool_utilization  gauges
+ *              - operation_latency_seconds{operation,quantile}  summary
+ *              - request_phase_seconds{code,phase,quantile}     summary
+ *
+ *              A write goes to "<path>.tmp", which is then renamed over the path.
+ *
+ * @note        This class is non-copyable. The engine must outlive the exporter.
+ */
+class MetricsExporter
+{
+public:
+	// ================================
+	// Constructor and Destructor
+	// ================================
+
+	/**
+	 * @brief       Writes the file once and starts the periodic writer
+	 * @param[in]   engine      Engine whose metrics are exported
+	 * @param[in]   path        Metrics file (should end in .prom for node-exporter)
+	 * @param[in]   interval    Time between writes
+	 */
+	MetricsExporter(const MessageEngine& engine, const std::string& path, std::chrono::milliseconds interval);
+
+	/**
+	 * @brief       Stops the writer and writes the final values
+	 */
+	virtual ~MetricsExporter();
+
+	// ================================
+	// Copy Control (Deleted)
+	// ================================
+
+	MetricsExporter(const MetricsExporter&) = delete;
+	MetricsExporter& operator=(const MetricsExporter&) = delete;
+
+	// ================================
+	// Public Interface Methods
+	// ================================
+
+	/**
+	 * @brief       Writes the metrics file now
+	 * @return      true if the file was replaced, false otherwise
+	 */
+	bool write();
+
+	/**
+	 * @brief       Checks if the last write succeeded
+	 */
+	bool isWriting() const { return _lastWriteSucceeded.load(std::memory_order_relaxed); }
+
+	/**
+	 * @brief       Formats the metrics of an engine in the Prometheus text format
+	 */
+	static void format(const MessageEngine& engine, std::ostream& output);
+
+private:
+	// ================================
+	// Member Variables
+	// ================================
+
+	const MessageEngine&            _engine;              ///< Exported engine
+	const std::string               _path;                ///< Metrics file
+	const std::chrono::milliseconds _interval;            ///< Write period
+	std::mutex                      _mutex;               ///< Guards _stopping, serializes writes
+	std::condition_variable         _wakeup;              ///< Signals stop
+	bool                            _stopping;            ///< Destructor requested stop
+	std::atomic<bool>               _lastWriteSucceeded;  ///< Result of the last write
+	std::thread                     _thread;              ///< Periodic writer
+
+	// ================================
+	// Private Helper Methods
+	// ================================
+
+	/**
+	 * @brief       Writer loop: one write per interval until stopped
+	 */
+	void run();
+
+	/**
+	 * @brief       Writes and renames the file (caller holds _mutex)
+	 */
+	bool writeLocked();
+};
@@ -0,0 +1,551 @@
+/**
+ * @file        MockServer.cpp
+ * @author      Natanel Maor Fishman
+ * @brief       Implementation of the in-process server stand-in.
+ * @details     Accept loop, per-connection framing and the request handlers.
+ * @date        2025
+ */
+
+#include "MockServer.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <iterator>
+
+namespace
+{
+	constexpr uint64_t MAX_REQUEST_BYTES = 1ull << 30;  ///< Larger requests are rejected unread
+	constexpr auto STRIPE_TIMEOUT = std::chrono::seconds(60);  ///< Incomplete transfers are kept this long without progress
+
+	size_t wireSize(const uint64_t size)
+	{
+		return static_cast<size_t>((size + DEFAULT_PACKET_SIZE - 1) / DEFAULT_PACKET_SIZE * DEFAULT_PACKET_SIZE);
+	}
+
+	std::string idKey(const ClientIdStruct& id)
+	{
+		return std::string(reinterpret_cast<const char*>(id.uuid), sizeof(id.uuid));
+	}
+
+	template <typename T>
+	void append(std::vector<uint8_t>& target, const T& value)
+	{
+		const auto bytes = reinterpret_cast<const uint8_t*>(&value);
+		target.insert(target.end(), bytes, bytes + sizeof(value));
+	}
+
+	void appendHeader(std::vector<uint8_t>& response, const ResponseCodeEnum code, const size_t payloadSize)
+	{
+		ResponseHeaderStruct header;
+		header.version = PROTOCOL_VERSION;
+		header.code = static_cast<code_t>(code);
+		header.payloadSize = static_cast<csize_t>(payloadSize);
+		append(response, header);
+	}
+}
+
+// ================================
+// Constructor and Destructor
+// ================================
+
+MockServer::MockServer()
+	: _acceptor(_context), _port(0), _stopping(false), _nextMessageId(0),
+	_random(std::random_device()()), _requests(0), _pollHintMs(0)
+{
+}
+
+MockServer::~MockServer()
+{
+	stop();
+}
+
+// ================================
+// Public Interface Methods
+// ================================
+
+bool MockServer::start(const uint16_t port)
+{
+	if (_acceptor.is_open()) {
+		return false;
+	}
+
+	boost::system::error_code error;
+	const boost::asio::ip::tcp::endpoint endpoint(boost::asio::ip::address_v4::loopback(), port);
+	_acceptor.open(endpoint.protocol(), error);
+	if (!error) {
+		_acceptor.set_option(boost::asio::ip::tcp::acceptor::reuse_address(true), error);
+	}
+	if (!error) {
+		_acceptor.bind(endpoint, error);
+	}
+	if (!error) {
+		_acceptor.listen(boost::asio::socket_base::max_listen_connections, error);
+	}
+	if (error)
+	{
+		_acceptor.close(error);
+		return false;
+	}
+
+	_port = _acceptor.local_endpoint().port();
+	_stopping = false;
+	_acceptThread = std::thread([this]() { acceptLoop(); });
+	return true;
+}
+
+void MockServer::stop()
+{
+	if (!_acceptThread.joinable()) {
+		return;
+	}
+
+	// Wake the blocking accept with a final connection
+	_stopping = true;
+	boost::system::error_code error;
+	boost::asio::ip::tcp::socket wake(_context);
+	wake.connect(boost::asio::ip::tcp::endpoint(boost::asio::ip::address_v4::loopback(), _port), error);
+	_acceptThread.join();
+	wake.close(error);
+	_acceptor.close(error);
+
+	// Unblock sessions waiting for their client's next request
+	std::lock_guard<std::mutex> lock(_sessionsMutex);
+	for (Session& session : _sessions) {
+		session.socket->shutdown(boost::asio::ip::tcp::socket::shutdown_both, error);
+	}
+	for (Session& session : _sessions) {
+		session.thread.join();
+	}
+	_sessions.clear();
+}
+
+void MockServer::wait()
+{
+	while (_acceptThread.joinable() && !_stopping) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(200));
+	}
+}
+
+size_t MockServer::getClientCount() const
+{
+	std::lock_guard<std::mutex> lock(_storeMutex);
+	return _clients.size();
+}
+
+size_t MockServer::getPendingCount() const
+{
+	std::lock_guard<std::mutex> lock(_storeMutex);
+	size_t pending = 0;
+	for (const auto& inbox : _inboxes) {
+		pending += inbox.second.size();
+	}
+	return pending;
+}
+
+// ================================
+// Private Helper Methods
+// ================================
+
+void MockServer::acceptLoop()
+{
+	while (true)
+	{
+		auto socket = std::make_shared<boost::asio::ip::tcp::socket>(_context);
+		boost::system::error_code error;
+		_acceptor.accept(*socket, error);
+		if (_stopping) {
+			return;
+		}
+		if (error) {
+			continue;
+		}
+		socket->set_option(boost::asio::ip::tcp::no_delay(true), error);
+
+		std::lock_guard<std::mutex> lock(_sessionsMutex);
+		for (auto session = _sessions.begin(); session != _sessions.end();)
+		{
+			if (session->done->load())
+			{
+				session->thread.join();
+				session = _sessions.erase(session);
+			}
+			else {
+				++session;
+			}
+		}
+
+		auto done = std::make_shared<std::atomic<bool>>(false);
+		std::thread thread([this, socket, done]() {
+			serve(*socket);
+			*done = true;
+		});
+		_sessions.push_back({ socket, done, std::move(thread) });
+	}
+}
+
+void MockServer::serve(boost::asio::ip::tcp::socket& socket)
+{
+	std::vector<uint8_t> request;
+	std::vector<uint8_t> response;
+	boost::system::error_code error;
+
+	while (!_stopping)
+	{
+		request.resize(DEFAULT_PACKET_SIZE);
+		boost::asio::read(socket, boost::asio::buffer(request), error);
+		if (error) {
+			return;  // Client closed the connection
+		}
+
+		const uint64_t size = sizeof(RequestHeaderStruct) + reinterpret_cast<const RequestHeaderStruct*>(request.data())->payloadSize;
+		bool accepted = false;
+		response.clear();
+		if (size <= MAX_REQUEST_BYTES)
+		{
+			if (wireSize(size) > DEFAULT_PACKET_SIZE)
+			{
+				request.resize(wireSize(size));
+				boost::asio::read(socket, boost::asio::buffer(request.data() + DEFAULT_PACKET_SIZE, request.size() - DEFAULT_PACKET_SIZE), error);
+				if (error) {
+					return;
+				}
+			}
+			accepted = handle(request.data(), static_cast<size_t>(size), response);
+		}
+		_requests.fetch_add(1, std::memory_order_relaxed);
+
+		if (!accepted)
+		{
+			response.clear();
+			appendHeader(response, RESPONSE_ERROR, 0);
+		}
+		response.resize(wireSize(response.size()), 0);
+		boost::asio::write(socket, boost::asio::buffer(response), error);
+		if (error || !accepted) {
+			return;  // The server closes the connection after a rejected request
+		}
+	}
+}
+
+bool MockServer::handle(const uint8_t* const request, const size_t size, std::vector<uint8_t>& response)
+{
+	const auto& header = *reinterpret_cast<const RequestHeaderStruct*>(request);
+	const uint8_t* const payload = request + sizeof(RequestHeaderStruct);
+	const size_t payloadSize = size - sizeof(RequestHeaderStruct);
+
+	std::lock_guard<std::mutex> lock(_storeMutex);
+	if (header.code == REQUEST_REGISTRATION) {
+		return handleRegistration(payload, payloadSize, response);
+	}
+	if (_clients.find(idKey(header.clientId)) == _clients.end()) {
+		return false;  // Unknown requester
+	}
+
+	switch (header.code)
+	{
+	case REQUEST_CLIENTS_LIST: return handleClientsList(header.clientId, response);
+	case REQUEST_PUBLIC_KEY:   return handlePublicKey(payload, payloadSize, response);
+	case REQUEST_SEND_MSG:     return handleSendMessage(header.clientId, payload, payloadSize, response);
+	case REQUEST_SEND_STRIPE:  return handleSendStripe(header.clientId, payload, payloadSize, response);
+	case REQUEST_PENDING_MSG:  return handlePendingMessages(header.clientId, response);
+	case REQUEST_INBOX_PROBE:  return handleInboxProbe(header.clientId, response);
+	case REQUEST_SEND_BATCH:   return handleSendBatch(header.clientId, payload, payloadSize, response);
+	case REQUEST_SERVER_INFO:  return handleServerInfo(response);
+	default:                   return false;
+	}
+}
+
+bool MockServer::handleRegistration(const uint8_t* const payload, const size_t payloadSize, std::vector<uint8_t>& response)
+{
+	if (payloadSize != sizeof(ClientNameStruct) + sizeof(PublicKeyStruct)) {
+		return false;
+	}
+
+	Client client;
+	const auto nameField = reinterpret_cast<const char*>(payload);
+	client.name.assign(nameField, strnlen(nameField, CLIENT_NAME_MAX_LENGTH - 1));
+	if (client.name.empty() || !std::all_of(client.name.begin(), client.name.end(),
+		[](const char c) { return std::isalnum(static_cast<unsigned char>(c)) != 0; })) {
+		return false;
+	}
+	for (const auto& registered : _clients)
+	{
+		if (registered.second.name == client.name) {
+			return false;
+		}
+	}
+
+	memcpy(client.publicKey.publicKey, payload + sizeof(ClientNameStruct), sizeof(client.publicKey.publicKey));
+	do
+	{
+		for (size_t i = 0; i < CLIENT_ID_LENGTH; i += sizeof(uint64_t))
+		{
+			const uint64_t bits = _random();
+			memcpy(client.id.uuid + i, &bits, std::min(sizeof(bits), CLIENT_ID_LENGTH - i));
+		}
+	} while (_clients.count(idKey(client.id)) != 0);
+	_clients[idKey(client.id)] = client;
+
+	appendHeader(response, RESPONSE_REGISTRATION, sizeof(ClientIdStruct));
+	append(response, client.id);
+	return true;
+}
+
+bool MockServer::handleClientsList(const ClientIdStruct& requester, std::vector<uint8_t>& response) const
+{
+	const size_t entrySize = sizeof(ClientIdStruct) + sizeof(ClientNameStruct);
+	appendHeader(response, RESPONSE_USERS, (_clients.size() - 1) * entrySize);
+	for (const auto& registered : _clients)
+	{
+		const Client& client = registered.second;
+		if (client.id == requester) {
+			continue;
+		}
+		ClientNameStruct name;
+		memcpy(name.name, client.name.data(), client.name.size());
+		append(response, client.id);
+		append(response, name);
+	}
+	return true;
+}
+
+bool MockServer::handlePublicKey(const uint8_t* const payload, const size_t payloadSize, std::vector<uint8_t>& response) const
+{
+	// The client sends this request with payloadSize 0; like the Python server, read the
+	// target id from the packet regardless (it lies within the first, always-read packet)
+	if (payloadSize != 0 && payloadSize != sizeof(ClientIdStruct)) {
+		return false;
+	}
+	const auto target = _clients.find(std::string(reinterpret_cast<const char*>(payload), sizeof(ClientIdStruct)));
+	if (target == _clients.end()) {
+		return false;
+	}
+
+	appendHeader(response, RESPONSE_PUBLIC_KEY, sizeof(ClientIdStruct) + sizeof(PublicKeyStruct));
+	append(response, target->second.id);
+	append(response, target->second.publicKey);
+	return true;
+}
+
+bool MockServer::handleSendMessage(const ClientIdStruct& sender, const uint8_t* const payload, const size_t payloadSize, std::vector<uint8_t>& response)
+{
+	using PayloadHeader = RequestSendMessageStruct::PayloadHeaderStruct;
+	if (payloadSize < sizeof(PayloadHeader)) {
+		return false;
+	}
+	const auto& header = *reinterpret_cast<const PayloadHeader*>(payload);
+	if (header.contentSize != payloadSize - sizeof(PayloadHeader) || _clients.count(idKey(header.clientId)) == 0) {
+		return false;
+	}
+
+	Message message;
+	message.from = sender;
+	message.id = ++_nextMessageId;
+	message.type = header.messageType;
+	message.content.assign(payload + sizeof(PayloadHeader), payload + payloadSize);
+	_inboxes[idKey(header.clientId)].push_back(std::move(message));
+
+	ResponseMessageSentStruct::PayloadStruct sent;
+	sent.clientId = header.clientId;
+	sent.messageId = _nextMessageId;
+	appendHeader(response, RESPONSE_MSG_SENT, sizeof(sent));
+	append(response, sent);
+	return true;
+}
+
+bool MockServer::handleSendBatch(const ClientIdStruct& sender, const uint8_t* const payload, const size_t payloadSize, std::vector<uint8_t>& response)
+{
+	using PayloadHeader = RequestSendBatchStruct::PayloadHeaderStruct;
+	if (payloadSize < sizeof(PayloadHeader)) {
+		return false;
+	}
+	const uint32_t count = reinterpret_cast<const PayloadHeader*>(payload)->entryCount;
+	if (count == 0 || count > BATCH_MAX_ENTRIES) {
+		return false;
+	}
+
+	// All entries are checked before any is stored
+	std::vector<const BatchEntryStruct*> entries;
+	entries.reserve(count);
+	size_t offset = sizeof(PayloadHeader);
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		if (payloadSize - offset < sizeof(BatchEntryStruct)) {
+			return false;
+		}
+		const auto entry = reinterpret_cast<const BatchEntryStruct*>(payload + offset);
+		offset += sizeof(BatchEntryStruct);
+		if (payloadSize - offset < entry->contentSize || _clients.count(idKey(entry->clientId)) == 0) {
+			return false;
+		}
+		if (entry->messageType != MSG_TEXT && entry->messageType != MSG_FILE) {
+			return false;  // Key exchanges go through single sends
+		}
+		offset += entry->contentSize;
+		entries.push_back(entry);
+	}
+	if (offset != payloadSize) {
+		return false;
+	}
+
+	appendHeader(response, RESPONSE_BATCH_SENT, sizeof(PayloadHeader) + count * sizeof(ResponseMessageSentStruct::PayloadStruct));
+	ResponseBatchSentStruct::PayloadHeaderStruct sentHeader;
+	sentHeader.entryCount = count;
+	append(response, sentHeader);
+	for (const BatchEntryStruct* entry : entries)
+	{
+		const uint8_t* const content = reinterpret_cast<const uint8_t*>(entry + 1);
+		Message message;
+		message.from = sender;
+		message.id = ++_nextMessageId;
+		message.type = entry->messageType;
+		message.content.assign(content, content + entry->contentSize);
+		_inboxes[idKey(entry->clientId)].push_back(std::move(message));
+
+		ResponseMessageSentStruct::PayloadStruct sent;
+		sent.clientId = entry->clientId;
+		sent.messageId = _nextMessageId;
+		append(response, sent);
+	}
+	return true;
+}
+
+bool MockServer::handleSendStripe(const ClientIdStruct& sender, const uint8_t* const payload, const size_t payloadSize, std::vector<uint8_t>& response)
+{
+	using PayloadHeader = RequestSendStripeStruct::PayloadHeaderStruct;
+	if (payloadSize < sizeof(PayloadHeader)) {
+		return false;
+	}
+	const auto& header = *reinterpret_cast<const PayloadHeader*>(payload);
+	const auto key = std::make_pair(idKey(sender), header.transferId);
+
+	const auto now = std::chrono::steady_clock::now();
+	for (auto transfer = _transfers.begin(); transfer != _transfers.end();)
+	{
+		if (now - transfer->second.updated > STRIPE_TIMEOUT) {
+			transfer = _transfers.erase(transfer);
+		}
+		else {
+			++transfer;
+		}
+	}
+
+	if (header.stripeSize == 0 || header.stripeSize != payloadSize - sizeof(PayloadHeader)
+		|| static_cast<uint64_t>(header.offset) + header.stripeSize > header.totalSize
+		|| header.totalSize > MAX_REQUEST_BYTES || _clients.count(idKey(header.clientId)) == 0)
+	{
+		_transfers.erase(key);
+		return false;
+	}
+
+	auto found = _transfers.find(key);
+	if (found == _transfers.end())
+	{
+		const size_t open = std::count_if(_transfers.begin(), _transfers.end(),
+			[&key](const std::pair<const std::pair<std::string, uint32_t>, Transfer>& entry) { return entry.first.first == key.first; });
+		if (open >= MAX_OPEN_TRANSFERS) {
+			return false;
+		}
+		Transfer transfer;
+		transfer.recipient = header.clientId;
+		transfer.type = header.messageType;
+		transfer.content.resize(header.totalSize);
+		transfer.received = 0;
+		found = _transfers.emplace(key, std::move(transfer)).first;
+	}
+
+	// Every stripe must describe the same message and cover new bytes only
+	Transfer& transfer = found->second;
+	const auto next = transfer.stripes.lower_bound(header.offset);
+	const bool overlapsNext = next != transfer.stripes.end() && next->first < header.offset + header.stripeSize;
+	const bool overlapsPrevious = next != transfer.stripes.begin() && std::prev(next)->first + std::prev(next)->second > header.offset;
+	if (transfer.recipient != header.clientId || transfer.type != header.messageType
+		|| transfer.content.size() != header.totalSize || overlapsNext || overlapsPrevious)
+	{
+		_transfers.erase(found);
+		return false;
+	}
+	memcpy(transfer.content.data() + header.offset, payload + sizeof(PayloadHeader), header.stripeSize);
+	transfer.stripes[header.offset] = header.stripeSize;
+	transfer.received += header.stripeSize;
+	transfer.updated = now;
+
+	ResponseStripeReceivedStruct::PayloadStruct received;
+	received.clientId = header.clientId;
+	received.transferId = header.transferId;
+	received.receivedSize = transfer.received;
+	if (transfer.received == header.totalSize)
+	{
+		Message message;
+		message.from = sender;
+		message.id = ++_nextMessageId;
+		message.type = transfer.type;
+		message.content = std::move(transfer.content);
+		_inboxes[idKey(header.clientId)].push_back(std::move(message));
+		_transfers.erase(found);
+		received.messageId = _nextMessageId;
+	}
+
+	appendHeader(response, RESPONSE_STRIPE_RECEIVED, sizeof(received));
+	append(response, received);
+	return true;
+}
+
+bool MockServer::handlePendingMessages(const ClientIdStruct& requester, std::vector<uint8_t>& response)
+{
+	std::vector<Message> messages;
+	const auto inbox = _inboxes.find(idKey(requester));
+	if (inbox != _inboxes.end())
+	{
+		messages.swap(inbox->second);
+		_inboxes.erase(inbox);
+	}
+
+	size_t payloadSize = 0;
+	for (const Message& message : messages) {
+		payloadSize += sizeof(PendingMessageStruct) + message.content.size();
+	}
+	response.reserve(sizeof(ResponseHeaderStruct) + payloadSize);
+	appendHeader(response, RESPONSE_PENDING_MSG, payloadSize);
+
+	for (const Message& message : messages)
+	{
+		PendingMessageStruct pending;
+		pending.clientId = message.from;
+		pending.messageId = message.id;
+		pending.messageType = message.type;
+		pending.messageSize = static_cast<csize_t>(message.content.size());
+		append(response, pending);
+		response.insert(response.end(), message.content.begin(), message.content.end());
+	}
+	return true;
+}
+
+bool MockServer::handleInboxProbe(const ClientIdStruct& requester, std::vector<uint8_t>& response) const
+{
+	ResponseInboxStatusStruct::PayloadStruct status;
+	const auto inbox = _inboxes.find(idKey(requester));
+	if (inbox != _inboxes.end())
+	{
+		status.messageCount = static_cast<uint32_t>(inbox->second.size());
+		for (const Message& message : inbox->second) {
+			status.totalBytes += message.content.size();
+		}
+	}
+	status.pollHintMs = _pollHintMs.load(std::memory_order_relaxed);
+
+	appendHeader(response, RESPONSE_INBOX_STATUS, sizeof(status));
+	append(response, status);
+	return true;
+}
+
+bool MockServer::handleServerInfo(std::vector<uint8_t>& response) const
+{
+	ResponseServerInfoStruct::PayloadStruct info;
+	info.features = FEATURE_CONCURRENT_STRIPES;  // One thread per connection
+
+	appendHeader(response, RESPONSE_SERVER_INFO, sizeof(info));
+	append(response, info);
+	return true;
+}
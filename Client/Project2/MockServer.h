@@ -0,0 +1,232 @@
+/**
+ * @file        MockServer.h
+ * @author      Natanel Maor Fishman
+ * @brief       In-process MessageU server stand-in
+ * @details     Implements request codes 600-608 of protocol.h against an in-memory store,
+ *              on a loopback TCP port, with the packet-padded wire format of the Python
+ *              server. Lets benchmarks and scripted runs exercise MessageEngine without
+ *              the Python server and its SQLite database, so only client cost is measured.
+ * @version     2.0
+ * @date        2025
+ */
+
+#pragma once
+
+// ================================
+// Standard Library Includes
+// ================================
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+// ================================
+// Third-Party Includes
+// ================================
+
+#include <boost/asio.hpp>
+
+// ================================
+// Application Includes
+// ================================
+
+#include "NetworkConnection.h"
+#include "protocol.h"
+
+// ================================
+// Class Definition
+// ================================
+
+/**
+ * @class       MockServer
+ * @brief       Loopback server with the behavior of the Python server
+ * @details     Behavior matched to the Python server:
+ *              - connections stay open across requests until the client closes them;
+ *              - a rejected request is answered with RESPONSE_ERROR and the connection is
+ *                closed;
+ *              - usernames are unique and alphanumeric; every request other than
+ *                registration needs a registered client id;
+ *              - the users list excludes the requester; pending messages are removed once
+ *                delivered; a batch is stored completely or not at all;
+ *              - stripes of a transfer must agree on recipient, type and size and may not
+ *                overlap; an incomplete transfer is dropped after STRIPE_TIMEOUT without
+ *                progress.
+ *              Every connection is served on its own thread, so stripes arrive
+ *              concurrently (FEATURE_CONCURRENT_STRIPES). Data is kept in memory only
+ *              and lost when the server stops. Structs are sent in host byte order
+ *              (little-endian hosts only).
+ *
+ * @note        This class is non-copyable.
+ */
+class MockServer
+{
+public:
+	// ================================
+	// Constructor and Destructor
+	// ================================
+
+	/**
+	 * @brief       Creates a stopped server with an empty store
+	 */
+	MockServer();
+
+	/**
+	 * @brief       Stops the server
+	 */
+	virtual ~MockServer();
+
+	// ================================
+	// Copy Control (Deleted)
+	// ================================
+
+	MockServer(const MockServer&) = delete;
+	MockServer& operator=(const MockServer&) = delete;
+
+	// ================================
+	// Public Interface Methods
+	// ================================
+
+	/**
+	 * @brief       Starts listening on 127.0.0.1
+	 * @param[in]   port    TCP port (0 = any free port, see getPort)
+	 * @return      true if listening, false if the port cannot be bound or already started
+	 */
+	bool start(uint16_t port = 0);
+
+	/**
+	 * @brief       Stops accepting, closes open connections and joins all threads
+	 */
+	void stop();
+
+	/**
+	 * @brief       Blocks until the server is stopped from another thread
+	 */
+	void wait();
+
+	/**
+	 * @brief       Gets the listening port (valid after start)
+	 */
+	uint16_t getPort() const { return _port; }
+
+	/**
+	 * @brief       Gets the number of registered clients
+	 */
+	size_t getClientCount() const;
+
+	/**
+	 * @brief       Gets the number of stored, undelivered messages
+	 */
+	size_t getPendingCount() const;
+
+	/**
+	 * @brief       Gets the number of requests served (accepted or rejected)
+	 */
+	uint64_t getRequestCount() const { return _requests.load(std::memory_order_relaxed); }
+
+	/**
+	 * @brief       Sets the poll interval hint returned with every inbox status
+	 * @param[in]   hint    Suggested minimum time between probes (0 = none, the default)
+	 */
+	void setPollHint(const std::chrono::milliseconds hint) { _pollHintMs = static_cast<uint32_t>(hint.count()); }
+
+	static constexpr size_t MAX_OPEN_TRANSFERS = 16;  ///< Incomplete striped transfers per sender
+
+private:
+	// ================================
+	// Data Structures
+	// ================================
+
+	struct Client
+	{
+		ClientIdStruct  id;         ///< Assigned id
+		std::string     name;       ///< Username
+		PublicKeyStruct publicKey;  ///< Registered public key
+	};
+
+	struct Message
+	{
+		ClientIdStruct       from;     ///< Sender id
+		messageID_t          id;       ///< Server-assigned id
+		messageType_t        type;     ///< Message type
+		std::vector<uint8_t> content;  ///< Opaque content
+	};
+
+	struct Transfer
+	{
+		ClientIdStruct                        recipient;  ///< Destination client
+		messageType_t                         type;       ///< Message type
+		std::vector<uint8_t>                  content;    ///< Complete content, filled by stripes
+		std::map<csize_t, csize_t>            stripes;    ///< Stored stripes (offset -> size)
+		csize_t                               received;   ///< Bytes stored so far
+		std::chrono::steady_clock::time_point updated;    ///< Last stored stripe
+	};
+
+	struct Session
+	{
+		std::shared_ptr<boost::asio::ip::tcp::socket> socket;  ///< Client connection
+		std::shared_ptr<std::atomic<bool>>            done;    ///< Thread finished
+		std::thread                                   thread;  ///< Serving thread
+	};
+
+	// ================================
+	// Member Variables
+	// ================================
+
+	boost::asio::io_context        _context;        ///< Owns the sockets
+	boost::asio::ip::tcp::acceptor _acceptor;       ///< Listening socket
+	uint16_t                       _port;           ///< Listening port
+	std::atomic<bool>              _stopping;       ///< stop() requested
+	std::thread                    _acceptThread;   ///< Accept loop
+	std::mutex                     _sessionsMutex;  ///< Guards _sessions
+	std::list<Session>             _sessions;       ///< Served connections
+
+	mutable std::mutex                          _storeMutex;     ///< Guards the store below
+	std::map<std::string, Client>               _clients;        ///< By raw id bytes
+	std::map<std::string, std::vector<Message>> _inboxes;        ///< By recipient raw id bytes
+	std::map<std::pair<std::string, uint32_t>, Transfer> _transfers;  ///< By sender raw id bytes and transfer id
+	messageID_t                                 _nextMessageId;  ///< Last assigned message id
+	std::mt19937_64                             _random;         ///< Client id generator
+	std::atomic<uint64_t>                       _requests;       ///< Requests served
+	std::atomic<uint32_t>                       _pollHintMs;     ///< Inbox status poll hint
+
+	// ================================
+	// Private Helper Methods
+	// ================================
+
+	/**
+	 * @brief       Accepts connections until stopped; reaps finished sessions
+	 */
+	void acceptLoop();
+
+	/**
+	 * @brief       Serves the requests of one connection until it closes or a request fails
+	 */
+	void serve(boost::asio::ip::tcp::socket& socket);
+
+	/**
+	 * @brief       Handles one complete request
+	 * @param[in]   request     Header and payload
+	 * @param[in]   size        Header plus payload size (without packet padding)
+	 * @param[out]  response    Response header and payload (without packet padding)
+	 * @return      true if accepted, false to answer with RESPONSE_ERROR
+	 */
+	bool handle(const uint8_t* request, size_t size, std::vector<uint8_t>& response);
+
+	bool handleRegistration(const uint8_t* payload, size_t payloadSize, std::vector<uint8_t>& response);
+	bool handleClientsList(const ClientIdStruct& requester, std::vector<uint8_t>& response) const;
+	bool handlePublicKey(const uint8_t* payload, size_t payloadSize, std::vector<uint8_t>& response) const;
+	bool handleSendMessage(const ClientIdStruct& sender, const uint8_t* payload, size_t payloadSize, std::vector<uint8_t>& response);
+	bool handleSendBatch(const ClientIdStruct& sender, const uint8_t* payload, size_t payloadSize, std::vector<uint8_t>& response);
+	bool handleSendStripe(const ClientIdStruct& sender, const uint8_t* payload, size_t payloadSize, std::vector<uint8_t>& response);
+	bool handlePendingMessages(const ClientIdStruct& requester, std::vector<uint8_t>& response);
+	bool handleInboxProbe(const ClientIdStruct& requester, std::vector<uint8_t>& response) const;
+	bool handleServerInfo(std::vector<uint8_t>& response) const;
+};
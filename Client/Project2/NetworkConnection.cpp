@@ -12,6 +12,9 @@
 // ================================
 
 #include "NetworkConnection.h"
+#include "EventLog.h"
+#include "Tracer.h"
+#include "WireCapture.h"
 #include <boost/asio.hpp>
 #include <stdexcept>
 #include <algorithm>
@@ -27,7 +30,9 @@ using boost::asio::io_context;
  * @brief       Default constructor - initializes network connection and detects system endianness
  * @details     Sets up internal state and determines system endianness for cross-platform compatibility.
  */
-NetworkConnection::NetworkConnection() : m_ioContext(nullptr), m_resolver(nullptr), m_socket(nullptr), m_isConnected(false)
+NetworkConnection::NetworkConnection() : m_ioContext(nullptr), m_resolver(nullptr), m_socket(nullptr), m_isConnected(false), m_isPersistent(false), m_connectFailed(false),
+	m_metrics(nullptr), m_requestCode(0), m_awaitingFirstByte(false), m_responseStarted(false), m_captureStream(0),
+	m_counters(nullptr), m_chunkSize(DEFAULT_PACKET_SIZE)
 {
 	// Detect system endianness using union approach
 	union
@@ -68,6 +73,83 @@ bool NetworkConnection::configureEndpoint(const std::string& address, const std:
 	return true;
 }
 
+/**
+ * @brief       Enables or disables connection reuse across exchanges
+ * @param[in]   persistent    true to keep the connection open between requests
+ * @details     Disabling closes an open connection.
+ */
+void NetworkConnection::setPersistent(const bool persistent)
+{
+	m_isPersistent = persistent;
+	if (!persistent) {
+		disconnectSocket();
+	}
+}
+
+/**
+ * @brief       Creates another, unconnected connection of the same kind
+ * @return      New connection with this one's settings (caller takes ownership)
+ */
+NetworkConnection* NetworkConnection::createConnection() const
+{
+	NetworkConnection* const connection = new NetworkConnection();
+	copySettingsTo(*connection);
+	return connection;
+}
+
+/**
+ * @brief       Sets how many bytes one socket read or write moves
+ * @param[in]   bytes    Chunk size, rounded down to whole packets (at least one packet)
+ */
+void NetworkConnection::setTransferChunkSize(const size_t bytes)
+{
+	m_chunkSize = std::max<size_t>(1, bytes / DEFAULT_PACKET_SIZE) * DEFAULT_PACKET_SIZE;
+}
+
+/**
+ * @brief       Gets a connection for the next request
+ * @return      true if connected, false otherwise
+ * @details     Reuses the open connection in persistent mode, otherwise connects anew.
+ */
+bool NetworkConnection::acquireConnection()
+{
+	if (m_isPersistent && m_isConnected && m_socket != nullptr && m_socket->is_open()) {
+		m_connectFailed = false;
+		return true;
+	}
+	m_connectFailed = !establishConnection();
+	return !m_connectFailed;
+}
+
+/**
+ * @brief       Ends a request on the current connection
+ * @param[in]   reusable    false if the exchange failed
+ * @details     Keeps the connection open only in persistent mode after a clean exchange.
+ */
+void NetworkConnection::releaseConnection(const bool reusable)
+{
+	if (reusable && m_responseStarted) {
+		recordPhase(LatencyMetrics::Phase::RECEIVE, m_sendDone);
+	}
+	m_responseStarted = false;
+	m_awaitingFirstByte = false;
+
+	if (!m_isPersistent || !reusable) {
+		disconnectSocket();
+	}
+}
+
+/**
+ * @brief       Starts timing a new request
+ * @param[in]   code    Request code the following phases are recorded under
+ */
+void NetworkConnection::beginRequest(const code_t code)
+{
+	m_requestCode = code;
+	m_awaitingFirstByte = false;
+	m_responseStarted = false;
+}
+
 /**
  * @brief       Establishes connection to the configured endpoint
  * @return      true if connection successful, false otherwise
@@ -78,9 +160,11 @@ bool NetworkConnection::establishConnection()
 	if (!validateAddress(m_address) || !validatePort(m_port)) {
 		return false;
 	}
+	TraceSpan span("net", "connect");
 	try
 	{
 		disconnectSocket(); // Ensure clean state before connecting
+		const auto start = std::chrono::steady_clock::now();
 		m_ioContext = new io_context;
 		m_resolver = new tcp::resolver(*m_ioContext);
 		m_socket = new tcp::socket(*m_ioContext);
@@ -89,8 +173,20 @@ bool NetworkConnection::establishConnection()
 		m_socket->set_option(tcp::no_delay(true));
 		m_socket->non_blocking(false);
 		m_isConnected = true;
+		recordPhase(LatencyMetrics::Phase::CONNECT, start);
+		captureFrame(WireCapture::FrameType::CONNECT, nullptr, 0);
+		EventLog::write(EventLog::Level::DEBUG, "connect", m_requestCode, 0, static_cast<uint64_t>(
+			std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count()));
 		return true;
 	}
+	catch (const std::exception& e)
+	{
+		m_isConnected = false;
+		if (EventLog::isEnabled(EventLog::Level::WARNING)) {
+			EventLog::write(EventLog::Level::WARNING, "connect_failed", m_requestCode, m_address + ":" + m_port + ": " + e.what());
+		}
+		return false;
+	}
 	catch (...)
 	{
 		m_isConnected = false;
@@ -104,6 +200,9 @@ bool NetworkConnection::establishConnection()
  */
 void NetworkConnection::disconnectSocket()
 {
+	if (m_isConnected) {
+		captureFrame(WireCapture::FrameType::CLOSE, nullptr, 0);
+	}
 	try
 	{
 		if (m_socket != nullptr && m_socket->is_open()) {
@@ -151,24 +250,43 @@ bool NetworkConnection::receiveData(uint8_t* const buffer, const size_t size) co
 	if (!m_socket || !m_isConnected || !buffer || size == 0) {
 		return false;
 	}
+	TraceSpan span("net", "receive");
+	span.setBytes(size);
 	size_t bytesRemaining = size;
 	uint8_t* currentPosition = buffer;
+	m_transferBuffer.resize(m_chunkSize);
+	uint8_t* const tempBuffer = m_transferBuffer.data();
 	while (bytesRemaining > 0)
 	{
-		uint8_t tempBuffer[DEFAULT_PACKET_SIZE] = { 0 };
+		// Whole packets only, and never past the end of this transfer
+		const size_t packets = (bytesRemaining + DEFAULT_PACKET_SIZE - 1) / DEFAULT_PACKET_SIZE;
+		const size_t bytesToRead = std::min(m_chunkSize, packets * DEFAULT_PACKET_SIZE);
 		boost::system::error_code errorCode;
-		size_t bytesRead = read(*m_socket, boost::asio::buffer(tempBuffer, DEFAULT_PACKET_SIZE), errorCode);
+		size_t bytesRead = read(*m_socket, boost::asio::buffer(tempBuffer, bytesToRead), errorCode);
+		++m_transferStats.readCalls;
 		if (errorCode || bytesRead == 0) {
 			return false;
 		}
+		if (m_counters != nullptr) {
+			m_counters->addBytesReceived(bytesRead);
+			m_counters->addWireBytes(m_requestCode, bytesRead);
+		}
+		if (m_awaitingFirstByte)
+		{
+			recordPhase(LatencyMetrics::Phase::FIRST_BYTE, m_sendDone);
+			m_awaitingFirstByte = false;
+			m_responseStarted = true;
+		}
 		if (m_isBigEndian) {
 			convertEndianness(tempBuffer, bytesRead);
 		}
 		const size_t bytesCopy = (bytesRemaining > bytesRead) ? bytesRead : bytesRemaining;
 		memcpy(currentPosition, tempBuffer, bytesCopy);
+		m_transferStats.bytesCopied += bytesCopy;
 		currentPosition += bytesCopy;
 		bytesRemaining = (bytesRemaining < bytesCopy) ? 0 : (bytesRemaining - bytesCopy);
 	}
+	captureFrame(WireCapture::FrameType::RESPONSE, buffer, size);
 	return true;
 }
 
@@ -184,23 +302,41 @@ bool NetworkConnection::sendData(const uint8_t* const buffer, const size_t size)
 	if (!m_socket || !m_isConnected || !buffer || size == 0) {
 		return false;
 	}
+	TraceSpan span("net", "send");
+	span.setBytes(size);
+	const auto start = std::chrono::steady_clock::now();
 	size_t bytesRemaining = size;
 	const uint8_t* currentPosition = buffer;
+	m_transferBuffer.resize(m_chunkSize);
+	uint8_t* const tempBuffer = m_transferBuffer.data();
 	while (bytesRemaining > 0) {
-		uint8_t tempBuffer[DEFAULT_PACKET_SIZE] = { 0 };
 		boost::system::error_code errorCode;
-		const size_t bytesToSend = (bytesRemaining > DEFAULT_PACKET_SIZE) ? DEFAULT_PACKET_SIZE : bytesRemaining;
+		const size_t bytesToSend = (bytesRemaining > m_chunkSize) ? m_chunkSize : bytesRemaining;
+		const size_t packetBytes = (bytesToSend + DEFAULT_PACKET_SIZE - 1) / DEFAULT_PACKET_SIZE * DEFAULT_PACKET_SIZE;
 		memcpy(tempBuffer, currentPosition, bytesToSend);
+		memset(tempBuffer + bytesToSend, 0, packetBytes - bytesToSend);  // Zero padding of the last packet
+		m_transferStats.bytesCopied += bytesToSend;
 		if (m_isBigEndian) {
 			convertEndianness(tempBuffer, bytesToSend);
 		}
-		const size_t bytesWritten = write(*m_socket, boost::asio::buffer(tempBuffer, DEFAULT_PACKET_SIZE), errorCode);
+		const size_t bytesWritten = write(*m_socket, boost::asio::buffer(tempBuffer, packetBytes), errorCode);
+		++m_transferStats.writeCalls;
 		if (errorCode || bytesWritten == 0) {
 			return false;
 		}
-		currentPosition += bytesWritten;
-		bytesRemaining = (bytesRemaining < bytesWritten) ? 0 : (bytesRemaining - bytesWritten);
+		if (m_counters != nullptr) {
+			m_counters->addBytesSent(bytesWritten);
+			m_counters->addWireBytes(m_requestCode, bytesWritten);
+		}
+		currentPosition += bytesToSend;
+		bytesRemaining -= bytesToSend;
 	}
+
+	recordPhase(LatencyMetrics::Phase::SEND, start);
+	captureFrame(WireCapture::FrameType::REQUEST, buffer, size);
+	m_sendDone = std::chrono::steady_clock::now();
+	m_awaitingFirstByte = true;
+	m_responseStarted = false;
 	return true;
 }
 
@@ -212,10 +348,11 @@ bool NetworkConnection::sendData(const uint8_t* const buffer, const size_t size)
  * @param[in]   receiveSize   Size of response buffer
  * @return      true if exchange successful, false otherwise
  * @details     Performs complete request-response cycle by sending data and immediately waiting for response. Atomic operation.
+ *              The connection is kept open afterwards only in persistent mode.
  */
 bool NetworkConnection::exchangeData(const uint8_t* const sendBuffer, const size_t sendSize, uint8_t* const receiveBuffer, const size_t receiveSize)
 {
-	if (!establishConnection()) {
+	if (!acquireConnection()) {
 		return false;
 	}
 	bool success = true;
@@ -225,14 +362,62 @@ bool NetworkConnection::exchangeData(const uint8_t* const sendBuffer, const size
 	if (success && !receiveData(receiveBuffer, receiveSize)) {
 		success = false;
 	}
-	disconnectSocket();
+	releaseConnection(success);
 	return success;
 }
 
+// ================================
+// Protected Helper Methods
+// ================================
+
+/**
+ * @brief       Gives a new connection this one's endpoint and settings
+ * @param[out]  connection    Connection to configure
+ */
+void NetworkConnection::copySettingsTo(NetworkConnection& connection) const
+{
+	connection.m_address = m_address;
+	connection.m_port = m_port;
+	connection.m_isPersistent = m_isPersistent;
+	connection.m_metrics = m_metrics;
+	connection.m_counters = m_counters;
+	connection.m_chunkSize = m_chunkSize;
+}
+
 // ================================
 // Private Helper Methods
 // ================================
 
+/**
+ * @brief       Records a phase duration of the current request
+ * @param[in]   phase    Measured phase
+ * @param[in]   start    Phase start time
+ */
+void NetworkConnection::recordPhase(const LatencyMetrics::Phase phase, const std::chrono::steady_clock::time_point start) const
+{
+	if (m_metrics != nullptr) {
+		m_metrics->recordPhase(m_requestCode, phase, std::chrono::duration_cast<std::chrono::microseconds>(
+			std::chrono::steady_clock::now() - start));
+	}
+}
+
+/**
+ * @brief       Writes a frame to the wire capture if one is running
+ * @param[in]   type    Event kind
+ * @param[in]   data    Logical (unpadded) payload
+ * @param[in]   size    Payload size
+ */
+void NetworkConnection::captureFrame(const WireCapture::FrameType type, const uint8_t* const data, const size_t size) const
+{
+	if (!WireCapture::isEnabled()) {
+		return;
+	}
+	if (m_captureStream == 0) {
+		m_captureStream = WireCapture::openStream();
+	}
+	WireCapture::record(m_captureStream, type, data, size);
+}
+
 /**
  * @brief       Converts data endianness if necessary
  * @param[in,out] buffer    Data buffer to convert
@@ -16,8 +16,10 @@
 // ================================
 
 #include <string>
+#include <chrono>
 #include <cstdint>
 #include <ostream>
+#include <vector>
 
 // ================================
 // Third-Party Includes
@@ -25,6 +27,14 @@
 
 #include <boost/asio/ip/tcp.hpp>
 
+// ================================
+// Application Includes
+// ================================
+
+#include "EngineCounters.h"
+#include "LatencyMetrics.h"
+#include "WireCapture.h"
+
 // ================================
 // Using Declarations
 // ================================
@@ -64,6 +74,17 @@ constexpr size_t DEFAULT_PACKET_SIZE = 1024;
 class NetworkConnection
 {
 public:
+	/**
+	 * @struct      TransferStats
+	 * @brief       Transport work counters (see getTransferStats)
+	 */
+	struct TransferStats
+	{
+		uint64_t writeCalls = 0;   ///< Socket write calls
+		uint64_t readCalls = 0;    ///< Socket read calls
+		uint64_t bytesCopied = 0;  ///< Bytes copied between caller and transfer buffers
+	};
+
 	// ================================
 	// Constructor and Destructor
 	// ================================
@@ -130,7 +151,7 @@ public:
 	 * @details     Attempts to establish TCP connection to the configured
 	 *              address and port. Updates connection state accordingly.
 	 */
-	bool establishConnection();
+	virtual bool establishConnection();
 
 	/**
 	 * @brief       Closes the active connection
@@ -157,6 +178,103 @@ public:
 	 */
 	bool configureEndpoint(const std::string& address, const std::string& port);
 
+	/**
+	 * @brief       Enables or disables connection reuse across exchanges
+	 * @param[in]   persistent    true to keep the connection open between requests
+	 * @details     The server keeps a connection open until the client closes it, so a
+	 *              persistent connection saves a TCP handshake per request. Disabling
+	 *              closes an open connection.
+	 */
+	void setPersistent(bool persistent);
+
+	/**
+	 * @brief       Creates another, unconnected connection of the same kind
+	 * @return      New connection with this one's endpoint, persistence, chunk size,
+	 *              metrics and counters (caller takes ownership)
+	 * @details     Used where a request needs a connection of its own, e.g. for a stripe.
+	 *              Derived transports override this to pass their settings on.
+	 */
+	virtual NetworkConnection* createConnection() const;
+
+	/**
+	 * @brief       Gets the configured endpoint address
+	 */
+	const std::string& getAddress() const { return m_address; }
+
+	/**
+	 * @brief       Gets the configured endpoint port
+	 */
+	const std::string& getPort() const { return m_port; }
+
+	/**
+	 * @brief       Sets how many bytes one socket read or write moves
+	 * @param[in]   bytes    Chunk size, rounded down to whole packets (at least one packet)
+	 * @details     The wire format is unchanged: transfers are still padded to whole
+	 *              DEFAULT_PACKET_SIZE packets. Larger chunks only batch several packets
+	 *              per call.
+	 */
+	void setTransferChunkSize(size_t bytes);
+
+	/**
+	 * @brief       Gets the transport work counters since the last reset
+	 */
+	TransferStats getTransferStats() const { return m_transferStats; }
+
+	/**
+	 * @brief       Clears the transport work counters
+	 */
+	void resetTransferStats() { m_transferStats = TransferStats(); }
+
+	/**
+	 * @brief       Checks if connections are reused across exchanges
+	 * @return      true if persistent, false otherwise
+	 */
+	bool isPersistent() const { return m_isPersistent; }
+
+	/**
+	 * @brief       Gets a connection for the next request
+	 * @return      true if connected, false otherwise
+	 * @details     Reuses the open connection in persistent mode, otherwise connects anew.
+	 */
+	bool acquireConnection();
+
+	/**
+	 * @brief       Checks whether the last acquireConnection failed to connect
+	 * @return      true if the request it was for was never sent
+	 */
+	bool connectFailed() const { return m_connectFailed; }
+
+	/**
+	 * @brief       Ends a request on the current connection
+	 * @param[in]   reusable    false if the exchange failed (the stream may be out of sync)
+	 * @details     Keeps the connection open only in persistent mode after a clean exchange.
+	 */
+	void releaseConnection(bool reusable);
+
+	// ================================
+	// Latency Measurement
+	// ================================
+
+	/**
+	 * @brief       Sets the destination of phase timings
+	 * @param[in]   metrics    Histograms to record into (nullptr disables recording)
+	 */
+	void setLatencyMetrics(LatencyMetrics* metrics) { m_metrics = metrics; }
+
+	/**
+	 * @brief       Sets the destination of wire byte counts
+	 * @param[in]   counters    Engine counters (nullptr disables counting)
+	 */
+	void setEngineCounters(EngineCounters* counters) { m_counters = counters; }
+
+	/**
+	 * @brief       Starts timing a new request
+	 * @param[in]   code    Request code the following phases are recorded under
+	 * @details     Phases: connect, send, first byte (end of send to first response packet)
+	 *              and receive (end of send to releaseConnection after a clean exchange).
+	 */
+	void beginRequest(code_t code);
+
 	// ================================
 	// Data Transfer Methods
 	// ================================
@@ -169,7 +287,7 @@ public:
 	 * @details     Receives specified amount of data from the connected socket.
 	 *              Handles endianness conversion if necessary.
 	 */
-	bool receiveData(uint8_t* const buffer, const size_t size) const;
+	virtual bool receiveData(uint8_t* const buffer, const size_t size) const;
 
 	/**
 	 * @brief       Sends data through the socket
@@ -179,7 +297,7 @@ public:
 	 * @details     Sends specified amount of data through the connected socket.
 	 *              Handles endianness conversion if necessary.
 	 */
-	bool sendData(const uint8_t* const buffer, const size_t size) const;
+	virtual bool sendData(const uint8_t* const buffer, const size_t size) const;
 
 	/**
 	 * @brief       Sends data and waits for response
@@ -194,6 +312,17 @@ public:
 	bool exchangeData(const uint8_t* const toSend, const size_t size, 
 		uint8_t* const response, const size_t resSize);
 
+protected:
+	// ================================
+	// Protected Helper Methods
+	// ================================
+
+	/**
+	 * @brief       Gives a new connection this one's endpoint and settings
+	 * @param[out]  connection    Connection to configure
+	 */
+	void copySettingsTo(NetworkConnection& connection) const;
+
 private:
 	// ================================
 	// Member Variables
@@ -205,8 +334,24 @@ private:
 	std::string m_address;        ///< Remote endpoint IP address
 	std::string m_port;           ///< Remote endpoint port number
 	bool m_isConnected;           ///< Connection state flag
+	bool m_isPersistent;          ///< Reuse the connection across exchanges
+	bool m_connectFailed;         ///< The last acquireConnection could not connect
 	bool m_isBigEndian;           ///< System endianness flag for data conversion
 
+	// Phase timing of the current request (mutable: updated by the const transfer methods)
+	LatencyMetrics* m_metrics;                                 ///< Phase histograms (may be null)
+	code_t m_requestCode;                                      ///< Code of the current request
+	mutable std::chrono::steady_clock::time_point m_sendDone;  ///< End of the last send
+	mutable bool m_awaitingFirstByte;                          ///< No packet received since the send
+	mutable bool m_responseStarted;                            ///< A response packet has been received
+	mutable uint32_t m_captureStream;                          ///< Wire capture stream (0 = not assigned yet)
+	EngineCounters* m_counters;                                ///< Wire byte counters (may be null)
+
+	// Transfer chunking (mutable: used by the const transfer methods)
+	size_t m_chunkSize;                                        ///< Bytes per socket call (whole packets)
+	mutable std::vector<uint8_t> m_transferBuffer;             ///< Staging buffer of one chunk
+	mutable TransferStats m_transferStats;                     ///< Transport work counters
+
 	// ================================
 	// Private Helper Methods
 	// ================================
@@ -220,6 +365,21 @@ private:
 	 */
 	void convertEndianness(uint8_t* const buffer, size_t size) const;
 
+	/**
+	 * @brief       Records a phase duration of the current request
+	 * @param[in]   phase    Measured phase
+	 * @param[in]   start    Phase start time
+	 */
+	void recordPhase(LatencyMetrics::Phase phase, std::chrono::steady_clock::time_point start) const;
+
+	/**
+	 * @brief       Writes a frame to the wire capture if one is running
+	 * @param[in]   type    Event kind
+	 * @param[in]   data    Logical (unpadded) payload
+	 * @param[in]   size    Payload size
+	 */
+	void captureFrame(WireCapture::FrameType type, const uint8_t* data, size_t size) const;
+
 	/**
 	 * @brief       Validates port number format
 	 * @param[in]   port      Port string to validate
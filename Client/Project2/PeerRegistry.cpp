@@ -0,0 +1,294 @@
+/**
+ * @file        PeerRegistry.cpp
+ * @author      Natanel Maor Fishman
+ * @brief       Implementation of the read-mostly peer registry.
+ * @details     Snapshot publication through an atomic pointer and epoch-based reclamation
+ *              of retired snapshots.
+ * @date        2025
+ */
+
+#include "PeerRegistry.h"
+
+#include <algorithm>
+#include <limits>
+
+// ================================
+// Epoch Domain
+// ================================
+
+namespace
+{
+	constexpr size_t   READER_SLOTS = 128;                                  ///< Concurrent pinned reader threads
+	constexpr uint64_t EPOCH_INACTIVE = std::numeric_limits<uint64_t>::max(); ///< Slot not inside a guard
+
+	/**
+	 * @struct      ReaderSlot
+	 * @brief       Epoch announced by one reader thread (own cache line to avoid false sharing)
+	 */
+	struct alignas(64) ReaderSlot
+	{
+		std::atomic<uint64_t> epoch{ EPOCH_INACTIVE };  ///< Epoch pinned by the owner, or inactive
+		std::atomic<bool>     owned{ false };           ///< Claimed by a live thread
+	};
+
+	ReaderSlot            readerSlots[READER_SLOTS];
+	std::atomic<uint64_t> globalEpoch{ 1 };
+	std::atomic<size_t>   overflowReaders{ 0 };  ///< Readers without a slot (block all reclamation)
+
+	/**
+	 * @struct      ThreadReader
+	 * @brief       Per-thread slot ownership and guard nesting depth
+	 */
+	struct ThreadReader
+	{
+		ReaderSlot* slot = nullptr;
+		size_t      depth = 0;
+		bool        claimAttempted = false;
+
+		~ThreadReader()
+		{
+			if (slot != nullptr)
+			{
+				slot->epoch.store(EPOCH_INACTIVE);
+				slot->owned.store(false);
+			}
+		}
+	};
+
+	thread_local ThreadReader threadReader;
+
+	/**
+	 * @brief       Returns the calling thread's slot, claiming one on first use
+	 * @return      Slot pointer, or nullptr if all slots are taken
+	 */
+	ReaderSlot* readerSlot()
+	{
+		if (!threadReader.claimAttempted)
+		{
+			threadReader.claimAttempted = true;
+			for (ReaderSlot& slot : readerSlots)
+			{
+				bool expected = false;
+				if (slot.owned.compare_exchange_strong(expected, true))
+				{
+					threadReader.slot = &slot;
+					break;
+				}
+			}
+		}
+		return threadReader.slot;
+	}
+}
+
+// ================================
+// Snapshot Lookups
+// ================================
+
+const PeerInfo* PeerRegistry::Snapshot::findByName(const std::string& username) const
+{
+	const auto it = byName.find(username);
+	return (it == byName.end()) ? nullptr : &peers[it->second];
+}
+
+const PeerInfo* PeerRegistry::Snapshot::findById(const ClientIdStruct& clientID) const
+{
+	const auto it = byId.find(idKey(clientID));
+	return (it == byId.end()) ? nullptr : &peers[it->second];
+}
+
+// ================================
+// Read Guard
+// ================================
+
+/**
+ * @brief       Announces the current epoch, then loads the snapshot pointer
+ * @details     Both operations are sequentially consistent so that a writer scanning
+ *              the slots after swapping the pointer either sees this reader's epoch or
+ *              this reader sees the new pointer.
+ */
+PeerRegistry::ReadGuard::ReadGuard(const PeerRegistry& registry)
+{
+	ReaderSlot* slot = readerSlot();
+	if (slot == nullptr) {
+		++overflowReaders;
+	}
+	else if (threadReader.depth++ == 0) {
+		slot->epoch.store(globalEpoch.load());
+	}
+	_snapshot = registry._current.load();
+}
+
+PeerRegistry::ReadGuard::~ReadGuard()
+{
+	ReaderSlot* slot = threadReader.slot;
+	if (slot == nullptr) {
+		--overflowReaders;
+	}
+	else if (--threadReader.depth == 0) {
+		slot->epoch.store(EPOCH_INACTIVE, std::memory_order_release);
+	}
+}
+
+// ================================
+// Constructor and Destructor
+// ================================
+
+PeerRegistry::PeerRegistry()
+	: _current(new Snapshot())
+{
+}
+
+PeerRegistry::~PeerRegistry()
+{
+	delete _current.load();
+	for (const auto& retired : _retired) {
+		delete retired.second;
+	}
+}
+
+// ================================
+// Writer Methods
+// ================================
+
+/**
+ * @brief       Copy, mutate, publish
+ */
+bool PeerRegistry::update(const Mutation& mutation)
+{
+	std::lock_guard<std::mutex> lock(_writerMutex);
+	std::vector<PeerInfo> peers = _current.load(std::memory_order_relaxed)->peers;
+	if (!mutation(peers)) {
+		return false;
+	}
+	publish(std::move(peers));
+	return true;
+}
+
+/**
+ * @brief       Replaces the peer list, carrying over keys of peers that remain
+ */
+void PeerRegistry::mergeList(std::vector<PeerInfo> peers)
+{
+	update([&peers](std::vector<PeerInfo>& current) {
+		std::unordered_map<std::string, size_t> known;
+		for (size_t i = 0; i < current.size(); ++i) {
+			known.emplace(idKey(current[i].id), i);
+		}
+
+		for (PeerInfo& peer : peers)
+		{
+			const auto it = known.find(idKey(peer.id));
+			if (it == known.end()) {
+				continue;
+			}
+			const PeerInfo& previous = current[it->second];
+			if (!peer.publicKeySet && previous.publicKeySet)
+			{
+				peer.publicKey = previous.publicKey;
+				peer.publicKeySet = true;
+			}
+			if (!peer.symmetricKeySet && previous.symmetricKeySet)
+			{
+				peer.symmetricKey = previous.symmetricKey;
+				peer.symmetricKeySet = true;
+			}
+		}
+
+		current.swap(peers);
+		return true;
+	});
+}
+
+// ================================
+// Reader Methods
+// ================================
+
+bool PeerRegistry::findByName(const std::string& username, PeerInfo& peer) const
+{
+	const ReadGuard snapshot(*this);
+	const PeerInfo* found = snapshot->findByName(username);
+	if (found == nullptr) {
+		return false;
+	}
+	peer = *found;
+	return true;
+}
+
+bool PeerRegistry::findById(const ClientIdStruct& clientID, PeerInfo& peer) const
+{
+	const ReadGuard snapshot(*this);
+	const PeerInfo* found = snapshot->findById(clientID);
+	if (found == nullptr) {
+		return false;
+	}
+	peer = *found;
+	return true;
+}
+
+size_t PeerRegistry::size() const
+{
+	const ReadGuard snapshot(*this);
+	return snapshot->peers.size();
+}
+
+size_t PeerRegistry::retiredCount() const
+{
+	std::lock_guard<std::mutex> lock(_writerMutex);
+	return _retired.size();
+}
+
+// ================================
+// Private Helper Methods
+// ================================
+
+/**
+ * @brief       Indexes the peers, swaps the snapshot in and retires the previous one
+ * @details     The first peer with a given username wins, matching the linear search
+ *              this registry replaced.
+ */
+void PeerRegistry::publish(std::vector<PeerInfo> peers)
+{
+	Snapshot* next = new Snapshot();
+	next->peers = std::move(peers);
+	next->byName.reserve(next->peers.size());
+	next->byId.reserve(next->peers.size());
+	for (size_t i = 0; i < next->peers.size(); ++i)
+	{
+		next->byName.emplace(next->peers[i].username, i);
+		next->byId.emplace(idKey(next->peers[i].id), i);
+	}
+
+	const Snapshot* previous = _current.load(std::memory_order_relaxed);
+	next->version = previous->version + 1;
+
+	_current.store(next);
+	_retired.emplace_back(globalEpoch.fetch_add(1), previous);
+	reclaim();
+}
+
+/**
+ * @brief       Frees snapshots retired before the oldest epoch still pinned by a reader
+ */
+void PeerRegistry::reclaim()
+{
+	if (overflowReaders.load() != 0) {
+		return;
+	}
+
+	uint64_t oldestPinned = EPOCH_INACTIVE;
+	for (const ReaderSlot& slot : readerSlots) {
+		oldestPinned = std::min(oldestPinned, slot.epoch.load());
+	}
+
+	const auto reachable = std::partition(_retired.begin(), _retired.end(),
+		[oldestPinned](const std::pair<uint64_t, const Snapshot*>& retired) { return retired.first >= oldestPinned; });
+	for (auto it = reachable; it != _retired.end(); ++it) {
+		delete it->second;
+	}
+	_retired.erase(reachable, _retired.end());
+}
+
+std::string PeerRegistry::idKey(const ClientIdStruct& clientID)
+{
+	return std::string(reinterpret_cast<const char*>(clientID.uuid), sizeof(clientID.uuid));
+}
@@ -0,0 +1,230 @@
+/**
+ * @file        PeerRegistry.h
+ * @author      Natanel Maor Fishman
+ * @brief       Read-mostly peer registry published as immutable snapshots
+ * @details     Lookups (findClientByUsername / findClientById) are on the hot path of every
+ *              send, while writes (list merges, key updates) are rare. Readers load the
+ *              current snapshot with a single atomic pointer read and never take a lock;
+ *              writers copy, modify and swap. Retired snapshots are freed with epoch-based
+ *              reclamation once no reader can still hold them.
+ * @version     2.0
+ * @date        2025
+ */
+
+#pragma once
+
+// ================================
+// Standard Library Includes
+// ================================
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// ================================
+// Application Includes
+// ================================
+
+#include "protocol.h"
+
+// ================================
+// Data Structures
+// ================================
+
+/**
+ * @struct      PeerInfo
+ * @brief       Complete client information structure
+ * @details     Contains all necessary information about a client including
+ *              identification, authentication, and encryption keys.
+ */
+struct PeerInfo
+{
+	ClientIdStruct         id;				///< Unique client identifier
+	std::string            username;		///< Client's display name
+	PublicKeyStruct        publicKey;		///< RSA public key for asymmetric encryption
+	SymmetricKeyStruct     symmetricKey;	///< Session encryption key for symmetric encryption
+	bool publicKeySet =	   false;			///< Flag indicating if public key is available
+	bool symmetricKeySet = false;			///< Flag indicating if symmetric key is available
+};
+
+// ================================
+// Class Definition
+// ================================
+
+/**
+ * @class       PeerRegistry
+ * @brief       RCU-style registry of known peers
+ * @details     A Snapshot is never modified after publication. Readers pin it with a
+ *              ReadGuard, which announces the current epoch in a per-thread slot and then
+ *              loads the snapshot pointer. Writers are serialized by a mutex; each write
+ *              publishes a new snapshot, retires the old one tagged with the epoch in which
+ *              it was replaced, and advances the epoch. A retired snapshot is freed once every
+ *              active reader has announced a later epoch.
+ *
+ *              Reader slots are shared by all registries in the process. Threads beyond the
+ *              slot capacity are counted instead; while any such reader is active, nothing
+ *              is reclaimed.
+ *
+ * @note        This class is non-copyable and non-movable because readers hold raw pointers
+ *              into it.
+ */
+class PeerRegistry
+{
+public:
+	// ================================
+	// Data Structures
+	// ================================
+
+	/**
+	 * @struct      Snapshot
+	 * @brief       Immutable version of the registry with lookup indexes
+	 */
+	struct Snapshot
+	{
+		std::vector<PeerInfo>                   peers;     ///< Peers in server order
+		std::unordered_map<std::string, size_t> byName;       ///< Username -> index in peers
+		std::unordered_map<std::string, size_t> byId;         ///< Raw 16-byte ID -> index in peers
+		uint64_t                                version = 0;  ///< Monotonic publication number
+
+		/**
+		 * @brief       Finds a peer by username
+		 * @return      Pointer into this snapshot, or nullptr
+		 */
+		const PeerInfo* findByName(const std::string& username) const;
+
+		/**
+		 * @brief       Finds a peer by client ID
+		 * @return      Pointer into this snapshot, or nullptr
+		 */
+		const PeerInfo* findById(const ClientIdStruct& clientID) const;
+	};
+
+	/**
+	 * @class       ReadGuard
+	 * @brief       Pins the current snapshot for the guard's lifetime
+	 * @details     Guards may be nested on one thread, across registries. Do not keep
+	 *              pointers obtained from a guard after it is destroyed, and do not write
+	 *              to a registry while holding a guard on it for long periods (the old
+	 *              version stays allocated until the guard is released).
+	 */
+	class ReadGuard
+	{
+	public:
+		explicit ReadGuard(const PeerRegistry& registry);
+		~ReadGuard();
+
+		ReadGuard(const ReadGuard&) = delete;
+		ReadGuard& operator=(const ReadGuard&) = delete;
+
+		const Snapshot& operator*() const { return *_snapshot; }
+		const Snapshot* operator->() const { return _snapshot; }
+
+	private:
+		const Snapshot* _snapshot;  ///< Pinned snapshot
+	};
+
+	/// Writer callback: edits a private copy of the peers; return false to discard the edit
+	using Mutation = std::function<bool(std::vector<PeerInfo>&)>;
+
+	// ================================
+	// Constructor and Destructor
+	// ================================
+
+	/**
+	 * @brief       Creates an empty registry
+	 */
+	PeerRegistry();
+
+	/**
+	 * @brief       Frees the current and all retired snapshots
+	 * @details     No ReadGuard may outlive the registry.
+	 */
+	virtual ~PeerRegistry();
+
+	// ================================
+	// Copy Control (Deleted)
+	// ================================
+
+	PeerRegistry(const PeerRegistry&) = delete;
+	PeerRegistry(PeerRegistry&&) noexcept = delete;
+	PeerRegistry& operator=(const PeerRegistry&) = delete;
+	PeerRegistry& operator=(PeerRegistry&&) noexcept = delete;
+
+	// ================================
+	// Writer Methods
+	// ================================
+
+	/**
+	 * @brief       Applies a mutation and publishes the result as a new snapshot
+	 * @param[in]   mutation    Edits a copy of the current peer list
+	 * @return      Result of the mutation (nothing is published on false)
+	 */
+	bool update(const Mutation& mutation);
+
+	/**
+	 * @brief       Merges a freshly downloaded peer list
+	 * @param[in]   peers    Complete peer list as returned by the server
+	 * @details     Peers missing from the new list are dropped. Keys already known for
+	 *              peers that remain (same client ID) are preserved.
+	 */
+	void mergeList(std::vector<PeerInfo> peers);
+
+	// ================================
+	// Reader Methods
+	// ================================
+
+	/**
+	 * @brief       Copies a peer found by username
+	 * @return      true if found, false otherwise
+	 */
+	bool findByName(const std::string& username, PeerInfo& peer) const;
+
+	/**
+	 * @brief       Copies a peer found by client ID
+	 * @return      true if found, false otherwise
+	 */
+	bool findById(const ClientIdStruct& clientID, PeerInfo& peer) const;
+
+	/**
+	 * @brief       Gets the number of peers in the current snapshot
+	 */
+	size_t size() const;
+
+	/**
+	 * @brief       Gets the number of retired snapshots awaiting reclamation
+	 */
+	size_t retiredCount() const;
+
+private:
+	// ================================
+	// Member Variables
+	// ================================
+
+	std::atomic<const Snapshot*>                      _current;     ///< Published snapshot
+	mutable std::mutex                                _writerMutex; ///< Serializes writers
+	std::vector<std::pair<uint64_t, const Snapshot*>> _retired;     ///< (retire epoch, snapshot)
+
+	// ================================
+	// Private Helper Methods
+	// ================================
+
+	/**
+	 * @brief       Builds lookup indexes and publishes a snapshot (writer mutex held)
+	 */
+	void publish(std::vector<PeerInfo> peers);
+
+	/**
+	 * @brief       Frees retired snapshots no reader can reach (writer mutex held)
+	 */
+	void reclaim();
+
+	/**
+	 * @brief       Returns the index key for a client ID
+	 */
+	static std::string idKey(const ClientIdStruct& clientID);
+};
@@ -0,0 +1,95 @@
+/**
+ * @file        PollScheduler.cpp
+ * @author      Natanel Maor Fishman
+ * @brief       Implementation of the adaptive inbox polling interval.
+ * @details     Backoff state, the active window, jitter and the server floor.
+ * @date        2025
+ */
+
+#include "PollScheduler.h"
+
+#include <algorithm>
+
+// ================================
+// Constructor
+// ================================
+
+PollScheduler::PollScheduler() : _intervalMs(0), _serverHint(0), _random(std::random_device()())
+{
+	configure(Settings());
+}
+
+// ================================
+// Public Interface Methods
+// ================================
+
+void PollScheduler::configure(const Settings& settings)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	_settings = settings;
+	_settings.minimumInterval = std::max(_settings.minimumInterval, std::chrono::milliseconds(1));
+	if (_settings.maximumInterval < _settings.minimumInterval) {
+		std::swap(_settings.minimumInterval, _settings.maximumInterval);
+		_settings.minimumInterval = std::max(_settings.minimumInterval, std::chrono::milliseconds(1));
+	}
+	_settings.backoffFactor = std::max(_settings.backoffFactor, 1.0);
+	_settings.jitter = std::min(std::max(_settings.jitter, 0.0), 0.9);
+
+	// Starts idle: a fresh client has no conversation to keep up with yet
+	_intervalMs = static_cast<double>(_settings.minimumInterval.count());
+	_lastActivity = Clock::now() - _settings.activeWindow;
+}
+
+PollScheduler::Settings PollScheduler::getSettings() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _settings;
+}
+
+void PollScheduler::recordActivity()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	_intervalMs = static_cast<double>(_settings.minimumInterval.count());
+	_lastActivity = Clock::now();
+	++_stats.activity;
+}
+
+void PollScheduler::recordEmptyPoll()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	++_stats.emptyPolls;
+	if (Clock::now() - _lastActivity < _settings.activeWindow) {
+		return;  // A reply may still be on its way
+	}
+	_intervalMs = std::min(_intervalMs * _settings.backoffFactor, static_cast<double>(_settings.maximumInterval.count()));
+	++_stats.backoffs;
+}
+
+void PollScheduler::setServerHint(const std::chrono::milliseconds hint)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	_serverHint = std::max(hint, std::chrono::milliseconds(0));
+}
+
+std::chrono::milliseconds PollScheduler::nextDelay()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	const double hintMs = static_cast<double>(_serverHint.count());
+	if (hintMs >= _intervalMs * (1.0 - _settings.jitter))
+	{
+		// Spread above the floor only, so clients held at the hint stay apart
+		std::uniform_real_distribution<double> spread(1.0, 1.0 + _settings.jitter);
+		return std::chrono::milliseconds(static_cast<int64_t>(std::max(hintMs, _intervalMs) * spread(_random)));
+	}
+	std::uniform_real_distribution<double> spread(1.0 - _settings.jitter, 1.0 + _settings.jitter);
+	return std::chrono::milliseconds(static_cast<int64_t>(_intervalMs * spread(_random)));
+}
+
+PollScheduler::Stats PollScheduler::getStats() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	Stats stats = _stats;
+	stats.interval = std::chrono::milliseconds(static_cast<int64_t>(_intervalMs));
+	stats.serverHint = _serverHint;
+	return stats;
+}
@@ -0,0 +1,153 @@
+/**
+ * @file        PollScheduler.h
+ * @author      Natanel Maor Fishman
+ * @brief       Adaptive inbox polling interval
+ * @details     Decides how long a poller waits before its next inbox check: the short
+ *              minimum interval while a conversation is active, an exponentially growing
+ *              one while the inbox stays empty, randomized so that many clients started
+ *              together do not poll in lockstep, and never shorter than the interval the
+ *              server asks for.
+ * @version     2.0
+ * @date        2025
+ */
+
+#pragma once
+
+// ================================
+// Standard Library Includes
+// ================================
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <random>
+
+// ================================
+// Class Definition
+// ================================
+
+/**
+ * @class       PollScheduler
+ * @brief       Active/idle poll interval controller with jitter and a server floor
+ * @details     Activity (a message sent or received) resets the interval to the
+ *              minimum. An empty poll within activeWindow of the last activity keeps
+ *              it there; after that, every empty poll multiplies it by backoffFactor,
+ *              up to the maximum. The delay handed out is the interval spread by
+ *              +/- jitter; when the server hint is longer, it is the hint spread upward.
+ *
+ * @note        Thread-safe.
+ */
+class PollScheduler
+{
+public:
+	// ================================
+	// Data Structures
+	// ================================
+
+	/**
+	 * @struct      Settings
+	 * @brief       Interval bounds, backoff and jitter
+	 */
+	struct Settings
+	{
+		std::chrono::milliseconds minimumInterval{ 1000 };  ///< Interval while a conversation is active
+		std::chrono::milliseconds maximumInterval{ 30000 }; ///< Backoff ceiling while idle
+		std::chrono::milliseconds activeWindow{ 30000 };    ///< Time after the last activity that counts as active
+		double                    backoffFactor = 2.0;      ///< Interval growth per empty poll once idle
+		double                    jitter = 0.2;             ///< Random spread, as a fraction of the interval
+	};
+
+	/**
+	 * @struct      Stats
+	 * @brief       Observed scheduling behavior
+	 */
+	struct Stats
+	{
+		uint64_t                  activity = 0;     ///< Messages sent or received
+		uint64_t                  emptyPolls = 0;   ///< Polls that found nothing
+		uint64_t                  backoffs = 0;     ///< Empty polls that lengthened the interval
+		std::chrono::milliseconds interval{ 0 };    ///< Current interval before jitter and hint
+		std::chrono::milliseconds serverHint{ 0 };  ///< Last server hint (0 = none)
+	};
+
+	// ================================
+	// Constructor and Destructor
+	// ================================
+
+	/**
+	 * @brief       Creates a scheduler at the minimum interval
+	 */
+	PollScheduler();
+
+	/**
+	 * @brief       Virtual destructor
+	 */
+	virtual ~PollScheduler() = default;
+
+	// ================================
+	// Copy Control (Deleted)
+	// ================================
+
+	PollScheduler(const PollScheduler&) = delete;
+	PollScheduler& operator=(const PollScheduler&) = delete;
+
+	// ================================
+	// Public Interface Methods
+	// ================================
+
+	/**
+	 * @brief       Replaces the settings and restarts at the minimum interval
+	 * @param[in]   settings    Bounds are ordered if given inverted; factor and jitter are clamped
+	 */
+	void configure(const Settings& settings);
+
+	/**
+	 * @brief       Gets the current settings
+	 */
+	Settings getSettings() const;
+
+	/**
+	 * @brief       Records a sent or received message; returns to the minimum interval
+	 */
+	void recordActivity();
+
+	/**
+	 * @brief       Records a poll that found nothing; backs off once outside the active window
+	 */
+	void recordEmptyPoll();
+
+	/**
+	 * @brief       Sets the shortest interval the server accepts
+	 * @param[in]   hint    Server-suggested minimum time between polls (0 = none)
+	 */
+	void setServerHint(std::chrono::milliseconds hint);
+
+	/**
+	 * @brief       Gets the time to wait before the next poll (jittered, at least the server hint)
+	 */
+	std::chrono::milliseconds nextDelay();
+
+	/**
+	 * @brief       Gets the scheduling statistics
+	 */
+	Stats getStats() const;
+
+private:
+	// ================================
+	// Internal Types
+	// ================================
+
+	using Clock = std::chrono::steady_clock;
+
+	// ================================
+	// Member Variables
+	// ================================
+
+	mutable std::mutex        _mutex;         ///< Guards everything below
+	Settings                  _settings;      ///< Bounds, backoff and jitter
+	double                    _intervalMs;    ///< Current interval before jitter and hint
+	Clock::time_point         _lastActivity;  ///< Last sent or received message
+	std::chrono::milliseconds _serverHint;    ///< Server floor (0 = none)
+	std::minstd_rand          _random;        ///< Jitter source
+	Stats                     _stats;         ///< Observed behavior
+};
@@ -8,6 +8,7 @@
 
 #include "RSAWrapper.h"
 #include "protocol.h"
+#include "Tracer.h"
 
 // ================================
 // RSAWrapper.cpp - Implementation
@@ -21,6 +22,8 @@
  */
 RSAPublicWrapper::RSAPublicWrapper(const PublicKeyStruct& publicKeyData)
 {
+	TraceSpan span("crypto", "rsaLoadPublicKey");
+
 	// Load the public key from the provided key structure
 	CryptoPP::StringSource keySource(publicKeyData.publicKey,
 		sizeof(publicKeyData.publicKey),
@@ -39,6 +42,9 @@ RSAPublicWrapper::RSAPublicWrapper(const PublicKeyStruct& publicKeyData)
  */
 std::string RSAPublicWrapper::encrypt(const uint8_t* plaintextData, size_t dataLength)
 {
+	TraceSpan span("crypto", "rsaEncrypt");
+	span.setBytes(dataLength);
+
 	std::string encryptedData;
 
 	// Create RSA encryption engine with OAEP padding and SHA-1
@@ -59,6 +65,8 @@ std::string RSAPublicWrapper::encrypt(const uint8_t* plaintextData, size_t dataL
  */
 RSAPrivateWrapper::RSAPrivateWrapper()
 {
+	TraceSpan span("crypto", "rsaGenerateKey");
+
 	// Generate a new RSA-1024 private key using cryptographically secure random numbers
 	_privateKey.Initialize(_randomGenerator, RSA_KEY_SIZE_BITS);
 }
@@ -71,6 +79,8 @@ RSAPrivateWrapper::RSAPrivateWrapper()
  */
 RSAPrivateWrapper::RSAPrivateWrapper(const std::string& privateKeyString)
 {
+	TraceSpan span("crypto", "rsaLoadPrivateKey");
+
 	// Load the private key from the serialized string format
 	CryptoPP::StringSource keySource(privateKeyString, true);
 	_privateKey.Load(keySource);
@@ -122,6 +132,9 @@ std::string RSAPrivateWrapper::getPublicKey() const
  */
 std::string RSAPrivateWrapper::decrypt(const uint8_t* encryptedData, size_t dataLength)
 {
+	TraceSpan span("crypto", "rsaDecrypt");
+	span.setBytes(dataLength);
+
 	std::string decryptedPlaintext;
 
 	// Create RSA decryption engine with OAEP padding and SHA-1
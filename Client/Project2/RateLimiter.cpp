@@ -0,0 +1,188 @@
+/**
+ * @file        RateLimiter.cpp
+ * @author      Natanel Maor Fishman
+ * @brief       Implementation of client-side outbound pacing.
+ * @details     Token buckets per request code with additive-increase / multiplicative-decrease
+ *              rate adaptation.
+ * @date        2025
+ */
+
+#include "RateLimiter.h"
+
+#include <algorithm>
+#include <thread>
+
+// ================================
+// AIMD Tuning
+// ================================
+
+namespace
+{
+	constexpr double  AIMD_DECREASE_FACTOR = 0.5;   ///< Multiplicative decrease on congestion
+	constexpr double  AIMD_INCREASE_STEP = 0.05;    ///< Additive increase per healthy exchange
+	constexpr double  AIMD_MIN_FACTOR = 0.05;       ///< Never slow below 5% of the configured rate
+	constexpr auto    AIMD_COOLDOWN = std::chrono::milliseconds(500); ///< Min time between decreases
+	constexpr auto    MAX_SINGLE_WAIT = std::chrono::milliseconds(100); ///< Re-check interval while waiting
+}
+
+// ================================
+// Configuration Methods
+// ================================
+
+void RateLimiter::setLimit(const code_t code, const Limit& limit)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	Bucket& bucket = _buckets[code];
+	bucket.limit = limit;
+	bucket.limit.burstRequests = std::max(1.0, limit.burstRequests);
+	bucket.requestTokens = bucket.limit.burstRequests;
+	bucket.byteTokens = byteCapacity(bucket);
+	bucket.factor = 1.0;
+	bucket.lastRefill = Clock::now();
+	bucket.lastDecrease = Clock::time_point();
+	bucket.stats.rateFactor = 1.0;
+}
+
+void RateLimiter::removeLimit(const code_t code)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	_buckets.erase(code);
+}
+
+bool RateLimiter::isEnabled() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return !_buckets.empty();
+}
+
+// ================================
+// Pacing Methods
+// ================================
+
+/**
+ * @brief       Waits until both buckets allow the request, then debits them
+ */
+uint64_t RateLimiter::acquire(const code_t code, const size_t bytes)
+{
+	const auto start = Clock::now();
+	bool delayed = false;
+
+	while (true)
+	{
+		Clock::duration wait = Clock::duration::zero();
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			const auto it = _buckets.find(code);
+			if (it == _buckets.end()) {
+				return 0;  // Not paced
+			}
+			Bucket& bucket = it->second;
+			refill(bucket, Clock::now());
+
+			const bool requestReady = (bucket.limit.requestsPerSecond <= 0) || (bucket.requestTokens >= 1.0);
+			const bool bytesReady = (bucket.limit.bytesPerSecond <= 0) || (bucket.byteTokens >= 0.0);
+
+			if (requestReady && bytesReady)
+			{
+				if (bucket.limit.requestsPerSecond > 0) {
+					bucket.requestTokens -= 1.0;
+				}
+				if (bucket.limit.bytesPerSecond > 0) {
+					bucket.byteTokens -= static_cast<double>(bytes);  // May go into debt
+				}
+
+				const uint64_t waited = static_cast<uint64_t>(
+					std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count());
+				++bucket.stats.admitted;
+				if (delayed)
+				{
+					++bucket.stats.delayed;
+					bucket.stats.waitedMicros += waited;
+				}
+				return waited;
+			}
+
+			// Time until the missing tokens accumulate at the current (adapted) rate
+			double seconds = 0;
+			if (!requestReady) {
+				seconds = std::max(seconds, (1.0 - bucket.requestTokens) / (bucket.limit.requestsPerSecond * bucket.factor));
+			}
+			if (!bytesReady) {
+				seconds = std::max(seconds, -bucket.byteTokens / (bucket.limit.bytesPerSecond * bucket.factor));
+			}
+			wait = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(seconds));
+		}
+
+		delayed = true;
+		std::this_thread::sleep_for(std::min<Clock::duration>(wait, MAX_SINGLE_WAIT));
+	}
+}
+
+/**
+ * @brief       Applies additive increase or multiplicative decrease
+ */
+void RateLimiter::reportOutcome(const code_t code, const bool success, const std::chrono::microseconds latency)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	const auto it = _buckets.find(code);
+	if (it == _buckets.end()) {
+		return;
+	}
+	Bucket& bucket = it->second;
+	const auto now = Clock::now();
+	refill(bucket, now);  // Settle tokens at the old rate before changing it
+
+	const bool congested = !success ||
+		(latency > std::chrono::milliseconds(bucket.limit.latencyTargetMs));
+
+	if (congested)
+	{
+		if (now - bucket.lastDecrease >= AIMD_COOLDOWN)
+		{
+			bucket.factor = std::max(AIMD_MIN_FACTOR, bucket.factor * AIMD_DECREASE_FACTOR);
+			bucket.lastDecrease = now;
+			++bucket.stats.congestionEvents;
+		}
+	}
+	else
+	{
+		bucket.factor = std::min(1.0, bucket.factor + AIMD_INCREASE_STEP);
+	}
+	bucket.stats.rateFactor = bucket.factor;
+}
+
+RateLimiter::Stats RateLimiter::getStats(const code_t code) const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	const auto it = _buckets.find(code);
+	return (it == _buckets.end()) ? Stats() : it->second.stats;
+}
+
+// ================================
+// Private Helper Methods
+// ================================
+
+void RateLimiter::refill(Bucket& bucket, const Clock::time_point now)
+{
+	const double elapsed = std::chrono::duration<double>(now - bucket.lastRefill).count();
+	bucket.lastRefill = now;
+	if (elapsed <= 0) {
+		return;
+	}
+
+	if (bucket.limit.requestsPerSecond > 0)
+	{
+		bucket.requestTokens = std::min(bucket.limit.burstRequests,
+			bucket.requestTokens + elapsed * bucket.limit.requestsPerSecond * bucket.factor);
+	}
+	if (bucket.limit.bytesPerSecond > 0)
+	{
+		bucket.byteTokens = std::min(byteCapacity(bucket),
+			bucket.byteTokens + elapsed * bucket.limit.bytesPerSecond * bucket.factor);
+	}
+}
+
+double RateLimiter::byteCapacity(const Bucket& bucket)
+{
+	return (bucket.limit.burstBytes > 0) ? bucket.limit.burstBytes : bucket.limit.bytesPerSecond;
+}
@@ -0,0 +1,197 @@
+/**
+ * @file        RateLimiter.h
+ * @author      Natanel Maor Fishman
+ * @brief       Client-side outbound pacing for server requests
+ * @details     Token-bucket limiter on requests per second and bytes per second,
+ *              configurable per request code, with AIMD rate adaptation driven by
+ *              observed failures and latency. Keeps batch senders from flooding the
+ *              single-threaded server and its small accept backlog.
+ * @version     2.0
+ * @date        2025
+ */
+
+#pragma once
+
+// ================================
+// Standard Library Includes
+// ================================
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+
+// ================================
+// Application Includes
+// ================================
+
+#include "protocol.h"
+
+// ================================
+// Class Definition
+// ================================
+
+/**
+ * @class       RateLimiter
+ * @brief       Per-request-code token buckets with AIMD adaptation
+ * @details     Each configured request code owns two buckets (requests and bytes).
+ *              A request may take the byte bucket into debt, so payloads larger than
+ *              the burst size still pass; the debt delays the following requests.
+ *
+ *              Adaptation (AIMD): every bucket runs at configured rate x factor.
+ *              A failed or slow exchange halves the factor (at most once per cooldown
+ *              period); each healthy exchange adds a small step back, up to 1.0.
+ *
+ *              Codes without a configured limit are not paced.
+ *
+ * @note        Thread-safe. Waiting happens outside the internal lock.
+ */
+class RateLimiter
+{
+public:
+	// ================================
+	// Data Structures
+	// ================================
+
+	/**
+	 * @struct      Limit
+	 * @brief       Pacing configuration for one request code
+	 */
+	struct Limit
+	{
+		double   requestsPerSecond = 0;   ///< Request rate ceiling (0 = unlimited)
+		double   bytesPerSecond = 0;      ///< Byte rate ceiling (0 = unlimited)
+		double   burstRequests = 1;       ///< Request bucket capacity
+		double   burstBytes = 0;          ///< Byte bucket capacity (0 = one second of bytes)
+		uint32_t latencyTargetMs = 500;   ///< Exchanges slower than this count as congestion
+	};
+
+	/**
+	 * @struct      Stats
+	 * @brief       Observed pacing behavior for one request code
+	 */
+	struct Stats
+	{
+		uint64_t admitted = 0;            ///< Requests let through
+		uint64_t delayed = 0;             ///< Requests that had to wait
+		uint64_t waitedMicros = 0;        ///< Total time spent waiting
+		uint64_t congestionEvents = 0;    ///< Multiplicative decreases applied
+		double   rateFactor = 1.0;        ///< Current fraction of configured rates
+	};
+
+	// ================================
+	// Constructor and Destructor
+	// ================================
+
+	/**
+	 * @brief       Default constructor - no codes paced
+	 */
+	RateLimiter() = default;
+
+	/**
+	 * @brief       Virtual destructor
+	 */
+	virtual ~RateLimiter() = default;
+
+	// ================================
+	// Copy Control (Deleted)
+	// ================================
+
+	RateLimiter(const RateLimiter&) = delete;
+	RateLimiter& operator=(const RateLimiter&) = delete;
+
+	// ================================
+	// Configuration Methods
+	// ================================
+
+	/**
+	 * @brief       Sets or replaces the limit for a request code
+	 * @param[in]   code     Request code to pace
+	 * @param[in]   limit    Pacing configuration
+	 */
+	void setLimit(code_t code, const Limit& limit);
+
+	/**
+	 * @brief       Removes pacing for a request code
+	 * @param[in]   code     Request code
+	 */
+	void removeLimit(code_t code);
+
+	/**
+	 * @brief       Checks if any request code is paced
+	 * @return      true if at least one limit is configured
+	 */
+	bool isEnabled() const;
+
+	// ================================
+	// Pacing Methods
+	// ================================
+
+	/**
+	 * @brief       Blocks until a request may be sent
+	 * @param[in]   code     Request code of the outgoing request
+	 * @param[in]   bytes    Request size on the wire
+	 * @return      Time spent waiting, in microseconds
+	 */
+	uint64_t acquire(code_t code, size_t bytes);
+
+	/**
+	 * @brief       Feeds an exchange outcome into the AIMD controller
+	 * @param[in]   code       Request code of the completed exchange
+	 * @param[in]   success    false if the connection or transfer failed
+	 * @param[in]   latency    Duration of the exchange
+	 */
+	void reportOutcome(code_t code, bool success, std::chrono::microseconds latency);
+
+	/**
+	 * @brief       Returns pacing statistics for a request code
+	 * @param[in]   code     Request code
+	 * @return      Statistics (default values if the code is not paced)
+	 */
+	Stats getStats(code_t code) const;
+
+private:
+	// ================================
+	// Internal Types
+	// ================================
+
+	using Clock = std::chrono::steady_clock;
+
+	/**
+	 * @struct      Bucket
+	 * @brief       Token-bucket state for one request code
+	 */
+	struct Bucket
+	{
+		Limit             limit;              ///< Configured ceiling
+		double            requestTokens = 0;  ///< Available request tokens
+		double            byteTokens = 0;     ///< Available byte tokens (may be negative)
+		double            factor = 1.0;       ///< AIMD multiplier applied to both rates
+		Clock::time_point lastRefill;         ///< Last refill time
+		Clock::time_point lastDecrease;       ///< Last multiplicative decrease
+		Stats             stats;              ///< Observed behavior
+	};
+
+	// ================================
+	// Member Variables
+	// ================================
+
+	mutable std::mutex      _mutex;    ///< Guards all buckets
+	std::map<code_t, Bucket> _buckets; ///< Buckets by request code
+
+	// ================================
+	// Private Helper Methods
+	// ================================
+
+	/**
+	 * @brief       Adds tokens accumulated since the last refill
+	 * @param[in,out] bucket    Bucket to refill
+	 * @param[in]     now       Current time
+	 */
+	static void refill(Bucket& bucket, Clock::time_point now);
+
+	/**
+	 * @brief       Returns the byte bucket capacity for a bucket
+	 */
+	static double byteCapacity(const Bucket& bucket);
+};
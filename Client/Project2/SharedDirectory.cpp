@@ -0,0 +1,433 @@
+/**
+ * @file        SharedDirectory.cpp
+ * @author      Natanel Maor Fishman
+ * @brief       Implementation of the shared-memory peer directory.
+ * @details     Maps a named segment through Boost.Interprocess and implements the seqlock
+ *              reader/writer protocol over an offset-based layout.
+ * @date        2025
+ */
+
+#include "SharedDirectory.h"
+
+#include <chrono>
+#include <cstring>
+#include <thread>
+#include <boost/interprocess/mapped_region.hpp>
+#ifdef _WIN32
+#include <boost/interprocess/windows_shared_memory.hpp>
+#else
+#include <boost/interprocess/shared_memory_object.hpp>
+#endif
+
+namespace ipc = boost::interprocess;
+
+// ================================
+// Layout Constants
+// ================================
+
+namespace
+{
+	constexpr uint32_t SEGMENT_MAGIC = 0x4D535544;       ///< "MSUD"
+	constexpr uint32_t SEGMENT_LAYOUT_VERSION = 1;       ///< Bumped on any layout change
+	constexpr size_t   SEGMENT_ALIGNMENT = 64;           ///< Cache line size
+	constexpr size_t   NAME_POOL_SIZE = SHARED_DIRECTORY_CAPACITY * CLIENT_NAME_MAX_LENGTH;
+	constexpr int64_t  STALE_WRITER_LOCK_MS = 5000;      ///< Writer lock takeover timeout
+	constexpr int      MAX_READ_ATTEMPTS = 1000;         ///< Seqlock retries before giving up
+
+	enum : uint32_t { SEGMENT_UNINITIALIZED = 0, SEGMENT_INITIALIZING = 1, SEGMENT_READY = 2 };
+
+	constexpr size_t alignUp(const size_t value) {
+		return (value + SEGMENT_ALIGNMENT - 1) & ~(SEGMENT_ALIGNMENT - 1);
+	}
+}
+
+/**
+ * @struct      SharedPeerDirectory::SegmentHeader
+ * @brief       Header at offset 0 of the shared segment
+ */
+struct SharedPeerDirectory::SegmentHeader
+{
+	std::atomic<uint32_t> initState;      ///< One-time initialization state
+	uint32_t              magic;          ///< SEGMENT_MAGIC once initialized
+	uint32_t              layoutVersion;  ///< SEGMENT_LAYOUT_VERSION
+	uint32_t              capacity;       ///< Number of peer slots
+	std::atomic<uint32_t> sequence;       ///< Seqlock counter (odd while writing)
+	uint32_t              entryCount;     ///< Number of published peers
+	uint32_t              poolUsed;       ///< Bytes used in the name pool
+	std::atomic<int64_t>  writerLockedAt; ///< Lock acquisition time, 0 when free
+	int64_t               refreshedAtMs;  ///< Time of the last full peer list publish
+};
+
+namespace
+{
+	constexpr size_t HEADER_OFFSET = 0;
+	constexpr size_t HEADER_RESERVED = 2 * SEGMENT_ALIGNMENT;
+	constexpr size_t IDS_OFFSET = HEADER_OFFSET + HEADER_RESERVED;
+	constexpr size_t NAMES_OFFSET = IDS_OFFSET + alignUp(SHARED_DIRECTORY_CAPACITY * sizeof(ClientIdStruct));
+	constexpr size_t KEY_FLAGS_OFFSET = NAMES_OFFSET + alignUp(SHARED_DIRECTORY_CAPACITY * 2 * sizeof(uint32_t));
+	constexpr size_t KEYS_OFFSET = KEY_FLAGS_OFFSET + alignUp(SHARED_DIRECTORY_CAPACITY);
+	constexpr size_t POOL_OFFSET = KEYS_OFFSET + alignUp(SHARED_DIRECTORY_CAPACITY * sizeof(PublicKeyStruct));
+}
+
+// ================================
+// Constructor and Destructor
+// ================================
+
+SharedPeerDirectory::SharedPeerDirectory() : _region(nullptr), _base(nullptr)
+{
+	static_assert(sizeof(SegmentHeader) <= HEADER_RESERVED, "Segment header overlaps peer IDs");
+}
+
+SharedPeerDirectory::~SharedPeerDirectory()
+{
+	detach();
+}
+
+// ================================
+// Segment Management Methods
+// ================================
+
+/**
+ * @brief       Opens or creates the named segment and initializes its layout once
+ */
+bool SharedPeerDirectory::attach(const std::string& segmentName)
+{
+	detach();
+	try
+	{
+#ifdef _WIN32
+		// Native Windows sections are released when the last process unmaps them
+		ipc::windows_shared_memory segment(ipc::open_or_create, segmentName.c_str(), ipc::read_write, segmentSize());
+		_region = new ipc::mapped_region(segment, ipc::read_write);
+#else
+		ipc::shared_memory_object segment(ipc::open_or_create, segmentName.c_str(), ipc::read_write);
+		ipc::offset_t currentSize = 0;
+		if (!segment.get_size(currentSize) || static_cast<size_t>(currentSize) < segmentSize()) {
+			segment.truncate(static_cast<ipc::offset_t>(segmentSize()));
+		}
+		_region = new ipc::mapped_region(segment, ipc::read_write);
+#endif
+		_base = static_cast<uint8_t*>(_region->get_address());
+	}
+	catch (...)
+	{
+		detach();
+		return false;
+	}
+
+	// New segments are zero-filled; the first process to claim initialization writes the header
+	SegmentHeader* const hdr = header();
+	uint32_t expected = SEGMENT_UNINITIALIZED;
+	if (hdr->initState.compare_exchange_strong(expected, SEGMENT_INITIALIZING))
+	{
+		hdr->magic = SEGMENT_MAGIC;
+		hdr->layoutVersion = SEGMENT_LAYOUT_VERSION;
+		hdr->capacity = SHARED_DIRECTORY_CAPACITY;
+		hdr->entryCount = 0;
+		hdr->poolUsed = 0;
+		hdr->refreshedAtMs = 0;
+		hdr->initState.store(SEGMENT_READY, std::memory_order_release);
+	}
+	else
+	{
+		for (int attempt = 0; attempt < MAX_READ_ATTEMPTS && hdr->initState.load(std::memory_order_acquire) != SEGMENT_READY; ++attempt) {
+			std::this_thread::yield();
+		}
+	}
+
+	if (hdr->initState.load(std::memory_order_acquire) != SEGMENT_READY ||
+		hdr->magic != SEGMENT_MAGIC ||
+		hdr->layoutVersion != SEGMENT_LAYOUT_VERSION ||
+		hdr->capacity != SHARED_DIRECTORY_CAPACITY)
+	{
+		detach();
+		return false;
+	}
+	return true;
+}
+
+void SharedPeerDirectory::detach()
+{
+	delete _region;
+	_region = nullptr;
+	_base = nullptr;
+}
+
+// ================================
+// Reader Methods (Lock-Free)
+// ================================
+
+/**
+ * @brief       Copies all peers, retrying while a writer is active
+ */
+bool SharedPeerDirectory::readPeers(std::vector<PeerRecord>& peers, int64_t& refreshedAtMs) const
+{
+	if (!isAttached()) {
+		return false;
+	}
+	const SegmentHeader* const hdr = header();
+
+	for (int attempt = 0; attempt < MAX_READ_ATTEMPTS; ++attempt)
+	{
+		const uint32_t before = hdr->sequence.load(std::memory_order_acquire);
+		if (before & 1) {
+			std::this_thread::yield();
+			continue;
+		}
+
+		// Copy speculatively; torn values are discarded by the sequence check below
+		const uint32_t count = hdr->entryCount;
+		refreshedAtMs = hdr->refreshedAtMs;
+		if (count > SHARED_DIRECTORY_CAPACITY) {
+			continue;
+		}
+
+		peers.resize(count);
+		bool valid = true;
+		for (uint32_t i = 0; i < count && valid; ++i)
+		{
+			PeerRecord& peer = peers[i];
+			const NameSlot slot = names()[i];
+			if (slot.length >= CLIENT_NAME_MAX_LENGTH || slot.offset + slot.length > NAME_POOL_SIZE) {
+				valid = false;
+				break;
+			}
+			peer.id = ids()[i];
+			peer.username.assign(namePool() + slot.offset, slot.length);
+			peer.publicKeySet = (keyFlags()[i] != 0);
+			if (peer.publicKeySet) {
+				peer.publicKey = keys()[i];
+			}
+		}
+
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (valid && hdr->sequence.load(std::memory_order_relaxed) == before) {
+			return refreshedAtMs != 0;
+		}
+	}
+	return false;
+}
+
+/**
+ * @brief       Scans the dense ID array for a peer and copies its key
+ */
+bool SharedPeerDirectory::findPublicKey(const ClientIdStruct& clientID, PublicKeyStruct& publicKey) const
+{
+	if (!isAttached()) {
+		return false;
+	}
+	const SegmentHeader* const hdr = header();
+
+	for (int attempt = 0; attempt < MAX_READ_ATTEMPTS; ++attempt)
+	{
+		const uint32_t before = hdr->sequence.load(std::memory_order_acquire);
+		if (before & 1) {
+			std::this_thread::yield();
+			continue;
+		}
+
+		uint32_t count = hdr->entryCount;
+		if (count > SHARED_DIRECTORY_CAPACITY) {
+			count = 0;
+		}
+
+		bool found = false;
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			if (ids()[i] == clientID)
+			{
+				found = (keyFlags()[i] != 0);
+				if (found) {
+					publicKey = keys()[i];
+				}
+				break;
+			}
+		}
+
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (hdr->sequence.load(std::memory_order_relaxed) == before) {
+			return found;
+		}
+	}
+	return false;
+}
+
+bool SharedPeerDirectory::isFresh() const
+{
+	if (!isAttached()) {
+		return false;
+	}
+	const int64_t refreshedAt = header()->refreshedAtMs;
+	return (refreshedAt != 0) && (nowMs() - refreshedAt < SHARED_DIRECTORY_TTL_MS);
+}
+
+// ================================
+// Writer Methods
+// ================================
+
+/**
+ * @brief       Rewrites the whole peer table under the seqlock
+ */
+bool SharedPeerDirectory::publishPeers(const std::vector<PeerRecord>& peers)
+{
+	if (!isAttached() || !tryLockWriter()) {
+		return false;
+	}
+	SegmentHeader* const hdr = header();
+
+	// Keys published by other processes survive a list refresh (we are the only writer here)
+	const uint32_t previousCount = (hdr->entryCount <= SHARED_DIRECTORY_CAPACITY) ? hdr->entryCount : 0;
+	std::vector<std::pair<ClientIdStruct, PublicKeyStruct>> knownKeys;
+	for (uint32_t i = 0; i < previousCount; ++i)
+	{
+		if (keyFlags()[i] != 0) {
+			knownKeys.emplace_back(ids()[i], keys()[i]);
+		}
+	}
+
+	hdr->sequence.fetch_add(1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	uint32_t count = 0;
+	uint32_t poolUsed = 0;
+	for (const PeerRecord& peer : peers)
+	{
+		const uint32_t nameLength = static_cast<uint32_t>(peer.username.size());
+		if (count == SHARED_DIRECTORY_CAPACITY || nameLength >= CLIENT_NAME_MAX_LENGTH) {
+			continue;
+		}
+
+		ids()[count] = peer.id;
+		names()[count] = { poolUsed, nameLength };
+		memcpy(namePool() + poolUsed, peer.username.data(), nameLength);
+		poolUsed += nameLength;
+
+		keyFlags()[count] = 0;
+		if (peer.publicKeySet)
+		{
+			keys()[count] = peer.publicKey;
+			keyFlags()[count] = 1;
+		}
+		else
+		{
+			for (const auto& known : knownKeys)
+			{
+				if (known.first == peer.id)
+				{
+					keys()[count] = known.second;
+					keyFlags()[count] = 1;
+					break;
+				}
+			}
+		}
+		++count;
+	}
+	hdr->entryCount = count;
+	hdr->poolUsed = poolUsed;
+	hdr->refreshedAtMs = nowMs();
+
+	hdr->sequence.fetch_add(1, std::memory_order_release);
+	unlockWriter();
+	return true;
+}
+
+/**
+ * @brief       Updates a single key slot under the seqlock
+ */
+bool SharedPeerDirectory::publishPublicKey(const ClientIdStruct& clientID, const PublicKeyStruct& publicKey)
+{
+	if (!isAttached() || !tryLockWriter()) {
+		return false;
+	}
+	SegmentHeader* const hdr = header();
+	const uint32_t count = (hdr->entryCount <= SHARED_DIRECTORY_CAPACITY) ? hdr->entryCount : 0;
+
+	bool stored = false;
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		if (ids()[i] == clientID)
+		{
+			hdr->sequence.fetch_add(1, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_release);
+			keys()[i] = publicKey;
+			keyFlags()[i] = 1;
+			hdr->sequence.fetch_add(1, std::memory_order_release);
+			stored = true;
+			break;
+		}
+	}
+
+	unlockWriter();
+	return stored;
+}
+
+// ================================
+// Private Helper Methods
+// ================================
+
+bool SharedPeerDirectory::tryLockWriter()
+{
+	SegmentHeader* const hdr = header();
+	const int64_t now = nowMs();
+	int64_t lockedAt = hdr->writerLockedAt.load(std::memory_order_relaxed);
+
+	if (lockedAt != 0 && (now - lockedAt) < STALE_WRITER_LOCK_MS) {
+		return false;  // Another process is refreshing
+	}
+	if (!hdr->writerLockedAt.compare_exchange_strong(lockedAt, now, std::memory_order_acquire)) {
+		return false;
+	}
+
+	// A writer that died mid-update leaves the sequence odd; make it even again
+	const uint32_t sequence = hdr->sequence.load(std::memory_order_relaxed);
+	if (sequence & 1) {
+		hdr->sequence.store(sequence + 1, std::memory_order_release);
+	}
+	return true;
+}
+
+void SharedPeerDirectory::unlockWriter()
+{
+	header()->writerLockedAt.store(0, std::memory_order_release);
+}
+
+SharedPeerDirectory::SegmentHeader* SharedPeerDirectory::header() const
+{
+	return reinterpret_cast<SegmentHeader*>(_base + HEADER_OFFSET);
+}
+
+ClientIdStruct* SharedPeerDirectory::ids() const
+{
+	return reinterpret_cast<ClientIdStruct*>(_base + IDS_OFFSET);
+}
+
+SharedPeerDirectory::NameSlot* SharedPeerDirectory::names() const
+{
+	return reinterpret_cast<NameSlot*>(_base + NAMES_OFFSET);
+}
+
+uint8_t* SharedPeerDirectory::keyFlags() const
+{
+	return _base + KEY_FLAGS_OFFSET;
+}
+
+PublicKeyStruct* SharedPeerDirectory::keys() const
+{
+	return reinterpret_cast<PublicKeyStruct*>(_base + KEYS_OFFSET);
+}
+
+char* SharedPeerDirectory::namePool() const
+{
+	return reinterpret_cast<char*>(_base + POOL_OFFSET);
+}
+
+size_t SharedPeerDirectory::segmentSize()
+{
+	return POOL_OFFSET + alignUp(NAME_POOL_SIZE);
+}
+
+int64_t SharedPeerDirectory::nowMs()
+{
+	return std::chrono::duration_cast<std::chrono::milliseconds>(
+		std::chrono::system_clock::now().time_since_epoch()).count();
+}
@@ -0,0 +1,241 @@
+/**
+ * @file        SharedDirectory.h
+ * @author      Natanel Maor Fishman
+ * @brief       Shared-memory peer directory for co-located client processes
+ * @details     Publishes the peer directory (client IDs, names and public keys) in a named
+ *              shared-memory segment so that every client process on the host can read it
+ *              instead of downloading identical data from the server.
+ *              One process refreshes the segment; readers never block (seqlock protocol).
+ * @version     2.0
+ * @date        2025
+ */
+
+#pragma once
+
+// ================================
+// Standard Library Includes
+// ================================
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// ================================
+// Application Includes
+// ================================
+
+#include "protocol.h"
+
+// ================================
+// Constants
+// ================================
+
+/// Default name of the shared peer directory segment
+constexpr auto SHARED_DIRECTORY_NAME = "MessageU_PeerDirectory";
+
+/// Maximum number of peers held by the shared directory
+constexpr uint32_t SHARED_DIRECTORY_CAPACITY = 4096;
+
+/// Age (in milliseconds) after which the published peer list is considered stale
+constexpr int64_t SHARED_DIRECTORY_TTL_MS = 30000;
+
+// ================================
+// Forward Declarations
+// ================================
+
+namespace boost { namespace interprocess { class mapped_region; } }
+
+// ================================
+// Class Definition
+// ================================
+
+/**
+ * @class       SharedPeerDirectory
+ * @brief       Lock-free readable peer directory stored in named shared memory
+ * @details     The segment uses an offset-based layout so it can be mapped at any address:
+ *
+ *              | header | ids[capacity] | names[capacity] | keyFlags[capacity] | keys[capacity] | name pool |
+ *
+ *              IDs are kept in a dense array so lookups by ID scan a single contiguous block.
+ *              Names are stored as (offset, length) records into a shared string pool.
+ *
+ *              Consistency is provided by a sequence counter (seqlock): the writer makes the
+ *              counter odd while it updates the segment and even when done. Readers copy the
+ *              data they need and retry if the counter changed meanwhile. Writers are
+ *              serialized by a try-lock in the header, so only one process refreshes at a time.
+ *
+ * @note        This class is non-copyable and non-movable because it owns a memory mapping.
+ */
+class SharedPeerDirectory
+{
+public:
+	// ================================
+	// Data Structures
+	// ================================
+
+	/**
+	 * @struct      PeerRecord
+	 * @brief       Peer information exchanged with the shared directory
+	 */
+	struct PeerRecord
+	{
+		ClientIdStruct  id;                 ///< Peer's client identifier
+		std::string     username;           ///< Peer's display name
+		PublicKeyStruct publicKey;          ///< Peer's public key (valid if publicKeySet)
+		bool            publicKeySet = false; ///< Whether the public key is known
+	};
+
+	// ================================
+	// Constructor and Destructor
+	// ================================
+
+	/**
+	 * @brief       Default constructor - creates a detached directory
+	 * @details     No segment is mapped until attach() succeeds.
+	 */
+	SharedPeerDirectory();
+
+	/**
+	 * @brief       Virtual destructor - unmaps the segment
+	 * @details     The segment itself stays alive while other processes use it.
+	 */
+	virtual ~SharedPeerDirectory();
+
+	// ================================
+	// Copy Control (Deleted)
+	// ================================
+
+	SharedPeerDirectory(const SharedPeerDirectory&) = delete;
+	SharedPeerDirectory(SharedPeerDirectory&&) noexcept = delete;
+	SharedPeerDirectory& operator=(const SharedPeerDirectory&) = delete;
+	SharedPeerDirectory& operator=(SharedPeerDirectory&&) noexcept = delete;
+
+	// ================================
+	// Segment Management Methods
+	// ================================
+
+	/**
+	 * @brief       Opens or creates the named shared-memory segment
+	 * @param[in]   segmentName    Name of the segment shared by all client processes
+	 * @return      true if the segment is mapped and has a valid layout, false otherwise
+	 */
+	bool attach(const std::string& segmentName);
+
+	/**
+	 * @brief       Unmaps the segment
+	 */
+	void detach();
+
+	/**
+	 * @brief       Checks if a segment is mapped
+	 * @return      true if attached, false otherwise
+	 */
+	bool isAttached() const { return _region != nullptr; }
+
+	// ================================
+	// Reader Methods (Lock-Free)
+	// ================================
+
+	/**
+	 * @brief       Copies a consistent snapshot of the directory
+	 * @param[out]  peers          Vector receiving the published peers
+	 * @param[out]  refreshedAtMs  Wall-clock time (ms since epoch) of the last refresh
+	 * @return      true if a snapshot was read, false if detached or never published
+	 */
+	bool readPeers(std::vector<PeerRecord>& peers, int64_t& refreshedAtMs) const;
+
+	/**
+	 * @brief       Looks up a peer's public key by client ID
+	 * @param[in]   clientID   Peer to look up
+	 * @param[out]  publicKey  Public key if known
+	 * @return      true if the key is published, false otherwise
+	 */
+	bool findPublicKey(const ClientIdStruct& clientID, PublicKeyStruct& publicKey) const;
+
+	/**
+	 * @brief       Checks if the published peer list is younger than the TTL
+	 * @return      true if a non-stale list is published, false otherwise
+	 */
+	bool isFresh() const;
+
+	// ================================
+	// Writer Methods
+	// ================================
+
+	/**
+	 * @brief       Replaces the published peer list
+	 * @param[in]   peers   Peers to publish
+	 * @return      true if published, false if another process holds the writer lock
+	 * @details     Public keys already published for the same client ID are preserved
+	 *              when the incoming record has no key.
+	 */
+	bool publishPeers(const std::vector<PeerRecord>& peers);
+
+	/**
+	 * @brief       Publishes a single peer's public key
+	 * @param[in]   clientID    Peer that owns the key
+	 * @param[in]   publicKey   Public key to publish
+	 * @return      true if stored, false if peer unknown or writer lock busy
+	 */
+	bool publishPublicKey(const ClientIdStruct& clientID, const PublicKeyStruct& publicKey);
+
+private:
+	// ================================
+	// Segment Layout
+	// ================================
+
+	struct SegmentHeader;
+
+	/**
+	 * @struct      NameSlot
+	 * @brief       Offset/length record locating a name inside the name pool
+	 */
+	struct NameSlot
+	{
+		uint32_t offset;   ///< Offset from the start of the name pool
+		uint32_t length;   ///< Name length in bytes (no terminator)
+	};
+
+	// ================================
+	// Member Variables
+	// ================================
+
+	boost::interprocess::mapped_region* _region;  ///< Mapping of the shared segment
+	uint8_t*                            _base;    ///< Start address of the mapping
+
+	// ================================
+	// Private Helper Methods
+	// ================================
+
+	SegmentHeader* header() const;
+	ClientIdStruct* ids() const;
+	NameSlot* names() const;
+	uint8_t* keyFlags() const;
+	PublicKeyStruct* keys() const;
+	char* namePool() const;
+
+	/**
+	 * @brief       Acquires the inter-process writer lock without blocking
+	 * @return      true if acquired, false if another writer is active
+	 * @details     A lock older than the stale-lock timeout is taken over, so a crashed
+	 *              writer cannot block refreshes forever.
+	 */
+	bool tryLockWriter();
+
+	/**
+	 * @brief       Releases the inter-process writer lock
+	 */
+	void unlockWriter();
+
+	/**
+	 * @brief       Computes the total segment size for the configured capacity
+	 * @return      Segment size in bytes
+	 */
+	static size_t segmentSize();
+
+	/**
+	 * @brief       Returns current wall-clock time in milliseconds since epoch
+	 */
+	static int64_t nowMs();
+};
@@ -0,0 +1,112 @@
+/**
+ * @file        StartupProfile.cpp
+ * @author      Natanel Maor Fishman
+ * @brief       Implementation of the startup phase profile.
+ * @details     Phase recording, the ready mark, peak RSS queries and the report.
+ * @date        2025
+ */
+
+#include "StartupProfile.h"
+
+#include <iomanip>
+#include <mutex>
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <psapi.h>
+#pragma comment(lib, "psapi.lib")
+#else
+#include <sys/resource.h>
+#endif
+
+namespace
+{
+	constexpr size_t MAX_PHASES = 32;  ///< Bound on recorded phases
+
+	/// Approximates process entry: initialized before main()
+	const std::chrono::steady_clock::time_point processStart = std::chrono::steady_clock::now();
+
+	std::mutex                          profileMutex;
+	std::vector<StartupProfile::Phase>  phases;
+	bool                                isReady = false;
+	std::ostream*                       report = nullptr;
+}
+
+// ================================
+// Public Interface Methods
+// ================================
+
+void StartupProfile::setReport(std::ostream* output)
+{
+	std::lock_guard<std::mutex> lock(profileMutex);
+	report = output;
+}
+
+void StartupProfile::record(const std::string& name, const std::chrono::microseconds duration)
+{
+	std::lock_guard<std::mutex> lock(profileMutex);
+	if (!isReady && phases.size() < MAX_PHASES) {
+		phases.emplace_back(name, static_cast<uint64_t>(duration.count()));
+	}
+}
+
+void StartupProfile::ready()
+{
+	std::ostream* output = nullptr;
+	{
+		std::lock_guard<std::mutex> lock(profileMutex);
+		if (isReady) {
+			return;
+		}
+		phases.emplace_back("total", static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+			std::chrono::steady_clock::now() - processStart).count()));
+		isReady = true;
+		output = report;
+	}
+
+	if (output != nullptr) {
+		print(*output);
+	}
+}
+
+std::vector<StartupProfile::Phase> StartupProfile::getPhases()
+{
+	std::lock_guard<std::mutex> lock(profileMutex);
+	return phases;
+}
+
+uint64_t StartupProfile::peakResidentBytes()
+{
+#ifdef _WIN32
+	PROCESS_MEMORY_COUNTERS counters;
+	if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+		return static_cast<uint64_t>(counters.PeakWorkingSetSize);
+	}
+	return 0;
+#else
+	struct rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) != 0) {
+		return 0;
+	}
+#ifdef __APPLE__
+	return static_cast<uint64_t>(usage.ru_maxrss);         // Bytes
+#else
+	return static_cast<uint64_t>(usage.ru_maxrss) * 1024;  // KiB
+#endif
+#endif
+}
+
+void StartupProfile::print(std::ostream& output)
+{
+	output << std::fixed << std::setprecision(3);
+	for (const Phase& phase : getPhases())
+	{
+		output << "startup." << std::left << std::setw(20) << phase.first << std::right
+			<< std::setw(12) << static_cast<double>(phase.second) / 1000.0 << " ms" << std::endl;
+	}
+	output << "startup." << std::left << std::setw(20) << "peak_rss" << std::right
+		<< std::setw(12) << static_cast<double>(peakResidentBytes()) / (1 << 20) << " MiB" << std::endl;
+	output << std::defaultfloat;
+}
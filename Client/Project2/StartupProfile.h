@@ -0,0 +1,127 @@
+/**
+ * @file        StartupProfile.h
+ * @author      Natanel Maor Fishman
+ * @brief       Timing of the client startup phases
+ * @details     Startup (engine construction, server.info, my.info decoding and RSA private
+ *              key parsing) runs before every scripted invocation, so it is on the hot path
+ *              of CLI automation. Each phase is timed with a StartupTimer; the client marks
+ *              the end of startup once it can take its first command. --startup-profile
+ *              prints the phases at that point, and the cold-start benchmark collects them
+ *              from repeated launches.
+ * @version     2.0
+ * @date        2025
+ */
+
+#pragma once
+
+// ================================
+// Standard Library Includes
+// ================================
+
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+// ================================
+// Class Definitions
+// ================================
+
+/**
+ * @class       StartupProfile
+ * @brief       Process-wide record of startup phase durations
+ * @details     Phases are kept in the order they finish, until ready() is called. Later
+ *              phases (e.g. credentials reloaded after a registration, or the engines of a
+ *              load test) are ignored. Times are measured from static initialization of
+ *              this module, which is as close to process entry as portable code gets.
+ *
+ * @note        This class cannot be instantiated - all methods are static. Thread-safe.
+ */
+class StartupProfile
+{
+public:
+	/// Phase name and duration in microseconds
+	using Phase = std::pair<std::string, uint64_t>;
+
+	// ================================
+	// Copy Control (Deleted)
+	// ================================
+
+	StartupProfile() = delete;
+	StartupProfile(const StartupProfile&) = delete;
+	StartupProfile& operator=(const StartupProfile&) = delete;
+
+	// ================================
+	// Public Interface Methods
+	// ================================
+
+	/**
+	 * @brief       Prints the profile to an output stream when ready() is reached
+	 * @param[in]   output    Destination (nullptr = do not print)
+	 */
+	static void setReport(std::ostream* output);
+
+	/**
+	 * @brief       Records a finished phase (ignored after ready())
+	 * @param[in]   name        Phase name (e.g. "server_config")
+	 * @param[in]   duration    Phase duration
+	 */
+	static void record(const std::string& name, std::chrono::microseconds duration);
+
+	/**
+	 * @brief       Marks the end of startup and prints the report if one was requested
+	 * @details     Only the first call has an effect.
+	 */
+	static void ready();
+
+	/**
+	 * @brief       Gets the recorded phases, followed by "total" once ready() was called
+	 */
+	static std::vector<Phase> getPhases();
+
+	/**
+	 * @brief       Gets the peak resident set size of the process
+	 * @return      Bytes, or 0 if the platform does not report it
+	 */
+	static uint64_t peakResidentBytes();
+
+	/**
+	 * @brief       Prints phases (milliseconds) and peak RSS as "name value" lines
+	 */
+	static void print(std::ostream& output);
+};
+
+/**
+ * @class       StartupTimer
+ * @brief       Scoped timer recording a startup phase on destruction or stop()
+ */
+class StartupTimer
+{
+public:
+	explicit StartupTimer(const char* name) : _name(name), _start(std::chrono::steady_clock::now()), _stopped(false) {}
+
+	~StartupTimer() { stop(); }
+
+	StartupTimer(const StartupTimer&) = delete;
+	StartupTimer& operator=(const StartupTimer&) = delete;
+
+	/**
+	 * @brief       Ends the phase early (later calls have no effect)
+	 */
+	void stop()
+	{
+		if (_stopped) {
+			return;
+		}
+		_stopped = true;
+		StartupProfile::record(_name, std::chrono::duration_cast<std::chrono::microseconds>(
+			std::chrono::steady_clock::now() - _start));
+	}
+
+private:
+	const char* const                           _name;     ///< Phase name (static string)
+	const std::chrono::steady_clock::time_point _start;    ///< Start time
+	bool                                        _stopped;  ///< Already recorded
+};
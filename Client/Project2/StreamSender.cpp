@@ -0,0 +1,224 @@
+/**
+ * @file        StreamSender.cpp
+ * @author      Natanel Maor Fishman
+ * @brief       Implementation of stdin streaming to a peer.
+ * @details     Bounded line queue, size/time batching on the task pool and throughput reporting.
+ * @date        2025
+ */
+
+#include "StreamSender.h"
+#include "ThreadPool.h"
+
+#include <iomanip>
+
+namespace
+{
+	constexpr double BYTES_PER_MIB = 1024.0 * 1024.0;
+}
+
+// ================================
+// Constructor
+// ================================
+
+StreamSender::StreamSender(MessageEngine& engine, const Settings& settings)
+	: _engine(engine), _settings(settings), _report(nullptr),
+	_queuedBytes(0), _inputClosed(false), _aborted(false)
+{
+}
+
+// ================================
+// Public Interface Methods
+// ================================
+
+ExitCode StreamSender::run(std::istream& input, std::ostream& report)
+{
+	_report = &report;
+
+	if (!_engine.prepareSecureChannel(_settings.recipient))
+	{
+		report << "Error: " << _engine.getErrorMessage() << std::endl;
+		return ExitCode::OPERATION_FAILED;
+	}
+
+	const bool wasPersistent = _engine.isPersistentConnection();
+	_engine.setPersistentConnection(true);
+	_startTime = _lastReport = Clock::now();
+
+	auto sender = _engine.getTaskPool()->submit([this]() { senderLoop(); });
+
+	std::string line;
+	while (std::getline(input, line))
+	{
+		if (!push(std::move(line))) {
+			break;  // Sender aborted
+		}
+		line.clear();
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_inputClosed = true;
+	}
+	_notEmpty.notify_all();
+	sender.get();
+
+	_engine.setPersistentConnection(wasPersistent);
+	printReport(true);
+
+	const Stats stats = getStats();
+	return (stats.batchesFailed == 0 && !_aborted) ? ExitCode::SUCCESS : ExitCode::OPERATION_FAILED;
+}
+
+StreamSender::Stats StreamSender::getStats() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _stats;
+}
+
+// ================================
+// Private Helper Methods
+// ================================
+
+bool StreamSender::push(std::string&& line)
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+
+	// A line always fits into an empty queue, however long it is
+	if (!_queue.empty() && _queuedBytes + line.size() > _settings.queueBytes && !_aborted)
+	{
+		const auto start = Clock::now();
+		++_stats.stalls;
+		_notFull.wait(lock, [this, &line]() {
+			return _aborted || _queue.empty() || _queuedBytes + line.size() <= _settings.queueBytes;
+		});
+		_stats.stallMicros += static_cast<uint64_t>(
+			std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count());
+	}
+
+	if (_aborted) {
+		return false;
+	}
+
+	++_stats.linesRead;
+	_stats.bytesRead += line.size();
+	_queuedBytes += line.size();
+	_queue.push_back(std::move(line));
+	lock.unlock();
+
+	_notEmpty.notify_one();
+	return true;
+}
+
+void StreamSender::senderLoop()
+{
+	std::string batch;
+	uint64_t lines = 0;
+
+	while (takeBatch(batch, lines))
+	{
+		if (!batch.empty())
+		{
+			const bool delivered = sendBatch(batch);
+
+			std::unique_lock<std::mutex> lock(_mutex);
+			if (delivered)
+			{
+				++_stats.batchesSent;
+				_stats.linesSent += lines;
+				_stats.bytesSent += batch.size();
+			}
+			else
+			{
+				++_stats.batchesFailed;
+				*_report << "Batch of " << lines << " lines failed: " << _engine.getErrorMessage() << std::endl;
+				if (_settings.stopOnFailure)
+				{
+					_aborted = true;
+					lock.unlock();
+					_notFull.notify_all();
+					return;
+				}
+			}
+		}
+
+		if (Clock::now() - _lastReport >= _settings.reportInterval) {
+			printReport(false);
+		}
+	}
+}
+
+bool StreamSender::takeBatch(std::string& batch, uint64_t& lines)
+{
+	batch.clear();
+	lines = 0;
+
+	std::unique_lock<std::mutex> lock(_mutex);
+
+	// Wake up at the report interval even when the input is idle
+	_notEmpty.wait_for(lock, _settings.reportInterval, [this]() { return !_queue.empty() || _inputClosed; });
+	if (_queue.empty()) {
+		return !_inputClosed;
+	}
+
+	const auto deadline = Clock::now() + _settings.batchWindow;
+	while (true)
+	{
+		while (!_queue.empty() && batch.size() < _settings.batchBytes)
+		{
+			std::string& line = _queue.front();
+			_queuedBytes -= line.size();
+			batch.append(line);
+			batch.push_back('\n');
+			_queue.pop_front();
+			++lines;
+		}
+		_notFull.notify_all();
+
+		if (batch.size() >= _settings.batchBytes || _inputClosed) {
+			break;
+		}
+		if (!_notEmpty.wait_until(lock, deadline, [this]() { return !_queue.empty() || _inputClosed; })) {
+			break;  // Time window expired
+		}
+	}
+	return true;
+}
+
+bool StreamSender::sendBatch(const std::string& batch)
+{
+	if (_engine.sendMessage(_settings.recipient, MSG_TEXT, batch)) {
+		return true;
+	}
+
+	// A batch the server may have stored is not resent: that could duplicate its lines
+	return _engine.failedBeforeSending() && _engine.sendMessage(_settings.recipient, MSG_TEXT, batch);
+}
+
+void StreamSender::printReport(const bool final)
+{
+	const auto now = Clock::now();
+	const Stats stats = getStats();
+	const Stats base = final ? Stats() : _lastReported;
+	const double seconds = std::chrono::duration<double>(now - (final ? _startTime : _lastReport)).count();
+	const double lineRate = (seconds > 0) ? (stats.linesSent - base.linesSent) / seconds : 0;
+	const double byteRate = (seconds > 0) ? (stats.bytesSent - base.bytesSent) / seconds / BYTES_PER_MIB : 0;
+
+	size_t queued = 0;
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		queued = _queuedBytes;
+	}
+
+	*_report << (final ? "[stream total] " : "[stream] ")
+		<< stats.linesSent << " lines, " << stats.batchesSent << " batches, "
+		<< std::fixed << std::setprecision(0) << lineRate << " lines/s, "
+		<< std::setprecision(2) << byteRate << " MiB/s, queued " << queued / 1024 << " KiB, "
+		<< stats.stalls << " stalls";
+	if (stats.batchesFailed > 0) {
+		*_report << ", " << stats.batchesFailed << " failed batches";
+	}
+	*_report << std::endl;
+
+	_lastReport = now;
+	_lastReported = stats;
+}
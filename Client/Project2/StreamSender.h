@@ -0,0 +1,197 @@
+/**
+ * @file        StreamSender.h
+ * @author      Natanel Maor Fishman
+ * @brief       High-throughput streaming of stdin lines to a peer
+ * @details     Reads an input stream continuously, batches lines by size or time window
+ *              into encrypted text messages and sends them over a persistent connection.
+ *              Intended for log forwarding.
+ * @version     2.0
+ * @date        2025
+ */
+
+#pragma once
+
+// ================================
+// Standard Library Includes
+// ================================
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <istream>
+#include <mutex>
+#include <ostream>
+#include <string>
+
+// ================================
+// Application Includes
+// ================================
+
+#include "CommandLine.h"
+#include "MessageEngine.h"
+
+// ================================
+// Class Definition
+// ================================
+
+/**
+ * @class       StreamSender
+ * @brief       Batches input lines into MSG_TEXT messages with bounded buffering
+ * @details     The calling thread reads lines into a byte-bounded queue. A sender task on the
+ *              engine's task pool drains the queue into batches: a batch is sent when it
+ *              reaches the size limit or when the time window since its first line expires.
+ *
+ *              Backpressure: when the server falls behind and the queue is full, the reader
+ *              stops consuming input, so the upstream writer blocks on the pipe instead of the
+ *              client buffering without bound.
+ *
+ *              Delivery is at most once. A batch is resent only if no connection could be
+ *              made, so the server never saw it. A batch whose exchange failed after it was
+ *              sent may or may not have been stored; it is counted as failed, not resent,
+ *              so forwarded lines are never duplicated.
+ *
+ *              Throughput (lines/s, bytes/s) is reported at a fixed interval and at the end.
+ *
+ * @note        This class is non-copyable. The engine must outlive the sender.
+ */
+class StreamSender
+{
+public:
+	// ================================
+	// Data Structures
+	// ================================
+
+	/**
+	 * @struct      Settings
+	 * @brief       Batching and buffering configuration
+	 */
+	struct Settings
+	{
+		std::string               recipient;                      ///< Target username
+		size_t                    batchBytes = 64 * 1024;         ///< Send once a batch reaches this size
+		std::chrono::milliseconds batchWindow{ 200 };             ///< Send a partial batch after this time
+		size_t                    queueBytes = 1024 * 1024;       ///< Reader blocks above this many queued bytes
+		std::chrono::milliseconds reportInterval{ 1000 };         ///< Throughput report period
+		bool                      stopOnFailure = true;           ///< Abort after a batch fails
+	};
+
+	/**
+	 * @struct      Stats
+	 * @brief       Streaming counters
+	 */
+	struct Stats
+	{
+		uint64_t linesRead = 0;        ///< Lines read from the input
+		uint64_t bytesRead = 0;        ///< Line bytes read (without separators)
+		uint64_t linesSent = 0;        ///< Lines delivered to the server
+		uint64_t bytesSent = 0;        ///< Batch bytes delivered (with separators)
+		uint64_t batchesSent = 0;      ///< Messages delivered
+		uint64_t batchesFailed = 0;    ///< Messages not confirmed (possibly stored)
+		uint64_t stalls = 0;           ///< Times the reader waited for queue space
+		uint64_t stallMicros = 0;      ///< Total reader wait time
+	};
+
+	// ================================
+	// Constructor and Destructor
+	// ================================
+
+	/**
+	 * @brief       Creates a sender
+	 * @param[in]   engine      Registered messaging engine
+	 * @param[in]   settings    Batching configuration
+	 */
+	StreamSender(MessageEngine& engine, const Settings& settings);
+
+	/**
+	 * @brief       Default destructor
+	 */
+	virtual ~StreamSender() = default;
+
+	// ================================
+	// Copy Control (Deleted)
+	// ================================
+
+	StreamSender(const StreamSender&) = delete;
+	StreamSender& operator=(const StreamSender&) = delete;
+
+	// ================================
+	// Public Interface Methods
+	// ================================
+
+	/**
+	 * @brief       Streams the input until end of file (or a fatal send failure)
+	 * @param[in]   input     Line source (usually stdin)
+	 * @param[in]   report    Destination of progress reports (usually stderr)
+	 * @return      SUCCESS if every batch was delivered, OPERATION_FAILED otherwise
+	 * @details     Establishes a symmetric key with the recipient first if needed.
+	 */
+	ExitCode run(std::istream& input, std::ostream& report);
+
+	/**
+	 * @brief       Gets a snapshot of the streaming counters
+	 */
+	Stats getStats() const;
+
+private:
+	// ================================
+	// Internal Types
+	// ================================
+
+	using Clock = std::chrono::steady_clock;
+
+	// ================================
+	// Member Variables
+	// ================================
+
+	MessageEngine&          _engine;        ///< Messaging engine
+	const Settings          _settings;      ///< Batching configuration
+	std::ostream*           _report;        ///< Progress report stream
+
+	mutable std::mutex      _mutex;         ///< Guards the queue and flags
+	std::condition_variable _notEmpty;      ///< Signals queued lines or end of input
+	std::condition_variable _notFull;       ///< Signals queue space or abort
+	std::deque<std::string> _queue;         ///< Lines waiting to be batched
+	size_t                  _queuedBytes;   ///< Bytes in the queue
+	bool                    _inputClosed;   ///< Reader reached end of input
+	bool                    _aborted;       ///< Sender gave up
+
+	Stats                   _stats;         ///< Counters (guarded by _mutex)
+	Clock::time_point       _startTime;     ///< Streaming start
+	Clock::time_point       _lastReport;    ///< Last progress report
+	Stats                   _lastReported;  ///< Counters at the last report
+
+	// ================================
+	// Private Helper Methods
+	// ================================
+
+	/**
+	 * @brief       Queues a line, blocking while the queue is full
+	 * @return      false if the sender aborted
+	 */
+	bool push(std::string&& line);
+
+	/**
+	 * @brief       Sender task: batches queued lines and sends them until input ends
+	 */
+	void senderLoop();
+
+	/**
+	 * @brief       Collects the next batch
+	 * @param[out]  batch    Newline-terminated lines
+	 * @param[out]  lines    Number of lines in the batch
+	 * @return      false once the input is closed and drained
+	 */
+	bool takeBatch(std::string& batch, uint64_t& lines);
+
+	/**
+	 * @brief       Sends one batch, retrying once if it could not connect
+	 */
+	bool sendBatch(const std::string& batch);
+
+	/**
+	 * @brief       Prints throughput since the last report (or overall when final)
+	 */
+	void printReport(bool final);
+};
@@ -0,0 +1,356 @@
+/**
+ * @file        Terminal.cpp
+ * @author      Natanel Maor Fishman
+ * @brief       Implementation of the raw-mode terminal session.
+ * @details     Console mode switching, window size queries and key decoding for
+ *              Windows consoles (input records) and POSIX terminals (VT sequences).
+ * @date        2025
+ */
+
+#include "Terminal.h"
+
+#include <cstdint>
+#include <cstdio>
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <sys/ioctl.h>
+#include <sys/select.h>
+#include <termios.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+	constexpr char ESC = '\x1b';
+
+	/// Alternate screen, cleared, cursor home
+	constexpr auto ENTER_SCREEN = "\x1b[?1049h\x1b[2J\x1b[H";
+	/// Reset attributes, show cursor, leave the alternate screen
+	constexpr auto LEAVE_SCREEN = "\x1b[0m\x1b[?25h\x1b[?1049l";
+
+	/// A lone ESC byte is the Escape key if no sequence follows within this time
+	constexpr auto ESCAPE_SEQUENCE_WAIT = std::chrono::milliseconds(30);
+
+	/**
+	 * @brief       Length of the UTF-8 sequence introduced by a lead byte (1 for invalid bytes)
+	 */
+	size_t utf8Length(const unsigned char lead)
+	{
+		if (lead >= 0xF0 && lead <= 0xF4) return 4;
+		if (lead >= 0xE0) return (lead <= 0xEF) ? 3 : 1;
+		if (lead >= 0xC2) return 2;
+		return 1;
+	}
+
+#ifdef _WIN32
+	/**
+	 * @brief       Encodes a UTF-16 code unit from the console as UTF-8 (BMP only)
+	 */
+	std::string utf8Encode(const wchar_t character)
+	{
+		const auto code = static_cast<uint32_t>(character);
+		std::string text;
+		if (code < 0x80) {
+			text.push_back(static_cast<char>(code));
+		}
+		else if (code < 0x800)
+		{
+			text.push_back(static_cast<char>(0xC0 | (code >> 6)));
+			text.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+		}
+		else if (code < 0xD800 || code > 0xDFFF)
+		{
+			text.push_back(static_cast<char>(0xE0 | (code >> 12)));
+			text.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+			text.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+		}
+		return text;  // Surrogate halves are dropped
+	}
+#else
+	/**
+	 * @brief       Waits until standard input is readable
+	 */
+	bool waitReadable(const std::chrono::milliseconds timeout)
+	{
+		fd_set readSet;
+		FD_ZERO(&readSet);
+		FD_SET(STDIN_FILENO, &readSet);
+		timeval wait{};
+		wait.tv_sec = static_cast<long>(timeout.count() / 1000);
+		wait.tv_usec = static_cast<long>((timeout.count() % 1000) * 1000);
+		return select(STDIN_FILENO + 1, &readSet, nullptr, nullptr, &wait) > 0;
+	}
+#endif
+}
+
+// ================================
+// Platform State
+// ================================
+
+#ifdef _WIN32
+struct Terminal::State
+{
+	HANDLE input = INVALID_HANDLE_VALUE;
+	HANDLE output = INVALID_HANDLE_VALUE;
+	DWORD  inputMode = 0;
+	DWORD  outputMode = 0;
+	UINT   outputCodePage = 0;
+};
+#else
+struct Terminal::State
+{
+	termios attributes{};
+};
+#endif
+
+// ================================
+// Constructor and Destructor
+// ================================
+
+Terminal::Terminal() : _state(new State()), _active(false)
+{
+#ifdef _WIN32
+	_state->input = GetStdHandle(STD_INPUT_HANDLE);
+	_state->output = GetStdHandle(STD_OUTPUT_HANDLE);
+	if (!GetConsoleMode(_state->input, &_state->inputMode) || !GetConsoleMode(_state->output, &_state->outputMode)) {
+		return;  // Redirected
+	}
+	if (!SetConsoleMode(_state->output, _state->outputMode | ENABLE_VIRTUAL_TERMINAL_PROCESSING | DISABLE_NEWLINE_AUTO_RETURN)) {
+		return;  // Console without VT support
+	}
+	(void)SetConsoleMode(_state->input, (_state->inputMode & ~(ENABLE_LINE_INPUT | ENABLE_ECHO_INPUT | ENABLE_PROCESSED_INPUT))
+		| ENABLE_WINDOW_INPUT);
+	_state->outputCodePage = GetConsoleOutputCP();
+	(void)SetConsoleOutputCP(CP_UTF8);
+#else
+	if (!isatty(STDIN_FILENO) || !isatty(STDOUT_FILENO) || tcgetattr(STDIN_FILENO, &_state->attributes) != 0) {
+		return;
+	}
+	termios raw = _state->attributes;
+	raw.c_lflag &= ~static_cast<tcflag_t>(ICANON | ECHO | ISIG | IEXTEN);
+	raw.c_iflag &= ~static_cast<tcflag_t>(IXON | ICRNL);
+	raw.c_cc[VMIN] = 1;
+	raw.c_cc[VTIME] = 0;
+	if (tcsetattr(STDIN_FILENO, TCSAFLUSH, &raw) != 0) {
+		return;
+	}
+#endif
+	_active = true;
+	write(ENTER_SCREEN);
+}
+
+Terminal::~Terminal()
+{
+	if (!_active) {
+		return;
+	}
+	write(LEAVE_SCREEN);
+#ifdef _WIN32
+	(void)SetConsoleMode(_state->input, _state->inputMode);
+	(void)SetConsoleMode(_state->output, _state->outputMode);
+	(void)SetConsoleOutputCP(_state->outputCodePage);
+#else
+	(void)tcsetattr(STDIN_FILENO, TCSAFLUSH, &_state->attributes);
+#endif
+}
+
+// ================================
+// Public Interface Methods
+// ================================
+
+void Terminal::getSize(size_t& rows, size_t& columns) const
+{
+	rows = 24;
+	columns = 80;
+#ifdef _WIN32
+	CONSOLE_SCREEN_BUFFER_INFO info;
+	if (GetConsoleScreenBufferInfo(_state->output, &info))
+	{
+		rows = static_cast<size_t>(info.srWindow.Bottom - info.srWindow.Top + 1);
+		columns = static_cast<size_t>(info.srWindow.Right - info.srWindow.Left + 1);
+	}
+#else
+	winsize size{};
+	if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &size) == 0 && size.ws_row > 0 && size.ws_col > 0)
+	{
+		rows = size.ws_row;
+		columns = size.ws_col;
+	}
+#endif
+}
+
+bool Terminal::readKey(KeyEvent& event, const std::chrono::milliseconds timeout)
+{
+	event = KeyEvent();
+	if (!_active) {
+		return false;
+	}
+
+#ifdef _WIN32
+	if (WaitForSingleObject(_state->input, static_cast<DWORD>(timeout.count())) != WAIT_OBJECT_0) {
+		return false;
+	}
+
+	INPUT_RECORD record;
+	DWORD count = 0;
+	if (!ReadConsoleInputW(_state->input, &record, 1, &count) || count == 0
+		|| record.EventType != KEY_EVENT || !record.Event.KeyEvent.bKeyDown) {
+		return false;  // Focus, mouse, resize and key-up events
+	}
+
+	switch (record.Event.KeyEvent.wVirtualKeyCode)
+	{
+	case VK_RETURN: event.key = Key::ENTER;     break;
+	case VK_BACK:   event.key = Key::BACKSPACE; break;
+	case VK_TAB:    event.key = Key::TAB;       break;
+	case VK_ESCAPE: event.key = Key::ESCAPE;    break;
+	case VK_UP:     event.key = Key::UP;        break;
+	case VK_DOWN:   event.key = Key::DOWN;      break;
+	case VK_LEFT:   event.key = Key::LEFT;      break;
+	case VK_RIGHT:  event.key = Key::RIGHT;     break;
+	case VK_PRIOR:  event.key = Key::PAGE_UP;   break;
+	case VK_NEXT:   event.key = Key::PAGE_DOWN; break;
+	case VK_HOME:   event.key = Key::HOME;      break;
+	case VK_END:    event.key = Key::END;       break;
+	default:
+	{
+		const wchar_t character = record.Event.KeyEvent.uChar.UnicodeChar;
+		if (character == 0x03) {
+			event.key = Key::INTERRUPT;
+		}
+		else if (character >= 0x20)
+		{
+			event.text = utf8Encode(character);
+			event.key = event.text.empty() ? Key::NONE : Key::CHARACTER;
+		}
+		break;
+	}
+	}
+	return event.key != Key::NONE;
+#else
+	const auto deadline = std::chrono::steady_clock::now() + timeout;
+	while (true)
+	{
+		while (decodePending(event))
+		{
+			if (event.key != Key::NONE) {
+				return true;
+			}
+		}
+
+		const auto now = std::chrono::steady_clock::now();
+		auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now);
+		if (_pending.size() == 1 && _pending[0] == ESC) {
+			wait = ESCAPE_SEQUENCE_WAIT;  // Completes a sequence split across reads
+		}
+		if (wait.count() < 0 || !waitReadable(wait))
+		{
+			if (_pending.size() == 1 && _pending[0] == ESC)
+			{
+				_pending.clear();
+				event.key = Key::ESCAPE;
+				return true;
+			}
+			return false;
+		}
+
+		char buffer[64];
+		const ssize_t bytesRead = ::read(STDIN_FILENO, buffer, sizeof(buffer));
+		if (bytesRead <= 0) {
+			return false;
+		}
+		_pending.append(buffer, static_cast<size_t>(bytesRead));
+	}
+#endif
+}
+
+void Terminal::write(const std::string& data)
+{
+	(void)fwrite(data.data(), 1, data.size(), stdout);
+	(void)fflush(stdout);
+}
+
+// ================================
+// Private Helper Methods
+// ================================
+
+bool Terminal::decodePending(KeyEvent& event)
+{
+	event = KeyEvent();
+	if (_pending.empty()) {
+		return false;
+	}
+
+	const auto first = static_cast<unsigned char>(_pending[0]);
+	size_t consumed = 1;
+
+	if (first == static_cast<unsigned char>(ESC))
+	{
+		if (_pending.size() < 2) {
+			return false;  // Wait for the rest (or the Escape timeout)
+		}
+		if (_pending[1] != '[' && _pending[1] != 'O')
+		{
+			event.key = Key::ESCAPE;  // ESC followed by an unrelated key
+		}
+		else
+		{
+			// CSI/SS3: parameters, then a final byte in 0x40..0x7E
+			size_t end = 2;
+			while (end < _pending.size() && (_pending[end] < 0x40 || _pending[end] > 0x7E)) {
+				++end;
+			}
+			if (end >= _pending.size()) {
+				return false;
+			}
+			const std::string parameters = _pending.substr(2, end - 2);
+			switch (_pending[end])
+			{
+			case 'A': event.key = Key::UP;    break;
+			case 'B': event.key = Key::DOWN;  break;
+			case 'C': event.key = Key::RIGHT; break;
+			case 'D': event.key = Key::LEFT;  break;
+			case 'H': event.key = Key::HOME;  break;
+			case 'F': event.key = Key::END;   break;
+			case '~':
+				if (parameters == "1" || parameters == "7") event.key = Key::HOME;
+				else if (parameters == "4" || parameters == "8") event.key = Key::END;
+				else if (parameters == "5") event.key = Key::PAGE_UP;
+				else if (parameters == "6") event.key = Key::PAGE_DOWN;
+				break;
+			default:
+				break;  // Unsupported sequence: consumed and ignored
+			}
+			consumed = end + 1;
+		}
+	}
+	else if (first == '\r' || first == '\n') {
+		event.key = Key::ENTER;
+	}
+	else if (first == 0x7F || first == 0x08) {
+		event.key = Key::BACKSPACE;
+	}
+	else if (first == '\t') {
+		event.key = Key::TAB;
+	}
+	else if (first == 0x03) {
+		event.key = Key::INTERRUPT;
+	}
+	else if (first >= 0x20)
+	{
+		consumed = utf8Length(first);
+		if (_pending.size() < consumed) {
+			return false;
+		}
+		event.key = Key::CHARACTER;
+		event.text = _pending.substr(0, consumed);
+	}
+	// Other control characters are consumed and ignored
+
+	_pending.erase(0, consumed);
+	return true;
+}
@@ -0,0 +1,145 @@
+/**
+ * @file        Terminal.h
+ * @author      Natanel Maor Fishman
+ * @brief       Raw-mode terminal access for the full-screen client
+ * @details     Switches the console to raw, non-echoing input and an alternate screen
+ *              buffer with ANSI (VT) output, decodes key presses and restores the
+ *              original console state on destruction. Windows consoles and POSIX
+ *              terminals are both supported.
+ * @version     2.0
+ * @date        2025
+ */
+
+#pragma once
+
+// ================================
+// Standard Library Includes
+// ================================
+
+#include <chrono>
+#include <memory>
+#include <string>
+
+// ================================
+// Class Definition
+// ================================
+
+/**
+ * @class       Terminal
+ * @brief       RAII raw terminal session
+ * @details     Construction enters raw mode and the alternate screen; destruction leaves
+ *              both. If standard input/output is not an interactive terminal the session
+ *              stays inactive and isActive() returns false.
+ *
+ * @note        This class is non-copyable. Only one session should exist at a time.
+ */
+class Terminal
+{
+public:
+	// ================================
+	// Data Structures
+	// ================================
+
+	/**
+	 * @enum        Key
+	 * @brief       Decoded key kinds
+	 */
+	enum class Key
+	{
+		NONE,           ///< No key (timeout or ignored input)
+		CHARACTER,      ///< Printable character (UTF-8 in KeyEvent::text)
+		ENTER,
+		BACKSPACE,
+		TAB,
+		ESCAPE,
+		UP,
+		DOWN,
+		LEFT,
+		RIGHT,
+		PAGE_UP,
+		PAGE_DOWN,
+		HOME,
+		END,
+		INTERRUPT       ///< Ctrl+C (signals are disabled in raw mode)
+	};
+
+	/**
+	 * @struct      KeyEvent
+	 * @brief       One key press
+	 */
+	struct KeyEvent
+	{
+		Key         key = Key::NONE;  ///< Key kind
+		std::string text;             ///< UTF-8 character for Key::CHARACTER
+	};
+
+	// ================================
+	// Constructor and Destructor
+	// ================================
+
+	/**
+	 * @brief       Enters raw mode and the alternate screen
+	 */
+	Terminal();
+
+	/**
+	 * @brief       Restores the original terminal state
+	 */
+	virtual ~Terminal();
+
+	// ================================
+	// Copy Control (Deleted)
+	// ================================
+
+	Terminal(const Terminal&) = delete;
+	Terminal& operator=(const Terminal&) = delete;
+
+	// ================================
+	// Public Interface Methods
+	// ================================
+
+	/**
+	 * @brief       Checks if the session is attached to an interactive terminal
+	 */
+	bool isActive() const { return _active; }
+
+	/**
+	 * @brief       Gets the visible window size
+	 * @param[out]  rows       Number of rows
+	 * @param[out]  columns    Number of columns
+	 */
+	void getSize(size_t& rows, size_t& columns) const;
+
+	/**
+	 * @brief       Waits for a key press
+	 * @param[out]  event      Decoded key
+	 * @param[in]   timeout    Maximum wait
+	 * @return      true if a key was read, false on timeout
+	 */
+	bool readKey(KeyEvent& event, std::chrono::milliseconds timeout);
+
+	/**
+	 * @brief       Writes raw output (text and escape sequences) and flushes it
+	 */
+	void write(const std::string& data);
+
+private:
+	// ================================
+	// Member Variables
+	// ================================
+
+	struct State;                    ///< Platform console state (defined in Terminal.cpp)
+	std::unique_ptr<State> _state;   ///< Saved modes and handles
+	bool                   _active;  ///< Raw mode entered
+	std::string            _pending; ///< Input bytes not yet decoded (POSIX)
+
+	// ================================
+	// Private Helper Methods
+	// ================================
+
+	/**
+	 * @brief       Decodes one key from the start of _pending
+	 * @return      true if a complete key was decoded and consumed
+	 */
+	bool decodePending(KeyEvent& event);
+};
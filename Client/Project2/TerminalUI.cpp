@@ -0,0 +1,659 @@
+/**
+ * @file        TerminalUI.cpp
+ * @author      Natanel Maor Fishman
+ * @brief       Implementation of the full-screen terminal interface.
+ * @details     Event loop, background inbox poller, input commands and
+ *              incremental (changed rows only) rendering.
+ * @date        2025
+ */
+
+#include "TerminalUI.h"
+#include "PollScheduler.h"
+#include "StartupProfile.h"
+
+#include <algorithm>
+#include <ctime>
+#include <iostream>
+#include <boost/algorithm/string/predicate.hpp>
+#include <boost/algorithm/string/trim.hpp>
+
+namespace
+{
+	/// Key wait per loop iteration; bounds the delay before polled messages appear
+	constexpr auto KEY_WAIT = std::chrono::milliseconds(50);
+
+	constexpr auto REVERSE_VIDEO = "\x1b[7m";
+	constexpr auto RESET_ATTRIBUTES = "\x1b[0m";
+
+	/// Row content that never matches a composed row (forces a full redraw)
+	const std::string INVALID_ROW = "\x1b";
+
+	const char* const HELP_TEXT[] = {
+		"Type a message and press Enter to send it to the selected user.",
+		"Up/Down/PgUp/PgDn/Home/End select a user, Esc clears the input line.",
+		"/register <name>  register this client",
+		"/list             refresh the user list",
+		"/find <prefix>    select the next user starting with prefix",
+		"/pubkey           fetch the selected user's public key",
+		"/key              request a symmetric key from the selected user",
+		"/sendkey          send a symmetric key to the selected user",
+		"/file <path>      send a file to the selected user",
+		"/inbox            check for messages now",
+		"/quit             exit (also Ctrl+C)"
+	};
+
+	/**
+	 * @brief       Length of the UTF-8 sequence at text[i] (1 for invalid bytes)
+	 */
+	size_t sequenceLength(const std::string& text, const size_t i)
+	{
+		const auto lead = static_cast<unsigned char>(text[i]);
+		size_t length = 1;
+		if (lead >= 0xF0 && lead <= 0xF4) length = 4;
+		else if (lead >= 0xE0 && lead <= 0xEF) length = 3;
+		else if (lead >= 0xC2 && lead <= 0xDF) length = 2;
+
+		if (i + length > text.size()) {
+			return 1;
+		}
+		for (size_t k = 1; k < length; ++k)
+		{
+			if ((static_cast<unsigned char>(text[i + k]) & 0xC0) != 0x80) {
+				return 1;
+			}
+		}
+		return length;
+	}
+
+	/**
+	 * @brief       Clips or pads text to exactly width columns
+	 * @details     One column per code point; control characters and invalid bytes are
+	 *              replaced so they cannot move the cursor or corrupt the screen.
+	 */
+	std::string fit(const std::string& text, const size_t width)
+	{
+		std::string result;
+		result.reserve(width + 8);
+		size_t used = 0;
+
+		for (size_t i = 0; i < text.size() && used < width; ++used)
+		{
+			const auto c = static_cast<unsigned char>(text[i]);
+			const size_t length = sequenceLength(text, i);
+
+			if (c < 0x20 || c == 0x7F) {
+				result.push_back(' ');
+			}
+			else if (c >= 0x80 && length == 1) {
+				result.push_back('?');
+			}
+			else {
+				result.append(text, i, length);
+			}
+			i += length;
+		}
+		result.append(width - used, ' ');
+		return result;
+	}
+
+	/**
+	 * @brief       Number of display columns of text (code points)
+	 */
+	size_t displayWidth(const std::string& text)
+	{
+		size_t width = 0;
+		for (size_t i = 0; i < text.size(); i += sequenceLength(text, i)) {
+			++width;
+		}
+		return width;
+	}
+
+	/**
+	 * @brief       Drops leading code points until text fits into width columns
+	 */
+	std::string tail(const std::string& text, const size_t width)
+	{
+		size_t excess = displayWidth(text);
+		size_t i = 0;
+		while (excess > width && i < text.size())
+		{
+			i += sequenceLength(text, i);
+			--excess;
+		}
+		return text.substr(i);
+	}
+
+	/**
+	 * @brief       Current local time as HH:MM:SS
+	 */
+	std::string clockTime()
+	{
+		const std::time_t now = std::time(nullptr);
+		std::tm local{};
+#ifdef _WIN32
+		(void)localtime_s(&local, &now);
+#else
+		(void)localtime_r(&now, &local);
+#endif
+		char text[16];
+		return std::string(text, std::strftime(text, sizeof(text), "%H:%M:%S", &local));
+	}
+}
+
+// ================================
+// Constructor and Destructor
+// ================================
+
+TerminalUI::TerminalUI(const ClientOptions& options, const Settings& settings)
+	: _options(options), _settings(settings), _registered(false), _stopping(false), _pollNow(false), _reschedule(false), _probeInbox(true),
+	_userTop(0), _selected(0), _running(true), _dirty(true), _rows(0), _columns(0), _cursor(1)
+{
+}
+
+TerminalUI::~TerminalUI()
+{
+	{
+		std::lock_guard<std::mutex> lock(_pollMutex);
+		_stopping = true;
+	}
+	_pollSignal.notify_all();
+	if (_poller.joinable()) {
+		_poller.join();
+	}
+}
+
+// ================================
+// Public Interface Methods
+// ================================
+
+int TerminalUI::run()
+{
+	if (!_engine.loadServerConfiguration())
+	{
+		std::cerr << "Error: " << _engine.getErrorMessage() << std::endl;
+		return static_cast<int>(ExitCode::CONFIGURATION_ERROR);
+	}
+	_registered = _engine.loadUserCredentials();
+	CommandLine::applyEngineOptions(_options, _engine);
+	StartupProfile::ready();
+
+	Terminal terminal;
+	if (!terminal.isActive())
+	{
+		std::cerr << "Error: --tui requires an interactive terminal" << std::endl;
+		return static_cast<int>(ExitCode::USAGE_ERROR);
+	}
+
+	// A dedicated thread: a long-lived pool task waiting on its own decryption
+	// sub-tasks could starve a single-worker pool
+	_poller = std::thread([this]() { pollerLoop(); });
+
+	_status = _registered ? "Loading user list..." : "Not registered - type /register <username> (/help for commands)";
+	appendHistory("MessageU client. Type /help for commands.");
+
+	bool usersLoaded = !_registered;
+	while (_running)
+	{
+		size_t rows = 0;
+		size_t columns = 0;
+		terminal.getSize(rows, columns);
+		if (rows != _rows || columns != _columns)
+		{
+			_rows = rows;
+			_columns = columns;
+			_front.assign(_rows, INVALID_ROW);
+			terminal.write("\x1b[2J");
+			moveSelection(0);
+			_dirty = true;
+		}
+
+		drainIncoming();
+		if (_dirty)
+		{
+			compose();
+			present(terminal);
+			_dirty = false;
+		}
+
+		// Initial fetch after the first frame, so the screen is not blank meanwhile
+		if (!usersLoaded)
+		{
+			usersLoaded = true;
+			_dirty = true;
+			if (refreshUsers()) {
+				_status = "Ready. " + std::to_string(_users.size()) + " users.";
+			}
+			continue;
+		}
+
+		Terminal::KeyEvent event;
+		if (terminal.readKey(event, KEY_WAIT))
+		{
+			if (event.key == Terminal::Key::ENTER) {
+				submitInput(terminal);
+			}
+			else {
+				handleKey(event);
+			}
+			_dirty = true;
+		}
+	}
+
+	return static_cast<int>(ExitCode::SUCCESS);
+}
+
+// ================================
+// Private Helper Methods
+// ================================
+
+void TerminalUI::pollerLoop()
+{
+	std::unique_lock<std::mutex> lock(_pollMutex);
+	while (!_stopping)
+	{
+		// The engine's scheduler shortens the wait while chatting and backs off when idle
+		const auto delay = _engine.getPollScheduler()->nextDelay();
+		const bool woken = _pollSignal.wait_for(lock, delay, [this]() { return _stopping || _pollNow || _reschedule; });
+		if (_stopping) {
+			break;
+		}
+		_reschedule = false;
+		if (woken && !_pollNow) {
+			continue;  // Wait again, for the interval as it is now
+		}
+		_pollNow = false;
+		if (!_registered) {
+			continue;
+		}
+		lock.unlock();
+
+		std::string warnings;
+		{
+			std::lock_guard<std::mutex> engineLock(_engineMutex);
+
+			// A probe is one small exchange; the inbox is fetched only when something waits
+			MessageEngine::InboxStatus status;
+			const bool probed = _probeInbox && _engine.probeInbox(status);
+			_probeInbox = _probeInbox && status.supported;  // A server without probes still serves the inbox
+			const bool idle = probed && status.messages == 0;
+
+			// Each message is queued as soon as it is decrypted
+			const bool success = idle || _engine.retrievePendingMessages([this](MessageEngine::MessageData&& message) {
+				std::lock_guard<std::mutex> queueLock(_pollMutex);
+				_incoming.push_back(std::move(message));
+			});
+			if (success)
+			{
+				warnings = idle ? std::string() : _engine.getErrorMessage();
+				_lastFailure.clear();
+			}
+			else if (_engine.getErrorMessage() != _lastFailure)
+			{
+				// Reported once until the next success, not on every poll
+				_lastFailure = _engine.getErrorMessage();
+				warnings = "Inbox check failed: " + _lastFailure;
+			}
+		}
+
+		lock.lock();
+		_pollWarnings += warnings;
+	}
+}
+
+void TerminalUI::reschedulePoll()
+{
+	{
+		std::lock_guard<std::mutex> lock(_pollMutex);
+		_reschedule = true;
+	}
+	_pollSignal.notify_all();
+}
+
+void TerminalUI::drainIncoming()
+{
+	std::deque<MessageEngine::MessageData> messages;
+	std::string warnings;
+	{
+		std::lock_guard<std::mutex> lock(_pollMutex);
+		messages.swap(_incoming);
+		warnings.swap(_pollWarnings);
+	}
+
+	if (messages.empty() && warnings.empty()) {
+		return;
+	}
+
+	const std::string time = clockTime();
+	for (const auto& message : messages)
+	{
+		if (message.type == MSG_FILE && message.decrypted) {
+			appendHistory(time + " <" + message.username + "> sent a file, saved to " + message.content);
+		}
+		else {
+			appendHistory(time + " <" + message.username + "> " + message.content);
+		}
+	}
+	if (!warnings.empty()) {
+		appendHistory(time + " " + warnings);
+	}
+	_dirty = true;
+}
+
+void TerminalUI::handleKey(const Terminal::KeyEvent& event)
+{
+	const long page = static_cast<long>(listHeight());
+	const long all = static_cast<long>(_users.size());
+
+	switch (event.key)
+	{
+	case Terminal::Key::CHARACTER: _input += event.text;  break;
+	case Terminal::Key::ESCAPE:    _input.clear();        break;
+	case Terminal::Key::UP:        moveSelection(-1);     break;
+	case Terminal::Key::DOWN:      moveSelection(1);      break;
+	case Terminal::Key::PAGE_UP:   moveSelection(-page);  break;
+	case Terminal::Key::PAGE_DOWN: moveSelection(page);   break;
+	case Terminal::Key::HOME:      moveSelection(-all);   break;
+	case Terminal::Key::END:       moveSelection(all);    break;
+	case Terminal::Key::INTERRUPT: _running = false;      break;
+	case Terminal::Key::BACKSPACE:
+		// Remove one whole UTF-8 character
+		while (!_input.empty() && (static_cast<unsigned char>(_input.back()) & 0xC0) == 0x80) {
+			_input.pop_back();
+		}
+		if (!_input.empty()) {
+			_input.pop_back();
+		}
+		break;
+	default:
+		break;
+	}
+}
+
+void TerminalUI::submitInput(Terminal& terminal)
+{
+	const std::string line = boost::algorithm::trim_copy(_input);
+	_input.clear();
+	if (line.empty()) {
+		return;
+	}
+
+	// Shows progress, runs an engine call under the engine lock and reports the outcome
+	const auto perform = [this, &terminal](const std::string& progress, const std::string& done,
+		const std::function<bool()>& operation) -> bool {
+		_status = progress;
+		compose();
+		present(terminal);
+
+		bool success = false;
+		std::string error;
+		{
+			std::lock_guard<std::mutex> lock(_engineMutex);
+			success = operation();
+			error = _engine.getErrorMessage();
+		}
+		_status = success ? done : "Error: " + error;
+		return success;
+	};
+
+	std::string command = line;
+	std::string argument;
+	if (line[0] == '/')
+	{
+		const size_t space = line.find(' ');
+		if (space != std::string::npos)
+		{
+			command = line.substr(0, space);
+			argument = boost::algorithm::trim_copy(line.substr(space + 1));
+		}
+	}
+
+	if (command == "/quit") {
+		_running = false;
+		return;
+	}
+	if (command == "/help")
+	{
+		for (const char* text : HELP_TEXT) {
+			appendHistory(text);
+		}
+		return;
+	}
+	if (command == "/register")
+	{
+		if (_registered) {
+			_status = "Already registered as " + _engine.getSelfUsername();
+		}
+		else if (argument.empty()) {
+			_status = "Usage: /register <username>";
+		}
+		else if (perform("Registering...", "Registered as " + argument,
+			[this, &argument]() { return _engine.registerClient(argument); }))
+		{
+			_registered = true;
+			(void)refreshUsers();
+		}
+		return;
+	}
+	if (!_registered)
+	{
+		_status = "Not registered - type /register <username>";
+		return;
+	}
+	if (command == "/list")
+	{
+		if (refreshUsers()) {
+			_status = std::to_string(_users.size()) + " users.";
+		}
+		return;
+	}
+	if (command == "/inbox")
+	{
+		{
+			std::lock_guard<std::mutex> lock(_pollMutex);
+			_pollNow = true;
+		}
+		_pollSignal.notify_all();
+		_status = "Checking for messages...";
+		return;
+	}
+	if (command == "/find")
+	{
+		for (size_t step = 1; step <= _users.size(); ++step)
+		{
+			const size_t index = (_selected + step) % _users.size();
+			if (boost::algorithm::istarts_with(_users[index], argument))
+			{
+				moveSelection(static_cast<long>(index) - static_cast<long>(_selected));
+				return;
+			}
+		}
+		_status = "No user starts with '" + argument + "'";
+		return;
+	}
+
+	const std::string recipient = selectedUser();
+	if (recipient.empty())
+	{
+		_status = "No user selected - type /list";
+		return;
+	}
+
+	if (line[0] != '/')
+	{
+		if (perform("Sending to " + recipient + "...", "Message delivered to " + recipient + ".",
+			[this, &recipient, &line]() { return _engine.sendMessage(recipient, MSG_TEXT, line); }))
+		{
+			appendHistory(clockTime() + " -> <" + recipient + "> " + line);
+			reschedulePoll();
+		}
+	}
+	else if (command == "/pubkey") {
+		(void)perform("Fetching public key...", "Public key of " + recipient + " retrieved.",
+			[this, &recipient]() { return _engine.requestClientPublicKey(recipient); });
+	}
+	else if (command == "/key") {
+		if (perform("Requesting symmetric key...", "Symmetric key requested from " + recipient + ".",
+			[this, &recipient]() { return _engine.sendMessage(recipient, MSG_SYMMETRIC_KEY_REQUEST); }))
+		{
+			reschedulePoll();
+		}
+	}
+	else if (command == "/sendkey") {
+		if (perform("Sending symmetric key...", "Symmetric key sent to " + recipient + ".",
+			[this, &recipient]() { return _engine.sendMessage(recipient, MSG_SYMMETRIC_KEY_SEND); }))
+		{
+			reschedulePoll();
+		}
+	}
+	else if (command == "/file")
+	{
+		if (argument.empty()) {
+			_status = "Usage: /file <path>";
+		}
+		else if (perform("Sending file to " + recipient + "...", "File delivered to " + recipient + ".",
+			[this, &recipient, &argument]() { return _engine.sendMessage(recipient, MSG_FILE, argument); }))
+		{
+			appendHistory(clockTime() + " -> <" + recipient + "> file " + argument);
+			reschedulePoll();
+		}
+	}
+	else {
+		_status = "Unknown command " + command + " (/help lists commands)";
+	}
+}
+
+bool TerminalUI::refreshUsers()
+{
+	bool success = false;
+	std::string error;
+	std::vector<std::string> users;
+	{
+		std::lock_guard<std::mutex> lock(_engineMutex);
+		success = _engine.requestClientsList();
+		error = _engine.getErrorMessage();
+		users = _engine.getUsernames();
+	}
+
+	// Keep the selection on the same user if it is still listed
+	const std::string previous = selectedUser();
+	_users.swap(users);
+	const auto found = std::find(_users.begin(), _users.end(), previous);
+	_selected = (found != _users.end()) ? static_cast<size_t>(found - _users.begin()) : 0;
+	moveSelection(0);
+
+	if (!success) {
+		_status = "Error: " + error;
+	}
+	return success;
+}
+
+void TerminalUI::moveSelection(const long delta)
+{
+	if (_users.empty())
+	{
+		_selected = 0;
+		_userTop = 0;
+		return;
+	}
+
+	const long last = static_cast<long>(_users.size()) - 1;
+	_selected = static_cast<size_t>(std::max(0L, std::min(last, static_cast<long>(_selected) + delta)));
+
+	const size_t height = listHeight();
+	if (_selected < _userTop) {
+		_userTop = _selected;
+	}
+	else if (_selected >= _userTop + height) {
+		_userTop = _selected - height + 1;
+	}
+	_userTop = std::min(_userTop, (_users.size() > height) ? _users.size() - height : 0);
+}
+
+void TerminalUI::appendHistory(const std::string& text)
+{
+	size_t start = 0;
+	while (start <= text.size())
+	{
+		size_t end = text.find('\n', start);
+		if (end == std::string::npos) {
+			end = text.size();
+		}
+		std::string line = text.substr(start, end - start);
+		if (!line.empty() && line.back() == '\r') {
+			line.pop_back();
+		}
+		_history.push_back(std::move(line));
+		start = end + 1;
+	}
+
+	while (_history.size() > _settings.historyLines) {
+		_history.pop_front();
+	}
+}
+
+void TerminalUI::compose()
+{
+	if (_rows == 0 || _columns == 0) {
+		return;
+	}
+
+	const size_t height = listHeight();
+	const size_t listWidth = std::min<size_t>(32, std::max<size_t>(12, _columns / 4));
+	const size_t paneWidth = (_columns > listWidth + 1) ? _columns - listWidth - 1 : 0;
+	_back.assign(_rows, std::string());
+
+	// Title bar
+	std::string title = " MessageU | ";
+	title += _registered ? _engine.getSelfUsername() : std::string("not registered");
+	title += " | users " + (_users.empty() ? std::string("0") : std::to_string(_selected + 1) + "/" + std::to_string(_users.size()));
+	if (!_users.empty()) {
+		title += " | to: " + selectedUser();
+	}
+	_back[0] = REVERSE_VIDEO + fit(title, _columns) + RESET_ATTRIBUTES;
+
+	// User list (only the visible slice is formatted) and message pane
+	const size_t historyStart = (_history.size() > height) ? _history.size() - height : 0;
+	for (size_t i = 0; i < height && i + 1 < _rows; ++i)
+	{
+		const size_t userIndex = _userTop + i;
+		std::string row;
+		if (userIndex < _users.size())
+		{
+			const std::string entry = fit(" " + _users[userIndex], listWidth);
+			row = (userIndex == _selected) ? REVERSE_VIDEO + entry + RESET_ATTRIBUTES : entry;
+		}
+		else {
+			row = fit("", listWidth);
+		}
+
+		const size_t historyIndex = historyStart + i;
+		row += "|";
+		row += fit((historyIndex < _history.size()) ? _history[historyIndex] : std::string(), paneWidth);
+		_back[i + 1] = row;
+	}
+
+	// Status and input lines (the last column of the last row is left empty to avoid scrolling)
+	if (_rows >= 3) {
+		_back[_rows - 2] = REVERSE_VIDEO + fit(_status, _columns) + RESET_ATTRIBUTES;
+	}
+	const size_t inputWidth = (_columns > 3) ? _columns - 3 : 0;
+	const std::string visibleInput = "> " + tail(_input, inputWidth);
+	_back[_rows - 1] = fit(visibleInput, _columns - 1);
+	_cursor = std::min(_columns, displayWidth(visibleInput) + 1);
+}
+
+void TerminalUI::present(Terminal& terminal)
+{
+	std::string frame = "\x1b[?25l";
+	for (size_t row = 0; row < _back.size() && row < _front.size(); ++row)
+	{
+		if (_back[row] != _front[row])
+		{
+			frame += "\x1b[" + std::to_string(row + 1) + ";1H";
+			frame += _back[row];
+			_front[row] = _back[row];
+		}
+	}
+	frame += "\x1b[" + std::to_string(_rows) + ";" + std::to_string(_cursor) + "H\x1b[?25h";
+	terminal.write(frame);
+}
@@ -0,0 +1,214 @@
+/**
+ * @file        TerminalUI.h
+ * @author      Natanel Maor Fishman
+ * @brief       Full-screen, event-driven terminal interface
+ * @details     Alternative to the menu-driven ConsoleInterface: a single screen with a
+ *              scrollable user list, a message pane fed by a background inbox poller and
+ *              an input line. Only rows that changed are redrawn, and no shell commands
+ *              (cls/pause) are spawned.
+ * @version     2.0
+ * @date        2025
+ */
+
+#pragma once
+
+// ================================
+// Standard Library Includes
+// ================================
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// ================================
+// Application Includes
+// ================================
+
+#include "CommandLine.h"
+#include "MessageEngine.h"
+#include "Terminal.h"
+
+// ================================
+// Class Definition
+// ================================
+
+/**
+ * @class       TerminalUI
+ * @brief       Incrementally rendered full-screen client
+ * @details     Layout: title bar, user list (left), messages (right), status line and
+ *              input line. Text typed on the input line is sent to the selected user;
+ *              lines starting with '/' are commands (see /help).
+ *
+ *              Events: the main thread waits for key presses with a short timeout and
+ *              drains messages queued by the poller thread in between, so new messages
+ *              appear without user interaction. Each frame is composed into a back buffer
+ *              of screen rows and only rows that differ from the previous frame are
+ *              written, in a single output call.
+ *
+ *              The user list is virtualized: a frame formats only the visible slice, so
+ *              scrolling costs the same for 100 or 100,000 users.
+ *
+ *              All engine calls (from the main thread and the poller) are serialized by
+ *              an internal mutex, since MessageEngine is not thread-safe.
+ *
+ * @note        This class is non-copyable.
+ */
+class TerminalUI
+{
+public:
+	// ================================
+	// Data Structures
+	// ================================
+
+	/**
+	 * @struct      Settings
+	 * @brief       Interface configuration
+	 */
+	struct Settings
+	{
+		size_t historyLines = 5000;  ///< Message pane lines kept
+	};
+
+	// ================================
+	// Constructor and Destructor
+	// ================================
+
+	/**
+	 * @brief       Creates the interface
+	 * @param[in]   options     Engine options (shared directory, rate limits, keep-alive)
+	 * @param[in]   settings    Interface configuration
+	 */
+	TerminalUI(const ClientOptions& options, const Settings& settings);
+
+	/**
+	 * @brief       Stops the poller
+	 */
+	virtual ~TerminalUI();
+
+	// ================================
+	// Copy Control (Deleted)
+	// ================================
+
+	TerminalUI(const TerminalUI&) = delete;
+	TerminalUI& operator=(const TerminalUI&) = delete;
+
+	// ================================
+	// Public Interface Methods
+	// ================================
+
+	/**
+	 * @brief       Runs the interface until /quit or Ctrl+C
+	 * @return      Process exit code (see ExitCode)
+	 */
+	int run();
+
+private:
+	// ================================
+	// Member Variables
+	// ================================
+
+	const ClientOptions _options;        ///< Command-line options
+	const Settings      _settings;       ///< Interface configuration
+
+	MessageEngine       _engine;         ///< Messaging engine
+	std::mutex          _engineMutex;    ///< Serializes engine calls
+	std::atomic<bool>   _registered;     ///< my.info loaded or registration done
+
+	// Poller
+	std::thread                                _poller;       ///< Background inbox poller
+	std::mutex                                 _pollMutex;    ///< Guards poller state and queue
+	std::condition_variable                    _pollSignal;   ///< Wakes the poller early
+	bool                                       _stopping;     ///< Poller shutdown requested
+	bool                                       _pollNow;      ///< Immediate poll requested
+	bool                                       _reschedule;   ///< Poll interval may have changed
+	std::deque<MessageEngine::MessageData>     _incoming;     ///< Messages not yet displayed
+	std::string                                _pollWarnings; ///< Poller errors not yet displayed
+	std::string                                _lastFailure;  ///< Last poll failure (poller thread only)
+	bool                                       _probeInbox;   ///< Server answers inbox probes (poller thread only)
+
+	// View state (main thread only)
+	std::vector<std::string> _users;     ///< User list snapshot
+	size_t                   _userTop;   ///< First visible user
+	size_t                   _selected;  ///< Selected user index
+	std::deque<std::string>  _history;   ///< Message pane lines
+	std::string              _input;     ///< Input line
+	std::string              _status;    ///< Status line
+	bool                     _running;   ///< Cleared by /quit
+	bool                     _dirty;     ///< View changed since the last frame
+
+	// Rendering
+	std::vector<std::string> _front;     ///< Rows currently on screen
+	std::vector<std::string> _back;      ///< Rows of the next frame
+	size_t                   _rows;      ///< Window rows
+	size_t                   _columns;   ///< Window columns
+	size_t                   _cursor;    ///< Input cursor column (1-based)
+
+	// ================================
+	// Private Helper Methods
+	// ================================
+
+	/**
+	 * @brief       Poller thread: checks the inbox at the intervals of the engine's poll scheduler
+	 */
+	void pollerLoop();
+
+	/**
+	 * @brief       Makes the poller restart its wait after a send shortened the interval
+	 */
+	void reschedulePoll();
+
+	/**
+	 * @brief       Moves messages queued by the poller into the message pane
+	 */
+	void drainIncoming();
+
+	/**
+	 * @brief       Handles one key press
+	 */
+	void handleKey(const Terminal::KeyEvent& event);
+
+	/**
+	 * @brief       Executes the input line (command or text message)
+	 * @param[in]   terminal    Used to show progress before blocking calls
+	 */
+	void submitInput(Terminal& terminal);
+
+	/**
+	 * @brief       Refreshes the user list from the server
+	 */
+	bool refreshUsers();
+
+	/**
+	 * @brief       Moves the selection, keeping it visible
+	 */
+	void moveSelection(long delta);
+
+	/**
+	 * @brief       Appends text (split into lines) to the message pane
+	 */
+	void appendHistory(const std::string& text);
+
+	/**
+	 * @brief       Composes the next frame into the back buffer
+	 */
+	void compose();
+
+	/**
+	 * @brief       Writes rows that differ from the screen, then places the cursor
+	 */
+	void present(Terminal& terminal);
+
+	/**
+	 * @brief       Number of visible user rows for the current window size
+	 */
+	size_t listHeight() const { return (_rows > 3) ? _rows - 3 : 1; }
+
+	/**
+	 * @brief       Gets the selected username, or empty if none
+	 */
+	std::string selectedUser() const { return (_selected < _users.size()) ? _users[_selected] : std::string(); }
+};
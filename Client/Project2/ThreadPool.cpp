@@ -0,0 +1,208 @@
+/**
+ * @file        ThreadPool.cpp
+ * @author      Natanel Maor Fishman
+ * @brief       Implementation of the engine-level work-stealing thread pool.
+ * @details     Per-worker priority deques, FIFO stealing, idle parking and optional CPU pinning.
+ * @date        2025
+ */
+
+#include "ThreadPool.h"
+
+#include <algorithm>
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace
+{
+	/// Identifies the pool and worker index of the current thread (nullptr outside workers)
+	thread_local const ThreadPool* currentPool = nullptr;
+	thread_local size_t currentWorker = 0;
+
+	/// Idle workers re-scan for stealable work at this interval
+	constexpr auto IDLE_RESCAN_INTERVAL = std::chrono::milliseconds(50);
+}
+
+// ================================
+// Constructor and Destructor
+// ================================
+
+ThreadPool::ThreadPool(size_t workerCount, const PinningPolicy pinning)
+	: _pending(0), _nextQueue(0), _stopping(false),
+	_submitted(0), _executed(0), _steals(0), _busyMicros(0),
+	_startTime(std::chrono::steady_clock::now())
+{
+	if (workerCount == 0) {
+		workerCount = std::max<size_t>(1, std::thread::hardware_concurrency());
+	}
+
+	for (size_t i = 0; i < workerCount; ++i) {
+		_queues.emplace_back(new WorkerQueue());
+	}
+
+	for (size_t i = 0; i < workerCount; ++i)
+	{
+		_workers.emplace_back([this, i, pinning]() {
+			if (pinning == PinningPolicy::PER_CORE) {
+				pinCurrentThread(i);
+			}
+			workerLoop(i);
+		});
+	}
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(_idleMutex);
+		_stopping = true;
+	}
+	_idleSignal.notify_all();
+
+	for (auto& worker : _workers)
+	{
+		if (worker.joinable()) {
+			worker.join();
+		}
+	}
+}
+
+// ================================
+// Accessor Methods
+// ================================
+
+ThreadPool::Stats ThreadPool::getStats() const
+{
+	Stats stats;
+	stats.workers = _workers.size();
+	stats.tasksSubmitted = _submitted.load();
+	stats.tasksExecuted = _executed.load();
+	stats.steals = _steals.load();
+	stats.busyMicros = _busyMicros.load();
+
+	const auto uptime = std::chrono::duration_cast<std::chrono::microseconds>(
+		std::chrono::steady_clock::now() - _startTime).count();
+	if (uptime > 0 && stats.workers > 0) {
+		stats.utilization = static_cast<double>(stats.busyMicros) / (static_cast<double>(uptime) * stats.workers);
+	}
+	return stats;
+}
+
+// ================================
+// Private Helper Methods
+// ================================
+
+/**
+ * @brief       Pushes to the caller's own deque (worker) or the next deque round-robin
+ */
+void ThreadPool::enqueue(Task task, const TaskPriority priority)
+{
+	const size_t target = (currentPool == this)
+		? currentWorker
+		: (_nextQueue.fetch_add(1, std::memory_order_relaxed) % _queues.size());
+
+	{
+		// Count before publishing: a busy worker may take the task, and decrement,
+		// as soon as it is queued. Under the idle lock so a parking worker sees it.
+		std::lock_guard<std::mutex> lock(_idleMutex);
+		++_pending;
+	}
+	{
+		WorkerQueue& queue = *_queues[target];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		queue.tasks[static_cast<size_t>(priority)].push_back(std::move(task));
+	}
+	++_submitted;
+	_idleSignal.notify_one();
+}
+
+/**
+ * @brief       Runs local tasks first, then steals, then parks until work arrives
+ */
+void ThreadPool::workerLoop(const size_t index)
+{
+	currentPool = this;
+	currentWorker = index;
+
+	while (true)
+	{
+		Task task;
+		if (popLocal(index, task) || steal(index, task))
+		{
+			--_pending;
+			const auto start = std::chrono::steady_clock::now();
+			task();  // packaged_task captures exceptions into the future
+			_busyMicros += static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+				std::chrono::steady_clock::now() - start).count());
+			++_executed;
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(_idleMutex);
+		if (_stopping && _pending == 0) {
+			break;  // Drained
+		}
+		_idleSignal.wait_for(lock, IDLE_RESCAN_INTERVAL, [this]() { return _stopping || _pending > 0; });
+	}
+
+	currentPool = nullptr;
+}
+
+bool ThreadPool::popLocal(const size_t index, Task& task)
+{
+	WorkerQueue& queue = *_queues[index];
+	std::lock_guard<std::mutex> lock(queue.mutex);
+	for (auto& tasks : queue.tasks)
+	{
+		if (!tasks.empty())
+		{
+			task = std::move(tasks.back());
+			tasks.pop_back();
+			return true;
+		}
+	}
+	return false;
+}
+
+bool ThreadPool::steal(const size_t thiefIndex, Task& task)
+{
+	const size_t count = _queues.size();
+	for (size_t level = 0; level < PRIORITY_LEVELS; ++level)
+	{
+		for (size_t offset = 1; offset < count; ++offset)
+		{
+			WorkerQueue& victim = *_queues[(thiefIndex + offset) % count];
+			std::unique_lock<std::mutex> lock(victim.mutex, std::try_to_lock);
+			if (!lock.owns_lock() || victim.tasks[level].empty()) {
+				continue;
+			}
+			task = std::move(victim.tasks[level].front());
+			victim.tasks[level].pop_front();
+			++_steals;
+			return true;
+		}
+	}
+	return false;
+}
+
+void ThreadPool::pinCurrentThread(const size_t index)
+{
+	const size_t cores = std::max<size_t>(1, std::thread::hardware_concurrency());
+	const size_t core = index % cores;
+#ifdef _WIN32
+	if (core < sizeof(DWORD_PTR) * 8) {
+		(void)SetThreadAffinityMask(GetCurrentThread(), static_cast<DWORD_PTR>(1) << core);
+	}
+#else
+	cpu_set_t cpuSet;
+	CPU_ZERO(&cpuSet);
+	CPU_SET(core, &cpuSet);
+	(void)pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet);
+#endif
+}
@@ -0,0 +1,220 @@
+/**
+ * @file        ThreadPool.h
+ * @author      Natanel Maor Fishman
+ * @brief       Engine-level work-stealing thread pool for crypto and I/O tasks
+ * @details     Single shared executor for background work (parallel decryption, prefetch,
+ *              file writes, polling) so that subsystems do not spawn their own threads.
+ *              Each worker owns a deque per priority; idle workers steal from the others.
+ * @version     2.0
+ * @date        2025
+ */
+
+#pragma once
+
+// ================================
+// Standard Library Includes
+// ================================
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// ================================
+// Enumerations
+// ================================
+
+/**
+ * @enum        TaskPriority
+ * @brief       Scheduling priority of a submitted task
+ * @details     Workers always drain higher priorities first, both locally and when stealing.
+ */
+enum class TaskPriority : uint8_t
+{
+	HIGH = 0,       ///< Latency-sensitive work (user-visible results)
+	NORMAL = 1,     ///< Default priority
+	LOW = 2         ///< Background work (prefetch, housekeeping)
+};
+
+/**
+ * @enum        PinningPolicy
+ * @brief       CPU affinity policy for worker threads
+ */
+enum class PinningPolicy : uint8_t
+{
+	NONE = 0,       ///< Let the OS scheduler place workers
+	PER_CORE = 1    ///< Pin worker i to logical processor i (mod core count)
+};
+
+// ================================
+// Class Definition
+// ================================
+
+/**
+ * @class       ThreadPool
+ * @brief       Work-stealing thread pool with task priorities
+ * @details     Tasks submitted from a worker thread go to that worker's own deque
+ *              (LIFO, cache-warm); tasks from other threads are distributed round-robin.
+ *              An idle worker takes from the front of another worker's deque (FIFO steal).
+ *
+ *              Counters (tasks executed, steals, busy time) are exposed through getStats()
+ *              for utilization monitoring.
+ *
+ * @note        The destructor drains all queued tasks before joining the workers.
+ *              This class is non-copyable and non-movable because it owns threads.
+ */
+class ThreadPool
+{
+public:
+	// ================================
+	// Data Structures
+	// ================================
+
+	/**
+	 * @struct      Stats
+	 * @brief       Pool utilization counters
+	 */
+	struct Stats
+	{
+		size_t   workers = 0;          ///< Number of worker threads
+		uint64_t tasksSubmitted = 0;   ///< Tasks accepted by submit()
+		uint64_t tasksExecuted = 0;    ///< Tasks run to completion
+		uint64_t steals = 0;           ///< Tasks taken from another worker's deque
+		uint64_t busyMicros = 0;       ///< Total time workers spent running tasks
+		double   utilization = 0;      ///< busy time / (uptime x workers), 0..1
+	};
+
+	// ================================
+	// Constructor and Destructor
+	// ================================
+
+	/**
+	 * @brief       Starts the worker threads
+	 * @param[in]   workerCount    Number of workers (0 = hardware concurrency)
+	 * @param[in]   pinning        CPU affinity policy for workers
+	 */
+	explicit ThreadPool(size_t workerCount = 0, PinningPolicy pinning = PinningPolicy::NONE);
+
+	/**
+	 * @brief       Drains queued tasks and joins all workers
+	 */
+	virtual ~ThreadPool();
+
+	// ================================
+	// Copy Control (Deleted)
+	// ================================
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool(ThreadPool&&) noexcept = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+	ThreadPool& operator=(ThreadPool&&) noexcept = delete;
+
+	// ================================
+	// Task Submission
+	// ================================
+
+	/**
+	 * @brief       Submits a callable for execution
+	 * @param[in]   function    Callable taking no arguments
+	 * @param[in]   priority    Scheduling priority
+	 * @return      Future receiving the callable's result or exception
+	 */
+	template <typename Function>
+	auto submit(Function&& function, TaskPriority priority = TaskPriority::NORMAL)
+		-> std::future<typename std::result_of<Function()>::type>
+	{
+		using Result = typename std::result_of<Function()>::type;
+		auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<Function>(function));
+		std::future<Result> result = task->get_future();
+		enqueue([task]() { (*task)(); }, priority);
+		return result;
+	}
+
+	// ================================
+	// Accessor Methods
+	// ================================
+
+	/**
+	 * @brief       Gets the number of worker threads
+	 */
+	size_t getWorkerCount() const { return _workers.size(); }
+
+	/**
+	 * @brief       Gets a snapshot of the utilization counters
+	 */
+	Stats getStats() const;
+
+private:
+	// ================================
+	// Internal Types
+	// ================================
+
+	using Task = std::function<void()>;
+	static constexpr size_t PRIORITY_LEVELS = 3;
+
+	/**
+	 * @struct      WorkerQueue
+	 * @brief       Per-worker deques, one per priority level
+	 */
+	struct WorkerQueue
+	{
+		std::mutex       mutex;                     ///< Guards the deques
+		std::deque<Task> tasks[PRIORITY_LEVELS];    ///< Pending tasks by priority
+	};
+
+	// ================================
+	// Member Variables
+	// ================================
+
+	std::vector<std::thread>                  _workers;     ///< Worker threads
+	std::vector<std::unique_ptr<WorkerQueue>> _queues;      ///< One queue set per worker
+	std::mutex                                _idleMutex;   ///< Guards idle waiting
+	std::condition_variable                   _idleSignal;  ///< Wakes idle workers
+	std::atomic<size_t>                       _pending;     ///< Queued, not yet started tasks
+	std::atomic<size_t>                       _nextQueue;   ///< Round-robin cursor for external submits
+	std::atomic<bool>                         _stopping;    ///< Set by the destructor
+
+	std::atomic<uint64_t>                     _submitted;   ///< Stats: tasks submitted
+	std::atomic<uint64_t>                     _executed;    ///< Stats: tasks executed
+	std::atomic<uint64_t>                     _steals;      ///< Stats: successful steals
+	std::atomic<uint64_t>                     _busyMicros;  ///< Stats: time spent in tasks
+	std::chrono::steady_clock::time_point     _startTime;   ///< Pool creation time
+
+	// ================================
+	// Private Helper Methods
+	// ================================
+
+	/**
+	 * @brief       Queues a type-erased task and wakes a worker
+	 */
+	void enqueue(Task task, TaskPriority priority);
+
+	/**
+	 * @brief       Worker thread main loop
+	 * @param[in]   index    Worker index
+	 */
+	void workerLoop(size_t index);
+
+	/**
+	 * @brief       Pops the newest highest-priority task from a worker's own deque
+	 */
+	bool popLocal(size_t index, Task& task);
+
+	/**
+	 * @brief       Steals the oldest highest-priority task from another worker
+	 */
+	bool steal(size_t thiefIndex, Task& task);
+
+	/**
+	 * @brief       Applies the pinning policy to the calling worker thread
+	 */
+	static void pinCurrentThread(size_t index);
+};
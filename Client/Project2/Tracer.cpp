@@ -0,0 +1,192 @@
+/**
+ * @file        Tracer.cpp
+ * @author      Natanel Maor Fishman
+ * @brief       Implementation of the trace event collector.
+ * @details     Per-thread event buffers and Chrome trace-event JSON output.
+ * @date        2025
+ */
+
+#include "Tracer.h"
+
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace
+{
+	/**
+	 * @struct      TraceEvent
+	 * @brief       One complete event
+	 */
+	struct TraceEvent
+	{
+		const char* category;
+		const char* name;
+		int64_t     startNanos;  // Relative to the trace start
+		int64_t     durationNanos;
+		uint64_t    bytes;
+	};
+
+	/**
+	 * @struct      ThreadBuffer
+	 * @brief       Events of one thread (the lock is uncontended except during stop)
+	 */
+	struct ThreadBuffer
+	{
+		std::mutex              mutex;
+		std::vector<TraceEvent> events;
+		uint32_t                threadId = 0;
+	};
+
+	/**
+	 * @struct      TraceState
+	 * @brief       Collector state shared by all threads
+	 */
+	struct TraceState
+	{
+		std::mutex                                 mutex;       // Guards everything but the buffers' contents
+		std::vector<std::shared_ptr<ThreadBuffer>> buffers;     // Kept alive after their threads exit
+		std::string                                path;
+		std::chrono::steady_clock::time_point      origin;
+		uint64_t                                   generation = 0;  // Invalidates thread-local buffers
+		std::atomic<size_t>                        eventCount{ 0 };
+		std::atomic<size_t>                        dropped{ 0 };
+	};
+
+	TraceState& state()
+	{
+		static TraceState instance;
+		return instance;
+	}
+
+	/**
+	 * @brief       Gets the calling thread's buffer for the current trace
+	 */
+	ThreadBuffer& threadBuffer()
+	{
+		thread_local std::shared_ptr<ThreadBuffer> buffer;
+		thread_local uint64_t bufferGeneration = 0;
+
+		TraceState& trace = state();
+		std::lock_guard<std::mutex> lock(trace.mutex);  // Only once per thread and trace
+		(void)lock;
+		if (!buffer || bufferGeneration != trace.generation)
+		{
+			buffer = std::make_shared<ThreadBuffer>();
+			buffer->threadId = static_cast<uint32_t>(trace.buffers.size() + 1);
+			bufferGeneration = trace.generation;
+			trace.buffers.push_back(buffer);
+		}
+		return *buffer;
+	}
+
+	/**
+	 * @brief       Writes a JSON string literal (names are plain identifiers, but stay safe)
+	 */
+	void writeString(std::ostream& output, const char* text)
+	{
+		output << '"';
+		for (const char* c = text; *c != '\0'; ++c)
+		{
+			if (*c == '"' || *c == '\\') {
+				output << '\\';
+			}
+			output << *c;
+		}
+		output << '"';
+	}
+}
+
+std::atomic<bool> Tracer::s_enabled(false);
+
+// ================================
+// Public Interface Methods
+// ================================
+
+bool Tracer::start(const std::string& path)
+{
+	TraceState& trace = state();
+	std::lock_guard<std::mutex> lock(trace.mutex);
+	if (s_enabled.load()) {
+		return false;
+	}
+
+	trace.buffers.clear();
+	trace.path = path;
+	trace.origin = std::chrono::steady_clock::now();
+	trace.eventCount = 0;
+	trace.dropped = 0;
+	++trace.generation;
+	s_enabled.store(true);
+	return true;
+}
+
+bool Tracer::stop()
+{
+	TraceState& trace = state();
+	std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+	std::string path;
+	{
+		std::lock_guard<std::mutex> lock(trace.mutex);
+		if (!s_enabled.exchange(false)) {
+			return true;
+		}
+		buffers.swap(trace.buffers);
+		path = trace.path;
+		++trace.generation;
+	}
+
+	std::ofstream file(path, std::ios::trunc);
+	if (!file.is_open()) {
+		return false;
+	}
+
+	file << "{\"displayTimeUnit\":\"ms\",\"otherData\":{\"droppedEvents\":" << trace.dropped.load() << "},\"traceEvents\":[";
+	file << std::fixed << std::setprecision(3);
+
+	bool first = true;
+	for (const auto& buffer : buffers)
+	{
+		std::lock_guard<std::mutex> lock(buffer->mutex);  // Spans still closing on other threads
+		for (const TraceEvent& event : buffer->events)
+		{
+			file << (first ? "\n" : ",\n") << "{\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->threadId << ",\"cat\":";
+			writeString(file, event.category);
+			file << ",\"name\":";
+			writeString(file, event.name);
+			file << ",\"ts\":" << event.startNanos / 1000.0 << ",\"dur\":" << event.durationNanos / 1000.0;
+			if (event.bytes != NO_BYTES) {
+				file << ",\"args\":{\"bytes\":" << event.bytes << "}";
+			}
+			file << "}";
+			first = false;
+		}
+	}
+	file << "\n]}\n";
+	return static_cast<bool>(file.flush());
+}
+
+void Tracer::record(const char* category, const char* name,
+	const std::chrono::steady_clock::time_point start, const std::chrono::steady_clock::time_point end, const uint64_t bytes)
+{
+	if (!isEnabled()) {
+		return;  // Stopped while the span was open
+	}
+
+	TraceState& trace = state();
+	if (trace.eventCount.fetch_add(1, std::memory_order_relaxed) >= MAX_EVENTS)
+	{
+		trace.dropped.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+
+	ThreadBuffer& buffer = threadBuffer();
+	const auto toNanos = [](const std::chrono::steady_clock::duration duration) {
+		return static_cast<int64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count());
+	};
+
+	std::lock_guard<std::mutex> lock(buffer.mutex);
+	buffer.events.push_back({ category, name, toNanos(start - trace.origin), toNanos(end - start), bytes });
+}
@@ -0,0 +1,125 @@
+/**
+ * @file        Tracer.h
+ * @author      Natanel Maor Fishman
+ * @brief       Scoped trace spans in Chrome trace-event format
+ * @details     Subsystems mark interesting scopes with TraceSpan objects. While tracing
+ *              is enabled, each span becomes a complete ("X") event in a JSON file that
+ *              chrome://tracing and Perfetto (ui.perfetto.dev) can open. While disabled,
+ *              a span costs one relaxed atomic load.
+ * @version     2.0
+ * @date        2025
+ */
+
+#pragma once
+
+// ================================
+// Standard Library Includes
+// ================================
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+// ================================
+// Class Definitions
+// ================================
+
+/**
+ * @class       Tracer
+ * @brief       Process-wide trace event collector
+ * @details     Events are appended to per-thread buffers (no shared lock on the hot path)
+ *              and written out by stop(). At most MAX_EVENTS events are kept; later ones
+ *              are counted as dropped.
+ *
+ * @note        This class cannot be instantiated - all methods are static. Thread-safe.
+ */
+class Tracer
+{
+public:
+	// ================================
+	// Copy Control (Deleted)
+	// ================================
+
+	Tracer() = delete;
+	Tracer(const Tracer&) = delete;
+	Tracer& operator=(const Tracer&) = delete;
+
+	// ================================
+	// Public Interface Methods
+	// ================================
+
+	/**
+	 * @brief       Starts collecting events
+	 * @param[in]   path    Trace file written by stop()
+	 * @return      true if tracing started, false if already running
+	 */
+	static bool start(const std::string& path);
+
+	/**
+	 * @brief       Stops collecting and writes the trace file
+	 * @return      true if the file was written (or tracing was not running), false otherwise
+	 */
+	static bool stop();
+
+	/**
+	 * @brief       Checks if events are being collected
+	 */
+	static bool isEnabled() { return s_enabled.load(std::memory_order_relaxed); }
+
+	/**
+	 * @brief       Records a complete event
+	 * @param[in]   category    Subsystem (static string, e.g. "net")
+	 * @param[in]   name        Span name (static string, e.g. "sendData")
+	 * @param[in]   start       Span start
+	 * @param[in]   end         Span end
+	 * @param[in]   bytes       Bytes processed, or NO_BYTES
+	 */
+	static void record(const char* category, const char* name,
+		std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end, uint64_t bytes);
+
+	static constexpr uint64_t NO_BYTES = UINT64_MAX;  ///< record(): no byte count
+	static constexpr size_t   MAX_EVENTS = 1000000;   ///< Events kept per trace
+
+private:
+	static std::atomic<bool> s_enabled;  ///< Collection switch
+};
+
+/**
+ * @class       TraceSpan
+ * @brief       RAII span: records [construction, destruction) while tracing is enabled
+ * @details     Names and categories must be string literals (they are stored by pointer).
+ */
+class TraceSpan
+{
+public:
+	TraceSpan(const char* category, const char* name)
+		: _category(category), _name(name), _bytes(Tracer::NO_BYTES), _active(Tracer::isEnabled())
+	{
+		if (_active) {
+			_start = std::chrono::steady_clock::now();
+		}
+	}
+
+	~TraceSpan()
+	{
+		if (_active) {
+			Tracer::record(_category, _name, _start, std::chrono::steady_clock::now(), _bytes);
+		}
+	}
+
+	TraceSpan(const TraceSpan&) = delete;
+	TraceSpan& operator=(const TraceSpan&) = delete;
+
+	/**
+	 * @brief       Attaches a byte count to the span (shown as args.bytes)
+	 */
+	void setBytes(const uint64_t bytes) { _bytes = bytes; }
+
+private:
+	const char*                           _category;  ///< Subsystem
+	const char*                           _name;      ///< Span name
+	uint64_t                              _bytes;     ///< Optional byte count
+	const bool                            _active;    ///< Tracing was enabled at construction
+	std::chrono::steady_clock::time_point _start;     ///< Span start
+};
@@ -0,0 +1,172 @@
+/**
+ * @file        WireCapture.cpp
+ * @author      Natanel Maor Fishman
+ * @brief       Implementation of the capture file writer and reader.
+ * @details     Serialized frame output under one lock and capture file parsing.
+ * @date        2025
+ */
+
+#include "WireCapture.h"
+
+#include <chrono>
+#include <fstream>
+#include <mutex>
+
+namespace
+{
+	/**
+	 * @struct      CaptureState
+	 * @brief       Open capture file shared by all connections
+	 */
+	struct CaptureState
+	{
+		std::mutex                            mutex;
+		std::ofstream                         file;
+		std::chrono::steady_clock::time_point origin;
+		uint32_t                              nextStream = 1;
+	};
+
+	CaptureState& state()
+	{
+		static CaptureState instance;
+		return instance;
+	}
+
+	void putInteger(std::ostream& output, uint64_t value, const size_t bytes)
+	{
+		char buffer[sizeof(uint64_t)];
+		for (size_t i = 0; i < bytes; ++i, value >>= 8) {
+			buffer[i] = static_cast<char>(value & 0xFF);
+		}
+		output.write(buffer, static_cast<std::streamsize>(bytes));
+	}
+
+	uint64_t getInteger(const char* data, const size_t bytes)
+	{
+		uint64_t value = 0;
+		for (size_t i = bytes; i > 0; --i) {
+			value = (value << 8) | static_cast<uint8_t>(data[i - 1]);
+		}
+		return value;
+	}
+}
+
+constexpr char   WireCapture::MAGIC[];
+constexpr size_t WireCapture::MAGIC_SIZE;
+constexpr size_t WireCapture::FRAME_HEADER_SIZE;
+std::atomic<bool> WireCapture::s_enabled(false);
+
+// ================================
+// Recording
+// ================================
+
+bool WireCapture::start(const std::string& path)
+{
+	CaptureState& capture = state();
+	std::lock_guard<std::mutex> lock(capture.mutex);
+	if (s_enabled.load()) {
+		return false;
+	}
+
+	capture.file.open(path, std::ios::binary | std::ios::trunc);
+	if (!capture.file.is_open()) {
+		return false;
+	}
+	capture.file.write(MAGIC, MAGIC_SIZE);
+	capture.origin = std::chrono::steady_clock::now();
+	capture.nextStream = 1;
+	s_enabled.store(true);
+	return true;
+}
+
+bool WireCapture::stop()
+{
+	CaptureState& capture = state();
+	std::lock_guard<std::mutex> lock(capture.mutex);
+	if (!s_enabled.exchange(false)) {
+		return true;
+	}
+
+	capture.file.flush();
+	const bool written = static_cast<bool>(capture.file);
+	capture.file.close();
+	return written;
+}
+
+uint32_t WireCapture::openStream()
+{
+	CaptureState& capture = state();
+	std::lock_guard<std::mutex> lock(capture.mutex);
+	return capture.nextStream++;
+}
+
+void WireCapture::record(const uint32_t stream, const FrameType type, const uint8_t* const data, const size_t size)
+{
+	CaptureState& capture = state();
+	std::lock_guard<std::mutex> lock(capture.mutex);
+	if (!s_enabled.load()) {
+		return;  // Stopped by another thread
+	}
+
+	const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - capture.origin);
+	putInteger(capture.file, static_cast<uint8_t>(type), 1);
+	putInteger(capture.file, stream, 4);
+	putInteger(capture.file, static_cast<uint64_t>(elapsed.count()), 8);
+	putInteger(capture.file, size, 4);
+	if (size > 0) {
+		capture.file.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(size));
+	}
+}
+
+// ================================
+// Reading
+// ================================
+
+bool WireCapture::load(const std::string& path, std::vector<Frame>& frames, std::string& error)
+{
+	frames.clear();
+	std::ifstream file(path, std::ios::binary);
+	if (!file.is_open())
+	{
+		error = "Cannot open capture file " + path;
+		return false;
+	}
+
+	char magic[MAGIC_SIZE];
+	if (!file.read(magic, MAGIC_SIZE) || std::string(magic, MAGIC_SIZE) != std::string(MAGIC, MAGIC_SIZE))
+	{
+		error = path + " is not a capture file";
+		return false;
+	}
+
+	char header[FRAME_HEADER_SIZE];
+	while (file.read(header, FRAME_HEADER_SIZE))
+	{
+		Frame frame;
+		const uint64_t type = getInteger(header, 1);
+		frame.stream = static_cast<uint32_t>(getInteger(header + 1, 4));
+		frame.timestampMicros = getInteger(header + 5, 8);
+		const size_t size = static_cast<size_t>(getInteger(header + 13, 4));
+		if (type < static_cast<uint8_t>(FrameType::CONNECT) || type > static_cast<uint8_t>(FrameType::CLOSE))
+		{
+			error = "Corrupt frame " + std::to_string(frames.size() + 1) + " in " + path;
+			return false;
+		}
+		frame.type = static_cast<FrameType>(type);
+
+		frame.payload.resize(size);
+		if (size > 0 && !file.read(&frame.payload[0], static_cast<std::streamsize>(size)))
+		{
+			error = "Truncated frame " + std::to_string(frames.size() + 1) + " in " + path;
+			return false;
+		}
+		frames.push_back(std::move(frame));
+	}
+
+	if (file.gcount() != 0)
+	{
+		error = "Truncated frame header at the end of " + path;
+		return false;
+	}
+	return true;
+}
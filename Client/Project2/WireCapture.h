@@ -0,0 +1,135 @@
+/**
+ * @file        WireCapture.h
+ * @author      Natanel Maor Fishman
+ * @brief       Recording of client-server traffic to a capture file
+ * @details     While a capture is running, every NetworkConnection writes its connects,
+ *              request frames, response frames and closes with timestamps to one file.
+ *              WireReplay feeds such a file back to a server or serves it to a client.
+ * @version     2.0
+ * @date        2025
+ */
+
+#pragma once
+
+// ================================
+// Standard Library Includes
+// ================================
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// ================================
+// Class Definition
+// ================================
+
+/**
+ * @class       WireCapture
+ * @brief       Process-wide capture file writer and reader
+ * @details     File layout (little-endian):
+ *              - 8-byte magic "MUCAP01\n"
+ *              - Frames: type (1 byte), stream (4), timestamp in microseconds since the
+ *                capture started (8), payload length (4), payload
+ *
+ *              A stream is one NetworkConnection. Its frames are in order; frames of
+ *              different streams may interleave. Payloads are the logical bytes passed to
+ *              sendData/receiveData, without the packet padding added on the wire.
+ *
+ * @note        This class cannot be instantiated - all methods are static. Thread-safe.
+ */
+class WireCapture
+{
+public:
+	// ================================
+	// Data Structures
+	// ================================
+
+	/**
+	 * @enum        FrameType
+	 * @brief       Kind of recorded event
+	 */
+	enum class FrameType : uint8_t
+	{
+		CONNECT = 1,   ///< Connection established (no payload)
+		REQUEST = 2,   ///< One sendData call
+		RESPONSE = 3,  ///< One receiveData call
+		CLOSE = 4      ///< Connection closed (no payload)
+	};
+
+	/**
+	 * @struct      Frame
+	 * @brief       One recorded event
+	 */
+	struct Frame
+	{
+		FrameType   type = FrameType::CONNECT;  ///< Event kind
+		uint32_t    stream = 0;                 ///< Connection the event belongs to
+		uint64_t    timestampMicros = 0;        ///< Time since the capture started
+		std::string payload;                    ///< Request or response bytes
+	};
+
+	// ================================
+	// Copy Control (Deleted)
+	// ================================
+
+	WireCapture() = delete;
+	WireCapture(const WireCapture&) = delete;
+	WireCapture& operator=(const WireCapture&) = delete;
+
+	// ================================
+	// Recording
+	// ================================
+
+	/**
+	 * @brief       Starts writing a capture file
+	 * @param[in]   path    Capture file (truncated)
+	 * @return      true if the file is open, false if it cannot be created or a capture is running
+	 */
+	static bool start(const std::string& path);
+
+	/**
+	 * @brief       Flushes and closes the capture file
+	 * @return      true if every frame was written (or no capture was running), false otherwise
+	 */
+	static bool stop();
+
+	/**
+	 * @brief       Checks if frames are being recorded
+	 */
+	static bool isEnabled() { return s_enabled.load(std::memory_order_relaxed); }
+
+	/**
+	 * @brief       Allocates a stream identifier for a connection
+	 */
+	static uint32_t openStream();
+
+	/**
+	 * @brief       Appends a frame
+	 * @param[in]   stream    Stream identifier from openStream()
+	 * @param[in]   type      Event kind
+	 * @param[in]   data      Payload (may be null when size is 0)
+	 * @param[in]   size      Payload size
+	 */
+	static void record(uint32_t stream, FrameType type, const uint8_t* data, size_t size);
+
+	// ================================
+	// Reading
+	// ================================
+
+	/**
+	 * @brief       Reads a capture file
+	 * @param[in]   path      Capture file
+	 * @param[out]  frames    Frames in file order
+	 * @param[out]  error     Description of the problem on failure
+	 * @return      true if the file is a complete capture, false otherwise
+	 */
+	static bool load(const std::string& path, std::vector<Frame>& frames, std::string& error);
+
+	static constexpr char   MAGIC[] = "MUCAP01\n";   ///< File signature
+	static constexpr size_t MAGIC_SIZE = 8;          ///< Signature length
+	static constexpr size_t FRAME_HEADER_SIZE = 17;  ///< type + stream + timestamp + length
+
+private:
+	static std::atomic<bool> s_enabled;  ///< Recording switch
+};
@@ -0,0 +1,350 @@
+/**
+ * @file        WireReplay.cpp
+ * @author      Natanel Maor Fishman
+ * @brief       Implementation of capture replay.
+ * @details     Per-stream replay threads against a server and the loopback fake server.
+ * @date        2025
+ */
+
+#include "WireReplay.h"
+#include "LatencyMetrics.h"
+#include "MessageEngine.h"
+#include "NetworkConnection.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <map>
+#include <memory>
+#include <thread>
+#include <boost/asio.hpp>
+
+namespace
+{
+	constexpr size_t REQUEST_CODE_OFFSET = sizeof(ClientIdStruct) + sizeof(version_t);
+	constexpr size_t RESPONSE_CODE_OFFSET = sizeof(version_t);
+	constexpr size_t DRAIN_CHUNK = 64 * DEFAULT_PACKET_SIZE;
+
+	/**
+	 * @struct      ReplayCounters
+	 * @brief       Outcome counters shared by the replay threads
+	 */
+	struct ReplayCounters
+	{
+		std::atomic<uint64_t> exchanges{ 0 };    ///< Requests sent
+		std::atomic<uint64_t> failures{ 0 };     ///< Connects, sends or receives that failed
+		std::atomic<uint64_t> differences{ 0 };  ///< Responses whose code differs from the capture
+	};
+
+	/**
+	 * @brief       Rounds a logical transfer size up to whole packets (the wire size)
+	 */
+	size_t paddedSize(const size_t size)
+	{
+		return (size + DEFAULT_PACKET_SIZE - 1) / DEFAULT_PACKET_SIZE * DEFAULT_PACKET_SIZE;
+	}
+
+	/**
+	 * @brief       Reads a little-endian 16-bit code from a payload
+	 */
+	code_t readCode(const std::string& payload, const size_t offset)
+	{
+		if (payload.size() < offset + sizeof(code_t)) {
+			return 0;
+		}
+		return static_cast<code_t>(static_cast<uint8_t>(payload[offset]) | (static_cast<uint8_t>(payload[offset + 1]) << 8));
+	}
+
+	/**
+	 * @brief       Replays the frames of one recorded stream on one connection
+	 */
+	void replayStream(const std::vector<const WireCapture::Frame*>& frames, const std::string& address, const std::string& port,
+		const bool paced, const std::chrono::steady_clock::time_point origin, LatencyMetrics& metrics, ReplayCounters& counters)
+	{
+		NetworkConnection connection;
+		connection.configureEndpoint(address, port);
+		connection.setLatencyMetrics(&metrics);
+		connection.setPersistent(true);  // Connects and closes follow the capture
+
+		std::vector<uint8_t> buffer;
+		bool connected = false;
+		bool inExchange = false;    // A request was sent on this connection
+		bool awaitingFirst = false; // Its first response frame is still to come
+
+		const auto fail = [&]() {
+			++counters.failures;
+			connection.disconnectSocket();
+			connected = inExchange = awaitingFirst = false;
+		};
+
+		for (size_t index = 0; index < frames.size(); ++index)
+		{
+			const WireCapture::Frame* const frame = frames[index];
+			switch (frame->type)
+			{
+			case WireCapture::FrameType::CONNECT:
+			{
+				// The connect is timed under the code of the request it was opened for
+				auto next = std::find_if(frames.begin() + index, frames.end(), [](const WireCapture::Frame* candidate) {
+					return candidate->type == WireCapture::FrameType::REQUEST;
+				});
+				connection.beginRequest((next != frames.end()) ? readCode((*next)->payload, REQUEST_CODE_OFFSET) : 0);
+				connection.disconnectSocket();
+				connected = connection.establishConnection();
+				inExchange = awaitingFirst = false;
+				if (!connected) {
+					++counters.failures;
+				}
+				break;
+			}
+
+			case WireCapture::FrameType::REQUEST:
+				if (!connected) {
+					break;  // Connect failed: skip the session's requests
+				}
+				if (inExchange) {
+					connection.releaseConnection(true);  // Records the previous receive phase
+				}
+				if (paced) {
+					std::this_thread::sleep_until(origin + std::chrono::microseconds(frame->timestampMicros));
+				}
+				connection.beginRequest(readCode(frame->payload, REQUEST_CODE_OFFSET));
+				++counters.exchanges;
+				if (!connection.sendData(reinterpret_cast<const uint8_t*>(frame->payload.data()), frame->payload.size())) {
+					fail();
+					break;
+				}
+				inExchange = awaitingFirst = true;
+				break;
+
+			case WireCapture::FrameType::RESPONSE:
+			{
+				// Later frames of a response are sized from the live header instead
+				if (!awaitingFirst || frame->payload.empty()) {
+					break;
+				}
+				awaitingFirst = false;
+
+				const size_t firstSize = frame->payload.size();
+				buffer.resize(std::max(firstSize, DRAIN_CHUNK));
+				if (!connection.receiveData(buffer.data(), firstSize))
+				{
+					fail();
+					break;
+				}
+
+				const std::string live(reinterpret_cast<const char*>(buffer.data()), std::min(firstSize, sizeof(ResponseHeaderStruct)));
+				if (readCode(live, RESPONSE_CODE_OFFSET) != readCode(frame->payload, RESPONSE_CODE_OFFSET)) {
+					++counters.differences;
+				}
+
+				// Drain the rest of the live response in whole packets
+				if (firstSize >= sizeof(ResponseHeaderStruct))
+				{
+					const auto header = reinterpret_cast<const ResponseHeaderStruct*>(buffer.data());
+					const size_t total = paddedSize(sizeof(ResponseHeaderStruct) + header->payloadSize);
+					size_t consumed = paddedSize(firstSize);
+					while (consumed < total)
+					{
+						const size_t chunk = std::min(DRAIN_CHUNK, total - consumed);
+						if (!connection.receiveData(buffer.data(), chunk))
+						{
+							fail();
+							break;
+						}
+						consumed += chunk;
+					}
+				}
+				break;
+			}
+
+			case WireCapture::FrameType::CLOSE:
+				if (inExchange) {
+					connection.releaseConnection(true);
+				}
+				connection.disconnectSocket();
+				connected = inExchange = awaitingFirst = false;
+				break;
+			}
+		}
+
+		if (inExchange) {
+			connection.releaseConnection(true);
+		}
+	}
+
+	/**
+	 * @brief       Serves one recorded session to an accepted client connection
+	 */
+	void serveSession(boost::asio::ip::tcp::socket& socket, const std::vector<const WireCapture::Frame*>& session)
+	{
+		std::vector<uint8_t> buffer;
+		boost::system::error_code error;
+
+		for (const WireCapture::Frame* frame : session)
+		{
+			const size_t padded = paddedSize(frame->payload.size());
+			if (frame->type == WireCapture::FrameType::REQUEST)
+			{
+				buffer.resize(padded);
+				boost::asio::read(socket, boost::asio::buffer(buffer), error);
+			}
+			else if (frame->type == WireCapture::FrameType::RESPONSE)
+			{
+				buffer.assign(padded, 0);
+				std::copy(frame->payload.begin(), frame->payload.end(), buffer.begin());
+				boost::asio::write(socket, boost::asio::buffer(buffer), error);
+			}
+			else if (frame->type == WireCapture::FrameType::CLOSE) {
+				break;
+			}
+
+			if (error) {
+				return;  // Client left early
+			}
+		}
+		socket.shutdown(boost::asio::ip::tcp::socket::shutdown_both, error);
+	}
+}
+
+// ================================
+// Entry Points
+// ================================
+
+int WireReplay::run(const ClientOptions& options)
+{
+	std::vector<WireCapture::Frame> frames;
+	std::string error;
+	if (!WireCapture::load(options.replayPath, frames, error))
+	{
+		std::cerr << "Error: " << error << std::endl;
+		return static_cast<int>(ExitCode::USAGE_ERROR);
+	}
+
+	if (options.replayServePort != 0) {
+		return static_cast<int>(serve(frames, options.replayServePort, std::cout));
+	}
+
+	MessageEngine engine;
+	if (!engine.loadServerConfiguration())
+	{
+		std::cerr << "Error: " << engine.getErrorMessage() << std::endl;
+		return static_cast<int>(ExitCode::CONFIGURATION_ERROR);
+	}
+	std::string address;
+	std::string port;
+	engine.getServerEndpoint(address, port);
+	return static_cast<int>(replayToServer(frames, address, port, options.replayPaced, std::cout));
+}
+
+ExitCode WireReplay::replayToServer(const std::vector<WireCapture::Frame>& frames,
+	const std::string& address, const std::string& port, const bool paced, std::ostream& report)
+{
+	std::map<uint32_t, Session> streams;
+	for (const WireCapture::Frame& frame : frames) {
+		streams[frame.stream].push_back(&frame);
+	}
+
+	LatencyMetrics metrics;
+	ReplayCounters counters;
+	const uint64_t firstTimestamp = frames.empty() ? 0 : frames.front().timestampMicros;
+	const auto start = std::chrono::steady_clock::now();
+	const auto origin = start - std::chrono::microseconds(firstTimestamp);
+
+	std::vector<std::thread> threads;
+	for (const auto& stream : streams)
+	{
+		const Session* const session = &stream.second;
+		threads.emplace_back([session, &address, &port, paced, origin, &metrics, &counters]() {
+			replayStream(*session, address, port, paced, origin, metrics, counters);
+		});
+	}
+	for (auto& thread : threads) {
+		thread.join();
+	}
+	const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+	report << "Replayed " << counters.exchanges.load() << " exchanges from " << streams.size() << " streams in "
+		<< std::fixed << std::setprecision(2) << elapsed.count() << " s" << std::defaultfloat
+		<< " (" << counters.failures.load() << " failed, " << counters.differences.load()
+		<< " responses differ from the capture)" << std::endl << std::endl;
+	metrics.print(report);
+
+	return (counters.failures.load() == 0) ? ExitCode::SUCCESS : ExitCode::OPERATION_FAILED;
+}
+
+ExitCode WireReplay::serve(const std::vector<WireCapture::Frame>& frames, const uint16_t port, std::ostream& report)
+{
+	const std::vector<Session> sessions = splitSessions(frames);
+	if (sessions.empty())
+	{
+		report << "Error: the capture contains no connections" << std::endl;
+		return ExitCode::OPERATION_FAILED;
+	}
+
+	boost::asio::io_context context;
+	boost::asio::ip::tcp::acceptor acceptor(context);
+	try
+	{
+		const boost::asio::ip::tcp::endpoint endpoint(boost::asio::ip::address_v4::loopback(), port);
+		acceptor.open(endpoint.protocol());
+		acceptor.set_option(boost::asio::ip::tcp::acceptor::reuse_address(true));
+		acceptor.bind(endpoint);
+		acceptor.listen();
+	}
+	catch (const boost::system::system_error& error)
+	{
+		report << "Error: cannot listen on port " << port << ": " << error.what() << std::endl;
+		return ExitCode::OPERATION_FAILED;
+	}
+
+	report << "Serving " << sessions.size() << " recorded connections on 127.0.0.1:" << port
+		<< " (Ctrl+C to stop)" << std::endl;
+
+	for (size_t next = 0; ; ++next)
+	{
+		auto socket = std::make_shared<boost::asio::ip::tcp::socket>(context);
+		boost::system::error_code error;
+		acceptor.accept(*socket, error);
+		if (error) {
+			continue;
+		}
+		socket->set_option(boost::asio::ip::tcp::no_delay(true), error);
+
+		// Sessions outlive the detached threads: this loop never returns
+		const Session* const session = &sessions[next % sessions.size()];
+		std::thread([socket, session]() { serveSession(*socket, *session); }).detach();
+	}
+}
+
+// ================================
+// Private Helper Methods
+// ================================
+
+std::vector<WireReplay::Session> WireReplay::splitSessions(const std::vector<WireCapture::Frame>& frames)
+{
+	std::vector<Session> sessions;
+	std::map<uint32_t, size_t> open;  // Stream -> index of its current session
+
+	for (const WireCapture::Frame& frame : frames)
+	{
+		if (frame.type == WireCapture::FrameType::CONNECT)
+		{
+			open[frame.stream] = sessions.size();
+			sessions.emplace_back();
+		}
+
+		const auto current = open.find(frame.stream);
+		if (current == open.end()) {
+			continue;  // Capture started while the connection was open
+		}
+		sessions[current->second].push_back(&frame);
+
+		if (frame.type == WireCapture::FrameType::CLOSE) {
+			open.erase(current);
+		}
+	}
+	return sessions;
+}
@@ -0,0 +1,104 @@
+/**
+ * @file        WireReplay.h
+ * @author      Natanel Maor Fishman
+ * @brief       Deterministic replay of wire captures
+ * @details     Replays a capture recorded with --capture either against a server, to
+ *              measure server behavior under a recorded session, or as a fake server that
+ *              answers a client with the recorded responses, to benchmark the client's
+ *              parsing and decryption without server or network variance.
+ * @version     2.0
+ * @date        2025
+ */
+
+#pragma once
+
+// ================================
+// Standard Library Includes
+// ================================
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// ================================
+// Application Includes
+// ================================
+
+#include "CommandLine.h"
+#include "WireCapture.h"
+
+// ================================
+// Class Definition
+// ================================
+
+/**
+ * @class       WireReplay
+ * @brief       Static capture replay entry points
+ * @details     A session is the frames of one stream from CONNECT to CLOSE, i.e. one TCP
+ *              connection of the recorded client.
+ *
+ * @note        This class cannot be instantiated - all methods are static.
+ */
+class WireReplay
+{
+public:
+	// ================================
+	// Copy Control (Deleted)
+	// ================================
+
+	WireReplay() = delete;
+	WireReplay(const WireReplay&) = delete;
+	WireReplay& operator=(const WireReplay&) = delete;
+
+	// ================================
+	// Entry Points
+	// ================================
+
+	/**
+	 * @brief       Loads options.replayPath and runs the selected replay mode
+	 * @param[in]   options    Parsed options (--replay, --replay-serve, --replay-paced)
+	 * @return      Process exit code (see ExitCode)
+	 * @details     Without --replay-serve, requests go to the server in server.info.
+	 */
+	static int run(const ClientOptions& options);
+
+	/**
+	 * @brief       Sends the recorded requests to a server and times the responses
+	 * @param[in]   frames     Capture frames
+	 * @param[in]   address    Server address
+	 * @param[in]   port       Server port
+	 * @param[in]   paced      true to keep the recorded request times, false to replay back to back
+	 * @param[in,out] report   Result output
+	 * @return      SUCCESS if every exchange completed, OPERATION_FAILED otherwise
+	 * @details     Each recorded connection stream replays on its own thread, so recorded
+	 *              concurrency is preserved. Response lengths are taken from the live
+	 *              response headers; responses whose code differs from the capture are
+	 *              counted as differences (e.g. a registration replayed twice is rejected).
+	 *              Latencies are reported per request code and phase.
+	 */
+	static ExitCode replayToServer(const std::vector<WireCapture::Frame>& frames,
+		const std::string& address, const std::string& port, bool paced, std::ostream& report);
+
+	/**
+	 * @brief       Serves the recorded responses to connecting clients until stopped
+	 * @param[in]   frames    Capture frames
+	 * @param[in]   port      Local port to listen on (loopback only)
+	 * @param[in,out] report  Status output
+	 * @return      OPERATION_FAILED if the port cannot be opened (otherwise runs until killed)
+	 * @details     The n-th accepted connection is served the n-th recorded session, cycling
+	 *              through the capture. Requests are read and discarded; responses are sent
+	 *              as recorded. Point server.info at 127.0.0.1:port and run the same
+	 *              operations as during the capture, with the same my.info.
+	 */
+	static ExitCode serve(const std::vector<WireCapture::Frame>& frames, uint16_t port, std::ostream& report);
+
+private:
+	/// Frames of one recorded connection, CONNECT to CLOSE
+	using Session = std::vector<const WireCapture::Frame*>;
+
+	/**
+	 * @brief       Splits frames into sessions in connection order
+	 */
+	static std::vector<Session> splitSessions(const std::vector<WireCapture::Frame>& frames);
+};
@@ -22,7 +22,18 @@
 // Application Includes
 // ================================
 
+#include "Benchmarks.h"
+#include "CommandLine.h"
 #include "ConsoleInterface.h"
+#include "EventLog.h"
+#include "HeadlessRunner.h"
+#include "LoadGenerator.h"
+#include "MockServer.h"
+#include "StartupProfile.h"
+#include "TerminalUI.h"
+#include "Tracer.h"
+#include "WireCapture.h"
+#include "WireReplay.h"
 
 // ================================
 // Function Definitions
@@ -32,20 +43,149 @@
  * @brief       Main application entry point
  * @param[in]   argumentCount     Number of command line arguments
  * @param[in]   argumentVector    Array of command line argument strings
- * @return      EXIT_SUCCESS on normal termination, EXIT_FAILURE on error
+ * @return      EXIT_SUCCESS on normal termination, otherwise an ExitCode value
  * @details     Initializes the client application and enters the main event loop.
  *              Provides secure messaging capabilities with encrypted communication.
  *              The application runs continuously until explicitly terminated.
  *              Handles graceful shutdown and error conditions.
  *              
  *              Program Flow:
- *              1. Initialize console interface
- *              2. Prepare interface and establish connections
- *              3. Enter main event loop (menu display and command processing)
- *              4. Handle graceful shutdown
+ *              1. Parse command-line options (see CommandLine::printUsage) and start tracing
+ *              2. Benchmark, load test or headless runs execute and return their exit code
+ *              3. --tui runs the full-screen interface
+ *              4. Otherwise initialize and prepare the console interface
+ *              5. Enter main event loop (menu display and command processing)
  */
 int main(int argumentCount, char* argumentVector[])
 {
+	// ================================
+	// Command-Line Options
+	// ================================
+
+	ClientOptions options;
+	std::string optionError;
+	StartupTimer optionsTimer("options");
+	if (!CommandLine::parse(argumentCount, argumentVector, options, optionError))
+	{
+		std::cerr << optionError << std::endl << std::endl;
+		CommandLine::printUsage(std::cerr);
+		return static_cast<int>(ExitCode::USAGE_ERROR);
+	}
+	optionsTimer.stop();
+
+	// Printed once the selected mode can take its first command
+	if (options.startupProfile) {
+		StartupProfile::setReport(&std::cerr);
+	}
+
+	if (options.showHelp)
+	{
+		CommandLine::printUsage(std::cout);
+		return EXIT_SUCCESS;
+	}
+
+	// Spans are collected from here on and written when the process exits, whichever
+	// mode it ran in (the menu leaves through exit())
+	if (!options.tracePath.empty())
+	{
+		Tracer::start(options.tracePath);
+		std::atexit([]() {
+			if (!Tracer::stop()) {
+				std::cerr << "Warning: cannot write trace file" << std::endl;
+			}
+		});
+	}
+
+	// Operational records are written by a background thread until the process exits
+	if (!options.logPath.empty())
+	{
+		EventLog::Settings settings;
+		settings.path = options.logPath;
+		settings.minimumLevel = options.logLevel;
+		settings.maxFileBytes = options.logMaxBytes;
+		settings.maxFiles = options.logFiles;
+		if (!EventLog::start(settings))
+		{
+			std::cerr << "Error: cannot open log file " << options.logPath << std::endl;
+			return static_cast<int>(ExitCode::USAGE_ERROR);
+		}
+		std::atexit([]() {
+			if (!EventLog::stop()) {
+				std::cerr << "Warning: log file is incomplete" << std::endl;
+			}
+		});
+	}
+
+	// Every connection of this process is recorded
+	if (!options.capturePath.empty())
+	{
+		if (!WireCapture::start(options.capturePath))
+		{
+			std::cerr << "Error: cannot create capture file " << options.capturePath << std::endl;
+			return static_cast<int>(ExitCode::USAGE_ERROR);
+		}
+		std::atexit([]() {
+			if (!WireCapture::stop()) {
+				std::cerr << "Warning: capture file is incomplete" << std::endl;
+			}
+		});
+	}
+
+	// Capture replay against the server, or as a fake server
+	if (!options.replayPath.empty()) {
+		return WireReplay::run(options);
+	}
+
+	// In-memory stand-in for the Python server, until the process is interrupted
+	if (options.mockServer)
+	{
+		MockServer server;
+		if (!server.start(options.mockServerPort))
+		{
+			std::cerr << "Error: cannot listen on 127.0.0.1:" << options.mockServerPort << std::endl;
+			return static_cast<int>(ExitCode::OPERATION_FAILED);
+		}
+		std::cout << "Mock server listening on 127.0.0.1:" << server.getPort() << std::endl;
+		server.wait();
+		return static_cast<int>(ExitCode::SUCCESS);
+	}
+
+	// Runs offline and exits without touching the server (cold-start launches read my.info)
+	if (options.benchmark) {
+		return Benchmarks::run(options, argumentVector[0]);
+	}
+
+	// Synthetic clients in ./loadgen against the configured server
+	if (options.loadTest)
+	{
+		LoadGenerator::Settings settings;
+		settings.clients = options.loadClients;
+		settings.duration = std::chrono::seconds(options.loadSeconds);
+		settings.persistentConnection = options.persistentConnection;
+		settings.emulateNetwork = !options.networkEmulation.empty()
+			&& EmulatedConnection::parseProfile(options.networkEmulation, settings.emulation);  // Validated by CommandLine::parse
+		if (!options.loadMix.empty()) {
+			(void)LoadGenerator::parseMix(options.loadMix, settings.mix);  // Validated by CommandLine::parse
+		}
+		LoadGenerator generator(settings);
+		return static_cast<int>(generator.run(std::cout));
+	}
+
+	// Scripted operation: no menu, no shell spawns, exit code reports the outcome
+	if (options.isHeadless())
+	{
+		HeadlessRunner runner(options);
+		return runner.run();
+	}
+
+	// Event-driven full-screen interface; the menu loop below is the fallback
+	if (options.terminalUI)
+	{
+		TerminalUI::Settings settings;
+		TerminalUI terminalInterface(options, settings);
+		return terminalInterface.run();
+	}
+
 	// ================================
 	// Application Initialization
 	// ================================
@@ -55,6 +195,8 @@ int main(int argumentCount, char* argumentVector[])
 
 	// Prepare the interface and establish initial connections
 	userInterface.prepare();
+	userInterface.configure(options);
+	StartupProfile::ready();
 
 	// ================================
 	// Main Application Event Loop
@@ -32,12 +32,16 @@ using messageType_t = uint8_t;  ///< Type of message being transmitted
 
 constexpr int DEFAULT_VALUE = 0;                ///< Default initialization value
 constexpr version_t PROTOCOL_VERSION = 2;       ///< Protocol version
-constexpr size_t REQUEST_TYPES_COUNT = 5;       ///< Number of request types
-constexpr size_t RESPONSE_TYPES_COUNT = 6;      ///< Number of response types
+constexpr size_t REQUEST_TYPES_COUNT = 9;       ///< Number of request types
+constexpr size_t RESPONSE_TYPES_COUNT = 10;     ///< Number of response types
 constexpr size_t CLIENT_ID_LENGTH = 16;         ///< Length of client ID in bytes
 constexpr size_t SYMMETRIC_KEY_LENGTH = 16;     ///< Length of symmetric key in bytes
 constexpr size_t PUBLIC_KEY_LENGTH = 160;       ///< Length of public key in bytes
 constexpr size_t CLIENT_NAME_MAX_LENGTH = 255;  ///< Maximum length of client name (null-terminated)
+constexpr size_t BATCH_MAX_ENTRIES = 1000;      ///< Maximum messages in one batch send request
+
+// Optional server features (ResponseServerInfoStruct bit flags)
+constexpr uint32_t FEATURE_CONCURRENT_STRIPES = 1u << 0;  ///< Stripes on different connections are received concurrently
 
 // ================================
 // Enumerations
@@ -67,7 +71,11 @@ enum RequestCodeEnum : code_t
 	REQUEST_CLIENTS_LIST = 601,   ///< Request for list of clients (empty payload)
 	REQUEST_PUBLIC_KEY = 602,     ///< Request for public key
 	REQUEST_SEND_MSG = 603,       ///< Send message request
-	REQUEST_PENDING_MSG = 604     ///< Request for pending messages (empty payload)
+	REQUEST_PENDING_MSG = 604,    ///< Request for pending messages (empty payload)
+	REQUEST_SEND_STRIPE = 605,    ///< Send one stripe of a message uploaded over several connections
+	REQUEST_INBOX_PROBE = 606,    ///< Request the pending messages count and size (empty payload)
+	REQUEST_SEND_BATCH = 607,     ///< Send several messages, each with its own recipient and content
+	REQUEST_SERVER_INFO = 608     ///< Request the server's optional features (empty payload)
 };
 
 /**
@@ -82,6 +90,10 @@ enum ResponseCodeEnum : code_t
 	RESPONSE_PUBLIC_KEY = 2102,   ///< Public key response
 	RESPONSE_MSG_SENT = 2103,     ///< Message sent response
 	RESPONSE_PENDING_MSG = 2104,  ///< Pending messages response
+	RESPONSE_STRIPE_RECEIVED = 2105, ///< Stripe stored response
+	RESPONSE_INBOX_STATUS = 2106, ///< Pending messages count and size response
+	RESPONSE_BATCH_SENT = 2107,   ///< Batch message IDs response
+	RESPONSE_SERVER_INFO = 2108,  ///< Server features response
 	RESPONSE_ERROR = 9000         ///< Error response (empty payload)
 };
 
@@ -287,6 +299,94 @@ struct ResponseMessageSentStruct
 	}payload;
 };
 
+/**
+ * @struct RequestSendBatchStruct
+ * @brief Request to send several messages structure
+ * @details Followed by entryCount entries, each a BatchEntryStruct and its content.
+ *          The server stores every entry or none.
+ */
+struct RequestSendBatchStruct
+{
+	RequestHeaderStruct header; ///< Request header
+	struct PayloadHeaderStruct
+	{
+		uint32_t entryCount; ///< Entries that follow (1 to BATCH_MAX_ENTRIES)
+		PayloadHeaderStruct() : entryCount(DEFAULT_VALUE) {}
+	}payloadHeader;
+	RequestSendBatchStruct(const ClientIdStruct& id) : header(id, REQUEST_SEND_BATCH) {}
+};
+
+/**
+ * @struct BatchEntryStruct
+ * @brief Structure for a single message of a batch
+ * @details Followed by contentSize bytes of content.
+ */
+struct BatchEntryStruct
+{
+	ClientIdStruct  clientId;    ///< Destination client ID
+	messageType_t   messageType; ///< Message type
+	csize_t         contentSize; ///< Size of message content
+	BatchEntryStruct() : messageType(DEFAULT_VALUE), contentSize(DEFAULT_VALUE) {}
+};
+
+/**
+ * @struct ResponseBatchSentStruct
+ * @brief Response for batch sent structure
+ * @details Followed by entryCount ResponseMessageSentStruct::PayloadStruct entries,
+ *          in request order.
+ */
+struct ResponseBatchSentStruct
+{
+	ResponseHeaderStruct header; ///< Response header
+	struct PayloadHeaderStruct
+	{
+		uint32_t entryCount; ///< Entries that follow
+		PayloadHeaderStruct() : entryCount(DEFAULT_VALUE) {}
+	}payloadHeader;
+};
+
+/**
+ * @struct RequestSendStripeStruct
+ * @brief Request to send one stripe of a message structure
+ * @details The content of a large message is cut into stripes sent over parallel
+ *          connections. The server collects the stripes of one transfer (sender and
+ *          transferId) and stores the message once every byte has arrived.
+ */
+struct RequestSendStripeStruct
+{
+	RequestHeaderStruct header; ///< Request header
+	struct PayloadHeaderStruct
+	{
+		ClientIdStruct           clientId;   ///< Destination client ID
+		const messageType_t      messageType;///< Message type
+		uint32_t                 transferId; ///< Sender-chosen ID shared by all stripes of the message
+		csize_t                  totalSize;  ///< Size of the complete message content
+		csize_t                  offset;     ///< Position of this stripe in the content
+		csize_t                  stripeSize; ///< Size of this stripe
+		PayloadHeaderStruct(const messageType_t type) : messageType(type), transferId(DEFAULT_VALUE), totalSize(DEFAULT_VALUE), offset(DEFAULT_VALUE), stripeSize(DEFAULT_VALUE) {}
+	}payloadHeader;
+	RequestSendStripeStruct(const ClientIdStruct& id, const messageType_t type) : header(id, REQUEST_SEND_STRIPE), payloadHeader(type) {}
+};
+
+/**
+ * @struct ResponseStripeReceivedStruct
+ * @brief Response for stripe received structure
+ * @details Reports the transfer progress; the message ID is set by the response to the
+ *          stripe that completed the message.
+ */
+struct ResponseStripeReceivedStruct
+{
+	ResponseHeaderStruct header; ///< Response header
+	struct PayloadStruct
+	{
+		ClientIdStruct   clientId;    ///< Destination client ID
+		uint32_t         transferId;  ///< Transfer of the stripe
+		csize_t          receivedSize;///< Content bytes received so far
+		messageID_t      messageId;   ///< Message ID once complete, otherwise 0
+		PayloadStruct() : transferId(DEFAULT_VALUE), receivedSize(DEFAULT_VALUE), messageId(DEFAULT_VALUE) {}
+	}payload;
+};
+
 /**
  * @struct RequestMessagesStruct
  * @brief Request for pending messages structure
@@ -312,4 +412,59 @@ struct PendingMessageStruct
 	PendingMessageStruct() : messageId(DEFAULT_VALUE), messageType(DEFAULT_VALUE), messageSize(DEFAULT_VALUE) {}
 };
 
+/**
+ * @struct RequestInboxProbeStruct
+ * @brief Request for the pending messages summary structure
+ * @details Lets pollers learn whether anything is waiting without downloading the inbox.
+ */
+struct RequestInboxProbeStruct
+{
+	RequestHeaderStruct header; ///< Request header
+	RequestInboxProbeStruct(const ClientIdStruct& id) : header(id, REQUEST_INBOX_PROBE) {}
+};
+
+/**
+ * @struct ResponseInboxStatusStruct
+ * @brief Response for the pending messages summary structure
+ * @details Contains the number and total content size of the pending messages, and
+ *          the shortest interval at which the server wants clients to poll.
+ */
+struct ResponseInboxStatusStruct
+{
+	ResponseHeaderStruct header; ///< Response header
+	struct PayloadStruct
+	{
+		uint32_t messageCount; ///< Pending messages
+		uint64_t totalBytes;   ///< Sum of their content sizes
+		uint32_t pollHintMs;   ///< Suggested minimum time to the next poll (0 = none)
+		PayloadStruct() : messageCount(DEFAULT_VALUE), totalBytes(DEFAULT_VALUE), pollHintMs(DEFAULT_VALUE) {}
+	}payload;
+};
+
+/**
+ * @struct RequestServerInfoStruct
+ * @brief Request for the server features structure
+ * @details Servers that predate this request answer with RESPONSE_ERROR, i.e. no features.
+ */
+struct RequestServerInfoStruct
+{
+	RequestHeaderStruct header; ///< Request header
+	RequestServerInfoStruct(const ClientIdStruct& id) : header(id, REQUEST_SERVER_INFO) {}
+};
+
+/**
+ * @struct ResponseServerInfoStruct
+ * @brief Response for the server features structure
+ * @details Contains the optional features the server supports (FEATURE_* flags).
+ */
+struct ResponseServerInfoStruct
+{
+	ResponseHeaderStruct header; ///< Response header
+	struct PayloadStruct
+	{
+		uint32_t features; ///< FEATURE_* flags
+		PayloadStruct() : features(DEFAULT_VALUE) {}
+	}payload;
+};
+
 #pragma pack(pop) // End 1-byte alignment
@@ -332,6 +332,36 @@ class Database:
             logging.error(f"Error storing message: {str(e)}")
             return None
 
+    def store_messages(self, messages: List[Message]) -> Optional[List[int]]:
+        """
+        Store several messages in one transaction: all of them or none.
+
+        Args:
+            messages: Message objects to store, in order
+
+        Returns:
+            Message IDs in the same order if stored, None otherwise
+        """
+        if not all(isinstance(msg, Message) and msg.validate() for msg in messages):
+            logging.error("Invalid message object")
+            return None
+
+        try:
+            with self.get_connection() as conn:
+                cursor = conn.cursor()
+                message_ids = []
+                for msg in messages:
+                    cursor.execute(
+                        f"INSERT INTO {self.MESSAGES_TABLE} (ToClient, FromClient, Type, Content) VALUES (?, ?, ?, ?)",
+                        (msg.ToClient, msg.FromClient, msg.Type, msg.Content),
+                    )
+                    message_ids.append(cursor.lastrowid)
+                conn.commit()  # Uncommitted inserts are discarded when the connection closes
+                return message_ids
+        except Exception as e:
+            logging.error(f"Error storing messages: {str(e)}")
+            return None
+
     def remove_message(self, msg_id: int) -> bool:
         """
         Remove a message from the database by ID.
@@ -469,6 +499,29 @@ class Database:
             logging.error(f"Error retrieving client by ID: {str(e)}")
             return None
 
+    def get_pending_summary(self, client_id: bytes) -> Optional[Tuple[int, int]]:
+        """
+        Count pending messages for a client and sum their content sizes.
+
+        Args:
+            client_id: ID of client to summarize messages for
+
+        Returns:
+            (message count, total content bytes), or None on a database error
+        """
+        try:
+            with self.get_connection() as conn:
+                cursor = conn.cursor()
+                cursor.execute(
+                    f"SELECT COUNT(*), COALESCE(SUM(LENGTH(Content)), 0) FROM {self.MESSAGES_TABLE} WHERE ToClient = ?",
+                    (client_id,),
+                )
+                result = cursor.fetchone()
+                return (result[0], result[1]) if result else (0, 0)
+        except Exception as e:
+            logging.error(f"Error summarizing pending messages: {str(e)}")
+            return None
+
     def get_message_count(self, client_id: bytes) -> int:
         """
         Count pending messages for a specific client.
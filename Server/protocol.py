@@ -11,6 +11,7 @@ proper binary serialization and deserialization mechanisms.
 Version: 2.0
 """
 
+import select
 import struct
 from enum import Enum
 
@@ -24,6 +25,7 @@ NAME_SIZE = 255  # Maximum size for names
 
 # Protocol limits
 MSG_TYPE_MAX = 0xFF  # Maximum message type value
+BATCH_MAX_ENTRIES = 1000  # Maximum messages in one batch send request
 MSG_ID_MAX = 0xFFFFFFFF  # Maximum message ID value
 
 # Default initialization value
@@ -37,6 +39,10 @@ class RequestCode(Enum):
     PUBLIC_KEY = 602  # Request public key for a specific user
     SEND_MESSAGE = 603  # Send a message to another user
     PENDING_MESSAGES = 604  # Request pending messages (no payload, payloadSize = 0)
+    SEND_STRIPE = 605  # Send one stripe of a message uploaded over several connections
+    INBOX_PROBE = 606  # Request pending messages count and size (no payload, payloadSize = 0)
+    SEND_BATCH = 607  # Send several messages, each with its own recipient and content
+    SERVER_INFO = 608  # Request the server's optional features (no payload, payloadSize = 0)
 
 
 # Enumeration of response codes sent from server to client
@@ -46,9 +52,28 @@ class ResponseCode(Enum):
     PUBLIC_KEY = 2102  # Public key for requested user
     MESSAGE_SENT = 2103  # Message sent successfully
     PENDING_MESSAGES = 2104  # List of pending messages
+    STRIPE_RECEIVED = 2105  # Stripe stored, with the transfer progress
+    INBOX_STATUS = 2106  # Pending messages count and total content size
+    BATCH_SENT = 2107  # Message IDs of a batch, in request order
+    SERVER_INFO = 2108  # Optional features of the server
     ERROR = 9000  # Error occurred (no payload, payloadSize = 0)
 
 
+# Enumeration of message types (content kinds)
+class MessageType(Enum):
+    SYMMETRIC_KEY_REQUEST = 1  # Empty content
+    SYMMETRIC_KEY_SEND = 2  # Symmetric key encrypted with the recipient's public key
+    TEXT = 3  # Text encrypted with the symmetric key
+    FILE = 4  # File encrypted with the symmetric key
+
+
+# Message types a batch send may carry (key exchanges go through single sends)
+BATCH_MESSAGE_TYPES = (MessageType.TEXT.value, MessageType.FILE.value)
+
+# Optional server features (bit flags of the server info response)
+FEATURE_CONCURRENT_STRIPES = 0x1  # Stripes on different connections are received concurrently
+
+
 class RequestHeader:
     """Base header for all client requests"""
 
@@ -373,7 +398,7 @@ class MessageSendRequest:
 
             # Read additional chunks for large messages
             while bytes_read < self.contentSize:
-                chunk = conn.recv(packet_size)  # reuse same buffer size
+                chunk = receive_exact(conn, packet_size)  # one whole packet
                 chunk_size = len(chunk)
 
                 if not chunk:  # Connection closed
@@ -423,6 +448,181 @@ class MessageSendRequest:
             return b""
 
 
+class StripeSendRequest:
+    """Request structure for one stripe of a message sent over several connections"""
+
+    STRIPE_HEADER_SIZE = CLIENT_ID_LENGTH + 17  # clientID, type, transfer, total, offset, size
+
+    def __init__(self):
+        self.header = RequestHeader()
+        self.clientID = b""  # Recipient's client ID
+        self.messageType = DEFAULT_VALUE  # Message type (1 byte)
+        self.transferID = DEFAULT_VALUE  # Sender-chosen transfer ID (4 bytes)
+        self.totalSize = DEFAULT_VALUE  # Size of the complete content (4 bytes)
+        self.offset = DEFAULT_VALUE  # Position of this stripe in the content (4 bytes)
+        self.stripeSize = DEFAULT_VALUE  # Size of this stripe (4 bytes)
+        self.content = b""  # Stripe bytes
+
+    def unpack(self, data):
+        """
+        Unpack binary data into stripe request fields.
+        Takes the stripe bytes of the first packet only; the caller reads the
+        remaining packets (missing_bytes()) and passes them to add_packets().
+        Args -  data: Initial binary data chunk (one packet)
+        Returns: True if unpacking was successful, False otherwise
+        """
+        if not self.header.unpack(data):
+            return False
+
+        try:
+            offset = self.header.SIZE
+            (
+                self.clientID,
+                self.messageType,
+                self.transferID,
+                self.totalSize,
+                self.offset,
+                self.stripeSize,
+            ) = struct.unpack(
+                f"<{CLIENT_ID_LENGTH}sBLLLL",
+                data[offset : offset + StripeSendRequest.STRIPE_HEADER_SIZE],
+            )
+            if self.header.payloadSize != StripeSendRequest.STRIPE_HEADER_SIZE + self.stripeSize:
+                return False
+
+            offset += StripeSendRequest.STRIPE_HEADER_SIZE
+            self.content = data[offset : offset + self.stripeSize]
+            return True
+        except:
+            self.clientID = b""
+            self.content = b""
+            return False
+
+    def missing_bytes(self, packet_size):
+        """
+        Socket bytes still to read for this stripe: whole packets, the last one padded.
+        """
+        remaining = self.stripeSize - len(self.content)
+        return (remaining + packet_size - 1) // packet_size * packet_size
+
+    def add_packets(self, packets):
+        """
+        Complete the stripe with the remaining packets (padding is dropped).
+        """
+        self.content += packets[: self.stripeSize - len(self.content)]
+
+
+class StripeReceivedResponse:
+    """Response structure for a stored stripe"""
+
+    def __init__(self):
+        self.header = ResponseHeader(ResponseCode.STRIPE_RECEIVED.value)
+        self.clientID = b""  # Recipient's client ID
+        self.transferID = 0  # Transfer of the stripe
+        self.receivedSize = 0  # Content bytes received so far
+        self.messageID = 0  # Assigned message ID once complete, otherwise 0
+
+    def pack(self):
+        """
+        Pack stripe received response fields into binary data.
+        Returns: Packed binary data
+        """
+        try:
+            self.header.payloadSize = CLIENT_ID_LENGTH + 8 + MSG_ID_SIZE
+            data = self.header.pack()
+            data += struct.pack(
+                f"<{CLIENT_ID_LENGTH}sLLL",
+                self.clientID,
+                self.transferID,
+                self.receivedSize,
+                self.messageID,
+            )
+            return data
+        except:
+            return b""
+
+
+class BatchSendRequest:
+    """Request structure for several messages sent in one request"""
+
+    ENTRY_HEADER_SIZE = CLIENT_ID_LENGTH + 5  # clientID, type, content size
+
+    def __init__(self):
+        self.header = RequestHeader()
+        self.entries = []  # (recipient client ID, message type, content) in request order
+
+    def unpack(self, conn, data):
+        """
+        Unpack binary data into batch request fields.
+        Reads the rest of the payload from the connection in one call.
+        Args -  conn: Socket connection to read additional data from
+                data: Initial binary data chunk (one packet)
+        Returns: True if unpacking was successful, False otherwise
+        """
+        packet_size = len(data)
+
+        if not self.header.unpack(data):
+            return False
+
+        try:
+            offset = self.header.SIZE
+            first = data[offset : offset + self.header.payloadSize]
+            remaining = self.header.payloadSize - len(first)
+            rest = b""
+            if remaining > 0:
+                packets = (remaining + packet_size - 1) // packet_size
+                rest = receive_exact(conn, packets * packet_size)
+                if not rest:  # Connection closed
+                    return False
+            payload = first + rest[:remaining]
+
+            (count,) = struct.unpack("<L", payload[:4])
+            if count == 0 or count > BATCH_MAX_ENTRIES:
+                return False
+            offset = 4
+            for _ in range(count):
+                if offset + BatchSendRequest.ENTRY_HEADER_SIZE > len(payload):
+                    return False
+                client_id, message_type, content_size = struct.unpack(
+                    f"<{CLIENT_ID_LENGTH}sBL",
+                    payload[offset : offset + BatchSendRequest.ENTRY_HEADER_SIZE],
+                )
+                offset += BatchSendRequest.ENTRY_HEADER_SIZE
+                if offset + content_size > len(payload):
+                    return False
+                self.entries.append(
+                    (client_id, message_type, payload[offset : offset + content_size])
+                )
+                offset += content_size
+            return offset == len(payload)
+        except:
+            self.entries = []
+            return False
+
+
+class BatchSentResponse:
+    """Response structure for a stored batch"""
+
+    def __init__(self):
+        self.header = ResponseHeader(ResponseCode.BATCH_SENT.value)
+        self.entries = []  # (recipient client ID, assigned message ID) in request order
+
+    def pack(self):
+        """
+        Pack batch sent response fields into binary data.
+        Returns: Packed binary data
+        """
+        try:
+            self.header.payloadSize = 4 + len(self.entries) * (CLIENT_ID_LENGTH + MSG_ID_SIZE)
+            data = self.header.pack()
+            data += struct.pack("<L", len(self.entries))
+            for client_id, message_id in self.entries:
+                data += struct.pack(f"<{CLIENT_ID_LENGTH}sL", client_id, message_id)
+            return data
+        except:
+            return b""
+
+
 class MessageSentResponse:
     """Response structure for message sending confirmation"""
 
@@ -468,6 +668,50 @@ class MessageSentResponse:
             return False
 
 
+class InboxStatusResponse:
+    """Response structure for the pending messages summary"""
+
+    def __init__(self):
+        self.header = ResponseHeader(ResponseCode.INBOX_STATUS.value)
+        self.messageCount = 0  # Pending messages (4 bytes)
+        self.totalBytes = 0  # Sum of their content sizes (8 bytes)
+        self.pollHintMs = 0  # Suggested minimum time to the next probe (4 bytes)
+
+    def pack(self):
+        """
+        Pack inbox status response fields into binary data.
+        Returns: Packed binary data
+        """
+        try:
+            self.header.payloadSize = 16
+            data = self.header.pack()
+            data += struct.pack("<LQL", self.messageCount, self.totalBytes, self.pollHintMs)
+            return data
+        except:
+            return b""
+
+
+class ServerInfoResponse:
+    """Response structure for the server's optional features"""
+
+    def __init__(self):
+        self.header = ResponseHeader(ResponseCode.SERVER_INFO.value)
+        self.features = 0  # FEATURE_* flags (4 bytes)
+
+    def pack(self):
+        """
+        Pack server info response fields into binary data.
+        Returns: Packed binary data
+        """
+        try:
+            self.header.payloadSize = 4
+            data = self.header.pack()
+            data += struct.pack("<L", self.features)
+            return data
+        except:
+            return b""
+
+
 class PendingMessage:
     """Structure for pending messages retrieved from server"""
 
@@ -536,6 +780,55 @@ class PendingMessage:
             return False, 0
 
 
+# Socket helpers (whole packets keep persistent connections in sync)
+
+SOCKET_TIMEOUT = 5.0  # Seconds to wait for a peer that stalls mid-packet
+
+
+def receive_exact(conn, size):
+    """
+    Read exactly size bytes from a (possibly non-blocking) socket.
+    Args -  conn: Socket connection to read from
+            size: Number of bytes to read
+    Returns: The bytes read, or b"" if the peer closed or stalled
+    """
+    data = bytearray()  # Appends in place: large stripes arrive in many chunks
+    while len(data) < size:
+        try:
+            chunk = conn.recv(size - len(data))
+        except BlockingIOError:
+            readable, _, _ = select.select([conn], [], [], SOCKET_TIMEOUT)
+            if not readable:
+                return b""
+            continue
+        if not chunk:
+            return b""
+        data += chunk
+    return bytes(data)
+
+
+def send_exact(conn, data):
+    """
+    Write all of data to a (possibly non-blocking) socket.
+    Args -  conn: Socket connection to write to
+            data: Bytes to send
+    Returns: True if everything was sent, False otherwise
+    """
+    view = memoryview(data)
+    while view:
+        try:
+            sent = conn.send(view)
+        except BlockingIOError:
+            _, writable, _ = select.select([], [conn], [], SOCKET_TIMEOUT)
+            if not writable:
+                return False
+            continue
+        if sent <= 0:
+            return False
+        view = view[sent:]
+    return True
+
+
 # Utility functions for message and client ID handling
 
 
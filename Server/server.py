@@ -11,22 +11,78 @@ import logging
 import selectors
 import uuid
 import socket
+import time
 import database
 import protocol
 from datetime import datetime
 from typing import Dict, Callable, Optional, Tuple, Any
 
 
+class StripeTransfer:
+    """
+    Stripes of one message received so far, kept until every byte has arrived.
+    A transfer is identified by its sender and the sender-chosen transfer ID.
+    """
+
+    def __init__(self, recipient: bytes, message_type: int, total_size: int):
+        self.recipient = recipient
+        self.message_type = message_type
+        self.total_size = total_size
+        self.chunks: Dict[int, bytes] = {}  # Stripe offset -> stripe bytes
+        self.received = 0
+        self.updated = time.monotonic()
+
+    def add(self, offset: int, content: bytes) -> bool:
+        """
+        Store a stripe. Returns False if it overlaps a stored stripe.
+        """
+        end = offset + len(content)
+        for start, chunk in self.chunks.items():
+            if offset < start + len(chunk) and start < end:
+                return False
+        self.chunks[offset] = content
+        self.received += len(content)
+        self.updated = time.monotonic()
+        return True
+
+    def is_complete(self) -> bool:
+        # Stripes never overlap, so the byte count proves full coverage
+        return self.received == self.total_size
+
+    def content(self) -> bytes:
+        return b"".join(self.chunks[offset] for offset in sorted(self.chunks))
+
+
+class StripeRead:
+    """
+    A stripe whose remaining packets are still arriving on its connection.
+    """
+
+    def __init__(self, request, missing: int):
+        self.request = request
+        self.missing = missing  # Socket bytes still expected (whole packets)
+        self.packets = bytearray()  # Appends in place: stripes arrive in many chunks
+        self.updated = time.monotonic()
+
+
 class Server:
     """
     MessageU server implementation handling client connections and message routing.
     Uses non-blocking sockets with selectors for efficient I/O multiplexing.
+    A connection stays open across requests until the client closes it (or a
+    request fails), so clients may reuse one connection for many requests.
     """
 
     # Class constants
     DATABASE_PATH = "defensive.db"
     PACKET_SIZE = 1024  # Default packet size in bytes
     MAX_CONNECTIONS = 10  # Maximum number of queued connections
+    STRIPE_TIMEOUT = 60.0  # Seconds an incomplete striped transfer is kept without progress
+    STRIPE_SWEEP_INTERVAL = 1.0  # Seconds between checks for expired stripes
+    MAX_OPEN_TRANSFERS = 16  # Incomplete striped transfers per sender
+    PROBE_TARGET_RATE = 50.0  # Inbox probes per second the poll hint aims for, all clients together
+    POLLER_WINDOW = 60.0  # Seconds a client counts as polling after its last probe
+    STRIPE_READ_SIZE = 64 * 1024  # Most stripe bytes read per readiness event
     NON_BLOCKING = False  # Socket blocking mode
 
     def __init__(self, host: str, port: int):
@@ -42,6 +98,9 @@ class Server:
         self.selector = selectors.DefaultSelector()
         self.database = database.Database(Server.DATABASE_PATH)
         self.last_error = ""  # Last error description
+        self.stripe_transfers: Dict[Tuple[bytes, int], StripeTransfer] = {}
+        self.stripe_reads: Dict[socket.socket, StripeRead] = {}  # Stripes still arriving
+        self.pollers: Dict[bytes, float] = {}  # Client ID -> time of its last inbox probe
 
         # Map request codes to their corresponding handler methods
         self.request_handlers: Dict[int, Callable] = {
@@ -50,6 +109,10 @@ class Server:
             protocol.RequestCode.PUBLIC_KEY.value: self._handle_public_key,
             protocol.RequestCode.SEND_MESSAGE.value: self._handle_message_send,
             protocol.RequestCode.PENDING_MESSAGES.value: self._handle_pending_messages,
+            protocol.RequestCode.SEND_STRIPE.value: self._handle_stripe_send,
+            protocol.RequestCode.INBOX_PROBE.value: self._handle_inbox_probe,
+            protocol.RequestCode.SEND_BATCH.value: self._handle_batch_send,
+            protocol.RequestCode.SERVER_INFO.value: self._handle_server_info,
         }
 
         # Configure logging
@@ -79,11 +142,13 @@ class Server:
             conn: Client connection socket
             mask: Event mask from selector
         """
-        client_addr = conn.getpeername() if hasattr(conn, "getpeername") else "Unknown"
-        logging.info(f"Processing request from {client_addr}")
-
+        keep_open = False
         try:
-            data = conn.recv(Server.PACKET_SIZE)
+            # A connection reset by the peer has no address any more
+            client_addr = self._peer_name(conn)
+            logging.info(f"Processing request from {client_addr}")
+
+            data = protocol.receive_exact(conn, Server.PACKET_SIZE)
             if data:
                 request_header = protocol.RequestHeader()
                 success = False
@@ -110,6 +175,9 @@ class Server:
                     self.database.set_last_seen(
                         request_header.clientID, str(datetime.now())
                     )
+
+                # After a failed request the stream may be out of sync
+                keep_open = success
             else:
                 logging.debug(
                     f"No data received from {client_addr}, closing connection"
@@ -117,9 +185,9 @@ class Server:
         except Exception as e:
             logging.error(f"Error processing request: {str(e)}")
         finally:
-            # Always clean up the connection
-            self.selector.unregister(conn)
-            conn.close()
+            # Wait for the next request, or clean up the connection
+            if not keep_open:
+                self._close_connection(conn)
 
     def send_response(self, conn: socket.socket, data: bytes) -> bool:
         """
@@ -145,24 +213,44 @@ class Server:
                 if len(chunk) < Server.PACKET_SIZE:
                     chunk += bytearray(Server.PACKET_SIZE - len(chunk))
 
-                # Send the chunk
-                bytes_sent = conn.send(chunk)
-                if bytes_sent <= 0:
+                # Send the whole chunk (partial sends would split packets)
+                if not protocol.send_exact(conn, chunk):
                     logging.error("Socket send returned unexpected result")
                     return False
 
-                sent += bytes_sent
+                sent += chunk_size
 
             logging.info(f"Response sent successfully ({size} bytes)")
             return True
 
         except Exception as e:
-            client_addr = (
-                conn.getpeername() if hasattr(conn, "getpeername") else "Unknown"
-            )
-            logging.error(f"Failed to send response to {client_addr}: {str(e)}")
+            logging.error(f"Failed to send response to {self._peer_name(conn)}: {str(e)}")
             return False
 
+    @staticmethod
+    def _peer_name(conn: socket.socket):
+        """
+        Get the client address for logging, or "Unknown" once the connection is reset.
+        """
+        try:
+            return conn.getpeername()
+        except OSError:
+            return "Unknown"
+
+    def _close_connection(self, conn: socket.socket) -> None:
+        """
+        Stop serving a connection and close it, whatever state it is in.
+
+        Args:
+            conn: Client connection socket
+        """
+        self.stripe_reads.pop(conn, None)
+        try:
+            self.selector.unregister(conn)
+        except (KeyError, ValueError):
+            pass  # Not registered, or already closed
+        conn.close()
+
     def start(self) -> bool:
         """
         Start the server, initialize database and begin listening for connections.
@@ -198,11 +286,22 @@ class Server:
 
         # Main server loop
         try:
+            next_sweep = time.monotonic()
             while True:
-                events = self.selector.select()
+                # Wake up regularly, so stalled stripes expire without further traffic
+                events = self.selector.select(timeout=Server.STRIPE_SWEEP_INTERVAL)
+                if time.monotonic() >= next_sweep:
+                    self._expire_stripe_transfers()
+                    next_sweep = time.monotonic() + Server.STRIPE_SWEEP_INTERVAL
                 for key, mask in events:
                     callback = key.data
-                    callback(key.fileobj, mask)
+                    try:
+                        callback(key.fileobj, mask)
+                    except Exception as e:
+                        # A failing connection must not stop the server
+                        logging.exception(f"Error serving connection: {str(e)}")
+                        if key.fileobj is not server_socket:
+                            self._close_connection(key.fileobj)
 
         except KeyboardInterrupt:
             logging.info("Server shutting down due to keyboard interrupt")
@@ -425,6 +524,290 @@ class Server:
 
         return self.send_response(conn, response.pack())
 
+    def _handle_batch_send(self, conn: socket.socket, data: bytes) -> bool:
+        """
+        Process request to send several messages, each to its own recipient.
+        All messages are stored in one transaction, or none if any is invalid:
+        every recipient must exist and every message must be text or a file.
+
+        Args:
+            conn: Client connection socket
+            data: Request data
+
+        Returns:
+            True if the batch was stored successfully, False otherwise
+        """
+        request = protocol.BatchSendRequest()
+        response = protocol.BatchSentResponse()
+
+        if not request.unpack(conn, data):
+            logging.error("Send Batch Request: Failed to parse request")
+            return False
+
+        for index, (_, message_type, _) in enumerate(request.entries):
+            if (
+                not protocol.validate_message_type(message_type)
+                or message_type not in protocol.BATCH_MESSAGE_TYPES
+            ):
+                logging.error(
+                    f"Send Batch Request: Invalid message type {message_type} in entry {index + 1}"
+                )
+                return False
+
+        recipients = {client_id for client_id, _, _ in request.entries}
+        if not all(self.database.client_id_exists(client_id) for client_id in recipients):
+            logging.error("Send Batch Request: Unknown recipient")
+            return False
+
+        messages = [
+            database.Message(client_id, request.header.clientID, message_type, content)
+            for client_id, message_type, content in request.entries
+        ]
+        message_ids = self.database.store_messages(messages)
+        if not message_ids:
+            logging.error("Send Batch Request: Failed to store messages")
+            return False
+
+        response.entries = [
+            (client_id, message_id)
+            for (client_id, _, _), message_id in zip(request.entries, message_ids)
+        ]
+        logging.info(
+            f"Batch of {len(message_ids)} messages from {request.header.clientID.hex()} stored "
+            f"(IDs {message_ids[0]}-{message_ids[-1]})"
+        )
+        return self.send_response(conn, response.pack())
+
+    def _handle_stripe_send(self, conn: socket.socket, data: bytes) -> bool:
+        """
+        Process one stripe of a message uploaded over several connections.
+        Only the first packet is read here. The rest of the stripe is read by
+        _receive_stripe as it arrives, so stripes on different connections are
+        received side by side and other clients are served meanwhile.
+
+        Args:
+            conn: Client connection socket
+            data: Request data
+
+        Returns:
+            True if the stripe was accepted or its reading started, False otherwise
+        """
+        request = protocol.StripeSendRequest()
+
+        if not request.unpack(data):
+            logging.error("Send Stripe Request: Failed to parse request")
+            return False
+
+        key = (request.header.clientID, request.transferID)
+        if (
+            request.stripeSize == 0
+            or request.offset + request.stripeSize > request.totalSize
+            or not self.database.client_id_exists(request.header.clientID)
+            or not self.database.client_id_exists(request.clientID)
+        ):
+            logging.error("Send Stripe Request: Invalid stripe")
+            self.stripe_transfers.pop(key, None)
+            return False
+
+        missing = request.missing_bytes(Server.PACKET_SIZE)
+        if missing == 0:
+            return self._store_stripe(conn, request)
+
+        self.stripe_reads[conn] = StripeRead(request, missing)
+        self.selector.modify(conn, selectors.EVENT_READ, self._receive_stripe)
+        return True
+
+    def _receive_stripe(self, conn: socket.socket, mask: int) -> None:
+        """
+        Read the part of a stripe that has arrived, and store the stripe once complete.
+
+        Args:
+            conn: Client connection socket
+            mask: Event mask from selector
+        """
+        read = self.stripe_reads[conn]
+        try:
+            chunk = conn.recv(min(read.missing, Server.STRIPE_READ_SIZE))
+        except (BlockingIOError, InterruptedError):
+            return
+        except OSError:
+            chunk = b""
+        if not chunk:
+            logging.error("Send Stripe Request: Connection closed mid-stripe")
+            self._close_connection(conn)
+            return
+
+        read.packets += chunk
+        read.missing -= len(chunk)
+        read.updated = time.monotonic()
+        if read.missing > 0:
+            return
+
+        # Complete: the connection returns to reading requests
+        del self.stripe_reads[conn]
+        self.selector.modify(conn, selectors.EVENT_READ, self.process_request)
+        read.request.add_packets(bytes(read.packets))
+        try:
+            stored = self._store_stripe(conn, read.request)
+        except Exception as e:
+            logging.error(f"Error processing request: {str(e)}")
+            stored = False
+        if not stored:
+            response_header = protocol.ResponseHeader(protocol.ResponseCode.ERROR.value)
+            self.send_response(conn, response_header.pack())
+            self._close_connection(conn)
+
+    def _store_stripe(self, conn: socket.socket, request: protocol.StripeSendRequest) -> bool:
+        """
+        Add a completely received stripe to its transfer, storing the message
+        once its last missing stripe has arrived, and answer the stripe.
+
+        Args:
+            conn: Client connection socket
+            request: Stripe with its content
+
+        Returns:
+            True if the stripe was accepted, False otherwise
+        """
+        response = protocol.StripeReceivedResponse()
+        sender = request.header.clientID
+        key = (sender, request.transferID)
+
+        transfer = self.stripe_transfers.get(key)
+        if transfer is None:
+            open_transfers = sum(1 for owner, _ in self.stripe_transfers if owner == sender)
+            if open_transfers >= Server.MAX_OPEN_TRANSFERS:
+                logging.error("Send Stripe Request: Too many open transfers")
+                return False
+            transfer = StripeTransfer(
+                request.clientID, request.messageType, request.totalSize
+            )
+            self.stripe_transfers[key] = transfer
+
+        # Every stripe must describe the same message
+        if (
+            transfer.recipient != request.clientID
+            or transfer.message_type != request.messageType
+            or transfer.total_size != request.totalSize
+            or not transfer.add(request.offset, request.content)
+        ):
+            logging.error("Send Stripe Request: Stripe does not match its transfer")
+            del self.stripe_transfers[key]
+            return False
+
+        message_id = 0
+        if transfer.is_complete():
+            del self.stripe_transfers[key]
+            message = database.Message(
+                transfer.recipient, sender, transfer.message_type, transfer.content()
+            )
+            message_id = self.database.store_message(message)
+            if not message_id:
+                logging.error("Send Stripe Request: Failed to store message")
+                return False
+            logging.info(
+                f"Striped message from {sender.hex()} to {transfer.recipient.hex()} "
+                f"stored successfully (ID: {message_id}, {transfer.total_size} bytes)"
+            )
+
+        response.clientID = request.clientID
+        response.transferID = request.transferID
+        response.receivedSize = transfer.received
+        response.messageID = message_id
+        return self.send_response(conn, response.pack())
+
+    def _expire_stripe_transfers(self) -> None:
+        """
+        Drop incomplete striped transfers, and stripes still arriving, that made
+        no progress for STRIPE_TIMEOUT.
+        """
+        deadline = time.monotonic() - Server.STRIPE_TIMEOUT
+        for key in [k for k, t in self.stripe_transfers.items() if t.updated < deadline]:
+            logging.warning(f"Striped transfer {key[1]} from {key[0].hex()} expired")
+            del self.stripe_transfers[key]
+        for conn in [c for c, r in self.stripe_reads.items() if r.updated < deadline]:
+            logging.warning("Stripe upload stalled, closing its connection")
+            self._close_connection(conn)
+
+    def _poll_hint(self, client_id: bytes) -> int:
+        """
+        Record a probe and compute the shortest poll interval to suggest.
+        Spreads the probes of all recently polling clients over PROBE_TARGET_RATE,
+        so the hint only matters once many clients poll at once.
+
+        Args:
+            client_id: ID of the probing client
+
+        Returns:
+            Suggested minimum milliseconds between probes
+        """
+        now = time.monotonic()
+        self.pollers.pop(client_id, None)  # Re-inserted last, so the first entry is the oldest
+        self.pollers[client_id] = now
+        deadline = now - Server.POLLER_WINDOW
+        if len(self.pollers) > 1 and next(iter(self.pollers.values())) < deadline:
+            self.pollers = {k: t for k, t in self.pollers.items() if t >= deadline}
+        return int(1000 * len(self.pollers) / Server.PROBE_TARGET_RATE)
+
+    def _handle_inbox_probe(self, conn: socket.socket, data: bytes) -> bool:
+        """
+        Process request for the number and size of pending messages.
+        Lets pollers skip the full download while nothing is waiting.
+
+        Args:
+            conn: Client connection socket
+            data: Request data
+
+        Returns:
+            True if request was handled successfully, False otherwise
+        """
+        request = protocol.RequestHeader()
+        response = protocol.InboxStatusResponse()
+
+        if not request.unpack(data):
+            logging.error("Inbox probe request: Failed to parse request header")
+            return False
+
+        if not self.database.client_id_exists(request.clientID):
+            logging.info("Inbox probe request: Invalid client ID")
+            return False
+
+        summary = self.database.get_pending_summary(request.clientID)
+        if summary is None:
+            return False
+        response.messageCount, response.totalBytes = summary
+        response.pollHintMs = self._poll_hint(request.clientID)
+        logging.debug(
+            f"Inbox probe from {request.clientID.hex()}: {response.messageCount} messages"
+        )
+        return self.send_response(conn, response.pack())
+
+    def _handle_server_info(self, conn: socket.socket, data: bytes) -> bool:
+        """
+        Process request for the server's optional features.
+
+        Args:
+            conn: Client connection socket
+            data: Request data
+
+        Returns:
+            True if request was handled successfully, False otherwise
+        """
+        request = protocol.RequestHeader()
+        response = protocol.ServerInfoResponse()
+
+        if not request.unpack(data):
+            logging.error("Server info request: Failed to parse request header")
+            return False
+
+        if not self.database.client_id_exists(request.clientID):
+            logging.info("Server info request: Invalid client ID")
+            return False
+
+        # Stripe bodies are read as they arrive (see _receive_stripe)
+        response.features = protocol.FEATURE_CONCURRENT_STRIPES
+        return self.send_response(conn, response.pack())
+
     def _handle_pending_messages(self, conn: socket.socket, data: bytes) -> bool:
         """
         Process request for pending messages and deliver them to client.